@@ -0,0 +1,377 @@
+// Measures the speed of the parts of the library that process settings and
+// names without talking to a device, using a generated corpus of settings
+// files for every product.
+
+#include <tic.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static const char help[] =
+  "Usage: ticbench_settings OPTIONS\n"
+  "\n"
+  "Measures the speed of settings processing and name lookups.\n"
+  "\n"
+  "Options:\n"
+  "  --files NUM          Settings files to generate per product (default: 200).\n"
+  "  --repeat NUM         Times to process the corpus (default: 10).\n"
+  "  --write-corpus DIR   Also write the generated files to DIR.\n"
+  "  -h, --help           Show this help screen.\n";
+
+static const uint8_t products[] = {
+  TIC_PRODUCT_T825,
+  TIC_PRODUCT_T834,
+  TIC_PRODUCT_T500,
+  TIC_PRODUCT_N825,
+  TIC_PRODUCT_T249,
+};
+
+struct options
+{
+  uint32_t files = 200;
+  uint32_t repeat = 10;
+  std::string corpus_dir;
+};
+
+static uint32_t parse_number(int argc, char ** argv, int & i)
+{
+  std::string arg = argv[i];
+  if (++i >= argc)
+  {
+    throw std::runtime_error("Expected a number after '" + arg + "'.");
+  }
+  char * end;
+  unsigned long value = strtoul(argv[i], &end, 10);
+  if (*argv[i] == 0 || *end != 0 || value == 0 || value > UINT32_MAX)
+  {
+    throw std::runtime_error("The number after '" + arg + "' is invalid.");
+  }
+  return value;
+}
+
+static options parse_args(int argc, char ** argv)
+{
+  options opts;
+  for (int i = 1; i < argc; i++)
+  {
+    std::string arg = argv[i];
+    if (arg == "--files")
+    {
+      opts.files = parse_number(argc, argv, i);
+    }
+    else if (arg == "--repeat")
+    {
+      opts.repeat = parse_number(argc, argv, i);
+    }
+    else if (arg == "--write-corpus")
+    {
+      if (++i >= argc)
+      {
+        throw std::runtime_error("Expected a directory after '" + arg + "'.");
+      }
+      opts.corpus_dir = argv[i];
+    }
+    else if (arg == "-h" || arg == "--help")
+    {
+      std::cout << help;
+      exit(0);
+    }
+    else
+    {
+      throw std::runtime_error("Unknown option: '" + arg + "'.");
+    }
+  }
+  return opts;
+}
+
+// A small deterministic random number generator, so every run processes the
+// same corpus.
+class random_source
+{
+public:
+  uint32_t next(uint32_t limit)
+  {
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (state >> 33) % limit;
+  }
+
+private:
+  uint64_t state = 1;
+};
+
+// Makes a settings object for the specified product with a realistic mix of
+// changes from the defaults.  Some of the values are out of range so that
+// tic_settings_fix() has work to do.
+static tic::settings generate_settings(uint8_t product, random_source & random)
+{
+  tic::settings settings = tic::settings::create();
+  tic_settings * s = settings.get_pointer();
+  tic_settings_set_product(s, product);
+  tic_settings_fill_with_defaults(s);
+
+  tic_settings_set_control_mode(s, random.next(8));
+  tic_settings_set_disable_safe_start(s, random.next(2));
+  tic_settings_set_serial_baud_rate(s, 9600 * (1 + random.next(24)));
+  tic_settings_set_serial_device_number_u16(s, random.next(0x4000));
+  tic_settings_set_command_timeout(s, random.next(4000));
+  tic_settings_set_serial_crc_for_commands(s, random.next(2));
+  tic_settings_set_serial_response_delay(s, random.next(20));
+  tic_settings_set_input_hysteresis(s, random.next(200));
+  tic_settings_set_input_scaling_degree(s, random.next(3));
+  tic_settings_set_input_min(s, random.next(1000));
+  tic_settings_set_input_max(s, 3000 + random.next(1096));
+  tic_settings_set_output_min(s, -(int32_t)random.next(100000));
+  tic_settings_set_output_max(s, random.next(100000));
+  tic_settings_set_encoder_prescaler(s, 1 + random.next(100));
+  tic_settings_set_encoder_postscaler(s, 1 + random.next(100));
+
+  for (uint8_t pin = 0; pin < TIC_CONTROL_PIN_COUNT; pin++)
+  {
+    tic_settings_set_pin_func(s, pin, random.next(10));
+    tic_settings_set_pin_pullup(s, pin, random.next(2));
+    tic_settings_set_pin_polarity(s, pin, random.next(2));
+  }
+
+  uint32_t max_current = tic_get_max_allowed_current(product);
+  tic_settings_set_current_limit(s, random.next(max_current + 500));
+  tic_settings_set_step_mode(s, random.next(7));
+
+  // Only use decay modes that can be written to a settings file.
+  uint8_t decay_mode = random.next(5);
+  const char * decay_mode_name;
+  if (!tic_look_up_decay_mode_name(decay_mode, product, 0, &decay_mode_name))
+  {
+    decay_mode = 0;
+  }
+  tic_settings_set_decay_mode(s, decay_mode);
+
+  tic_settings_set_max_speed(s, random.next(500000000));
+  tic_settings_set_starting_speed(s, random.next(2000000));
+  tic_settings_set_max_accel(s, 100 + random.next(2000000));
+  tic_settings_set_max_decel(s, random.next(2000000));
+  tic_settings_set_invert_motor_direction(s, random.next(2));
+
+  return settings;
+}
+
+static void print_header()
+{
+  std::cout << std::left << std::setw(30) << "Operation" << std::right
+    << std::setw(12) << "Count"
+    << std::setw(12) << "Total (ms)"
+    << std::setw(12) << "ns/op"
+    << std::setw(14) << "ops/s"
+    << std::endl;
+}
+
+// Runs the function the specified number of times.  Each call is counted as
+// ops_per_call operations.
+static void run_benchmark(const std::string & name, uint32_t calls,
+  uint64_t ops_per_call, const std::function<void()> & function)
+{
+  typedef std::chrono::steady_clock clock;
+
+  clock::time_point start = clock::now();
+  for (uint32_t i = 0; i < calls; i++) { function(); }
+  double total = std::chrono::duration<double>(clock::now() - start).count();
+
+  uint64_t ops = calls * ops_per_call;
+  std::cout << std::left << std::setw(30) << name << std::right
+    << std::setw(12) << ops
+    << std::fixed << std::setprecision(1)
+    << std::setw(12) << total * 1000
+    << std::setw(12) << total * 1e9 / ops
+    << std::setprecision(0)
+    << std::setw(14) << ops / total
+    << std::endl;
+}
+
+static void check(tic_error * error)
+{
+  tic::throw_if_needed(error);
+}
+
+// Prevents the compiler from optimizing away results we do not use.
+static volatile uintptr_t sink;
+
+static void run(const options & opts)
+{
+  random_source random;
+
+  std::vector<std::string> corpus;
+  for (uint8_t product : products)
+  {
+    for (uint32_t i = 0; i < opts.files; i++)
+    {
+      corpus.push_back(generate_settings(product, random).to_string());
+    }
+  }
+
+  if (!opts.corpus_dir.empty())
+  {
+    for (size_t i = 0; i < corpus.size(); i++)
+    {
+      std::string filename = opts.corpus_dir + "/settings" +
+        std::to_string(i) + ".txt";
+      std::ofstream file(filename);
+      file << corpus[i];
+      if (!file)
+      {
+        throw std::runtime_error("Failed to write " + filename + ".");
+      }
+    }
+  }
+
+  size_t corpus_bytes = 0;
+  for (const std::string & str : corpus) { corpus_bytes += str.size(); }
+  std::cout << "Corpus: " << corpus.size() << " files, "
+    << corpus_bytes << " bytes" << std::endl;
+
+  std::vector<tic_settings *> parsed(corpus.size());
+  for (size_t i = 0; i < corpus.size(); i++)
+  {
+    check(tic_settings_read_from_string(corpus[i].c_str(), &parsed[i]));
+  }
+
+  print_header();
+
+  run_benchmark("tic_settings_read_from_string", opts.repeat, corpus.size(),
+    [&]() {
+      for (const std::string & str : corpus)
+      {
+        tic_settings * settings;
+        check(tic_settings_read_from_string(str.c_str(), &settings));
+        tic_settings_free(settings);
+      }
+    });
+
+  run_benchmark("tic_settings_to_string", opts.repeat, parsed.size(), [&]() {
+    for (tic_settings * settings : parsed)
+    {
+      char * str;
+      check(tic_settings_to_string(settings, &str));
+      tic_string_free(str);
+    }
+  });
+
+  run_benchmark("tic_settings_copy", opts.repeat, parsed.size(), [&]() {
+    for (tic_settings * settings : parsed)
+    {
+      tic_settings * copy;
+      check(tic_settings_copy(settings, &copy));
+      tic_settings_free(copy);
+    }
+  });
+
+  run_benchmark("tic_settings_fix", opts.repeat, parsed.size(), [&]() {
+    for (tic_settings * settings : parsed)
+    {
+      tic_settings * copy;
+      check(tic_settings_copy(settings, &copy));
+      char * warnings;
+      check(tic_settings_fix(copy, &warnings));
+      tic_string_free(warnings);
+      tic_settings_free(copy);
+    }
+  });
+
+  // Fixing settings that were fixed before and then had one field changed,
+  // which is what the GUI and tic_set_settings() usually do.
+  std::vector<tic_settings *> fixed(parsed.size());
+  for (size_t i = 0; i < parsed.size(); i++)
+  {
+    check(tic_settings_copy(parsed[i], &fixed[i]));
+    check(tic_settings_fix(fixed[i], NULL));
+  }
+
+  run_benchmark("tic_settings_fix (one change)", opts.repeat, fixed.size(),
+    [&]() {
+      for (tic_settings * settings : fixed)
+      {
+        tic_settings * copy;
+        check(tic_settings_copy(settings, &copy));
+        tic_settings_set_max_accel(copy, tic_settings_get_max_accel(copy) + 1);
+        char * warnings;
+        check(tic_settings_fix(copy, &warnings));
+        tic_string_free(warnings);
+        tic_settings_free(copy);
+      }
+    });
+
+  run_benchmark("tic_look_up_*_name_ui", opts.repeat * 1000, 256 * 9, [&]() {
+    for (uint32_t code = 0; code < 256; code++)
+    {
+      sink = (uintptr_t)tic_look_up_product_name_ui(code);
+      sink = (uintptr_t)tic_look_up_input_state_name_ui(code);
+      sink = (uintptr_t)tic_look_up_device_reset_name_ui(code);
+      sink = (uintptr_t)tic_look_up_operation_state_name_ui(code);
+      sink = (uintptr_t)tic_look_up_step_mode_name_ui(code);
+      sink = (uintptr_t)tic_look_up_pin_state_name_ui(code);
+      sink = (uintptr_t)tic_look_up_planning_mode_name_ui(code);
+      sink = (uintptr_t)tic_look_up_motor_driver_error_name_ui(code);
+      sink = (uintptr_t)tic_look_up_agc_mode_name_ui(code);
+    }
+  });
+
+  static const char * decay_names[] = {
+    "mixed", "slow", "fast", "mixed25", "mixed50", "mixed75", "auto", "bogus",
+  };
+  run_benchmark("tic_look_up_decay_mode_code", opts.repeat * 1000,
+    sizeof(products) * 8, [&]() {
+      for (uint8_t product : products)
+      {
+        for (const char * name : decay_names)
+        {
+          uint8_t code;
+          sink = tic_look_up_decay_mode_code(name, product,
+            TIC_NAME_SNAKE_CASE, &code);
+        }
+      }
+    });
+
+  run_benchmark("tic_current_limit_ma_to_code", opts.repeat * 10,
+    sizeof(products) * 10000, [&]() {
+      for (uint8_t product : products)
+      {
+        for (uint32_t ma = 0; ma < 10000; ma++)
+        {
+          sink = tic_current_limit_ma_to_code(product, ma);
+        }
+      }
+    });
+
+  run_benchmark("tic_current_limit_code_to_ma", opts.repeat * 100,
+    sizeof(products) * 256, [&]() {
+      for (uint8_t product : products)
+      {
+        for (uint32_t code = 0; code < 256; code++)
+        {
+          sink = tic_current_limit_code_to_ma(product, code);
+        }
+      }
+    });
+
+  for (tic_settings * settings : parsed) { tic_settings_free(settings); }
+  for (tic_settings * settings : fixed) { tic_settings_free(settings); }
+}
+
+int main(int argc, char ** argv)
+{
+  try
+  {
+    run(parse_args(argc, argv));
+  }
+  catch (const std::exception & error)
+  {
+    std::cerr << "Error: " << error.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,429 @@
+// Measures the round-trip latency and throughput of the library's command
+// paths, using a real device over USB or serial, or an emulated device.
+
+#include <tic.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static const char help[] =
+  "Usage: ticbench OPTIONS\n"
+  "\n"
+  "Measures the latency of commands sent to a Tic.\n"
+  "\n"
+  "Options:\n"
+  "  -d SERIALNUMBER    Specifies the serial number of the device.\n"
+  "  --count NUM        Number of times to run each command (default: 1000).\n"
+  "  --eeprom           Also benchmark tic_set_settings(), which writes to the\n"
+  "                     Tic's EEPROM (always on for the simulated device).\n"
+  "  --port PORT        Use the Tic on the specified serial port.\n"
+  "  --port-settings FILE\n"
+  "                     A settings file describing how the Tic's serial\n"
+  "                     interface is set up (default: T825 defaults).\n"
+  "  --compact          Use the compact serial protocol.\n"
+  "  --half-duplex      The serial line is half-duplex (e.g. RS-485).\n"
+  "  --echo             The serial line echoes the bytes we send.\n"
+  "  --bus-devices LIST Measure update cycles for the devices on the serial\n"
+  "                     port with the specified device numbers, e.g. 1,2,3.\n"
+  "  --simulated        Use a simulated device instead of a real one.\n"
+  "  --latency US       Simulated request latency (default: 125).\n"
+  "  --jitter US        Maximum extra random simulated latency (default: 0).\n"
+  "  -h, --help         Show this help screen.\n";
+
+struct options
+{
+  std::string serial_number;
+  uint32_t count = 1000;
+  bool eeprom = false;
+  std::string port;
+  std::string port_settings;
+  bool compact = false;
+  bool half_duplex = false;
+  bool echo = false;
+  std::vector<uint16_t> bus_devices;
+  bool simulated = false;
+  uint32_t latency_us = 125;
+  uint32_t jitter_us = 0;
+};
+
+static uint32_t parse_number(int argc, char ** argv, int & i)
+{
+  std::string arg = argv[i];
+  if (++i >= argc)
+  {
+    throw std::runtime_error("Expected a number after '" + arg + "'.");
+  }
+  char * end;
+  unsigned long value = strtoul(argv[i], &end, 10);
+  if (*argv[i] == 0 || *end != 0 || value > UINT32_MAX)
+  {
+    throw std::runtime_error("The number after '" + arg + "' is invalid.");
+  }
+  return value;
+}
+
+static options parse_args(int argc, char ** argv)
+{
+  options opts;
+  for (int i = 1; i < argc; i++)
+  {
+    std::string arg = argv[i];
+    if (arg == "-d" || arg == "--serial")
+    {
+      if (++i >= argc)
+      {
+        throw std::runtime_error("Expected a serial number after '-d'.");
+      }
+      opts.serial_number = argv[i];
+    }
+    else if (arg == "--count")
+    {
+      opts.count = parse_number(argc, argv, i);
+      if (opts.count == 0)
+      {
+        throw std::runtime_error("The count must be at least 1.");
+      }
+    }
+    else if (arg == "--eeprom")
+    {
+      opts.eeprom = true;
+    }
+    else if (arg == "--port" || arg == "--port-settings")
+    {
+      if (++i >= argc)
+      {
+        throw std::runtime_error("Expected a filename after '" + arg + "'.");
+      }
+      (arg == "--port" ? opts.port : opts.port_settings) = argv[i];
+    }
+    else if (arg == "--compact")
+    {
+      opts.compact = true;
+    }
+    else if (arg == "--half-duplex")
+    {
+      opts.half_duplex = true;
+    }
+    else if (arg == "--echo")
+    {
+      opts.echo = true;
+    }
+    else if (arg == "--bus-devices")
+    {
+      if (++i >= argc)
+      {
+        throw std::runtime_error("Expected a list after '" + arg + "'.");
+      }
+      std::istringstream list(argv[i]);
+      std::string number;
+      while (std::getline(list, number, ','))
+      {
+        char * end;
+        unsigned long value = strtoul(number.c_str(), &end, 10);
+        if (number.empty() || *end != 0 || value > 0x3FFF)
+        {
+          throw std::runtime_error("Invalid device number: '" + number + "'.");
+        }
+        opts.bus_devices.push_back(value);
+      }
+    }
+    else if (arg == "--simulated")
+    {
+      opts.simulated = true;
+    }
+    else if (arg == "--latency")
+    {
+      opts.latency_us = parse_number(argc, argv, i);
+    }
+    else if (arg == "--jitter")
+    {
+      opts.jitter_us = parse_number(argc, argv, i);
+    }
+    else if (arg == "-h" || arg == "--help")
+    {
+      std::cout << help;
+      exit(0);
+    }
+    else
+    {
+      throw std::runtime_error("Unknown option: '" + arg + "'.");
+    }
+  }
+  return opts;
+}
+
+static tic::settings load_port_settings(const options & opts)
+{
+  if (opts.port_settings.empty())
+  {
+    tic::settings settings = tic::settings::create();
+    tic_settings_set_product(settings.get_pointer(), TIC_PRODUCT_T825);
+    tic_settings_fill_with_defaults(settings.get_pointer());
+    return settings;
+  }
+
+  std::ifstream file(opts.port_settings);
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+  if (!file)
+  {
+    throw std::runtime_error("Failed to read " + opts.port_settings + ".");
+  }
+  return tic::settings::read_from_string(buffer.str());
+}
+
+static uint32_t serial_flags(const options & opts)
+{
+  uint32_t flags = 0;
+  if (opts.compact) { flags |= TIC_SERIAL_COMPACT_PROTOCOL; }
+  if (opts.half_duplex) { flags |= TIC_SERIAL_HALF_DUPLEX; }
+  if (opts.echo) { flags |= TIC_SERIAL_ECHO; }
+  return flags;
+}
+
+static tic::handle open_handle(const options & opts)
+{
+  if (opts.simulated)
+  {
+    tic::emulator emulator = tic::emulator::create(TIC_PRODUCT_T825);
+    emulator.set_latency(opts.latency_us, opts.jitter_us);
+    return emulator.open_handle();
+  }
+
+  if (!opts.port.empty())
+  {
+    return tic::handle::open_serial(opts.port, load_port_settings(opts),
+      serial_flags(opts));
+  }
+
+  for (const tic::device & device : tic::list_connected_devices())
+  {
+    if (opts.serial_number.empty() ||
+      device.get_serial_number() == opts.serial_number)
+    {
+      return tic::handle(device);
+    }
+  }
+  throw std::runtime_error("No device was found.");
+}
+
+// Returns the value at the specified fraction of the way through a sorted
+// list of samples.
+static double percentile(const std::vector<double> & sorted, double fraction)
+{
+  size_t index = std::ceil(fraction * sorted.size());
+  if (index > 0) { index--; }
+  return sorted[std::min(index, sorted.size() - 1)];
+}
+
+static void print_header()
+{
+  std::cout << std::left << std::setw(26) << "Command" << std::right
+    << std::setw(8) << "Count"
+    << std::setw(10) << "p50 (ms)"
+    << std::setw(10) << "p90 (ms)"
+    << std::setw(10) << "p99 (ms)"
+    << std::setw(10) << "max (ms)"
+    << std::setw(10) << "ops/s"
+    << std::endl;
+}
+
+static void run_benchmark(const std::string & name, uint32_t count,
+  const std::function<void()> & command)
+{
+  typedef std::chrono::steady_clock clock;
+
+  std::vector<double> latencies;
+  latencies.reserve(count);
+
+  clock::time_point start = clock::now();
+  for (uint32_t i = 0; i < count; i++)
+  {
+    clock::time_point begin = clock::now();
+    command();
+    clock::time_point end = clock::now();
+    latencies.push_back(
+      std::chrono::duration<double, std::milli>(end - begin).count());
+  }
+  double total = std::chrono::duration<double>(clock::now() - start).count();
+
+  std::sort(latencies.begin(), latencies.end());
+
+  std::cout << std::left << std::setw(26) << name << std::right
+    << std::setw(8) << count
+    << std::fixed << std::setprecision(3)
+    << std::setw(10) << percentile(latencies, 0.50)
+    << std::setw(10) << percentile(latencies, 0.90)
+    << std::setw(10) << percentile(latencies, 0.99)
+    << std::setw(10) << latencies.back()
+    << std::setprecision(1)
+    << std::setw(10) << count / total
+    << std::endl;
+}
+
+static void run(const options & opts)
+{
+  tic::handle handle = open_handle(opts);
+  tic::device device = handle.get_device();
+
+  std::cout << "Device: " << device.get_short_name() << " #"
+    << device.get_serial_number() << ", firmware "
+    << handle.get_firmware_version_string() << std::endl;
+
+  // Command the position the motor is already at so that we do not cause
+  // any motion.
+  tic::variables vars = handle.get_variables();
+  int32_t position = vars.get_current_position();
+
+  tic::settings settings = handle.get_settings();
+
+  print_header();
+
+  run_benchmark("set_target_position", opts.count, [&]() {
+    handle.set_target_position(position);
+  });
+
+  // Ten commands per iteration, which transports like serial can send
+  // together.
+  run_benchmark("set_target_position x10", opts.count, [&]() {
+    handle.begin_batch();
+    for (int i = 0; i < 10; i++) { handle.set_target_position(position); }
+    handle.end_batch();
+  });
+
+  run_benchmark("reset_command_timeout", opts.count, [&]() {
+    handle.reset_command_timeout();
+  });
+
+  run_benchmark("get_variables", opts.count, [&]() {
+    handle.get_variables();
+  });
+
+  run_benchmark("update_variables", opts.count, [&]() {
+    handle.update_variables(vars);
+  });
+
+  run_benchmark("get_settings", opts.count, [&]() {
+    handle.get_settings();
+  });
+
+  if (opts.eeprom || opts.simulated)
+  {
+    // Each write cycles the EEPROM, which is rated for 100,000 cycles, so
+    // limit the number of iterations on real hardware.
+    uint32_t count = opts.count;
+    if (!opts.simulated) { count = std::min<uint32_t>(count, 10); }
+    run_benchmark("set_settings", count, [&]() {
+      handle.set_settings(settings);
+    });
+  }
+}
+
+// Runs update cycles for several devices on one serial port.  Each cycle sends
+// every device a command and then reads every device's variables, which is
+// how a multi-axis application typically uses a bus.
+static void run_bus(const options & opts)
+{
+  typedef std::chrono::steady_clock clock;
+
+  if (opts.port.empty())
+  {
+    throw std::runtime_error("--bus-devices requires --port.");
+  }
+
+  tic::settings settings = load_port_settings(opts);
+  tic::serial_bus bus = tic::serial_bus::open(opts.port,
+    tic_settings_get_serial_baud_rate(settings.get_pointer()),
+    serial_flags(opts));
+
+  std::vector<tic::handle> handles;
+  std::vector<tic::variables> vars;
+  for (uint16_t number : opts.bus_devices)
+  {
+    tic_settings_set_serial_device_number_u16(settings.get_pointer(), number);
+    handles.push_back(bus.open_device(settings));
+    vars.push_back(handles.back().get_variables());
+  }
+
+  clock::time_point start = clock::now();
+  for (uint32_t i = 0; i < opts.count; i++)
+  {
+    bus.begin_batch();
+    for (size_t d = 0; d < handles.size(); d++)
+    {
+      handles[d].set_target_position(vars[d].get_current_position());
+    }
+    bus.end_batch();
+
+    for (size_t d = 0; d < handles.size(); d++)
+    {
+      handles[d].update_variables(vars[d]);
+    }
+  }
+  double total = std::chrono::duration<double>(clock::now() - start).count();
+
+  std::cout << std::fixed << std::setprecision(1)
+    << "Cycles: " << opts.count << ", " << opts.count / total
+    << " cycles/s, " << opts.count * handles.size() / total
+    << " device updates/s" << std::endl;
+
+  std::cout << std::left << std::setw(8) << "Device" << std::right
+    << std::setw(10) << "Commands"
+    << std::setw(12) << "mean (ms)"
+    << std::setw(12) << "max (ms)"
+    << std::setw(10) << "Reads"
+    << std::setw(12) << "mean (ms)"
+    << std::setw(12) << "max (ms)"
+    << std::setw(8) << "Errors"
+    << std::endl;
+
+  for (uint16_t number : opts.bus_devices)
+  {
+    tic_serial_device_stats stats = bus.get_device_stats(number);
+    double command_mean = stats.command_count ?
+      stats.command_latency_total_us / 1000.0 / stats.command_count : 0;
+    double read_mean = stats.read_count ?
+      stats.read_latency_total_us / 1000.0 / stats.read_count : 0;
+    std::cout << std::left << std::setw(8) << number << std::right
+      << std::setprecision(3)
+      << std::setw(10) << stats.command_count
+      << std::setw(12) << command_mean
+      << std::setw(12) << stats.command_latency_max_us / 1000.0
+      << std::setw(10) << stats.read_count
+      << std::setw(12) << read_mean
+      << std::setw(12) << stats.read_latency_max_us / 1000.0
+      << std::setw(8) << stats.error_count
+      << std::endl;
+  }
+}
+
+int main(int argc, char ** argv)
+{
+  try
+  {
+    options opts = parse_args(argc, argv);
+    if (opts.bus_devices.empty())
+    {
+      run(opts);
+    }
+    else
+    {
+      run_bus(opts);
+    }
+  }
+  catch (const std::exception & error)
+  {
+    std::cerr << "Error: " << error.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
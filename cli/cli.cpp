@@ -1,5 +1,10 @@
 #include "cli.h"
 
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
 static const char help[] =
   CLI_NAME ": Pololu Tic Command-line Utility\n"
   "Version " SOFTWARE_VERSION_STRING "\n"
@@ -13,6 +18,16 @@ static const char help[] =
   "  --pause                      Pause program at the end.\n"
   "  --pause-on-error             Pause program at the end if an error happens.\n"
   "  -h, --help                   Show this help screen.\n"
+  "  --batch FILE                 Run commands from a file, one set per line.\n"
+  "                               Quote arguments that contain spaces.\n"
+  "  --daemon SOCKET              Serve commands to local clients on a socket.\n"
+  "\n"
+  "Streaming:\n"
+  "  --stream                     Read variables repeatedly and print them.\n"
+  "  --stream-rate HZ             Target samples per second (default: no limit).\n"
+  "  --stream-fields LIST         Comma-separated list of variables to print.\n"
+  "  --stream-count NUM           Stop after NUM samples (default: until Ctrl+C).\n"
+  "  --stream-binary              Write binary records instead of CSV.\n"
   "\n"
   "Control commands:\n"
   "  -p, --position NUM           Set target position in microsteps.\n"
@@ -29,6 +44,8 @@ static const char help[] =
   "  --enter-safe-start           Send the enter safe start command.\n"
   "  --reset                      Make the controller forget its current state.\n"
   "  --clear-driver-error         Attempt to clear a motor driver error.\n"
+  "  --wait                       Wait until target is reached or homing ends.\n"
+  "  --wait-timeout MS            Give up waiting after MS milliseconds.\n"
   "\n"
   "Temporary settings:\n"
   "  --max-speed NUM              Set the speed limit.\n"
@@ -55,7 +72,15 @@ static const char help[] =
   "  --restore-defaults           Restore device's factory settings\n"
   "  --settings FILE              Load settings file into device.\n"
   "  --get-settings FILE          Read device settings and write to file.\n"
+  "  --settings-bin FILE          Load binary settings image into device.\n"
+  "  --get-settings-bin FILE      Read device settings and write binary image.\n"
+  "  --diff-settings FILE         Show how device settings differ from file.\n"
   "  --fix-settings IN OUT        Read settings from a file and fix them.\n"
+  "  --fix-settings-bulk IN OUT   Fix each settings file listed by IN (a\n"
+  "                               directory, or a file with one path per line)\n"
+  "                               and write the results to directory OUT.\n"
+  "  --jobs NUM                   Threads for --fix-settings-bulk (default: one\n"
+  "                               per CPU).\n"
   "\n"
   "For more help, see: " DOCUMENTATION_URL "\n"
   "\n";
@@ -108,6 +133,9 @@ struct arguments
 
   bool clear_driver_error = false;
 
+  bool wait = false;
+  uint32_t wait_timeout_ms = 0;
+
   bool set_max_speed = false;
   uint32_t max_speed;
 
@@ -149,12 +177,35 @@ struct arguments
   bool get_settings = false;
   std::string get_settings_filename;
 
+  bool set_settings_bin = false;
+  std::string set_settings_bin_filename;
+
+  bool get_settings_bin = false;
+  std::string get_settings_bin_filename;
+
+  bool diff_settings = false;
+  std::string diff_settings_filename;
+
   bool fix_settings = false;
   std::string fix_settings_input_filename;
   std::string fix_settings_output_filename;
 
+  bool fix_settings_bulk = false;
+  std::string fix_settings_bulk_input;
+  std::string fix_settings_bulk_output_dir;
+  uint32_t jobs = 0;
+
   bool get_debug_data = false;
 
+  bool batch = false;
+  std::string batch_filename;
+
+  bool daemon = false;
+  std::string daemon_socket;
+
+  bool stream = false;
+  stream_parameters stream_options;
+
   uint32_t test_procedure = 0;
 
   bool action_specified() const
@@ -175,6 +226,7 @@ struct arguments
       enter_safe_start ||
       reset ||
       clear_driver_error ||
+      wait ||
       set_max_speed ||
       set_starting_speed ||
       set_max_accel ||
@@ -189,8 +241,15 @@ struct arguments
       restore_defaults ||
       set_settings ||
       get_settings ||
+      set_settings_bin ||
+      get_settings_bin ||
+      diff_settings ||
       fix_settings ||
+      fix_settings_bulk ||
       get_debug_data ||
+      batch ||
+      daemon ||
+      stream ||
       test_procedure;
   }
 };
@@ -548,6 +607,15 @@ static arguments parse_args(int argc, char ** argv)
     {
       args.clear_driver_error = true;
     }
+    else if (arg == "--wait")
+    {
+      args.wait = true;
+    }
+    else if (arg == "--wait-timeout")
+    {
+      args.wait = true;
+      args.wait_timeout_ms = parse_arg_int<uint32_t>(arg_reader);
+    }
     else if (arg == "--max-speed")
     {
       args.set_max_speed = true;
@@ -617,12 +685,68 @@ static arguments parse_args(int argc, char ** argv)
       args.get_settings = true;
       args.get_settings_filename = parse_arg_string(arg_reader);
     }
+    else if (arg == "--settings-bin")
+    {
+      args.set_settings_bin = true;
+      args.set_settings_bin_filename = parse_arg_string(arg_reader);
+    }
+    else if (arg == "--get-settings-bin")
+    {
+      args.get_settings_bin = true;
+      args.get_settings_bin_filename = parse_arg_string(arg_reader);
+    }
+    else if (arg == "--diff-settings")
+    {
+      args.diff_settings = true;
+      args.diff_settings_filename = parse_arg_string(arg_reader);
+    }
     else if (arg == "--fix-settings")
     {
       args.fix_settings = true;
       args.fix_settings_input_filename = parse_arg_string(arg_reader);
       args.fix_settings_output_filename = parse_arg_string(arg_reader);
     }
+    else if (arg == "--fix-settings-bulk")
+    {
+      args.fix_settings_bulk = true;
+      args.fix_settings_bulk_input = parse_arg_string(arg_reader);
+      args.fix_settings_bulk_output_dir = parse_arg_string(arg_reader);
+    }
+    else if (arg == "--jobs")
+    {
+      args.jobs = parse_arg_int<uint32_t>(arg_reader);
+    }
+    else if (arg == "--batch")
+    {
+      args.batch = true;
+      args.batch_filename = parse_arg_string(arg_reader);
+    }
+    else if (arg == "--daemon")
+    {
+      args.daemon = true;
+      args.daemon_socket = parse_arg_string(arg_reader);
+    }
+    else if (arg == "--stream")
+    {
+      args.stream = true;
+    }
+    else if (arg == "--stream-rate")
+    {
+      args.stream_options.rate = parse_arg_int<uint32_t>(arg_reader);
+    }
+    else if (arg == "--stream-fields")
+    {
+      args.stream_options.fields = parse_arg_string(arg_reader);
+      parse_stream_fields(args.stream_options.fields);
+    }
+    else if (arg == "--stream-count")
+    {
+      args.stream_options.count = parse_arg_int<uint64_t>(arg_reader);
+    }
+    else if (arg == "--stream-binary")
+    {
+      args.stream_options.binary = true;
+    }
     else if (arg == "--debug")
     {
       // This is an unadvertized option for helping customers troubleshoot
@@ -643,10 +767,9 @@ static arguments parse_args(int argc, char ** argv)
   return args;
 }
 
-static tic::handle handle(device_selector & selector)
+static tic::handle & handle(device_selector & selector)
 {
-  tic::device device = selector.select_device();
-  return tic::handle(device);
+  return selector.select_handle();
 }
 
 static void print_list(device_selector & selector)
@@ -662,7 +785,7 @@ static void print_list(device_selector & selector)
 
 static void set_current_limit_after_warning(device_selector & selector, uint32_t current_limit)
 {
-  tic::handle handle = ::handle(selector);
+  tic::handle & handle = ::handle(selector);
   uint8_t product = handle.get_device().get_product();
 
   uint32_t max_current = tic_get_max_allowed_current(product);
@@ -680,7 +803,7 @@ static void set_current_limit_after_warning(device_selector & selector, uint32_t
 static void get_status(device_selector & selector, bool full_output)
 {
   tic::device device = selector.select_device();
-  tic::handle handle(device);
+  tic::handle & handle = ::handle(selector);
   tic::settings settings = handle.get_settings();
   tic::variables vars = handle.get_variables(true);
   std::string name = device.get_name();
@@ -725,11 +848,148 @@ static void set_settings(device_selector & selector,
   settings.fix(&warnings);
   std::cerr << warnings;
 
-  tic::handle handle(device);
-  handle.set_settings(settings);
+  // Only write the bytes that changed to save time and EEPROM wear.
+  tic::handle & handle = ::handle(selector);
+  handle.set_settings_differential(settings);
+  handle.reinitialize();
+}
+
+static std::vector<uint8_t> read_binary_from_file_or_pipe(
+  const std::string & filename)
+{
+#ifdef _WIN32
+  if (filename == "-") { _setmode(_fileno(stdin), _O_BINARY); }
+#endif
+  std::shared_ptr<std::istream> stream;
+  if (filename == "-")
+  {
+    stream.reset(&std::cin, [](std::istream *){});
+  }
+  else
+  {
+    std::ifstream * file = new std::ifstream(filename, std::ios::binary);
+    stream.reset(file);
+    if (!*file)
+    {
+      int error_code = errno;
+      throw std::runtime_error(filename + ": " + strerror(error_code) + ".");
+    }
+  }
+  std::vector<uint8_t> data(
+    (std::istreambuf_iterator<char>(*stream)),
+    std::istreambuf_iterator<char>());
+  if (stream->bad())
+  {
+    throw std::runtime_error("Failed to read from file or pipe.");
+  }
+  return data;
+}
+
+static void write_binary_to_file_or_pipe(const std::string & filename,
+  const std::vector<uint8_t> & data)
+{
+#ifdef _WIN32
+  if (filename == "-") { _setmode(_fileno(stdout), _O_BINARY); }
+#endif
+  std::shared_ptr<std::ostream> stream;
+  if (filename == "-")
+  {
+    stream.reset(&std::cout, [](std::ostream *){});
+  }
+  else
+  {
+    std::ofstream * file = new std::ofstream(filename, std::ios::binary);
+    stream.reset(file);
+    if (!*file)
+    {
+      int error_code = errno;
+      throw std::runtime_error(filename + ": " + strerror(error_code) + ".");
+    }
+  }
+  stream->write((const char *)data.data(), data.size());
+  stream->flush();
+  if (stream->fail())
+  {
+    throw std::runtime_error("Failed to write to file or pipe.");
+  }
+}
+
+static void get_settings_bin(device_selector & selector,
+  const std::string & filename)
+{
+  tic::settings settings = handle(selector).get_settings();
+
+  std::string warnings;
+  settings.fix(&warnings);
+  std::cerr << warnings;
+
+  write_binary_to_file_or_pipe(filename, settings.to_image());
+}
+
+static void set_settings_bin(device_selector & selector,
+  const std::string & filename)
+{
+  std::vector<uint8_t> image = read_binary_from_file_or_pipe(filename);
+  tic::settings settings = tic::settings::read_from_image(image);
+
+  tic::device device = selector.select_device();
+
+  // Unlike a settings file, an image holds raw EEPROM bytes, which mean
+  // different things on different products.
+  if (settings.get_product() != device.get_product())
+  {
+    throw exception_with_exit_code(EXIT_OPERATION_FAILED,
+      std::string("The settings image is for a ") +
+      tic_look_up_product_name_ui(settings.get_product()) +
+      ", but the device is a " +
+      tic_look_up_product_name_ui(device.get_product()) + ".");
+  }
+
+  tic_settings_set_firmware_version(settings.get_pointer(),
+    device.get_firmware_version());
+
+  std::string warnings;
+  settings.fix(&warnings);
+  std::cerr << warnings;
+
+  tic::handle & handle = ::handle(selector);
+  handle.set_settings_differential(settings);
   handle.reinitialize();
 }
 
+// Prints the fields where the device's settings differ from the settings
+// file, in YAML.  Both sets of settings are fixed first, so fields that the
+// device would change when loading the file are not reported.
+static void diff_settings(device_selector & selector,
+  const std::string & filename)
+{
+  std::string settings_string = read_string_from_file_or_pipe(filename);
+  tic::settings file_settings = tic::settings::read_from_string(settings_string);
+
+  tic::device device = selector.select_device();
+
+  tic_settings_set_product(file_settings.get_pointer(),
+    device.get_product());
+  tic_settings_set_firmware_version(file_settings.get_pointer(),
+    device.get_firmware_version());
+
+  std::string warnings;
+  file_settings.fix(&warnings);
+  std::cerr << warnings;
+
+  tic::settings device_settings = handle(selector).get_settings();
+  device_settings.fix();
+
+  tic::settings_diff diff = tic::settings_diff::create(
+    device_settings, file_settings);
+  for (size_t i = 0; i < diff.get_count(); i++)
+  {
+    std::cout << diff.get_name(i) << ":" << std::endl
+              << "  device: " << diff.get_old_value(i) << std::endl
+              << "  file: " << diff.get_new_value(i) << std::endl;
+  }
+}
+
 static void fix_settings(const std::string & input_filename,
   const std::string & output_filename)
 {
@@ -746,8 +1006,7 @@ static void fix_settings(const std::string & input_filename,
 static void set_target_position_relative(device_selector & selector,
   int32_t target_position_relative)
 {
-  tic::device device = selector.select_device();
-  tic::handle handle(device);
+  tic::handle & handle = ::handle(selector);
   tic::variables variables = handle.get_variables();
   int32_t position = (uint32_t)variables.get_current_position() +
     (uint32_t)target_position_relative;
@@ -756,8 +1015,7 @@ static void set_target_position_relative(device_selector & selector,
 
 static void print_debug_data(device_selector & selector)
 {
-  tic::device device = selector.select_device();
-  tic::handle handle(device);
+  tic::handle & handle = ::handle(selector);
 
   std::vector<uint8_t> data(4096, 0);
   handle.get_debug_data(data);
@@ -770,7 +1028,7 @@ static void print_debug_data(device_selector & selector)
   std::cout << std::endl;
 }
 
-static void test_procedure(device_selector & selector, uint32_t procedure)
+static void test_procedure(uint32_t procedure)
 {
   if (procedure == 1)
   {
@@ -785,21 +1043,6 @@ static void test_procedure(device_selector & selector, uint32_t procedure)
     print_status(fake_vars, settings, "Fake name", "123", "9.99", true);
     fake_vars.pointer_release();
   }
-  else if (procedure == 2)
-  {
-    tic::device device = selector.select_device();
-    tic::handle handle(device);
-    while (1)
-    {
-      tic::variables vars = handle.get_variables();
-      std::cout << vars.get_analog_reading(TIC_PIN_NUM_SDA) << ','
-                << vars.get_target_position() << ','
-                << vars.get_acting_target_position() << ','
-                << vars.get_current_position() << ','
-                << vars.get_current_velocity() << ','
-                << std::endl;
-    }
-  }
   else if (procedure == 3)
   {
     // Test the current limit features.
@@ -865,9 +1108,333 @@ static void test_procedure(device_selector & selector, uint32_t procedure)
   }
 }
 
-// A note about ordering: We want to do all the setting stuff first because it
-// could affect subsequent options.  We want to show the status last, because it
-// could be affected by options before it.
+static void run_actions(const arguments &, device_selector &);
+
+static void print_batch_result(uint32_t line_number, bool success,
+  std::chrono::steady_clock::time_point begin)
+{
+  std::chrono::duration<double, std::milli> elapsed =
+    std::chrono::steady_clock::now() - begin;
+  std::ostringstream time;
+  time << std::fixed << std::setprecision(3) << elapsed.count();
+  std::cout << line_number << ": " << (success ? "ok" : "error")
+    << " (" << time.str() << " ms)" << std::endl;
+}
+
+// Splits a line from a batch file into words separated by whitespace.  Like
+// in a shell, part of a word can be put in single quotes, which keep
+// everything up to the next single quote, or double quotes, where a backslash
+// can also be used to escape a double quote or backslash.  Backslashes outside
+// of quotes are kept, so Windows paths work without quotes.
+static std::vector<std::string> split_batch_line(const std::string & line)
+{
+  std::vector<std::string> words;
+  std::string word;
+  bool in_word = false;
+  for (size_t i = 0; i < line.size(); i++)
+  {
+    char c = line[i];
+    if (c == ' ' || c == '\t' || c == '\r')
+    {
+      if (in_word) { words.push_back(word); }
+      word.clear();
+      in_word = false;
+      continue;
+    }
+
+    in_word = true;
+    if (c != '\'' && c != '"')
+    {
+      word += c;
+      continue;
+    }
+
+    char quote = c;
+    while (true)
+    {
+      if (++i >= line.size())
+      {
+        throw exception_with_exit_code(EXIT_BAD_ARGS,
+          "Line has an unterminated quote.");
+      }
+      c = line[i];
+      if (c == quote) { break; }
+      if (quote == '"' && c == '\\' && i + 1 < line.size() &&
+        (line[i + 1] == '"' || line[i + 1] == '\\'))
+      {
+        c = line[++i];
+      }
+      word += c;
+    }
+  }
+  if (in_word) { words.push_back(word); }
+  return words;
+}
+
+// Parses a line from a batch file or daemon client into arguments, using the
+// same options that are accepted on the command line.
+static arguments parse_batch_line(const std::string & line,
+  bool allow_serial_number = false)
+{
+  std::vector<std::string> words = split_batch_line(line);
+
+  std::vector<char *> argv;
+  argv.push_back((char *)CLI_NAME);
+  for (std::string & w : words)
+  {
+    argv.push_back(&w[0]);
+  }
+  argv.push_back(NULL);
+
+  arguments args = parse_args(argv.size() - 1, argv.data());
+
+  if ((args.serial_number_specified && !allow_serial_number) ||
+    args.show_list || args.pause || args.pause_on_error || args.show_help ||
+    args.batch || args.daemon || args.stream)
+  {
+    throw exception_with_exit_code(EXIT_BAD_ARGS,
+      "Line contains an option that is not allowed in batch mode.");
+  }
+
+  return args;
+}
+
+// Runs the commands in a batch file (or standard input if the filename is
+// "-") using the same device handle for every command.  Each line holds
+// options in the same format as the command line.  Blank lines and lines
+// starting with '#' are ignored.  Stops at the first command that fails.
+static void run_batch(device_selector & selector, const std::string & filename)
+{
+  std::ifstream file;
+  std::istream * input = &std::cin;
+  if (filename != "-")
+  {
+    file.open(filename);
+    if (!file)
+    {
+      throw exception_with_exit_code(EXIT_OPERATION_FAILED,
+        "Failed to open batch file '" + filename + "'.");
+    }
+    input = &file;
+  }
+
+  std::string line;
+  uint32_t line_number = 0;
+  while (std::getline(*input, line))
+  {
+    line_number++;
+
+    size_t start = line.find_first_not_of(" \t\r");
+    if (start == std::string::npos || line[start] == '#') { continue; }
+
+    auto begin = std::chrono::steady_clock::now();
+    bool success = false;
+    try
+    {
+      arguments line_args = parse_batch_line(line);
+      run_actions(line_args, selector);
+      success = true;
+    }
+    catch (...)
+    {
+      print_batch_result(line_number, success, begin);
+      throw;
+    }
+    print_batch_result(line_number, success, begin);
+  }
+}
+
+// How often the daemon reads the variables from each device.
+static const uint32_t daemon_poll_period_ms = 20;
+
+// Temporarily redirects a stream into a string stream.
+class stream_capture
+{
+public:
+  stream_capture(std::ostream & stream, std::ostringstream & destination)
+    : stream(stream), old_buffer(stream.rdbuf(destination.rdbuf()))
+  {
+  }
+
+  ~stream_capture()
+  {
+    stream.rdbuf(old_buffer);
+  }
+
+private:
+  std::ostream & stream;
+  std::streambuf * old_buffer;
+};
+
+// A device served by the daemon, along with the latest data read from it.
+struct daemon_device
+{
+  tic::device device;
+  device_selector selector;
+  std::string firmware_version;
+  tic::settings settings;
+  tic::variables variables;
+  bool connected = true;
+};
+
+static daemon_device & select_daemon_device(
+  std::vector<std::unique_ptr<daemon_device>> & devices,
+  const arguments & args)
+{
+  daemon_device * found = NULL;
+  for (auto & device : devices)
+  {
+    if (args.serial_number_specified &&
+      device->device.get_serial_number() != args.serial_number)
+    {
+      continue;
+    }
+
+    if (found != NULL)
+    {
+      throw exception_with_exit_code(EXIT_DEVICE_MULTIPLE_FOUND,
+        "There are multiple devices.  Use the -d option to pick one.");
+    }
+    found = device.get();
+  }
+
+  if (found == NULL)
+  {
+    throw exception_with_exit_code(EXIT_DEVICE_NOT_FOUND,
+      "No device was found.");
+  }
+
+  if (!found->connected)
+  {
+    throw exception_with_exit_code(EXIT_DEVICE_NOT_FOUND,
+      "The device is no longer connected.");
+  }
+
+  return *found;
+}
+
+static void poll_daemon_devices(
+  std::vector<std::unique_ptr<daemon_device>> & devices)
+{
+  for (auto & device : devices)
+  {
+    if (!device->connected) { continue; }
+
+    try
+    {
+      device->selector.select_handle().update_variables(device->variables);
+    }
+    catch (const tic::error & error)
+    {
+      if (error.has_code(TIC_ERROR_DEVICE_DISCONNECTED))
+      {
+        device->connected = false;
+      }
+    }
+  }
+}
+
+// Handles a request from a daemon client.  Status requests are answered from
+// the latest variables read by poll_daemon_devices() when possible.
+static std::string handle_daemon_request(
+  std::vector<std::unique_ptr<daemon_device>> & devices,
+  const std::string & request, int & exit_code)
+{
+  std::ostringstream output;
+  stream_capture capture_cout(std::cout, output);
+  stream_capture capture_cerr(std::cerr, output);
+
+  exit_code = 0;
+  try
+  {
+    arguments args = parse_batch_line(request, true);
+    daemon_device & device = select_daemon_device(devices, args);
+    tic::handle & handle = device.selector.select_handle();
+
+    arguments action_args = args;
+    action_args.show_status = false;
+    action_args.full_output = false;
+    if (action_args.action_specified())
+    {
+      run_actions(action_args, device.selector);
+
+      if (args.set_settings || args.restore_defaults)
+      {
+        device.settings = handle.get_settings();
+      }
+
+      // The actions might have changed the variables, so the snapshot is
+      // out of date.
+      if (args.show_status)
+      {
+        handle.update_variables(device.variables);
+      }
+    }
+
+    if (args.show_status)
+    {
+      if (!device.variables)
+      {
+        handle.update_variables(device.variables);
+      }
+      print_status(device.variables, device.settings,
+        device.device.get_name(), device.device.get_serial_number(),
+        device.firmware_version, args.full_output);
+    }
+  }
+  catch (const exception_with_exit_code & error)
+  {
+    std::cerr << "Error: " << error.what() << std::endl;
+    exit_code = error.get_code();
+  }
+  catch (const std::exception & error)
+  {
+    std::cerr << "Error: " << error.what() << std::endl;
+    exit_code = EXIT_OPERATION_FAILED;
+  }
+
+  return output.str();
+}
+
+// Opens handles to all the selected devices and serves requests from local
+// clients until the process is stopped.  Each request is a line of options in
+// the same format as a line in a batch file, and -d can be used to pick the
+// device.
+static void run_daemon_mode(device_selector & selector,
+  const std::string & socket_path)
+{
+  std::vector<std::unique_ptr<daemon_device>> devices;
+  for (const tic::device & instance : selector.list_devices())
+  {
+    std::unique_ptr<daemon_device> device(new daemon_device());
+    device->device = instance;
+    device->selector.specify_device(instance);
+    tic::handle & handle = device->selector.select_handle();
+    device->firmware_version = handle.get_firmware_version_string();
+    device->settings = handle.get_settings();
+    devices.push_back(std::move(device));
+  }
+
+  if (devices.empty())
+  {
+    throw exception_with_exit_code(EXIT_DEVICE_NOT_FOUND,
+      "No device was found.");
+  }
+
+  std::cout << "Serving " << devices.size() << " device(s) on "
+    << socket_path << "." << std::endl;
+
+  run_daemon(socket_path, daemon_poll_period_ms,
+    [&](const std::string & request, int & exit_code)
+    {
+      return handle_daemon_request(devices, request, exit_code);
+    },
+    [&]()
+    {
+      poll_daemon_devices(devices);
+    });
+}
+
 static void run(const arguments & args)
 {
   if (args.show_help || !args.action_specified())
@@ -888,17 +1455,47 @@ static void run(const arguments & args)
     return;
   }
 
+  if (args.daemon)
+  {
+    run_daemon_mode(selector, args.daemon_socket);
+    return;
+  }
+
+  run_actions(args, selector);
+}
+
+// A note about ordering: We want to do all the setting stuff first because it
+// could affect subsequent options.  We want to show the status last, because it
+// could be affected by options before it.
+static void run_actions(const arguments & args, device_selector & selector)
+{
   if (args.fix_settings)
   {
     fix_settings(args.fix_settings_input_filename,
       args.fix_settings_output_filename);
   }
 
+  if (args.fix_settings_bulk)
+  {
+    fix_settings_bulk(args.fix_settings_bulk_input,
+      args.fix_settings_bulk_output_dir, args.jobs);
+  }
+
   if (args.get_settings)
   {
     get_settings(selector, args.get_settings_filename);
   }
 
+  if (args.get_settings_bin)
+  {
+    get_settings_bin(selector, args.get_settings_bin_filename);
+  }
+
+  if (args.diff_settings)
+  {
+    diff_settings(selector, args.diff_settings_filename);
+  }
+
   if (args.restore_defaults)
   {
     restore_defaults(selector);
@@ -909,6 +1506,11 @@ static void run(const arguments & args)
     set_settings(selector, args.set_settings_filename);
   }
 
+  if (args.set_settings_bin)
+  {
+    set_settings_bin(selector, args.set_settings_bin_filename);
+  }
+
   if (args.reset)
   {
     handle(selector).reset();
@@ -1035,6 +1637,12 @@ static void run(const arguments & args)
     handle(selector).deenergize();
   }
 
+  // Should be after all the commands that could start the motor moving.
+  if (args.wait)
+  {
+    handle(selector).wait_until_reached(args.wait_timeout_ms);
+  }
+
   if (args.get_debug_data)
   {
     print_debug_data(selector);
@@ -1042,7 +1650,17 @@ static void run(const arguments & args)
 
   if (args.test_procedure)
   {
-    test_procedure(selector, args.test_procedure);
+    test_procedure(args.test_procedure);
+  }
+
+  if (args.batch)
+  {
+    run_batch(selector, args.batch_filename);
+  }
+
+  if (args.stream)
+  {
+    stream_variables(handle(selector), args.stream_options);
   }
 
   if (args.show_status)
@@ -14,11 +14,13 @@
 #include <bitset>
 #include <cassert>
 #include <chrono>
+#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
 #include <string>
 #include <thread>
+#include <vector>
 
 void print_status(const tic::variables & vars,
   const tic::settings & settings,
@@ -26,3 +28,34 @@ void print_status(const tic::variables & vars,
   const std::string & serial_number,
   const std::string & firmware_version,
   bool full_output);
+
+struct stream_parameters
+{
+  uint32_t rate = 0;  // Samples per second, or 0 to go as fast as possible.
+  std::string fields;
+  uint64_t count = 0;  // Number of samples, or 0 to stream until interrupted.
+  bool binary = false;
+};
+
+// Parses a comma-separated list of variable names for --stream-fields and
+// returns indices into the internal field table.
+std::vector<uint8_t> parse_stream_fields(const std::string & list);
+
+void stream_variables(tic::handle & handle, const stream_parameters & options);
+
+// Handles one request line received by the daemon and returns the text that
+// should be sent back to the client.  Sets exit_code to a non-zero value if
+// the request failed.
+typedef std::function<std::string(const std::string & request, int & exit_code)>
+  daemon_request_handler;
+
+void run_daemon(const std::string & socket_path, uint32_t poll_period_ms,
+  const daemon_request_handler & handler,
+  const std::function<void()> & poll_devices);
+
+// Fixes every settings file listed by input, which is either a directory or a
+// manifest file with one path per line, and writes the results to output_dir.
+// The files are processed by a pool of worker threads.  Prints a YAML report
+// of the warnings and errors for each file, followed by a summary.
+void fix_settings_bulk(const std::string & input,
+  const std::string & output_dir, uint32_t jobs);
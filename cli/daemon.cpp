@@ -0,0 +1,257 @@
+// A simple server that accepts newline-terminated requests from local clients
+// over a Unix domain socket.  The requests are handled one at a time in the
+// order they arrive, so access to the devices is serialized.
+
+#include "cli.h"
+
+#ifdef _WIN32
+
+void run_daemon(const std::string &, uint32_t,
+  const daemon_request_handler &, const std::function<void()> &)
+{
+  throw exception_with_exit_code(EXIT_BAD_ARGS,
+    "Daemon mode is not supported on Windows.");
+}
+
+#else
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Clients that send a line longer than this get disconnected.
+static const size_t max_request_length = 4096;
+
+static volatile sig_atomic_t stop_requested = 0;
+
+static void handle_stop_signal(int)
+{
+  stop_requested = 1;
+}
+
+static std::string errno_message(const std::string & what)
+{
+  return what + ": " + strerror(errno) + ".";
+}
+
+struct daemon_client
+{
+  int fd;
+  std::string input;
+  std::string output;
+  bool input_closed = false;
+  bool closing = false;
+};
+
+static int open_listening_socket(const std::string & path)
+{
+  sockaddr_un address;
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(address.sun_path))
+  {
+    throw exception_with_exit_code(EXIT_BAD_ARGS,
+      "The socket path is too long.");
+  }
+  strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0)
+  {
+    throw std::runtime_error(errno_message("Failed to create socket"));
+  }
+
+  // Remove a socket left behind by an earlier daemon, but never delete
+  // anything else that happens to be at the path.
+  struct stat path_stat;
+  if (lstat(path.c_str(), &path_stat) == 0)
+  {
+    if (!S_ISSOCK(path_stat.st_mode))
+    {
+      close(fd);
+      throw exception_with_exit_code(EXIT_BAD_ARGS,
+        "Refusing to replace " + path + " because it is not a socket.");
+    }
+    unlink(path.c_str());
+  }
+
+  if (bind(fd, (sockaddr *)&address, sizeof(address)) < 0 ||
+    listen(fd, 16) < 0)
+  {
+    std::string message = errno_message("Failed to listen on " + path);
+    close(fd);
+    throw std::runtime_error(message);
+  }
+
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+  return fd;
+}
+
+// Handles all the complete lines that have been received from the client.
+static void process_input(daemon_client & client,
+  const daemon_request_handler & handler)
+{
+  size_t start = 0;
+  while (true)
+  {
+    size_t end = client.input.find('\n', start);
+    if (end == std::string::npos) { break; }
+    std::string line = client.input.substr(start, end - start);
+    if (!line.empty() && line.back() == '\r') { line.pop_back(); }
+    start = end + 1;
+
+    int exit_code = 0;
+    std::string result = handler(line, exit_code);
+    if (exit_code == 0)
+    {
+      client.output += "ok " + std::to_string(result.size()) + "\n";
+    }
+    else
+    {
+      client.output += "error " + std::to_string(exit_code) + " " +
+        std::to_string(result.size()) + "\n";
+    }
+    client.output += result;
+  }
+  client.input.erase(0, start);
+
+  if (client.input.size() > max_request_length)
+  {
+    client.closing = true;
+  }
+}
+
+static void flush_output(daemon_client & client)
+{
+  while (!client.output.empty())
+  {
+    ssize_t count = send(client.fd, client.output.data(),
+      client.output.size(), 0);
+    if (count < 0)
+    {
+      if (errno != EAGAIN && errno != EWOULDBLOCK) { client.closing = true; }
+      return;
+    }
+    client.output.erase(0, count);
+  }
+}
+
+void run_daemon(const std::string & socket_path, uint32_t poll_period_ms,
+  const daemon_request_handler & handler,
+  const std::function<void()> & poll_devices)
+{
+  int listen_fd = open_listening_socket(socket_path);
+
+  signal(SIGINT, handle_stop_signal);
+  signal(SIGTERM, handle_stop_signal);
+  signal(SIGPIPE, SIG_IGN);
+
+  std::vector<daemon_client> clients;
+
+  auto next_poll = std::chrono::steady_clock::now();
+
+  while (!stop_requested)
+  {
+    auto now = std::chrono::steady_clock::now();
+    if (now >= next_poll)
+    {
+      poll_devices();
+      next_poll += std::chrono::milliseconds(poll_period_ms);
+      if (next_poll < now) { next_poll = now; }
+    }
+
+    std::vector<pollfd> fds;
+    fds.push_back({ listen_fd, POLLIN, 0 });
+    for (const daemon_client & client : clients)
+    {
+      short events = client.input_closed ? 0 : POLLIN;
+      if (!client.output.empty()) { events |= POLLOUT; }
+      fds.push_back({ client.fd, events, 0 });
+    }
+
+    int timeout = std::chrono::duration_cast<std::chrono::milliseconds>(
+      next_poll - std::chrono::steady_clock::now()).count();
+    if (timeout < 0) { timeout = 0; }
+
+    if (poll(fds.data(), fds.size(), timeout) < 0)
+    {
+      if (errno == EINTR) { continue; }
+      std::string message = errno_message("Failed to poll sockets");
+      close(listen_fd);
+      throw std::runtime_error(message);
+    }
+
+    for (size_t i = 0; i < clients.size(); i++)
+    {
+      daemon_client & client = clients[i];
+      short revents = fds[i + 1].revents;
+
+      if (!client.input_closed && (revents & (POLLIN | POLLHUP | POLLERR)))
+      {
+        char buffer[1024];
+        ssize_t count = recv(client.fd, buffer, sizeof(buffer), 0);
+        if (count > 0)
+        {
+          client.input.append(buffer, count);
+          process_input(client, handler);
+        }
+        else if (count == 0)
+        {
+          // The client is done sending, but might still be waiting for the
+          // responses to its last requests.
+          client.input_closed = true;
+        }
+        else if (errno != EAGAIN && errno != EWOULDBLOCK)
+        {
+          client.closing = true;
+        }
+      }
+
+      flush_output(client);
+      if (client.input_closed && client.output.empty())
+      {
+        client.closing = true;
+      }
+    }
+
+    for (size_t i = 0; i < clients.size(); )
+    {
+      if (clients[i].closing)
+      {
+        close(clients[i].fd);
+        clients.erase(clients.begin() + i);
+      }
+      else
+      {
+        i++;
+      }
+    }
+
+    if (fds[0].revents & POLLIN)
+    {
+      int fd = accept(listen_fd, NULL, NULL);
+      if (fd >= 0)
+      {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        daemon_client client;
+        client.fd = fd;
+        clients.push_back(client);
+      }
+    }
+  }
+
+  for (const daemon_client & client : clients)
+  {
+    close(client.fd);
+  }
+  close(listen_fd);
+  unlink(socket_path.c_str());
+}
+
+#endif
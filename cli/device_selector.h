@@ -15,6 +15,15 @@ public:
     this->serial_number_specified = true;
   }
 
+  // Selects the specified device without scanning for devices.
+  void specify_device(const tic::device & device)
+  {
+    assert(!list_initialized);
+    this->device = device;
+    list = { device };
+    list_initialized = true;
+  }
+
   std::vector<tic::device> list_devices()
   {
     if (list_initialized) { return list; }
@@ -52,6 +61,17 @@ public:
     return device;
   }
 
+  // Returns a handle to the selected device.  The handle is opened the first
+  // time this is called and reused after that, so we only open the device once
+  // per invocation of the program.
+  tic::handle & select_handle()
+  {
+    if (handle) { return handle; }
+
+    handle = tic::handle(select_device());
+    return handle;
+  }
+
 private:
 
   std::string device_not_found_message() const
@@ -89,4 +109,6 @@ private:
   std::vector<tic::device> list;
 
   tic::device device;
+
+  tic::handle handle;
 };
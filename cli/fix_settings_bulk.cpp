@@ -0,0 +1,279 @@
+// Fixes many settings files at once using a pool of worker threads, for
+// auditing a large collection of settings files without starting a process
+// for each one.
+
+#include "cli.h"
+
+#include <atomic>
+#include <cerrno>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#include <windows.h>
+#else
+#include <dirent.h>
+#endif
+
+namespace
+{
+  struct bulk_file
+  {
+    std::string input;
+    std::string output;
+
+    bool failed = false;
+    std::string error;
+    std::vector<std::string> warnings;
+  };
+}
+
+static bool is_directory(const std::string & path)
+{
+  struct stat st;
+  return stat(path.c_str(), &st) == 0 && (st.st_mode & S_IFMT) == S_IFDIR;
+}
+
+static std::string join_path(const std::string & dir, const std::string & name)
+{
+  if (dir.empty()) { return name; }
+  char last = dir[dir.size() - 1];
+  if (last == '/' || last == '\\') { return dir + name; }
+  return dir + "/" + name;
+}
+
+static std::string base_name(const std::string & path)
+{
+  size_t slash = path.find_last_of("/\\");
+  if (slash == std::string::npos) { return path; }
+  return path.substr(slash + 1);
+}
+
+// Returns the names of the regular files in the directory, sorted, skipping
+// hidden files.
+static std::vector<std::string> list_directory(const std::string & dir)
+{
+  std::vector<std::string> names;
+
+#ifdef _WIN32
+  WIN32_FIND_DATAA data;
+  HANDLE find = FindFirstFileA(join_path(dir, "*").c_str(), &data);
+  if (find == INVALID_HANDLE_VALUE)
+  {
+    throw exception_with_exit_code(EXIT_OPERATION_FAILED,
+      dir + ": Failed to list the directory.");
+  }
+  do
+  {
+    if (!(data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) &&
+      data.cFileName[0] != '.')
+    {
+      names.push_back(data.cFileName);
+    }
+  } while (FindNextFileA(find, &data));
+  FindClose(find);
+#else
+  DIR * d = opendir(dir.c_str());
+  if (d == NULL)
+  {
+    int error_code = errno;
+    throw exception_with_exit_code(EXIT_OPERATION_FAILED,
+      dir + ": " + strerror(error_code) + ".");
+  }
+  while (struct dirent * entry = readdir(d))
+  {
+    std::string name = entry->d_name;
+    if (name[0] == '.') { continue; }
+    if (is_directory(join_path(dir, name))) { continue; }
+    names.push_back(name);
+  }
+  closedir(d);
+#endif
+
+  std::sort(names.begin(), names.end());
+  return names;
+}
+
+// Reads a manifest file with one path per line.  Blank lines and lines
+// starting with '#' are ignored.
+static std::vector<std::string> read_manifest(const std::string & filename)
+{
+  std::vector<std::string> paths;
+  std::istringstream stream(read_string_from_file_or_pipe(filename));
+  std::string line;
+  while (std::getline(stream, line))
+  {
+    if (!line.empty() && line[line.size() - 1] == '\r')
+    {
+      line.erase(line.size() - 1);
+    }
+    if (line.empty() || line[0] == '#') { continue; }
+    paths.push_back(line);
+  }
+  return paths;
+}
+
+static void make_directory(const std::string & dir)
+{
+  if (is_directory(dir)) { return; }
+#ifdef _WIN32
+  int result = _mkdir(dir.c_str());
+#else
+  int result = mkdir(dir.c_str(), 0777);
+#endif
+  if (result != 0)
+  {
+    int error_code = errno;
+    throw exception_with_exit_code(EXIT_OPERATION_FAILED,
+      dir + ": " + strerror(error_code) + ".");
+  }
+}
+
+static void fix_one_file(bulk_file & file)
+{
+  try
+  {
+    std::string in_str = read_string_from_file(file.input);
+    tic::settings settings = tic::settings::read_from_string(in_str);
+
+    std::string warnings;
+    settings.fix(&warnings);
+    std::istringstream stream(warnings);
+    std::string line;
+    while (std::getline(stream, line))
+    {
+      if (!line.empty()) { file.warnings.push_back(line); }
+    }
+
+    write_string_to_file(file.output, settings.to_string());
+  }
+  catch (const std::exception & e)
+  {
+    file.failed = true;
+    file.error = e.what();
+  }
+}
+
+// Returns the string as a double-quoted YAML scalar.
+static std::string yaml_quote(const std::string & str)
+{
+  std::string result = "\"";
+  for (char c : str)
+  {
+    if (c == '"' || c == '\\') { result += '\\'; }
+    if ((unsigned char)c < 0x20)
+    {
+      char escape[8];
+      snprintf(escape, sizeof(escape), "\\x%02x", (unsigned char)c);
+      result += escape;
+      continue;
+    }
+    result += c;
+  }
+  return result + "\"";
+}
+
+void fix_settings_bulk(const std::string & input,
+  const std::string & output_dir, uint32_t jobs)
+{
+  std::vector<bulk_file> files;
+  if (is_directory(input))
+  {
+    for (const std::string & name : list_directory(input))
+    {
+      bulk_file file;
+      file.input = join_path(input, name);
+      files.push_back(file);
+    }
+  }
+  else
+  {
+    for (const std::string & path : read_manifest(input))
+    {
+      bulk_file file;
+      file.input = path;
+      files.push_back(file);
+    }
+  }
+
+  make_directory(output_dir);
+
+  // Each output file is named after its input file, so two inputs with the
+  // same name would overwrite each other.
+  std::vector<std::string> output_names;
+  for (bulk_file & file : files)
+  {
+    std::string name = base_name(file.input);
+    file.output = join_path(output_dir, name);
+    if (std::find(output_names.begin(), output_names.end(), name) !=
+      output_names.end())
+    {
+      file.failed = true;
+      file.error = "Another input file has the same name.";
+    }
+    output_names.push_back(name);
+  }
+
+  if (jobs == 0)
+  {
+    jobs = std::max<uint32_t>(1, std::thread::hardware_concurrency());
+  }
+  jobs = std::min<size_t>(jobs, std::max<size_t>(1, files.size()));
+
+  // The workers take files in order from a shared counter.  Each file is only
+  // touched by one worker, and we do not read the results until the workers
+  // have been joined.
+  std::atomic<size_t> next_index(0);
+  auto worker = [&]()
+  {
+    while (true)
+    {
+      size_t index = next_index++;
+      if (index >= files.size()) { break; }
+      if (!files[index].failed) { fix_one_file(files[index]); }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (uint32_t i = 1; i < jobs; i++) { threads.emplace_back(worker); }
+  worker();
+  for (std::thread & thread : threads) { thread.join(); }
+
+  size_t failed_count = 0;
+  size_t warned_count = 0;
+  std::ostream & out = std::cout;
+  out << "files:" << (files.empty() ? " []" : "") << std::endl;
+  for (const bulk_file & file : files)
+  {
+    out << "- input: " << yaml_quote(file.input) << std::endl;
+    if (file.failed)
+    {
+      failed_count++;
+      out << "  error: " << yaml_quote(file.error) << std::endl;
+      continue;
+    }
+    out << "  output: " << yaml_quote(file.output) << std::endl;
+    if (!file.warnings.empty())
+    {
+      warned_count++;
+      out << "  warnings:" << std::endl;
+      for (const std::string & warning : file.warnings)
+      {
+        out << "  - " << yaml_quote(warning) << std::endl;
+      }
+    }
+  }
+  out << "summary:" << std::endl
+      << "  files: " << files.size() << std::endl
+      << "  fixed_without_warnings: "
+      << files.size() - failed_count - warned_count << std::endl
+      << "  fixed_with_warnings: " << warned_count << std::endl
+      << "  failed: " << failed_count << std::endl;
+
+  if (failed_count)
+  {
+    throw exception_with_exit_code(EXIT_OPERATION_FAILED,
+      std::to_string(failed_count) + " of " + std::to_string(files.size()) +
+      " settings files could not be fixed.");
+  }
+}
@@ -0,0 +1,235 @@
+// Code for streaming variables from the device at a fixed rate (--stream).
+
+#include "cli.h"
+
+#include <cmath>
+#include <csignal>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+struct stream_field
+{
+  const char * name;
+  uint8_t offset;
+  uint8_t size;
+  int64_t (*get)(const tic::variables &);
+};
+
+static const stream_field stream_fields[] = {
+  { "operation_state", TIC_VAR_OPERATION_STATE, 1,
+    [](const tic::variables & v) -> int64_t { return v.get_operation_state(); } },
+  { "energized", TIC_VAR_MISC_FLAGS1, 1,
+    [](const tic::variables & v) -> int64_t { return v.get_energized(); } },
+  { "error_status", TIC_VAR_ERROR_STATUS, 2,
+    [](const tic::variables & v) -> int64_t { return v.get_error_status(); } },
+  { "errors_occurred", TIC_VAR_ERRORS_OCCURRED, 4,
+    [](const tic::variables & v) -> int64_t { return v.get_errors_occurred(); } },
+  { "planning_mode", TIC_VAR_PLANNING_MODE, 1,
+    [](const tic::variables & v) -> int64_t { return v.get_planning_mode(); } },
+  { "target_position", TIC_VAR_TARGET_POSITION, 4,
+    [](const tic::variables & v) -> int64_t { return v.get_target_position(); } },
+  { "target_velocity", TIC_VAR_TARGET_VELOCITY, 4,
+    [](const tic::variables & v) -> int64_t { return v.get_target_velocity(); } },
+  { "starting_speed", TIC_VAR_STARTING_SPEED, 4,
+    [](const tic::variables & v) -> int64_t { return v.get_starting_speed(); } },
+  { "max_speed", TIC_VAR_MAX_SPEED, 4,
+    [](const tic::variables & v) -> int64_t { return v.get_max_speed(); } },
+  { "max_decel", TIC_VAR_MAX_DECEL, 4,
+    [](const tic::variables & v) -> int64_t { return v.get_max_decel(); } },
+  { "max_accel", TIC_VAR_MAX_ACCEL, 4,
+    [](const tic::variables & v) -> int64_t { return v.get_max_accel(); } },
+  { "current_position", TIC_VAR_CURRENT_POSITION, 4,
+    [](const tic::variables & v) -> int64_t { return v.get_current_position(); } },
+  { "current_velocity", TIC_VAR_CURRENT_VELOCITY, 4,
+    [](const tic::variables & v) -> int64_t { return v.get_current_velocity(); } },
+  { "acting_target_position", TIC_VAR_ACTING_TARGET_POSITION, 4,
+    [](const tic::variables & v) -> int64_t { return v.get_acting_target_position(); } },
+  { "time_since_last_step", TIC_VAR_TIME_SINCE_LAST_STEP, 4,
+    [](const tic::variables & v) -> int64_t { return v.get_time_since_last_step(); } },
+  { "vin_voltage", TIC_VAR_VIN_VOLTAGE, 2,
+    [](const tic::variables & v) -> int64_t { return v.get_vin_voltage(); } },
+  { "up_time", TIC_VAR_UP_TIME, 4,
+    [](const tic::variables & v) -> int64_t { return v.get_up_time(); } },
+  { "encoder_position", TIC_VAR_ENCODER_POSITION, 4,
+    [](const tic::variables & v) -> int64_t { return v.get_encoder_position(); } },
+  { "rc_pulse_width", TIC_VAR_RC_PULSE_WIDTH, 2,
+    [](const tic::variables & v) -> int64_t { return v.get_rc_pulse_width(); } },
+  { "analog_scl", TIC_VAR_ANALOG_READING_SCL, 2,
+    [](const tic::variables & v) -> int64_t { return v.get_analog_reading(TIC_PIN_NUM_SCL); } },
+  { "analog_sda", TIC_VAR_ANALOG_READING_SDA, 2,
+    [](const tic::variables & v) -> int64_t { return v.get_analog_reading(TIC_PIN_NUM_SDA); } },
+  { "analog_tx", TIC_VAR_ANALOG_READING_TX, 2,
+    [](const tic::variables & v) -> int64_t { return v.get_analog_reading(TIC_PIN_NUM_TX); } },
+  { "analog_rx", TIC_VAR_ANALOG_READING_RX, 2,
+    [](const tic::variables & v) -> int64_t { return v.get_analog_reading(TIC_PIN_NUM_RX); } },
+  { "step_mode", TIC_VAR_STEP_MODE, 1,
+    [](const tic::variables & v) -> int64_t { return v.get_step_mode(); } },
+  { "current_limit_code", TIC_VAR_CURRENT_LIMIT, 1,
+    [](const tic::variables & v) -> int64_t { return v.get_current_limit_code(); } },
+  { "input_state", TIC_VAR_INPUT_STATE, 1,
+    [](const tic::variables & v) -> int64_t { return v.get_input_state(); } },
+  { "input_after_averaging", TIC_VAR_INPUT_AFTER_AVERAGING, 2,
+    [](const tic::variables & v) -> int64_t { return v.get_input_after_averaging(); } },
+  { "input_after_hysteresis", TIC_VAR_INPUT_AFTER_HYSTERESIS, 2,
+    [](const tic::variables & v) -> int64_t { return v.get_input_after_hysteresis(); } },
+  { "input_after_scaling", TIC_VAR_INPUT_AFTER_SCALING, 4,
+    [](const tic::variables & v) -> int64_t { return v.get_input_after_scaling(); } },
+};
+
+static const size_t stream_field_count =
+  sizeof(stream_fields) / sizeof(stream_fields[0]);
+
+// The fields we stream if the user does not specify any.
+static const char default_stream_fields[] =
+  "analog_sda,target_position,acting_target_position,"
+  "current_position,current_velocity";
+
+std::vector<uint8_t> parse_stream_fields(const std::string & list)
+{
+  std::string str = list.empty() ? default_stream_fields : list;
+
+  std::vector<uint8_t> fields;
+  std::istringstream stream(str);
+  std::string name;
+  while (std::getline(stream, name, ','))
+  {
+    size_t i = 0;
+    while (i < stream_field_count && name != stream_fields[i].name) { i++; }
+    if (i == stream_field_count)
+    {
+      throw exception_with_exit_code(EXIT_BAD_ARGS,
+        "Unknown field for --stream-fields: '" + name + "'.");
+    }
+    fields.push_back(i);
+  }
+
+  if (fields.empty())
+  {
+    throw exception_with_exit_code(EXIT_BAD_ARGS,
+      "Expected at least one field name after '--stream-fields'.");
+  }
+
+  return fields;
+}
+
+static volatile sig_atomic_t stream_stop_requested = 0;
+
+static void handle_stream_stop_signal(int)
+{
+  stream_stop_requested = 1;
+}
+
+static void write_le(std::ostream & out, uint64_t value, size_t size)
+{
+  char bytes[8];
+  for (size_t i = 0; i < size; i++)
+  {
+    bytes[i] = value >> (8 * i) & 0xFF;
+  }
+  out.write(bytes, size);
+}
+
+void stream_variables(tic::handle & handle, const stream_parameters & options)
+{
+  typedef std::chrono::steady_clock clock;
+
+  std::vector<uint8_t> fields = parse_stream_fields(options.fields);
+
+  // Only read the range of variables that contains the fields we want.
+  size_t begin = TIC_VARIABLES_SIZE, end = 0;
+  for (uint8_t f : fields)
+  {
+    begin = std::min<size_t>(begin, stream_fields[f].offset);
+    end = std::max<size_t>(end, stream_fields[f].offset + stream_fields[f].size);
+  }
+
+#ifdef _WIN32
+  if (options.binary) { _setmode(_fileno(stdout), _O_BINARY); }
+#endif
+
+  std::ostream & out = std::cout;
+  if (!options.binary)
+  {
+    out << "time";
+    for (uint8_t f : fields) { out << ',' << stream_fields[f].name; }
+    out << '\n';
+  }
+
+  stream_stop_requested = 0;
+  auto old_handler = std::signal(SIGINT, handle_stream_stop_signal);
+
+  clock::duration period(0);
+  if (options.rate)
+  {
+    period = std::chrono::duration_cast<clock::duration>(
+      std::chrono::duration<double>(1.0 / options.rate));
+  }
+
+  tic::variables vars = tic::variables::create();
+  uint64_t sample_count = 0;
+  double interval_sum = 0, interval_square_sum = 0, interval_max = 0;
+  clock::time_point start = clock::now();
+  clock::time_point deadline = start;
+  clock::time_point last_sample;
+
+  while (!stream_stop_requested &&
+    (options.count == 0 || sample_count < options.count))
+  {
+    if (options.rate)
+    {
+      std::this_thread::sleep_until(deadline);
+      deadline += period;
+    }
+
+    handle.update_variables_segment(vars, begin, end - begin);
+    clock::time_point now = clock::now();
+
+    if (sample_count)
+    {
+      double interval = std::chrono::duration<double>(now - last_sample).count();
+      interval_sum += interval;
+      interval_square_sum += interval * interval;
+      interval_max = std::max(interval_max, interval);
+    }
+    last_sample = now;
+    sample_count++;
+
+    auto time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      now - start).count();
+    if (options.binary)
+    {
+      write_le(out, time_ns, 8);
+      for (uint8_t f : fields)
+      {
+        write_le(out, (uint32_t)stream_fields[f].get(vars), 4);
+      }
+    }
+    else
+    {
+      out << time_ns / 1000000000 << '.' << std::setfill('0') << std::setw(6)
+        << time_ns / 1000 % 1000000;
+      for (uint8_t f : fields) { out << ',' << stream_fields[f].get(vars); }
+      out << '\n';
+    }
+  }
+
+  out.flush();
+  std::signal(SIGINT, old_handler);
+
+  std::cerr << "Samples: " << sample_count << std::endl;
+  if (sample_count > 1)
+  {
+    uint64_t n = sample_count - 1;
+    double mean = interval_sum / n;
+    double variance = interval_square_sum / n - mean * mean;
+    double jitter = std::sqrt(std::max(variance, 0.0));
+    std::cerr << std::fixed << std::setprecision(3)
+      << "Achieved rate: " << 1 / mean << " Hz" << std::endl
+      << "Mean interval: " << mean * 1000 << " ms" << std::endl
+      << "Interval jitter (std dev): " << jitter * 1000 << " ms" << std::endl
+      << "Max interval: " << interval_max * 1000 << " ms" << std::endl;
+  }
+}
@@ -8,9 +8,15 @@
 // This is how often we fetch the variables from the device.
 static const uint32_t UPDATE_INTERVAL_MS = 50;
 
-// Only update the device list once per second to save CPU time.
+// If hotplug notifications are not available, scan for devices once per
+// second to save CPU time.
 static const uint32_t UPDATE_DEVICE_LIST_DIVIDER = 20;
 
+// With hotplug notifications, the device monitor already scans when it knows
+// it missed an event, so this infrequent scan (every 30 seconds) is only a
+// safety net in case an event got lost without the kernel telling us.
+static const uint32_t HOTPLUG_SCAN_DIVIDER = 600;
+
 static bool settings_have_limit_switch(const tic::settings & settings)
 {
   for (uint8_t i = 0; i < TIC_CONTROL_PIN_COUNT; i++)
@@ -291,12 +297,21 @@ void main_controller::update()
   // here.  If the user tries to use the UI at all while this function is
   // running, the UI cannot respond until this function returns.
 
+  // With hotplug notifications, checking the device list is cheap, so we do
+  // it on every update to notice changes right away.  Without them, checking
+  // the list means a full scan, so we only do it every few updates.
   bool successfully_updated_list = false;
-  if (--update_device_list_counter == 0)
+  bool hotplug = device_monitor && device_monitor.has_hotplug_support();
+  bool scan_due = --update_device_list_counter == 0;
+  if (scan_due)
   {
-    update_device_list_counter = UPDATE_DEVICE_LIST_DIVIDER;
+    update_device_list_counter = hotplug ?
+      HOTPLUG_SCAN_DIVIDER : UPDATE_DEVICE_LIST_DIVIDER;
+  }
 
-    successfully_updated_list = update_device_list();
+  if (hotplug || scan_due)
+  {
+    successfully_updated_list = update_device_list(scan_due);
     if (successfully_updated_list && device_list_changed)
     {
       window->set_device_list_contents(device_list);
@@ -394,41 +409,23 @@ bool main_controller::exit()
   }
 }
 
-static bool device_lists_different(
-  const std::vector<tic::device> & list1,
-  const std::vector<tic::device> & list2)
+bool main_controller::update_device_list(bool full_scan)
 {
-  if (list1.size() != list2.size())
-  {
-    return true;
-  }
-  else
+  try
   {
-    for (int i = 0; i < list1.size(); i++)
+    if (!device_monitor)
     {
-      if (list1.at(i).get_os_id() != list2.at(i).get_os_id())
-      {
-        return true;
-      }
+      device_monitor = tic::device_monitor::create();
     }
-    return false;
-  }
-}
-
-bool main_controller::update_device_list()
-{
-  try
-  {
-    std::vector<tic::device> new_device_list = tic::list_connected_devices();
-    if (device_lists_different(device_list, new_device_list))
+    if (full_scan)
     {
-      device_list_changed = true;
+      device_monitor.request_scan();
     }
-    else
+    device_list_changed = device_monitor.update();
+    if (device_list_changed)
     {
-      device_list_changed = false;
+      device_list = device_monitor.get_devices();
     }
-    device_list = new_device_list;
     return true;
   }
   catch (const std::exception & e)
@@ -1553,7 +1550,7 @@ void main_controller::reload_variables()
 
   try
   {
-    variables = device_handle.get_variables(true);
+    device_handle.update_variables(variables, true);
     variables_update_failed = false;
   }
   catch (...)
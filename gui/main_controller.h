@@ -57,8 +57,9 @@ private:
   void really_disconnect();
   void set_connection_error(const std::string & error_message);
 
-  // Returns true for success, false for failure.
-  bool update_device_list();
+  // Returns true for success, false for failure.  If full_scan is true, the
+  // device monitor scans all the USB devices even if it has hotplug support.
+  bool update_device_list(bool full_scan);
 
   // True if device_list changed the last time update_device_list() was
   // called.
@@ -164,6 +165,10 @@ private:
   // Holds a list of the relevant devices that are connected to the computer.
   std::vector<tic::device> device_list;
 
+  // Keeps track of which devices are connected.  This is created the first
+  // time we update the device list.
+  tic::device_monitor device_monitor;
+
   // Holds an open handle to a device or a null handle if we are not connected.
   tic::handle device_handle;
 
@@ -195,8 +200,8 @@ private:
   // to a USB error).
   bool variables_update_failed = false;
 
-  // The number of updates to wait for before updating the
-  // device list again (saves CPU time).
+  // The number of updates to wait for before the next full scan of the
+  // device list (saves CPU time).
   uint32_t update_device_list_counter = 1;
 
   // True if we want to regularly send the "Reset command timeout" command to
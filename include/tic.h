@@ -95,6 +95,7 @@ extern "C" {
 /// Certain functions in the library return a newly-created string and require
 /// the caller to call this function to free the string.  Passing a NULL pointer
 /// to this function is OK.  Do not free the same non-NULL string twice.
+TIC_API
 void tic_string_free(char *);
 
 
@@ -329,6 +330,12 @@ bool tic_error_has_code(const tic_error *, uint32_t code);
 /// string consists of one or more complete sentences.
 ///
 /// The returned pointer will be valid at least until the error is freed.
+///
+/// Errors from USB transfers do not build their message until this function
+/// is called, so code that only checks whether an error happened (and maybe
+/// calls tic_error_has_code()) does not pay for formatting it.  For the same
+/// reason, a single error object should not be used by multiple threads at
+/// once.
 TIC_API TIC_WARN_UNUSED
 const char * tic_error_get_message(const tic_error *);
 
@@ -384,9 +391,81 @@ void tic_settings_fill_with_defaults(tic_settings * settings);
 /// fixed.  Each distinct warning in the string will be a series of complete
 /// English sentences that ends with a newline character.  The string must be
 /// freed by the caller using tic_string_free().
+///
+/// To get the warnings as a list with codes, use
+/// tic_settings_fix_with_warnings().
 TIC_API TIC_WARN_UNUSED
 tic_error * tic_settings_fix(tic_settings *, char ** warnings);
 
+/// The kinds of problems that tic_settings_fix_with_warnings() can fix.  Each
+/// warning has one of these codes.
+enum tic_settings_warning_code
+{
+  /// The setting had a value that is not valid, so it was changed.
+  TIC_SETTINGS_WARNING_INVALID = 1,
+
+  /// The setting was too high, so it was lowered.
+  TIC_SETTINGS_WARNING_TOO_HIGH = 2,
+
+  /// The setting was too low, so it was raised.
+  TIC_SETTINGS_WARNING_TOO_LOW = 3,
+
+  /// The setting is not supported by the firmware version of the settings, so
+  /// it was disabled.
+  TIC_SETTINGS_WARNING_NOT_SUPPORTED = 4,
+
+  /// The setting conflicted with another setting, so it was changed.
+  TIC_SETTINGS_WARNING_CONFLICT = 5,
+};
+
+/// Represents a list of the warnings from fixing a settings object.
+typedef struct tic_settings_warnings tic_settings_warnings;
+
+/// Fixes the settings to be valid and consistent, like tic_settings_fix(),
+/// but returns the warnings as a list instead of a string.
+///
+/// The settings object remembers its values from the last time it was fixed,
+/// and this function only checks the settings that have changed since then,
+/// so fixing settings that are already valid is fast.  The copy made by
+/// tic_settings_copy() remembers the same values.
+///
+/// The warnings parameter is optional.  If you supply it and this function
+/// is successful, it will be set to a new list that must be freed with
+/// tic_settings_warnings_free().  The list is empty if nothing was fixed.
+TIC_API TIC_WARN_UNUSED
+tic_error * tic_settings_fix_with_warnings(tic_settings *,
+  tic_settings_warnings ** warnings);
+
+/// Frees a list of warnings.  It is OK to pass NULL to this function.
+TIC_API
+void tic_settings_warnings_free(tic_settings_warnings *);
+
+/// Gets the number of warnings in the list.
+TIC_API
+size_t tic_settings_warnings_get_count(const tic_settings_warnings *);
+
+/// Gets the code of the warning with the specified index, which is one of the
+/// values of ::tic_settings_warning_code.  Returns 0 if the index is out of
+/// range.
+TIC_API
+uint8_t tic_settings_warnings_get_code(const tic_settings_warnings *,
+  size_t index);
+
+/// Gets the name of the setting that the warning with the specified index is
+/// about, as it appears in a settings file (e.g. "max_speed").  Returns NULL
+/// if the index is out of range.
+TIC_API
+const char * tic_settings_warnings_get_field(const tic_settings_warnings *,
+  size_t index);
+
+/// Gets the message of the warning with the specified index, which is a series
+/// of complete English sentences.  These are the same messages that
+/// tic_settings_fix() returns, without the "Warning: " prefix and the newline.
+/// Returns NULL if the index is out of range.
+TIC_API
+const char * tic_settings_warnings_get_message(const tic_settings_warnings *,
+  size_t index);
+
 /// Gets the settings as a YAML string, also known as a settings file.  If this
 /// function is successful, the string must be freed by the caller using
 /// tic_string_free().
@@ -406,6 +485,41 @@ TIC_API TIC_WARN_UNUSED
 tic_error * tic_settings_read_from_string(const char * string,
   tic_settings ** settings);
 
+/// The size of a binary settings image, in bytes.  See
+/// tic_settings_to_image().
+#define TIC_SETTINGS_IMAGE_SIZE (16 + TIC_SETTINGS_SIZE)
+
+/// Writes the settings as a binary settings image.
+///
+/// The image holds the raw bytes that the Tic stores in its EEPROM, along with
+/// a header that identifies the product and firmware version and a CRC-32
+/// checksum.  Images are much faster to read and write than settings files, but
+/// they are not meant to be edited by people.
+///
+/// Like tic_settings_to_string(), this function does not fix the settings, so
+/// you should call tic_settings_fix() first.
+///
+/// The image parameter should point to a buffer of size bytes, where size is at
+/// least ::TIC_SETTINGS_IMAGE_SIZE.
+TIC_API TIC_WARN_UNUSED
+tic_error * tic_settings_to_image(const tic_settings *,
+  uint8_t * image, size_t size);
+
+/// Reads a binary settings image made by tic_settings_to_image() and returns
+/// the corresponding settings object.  The product and firmware version of the
+/// settings come from the image.  This function returns an error if the image
+/// has the wrong size or format version, or if its checksum is incorrect.  The
+/// settings returned might be invalid, so it is recommended to call
+/// tic_settings_fix() to fix the settings and warn the user.
+///
+/// The settings parameter should be a non-null pointer to a tic_settings
+/// pointer, which will receive a pointer to a new settings object if and only
+/// if this function is successful.  The caller must free the settings later by
+/// calling tic_settings_free().
+TIC_API TIC_WARN_UNUSED
+tic_error * tic_settings_read_from_image(const uint8_t * image, size_t size,
+  tic_settings ** settings);
+
 /// Sets the product, which specifies what Tic product these settings are for.
 /// The value should be one of the TIC_PRODUCT_* macros.
 TIC_API
@@ -1145,6 +1259,19 @@ bool tic_settings_get_invert_motor_direction(const tic_settings *);
 /// Variables command.
 typedef struct tic_variables tic_variables;
 
+/// Creates a new variables object with all of its fields set to zero.
+///
+/// You would typically only need this if you want to read the variables with
+/// tic_update_variables(), which lets you reuse the same object instead of
+/// allocating a new one every time you read the variables.
+///
+/// The variables parameter should be a non-null pointer to a tic_variables
+/// pointer, which will receive a pointer to a new variables object if and only
+/// if this function is successful.  The caller must free the variables later by
+/// calling tic_variables_free().
+TIC_API TIC_WARN_UNUSED
+tic_error * tic_variables_create(tic_variables ** variables);
+
 /// Copies a tic_variables object.  If this function is successful, the caller must
 /// free the settings later by calling tic_settings_free().
 TIC_API TIC_WARN_UNUSED
@@ -1157,6 +1284,15 @@ tic_error * tic_variables_copy(
 TIC_API
 void tic_variables_free(tic_variables *);
 
+/// Returns true if any of the bytes in the specified range of variables were
+/// not read from the device by the last call to tic_update_variables(),
+/// tic_update_variables_segment(), or tic_get_variables() that populated this
+/// object.  The offset and length are in bytes, as described in
+/// tic_update_variables_segment().
+TIC_API TIC_WARN_UNUSED
+bool tic_variables_is_stale(const tic_variables *,
+  size_t offset, size_t length);
+
 /// Returns the current operation state of the Tic, which will be one of the
 /// TIC_OPERATION_STATE_* macros.
 TIC_API
@@ -1497,7 +1633,8 @@ uint8_t tic_variables_get_pin_state(const tic_variables *, uint8_t pin);
 typedef struct tic_device tic_device;
 
 /// Finds all the Tic devices connected to the computer via USB and returns a
-/// list of them.
+/// list of them.  The list also includes the emulated devices named in the
+/// TIC_EMULATED_DEVICES environment variable (see ::tic_emulator).
 ///
 /// The list is terminated by a NULL pointer.  The optional @a device_count
 /// parameter is used to return the number of devices in the list.
@@ -1565,6 +1702,74 @@ const char * tic_device_get_os_id(const tic_device *);
 TIC_API TIC_WARN_UNUSED
 uint16_t tic_device_get_firmware_version(const tic_device *);
 
+/// Keeps track of which Tics are connected to the computer.
+///
+/// On Linux, this uses USB hotplug notifications from the kernel so that it
+/// only needs to scan the USB devices when a Tic is connected.  On other
+/// platforms, it scans all the USB devices every time it is updated, just like
+/// tic_list_connected_devices().
+typedef struct tic_device_monitor tic_device_monitor;
+
+/// A function that is called by tic_device_monitor_update() when a device is
+/// connected (connected is true) or disconnected (connected is false).  The
+/// device pointer is only valid until the callback returns; use
+/// tic_device_copy() if you need to keep it.
+typedef void tic_device_monitor_callback(void * context,
+  const tic_device * device, bool connected);
+
+/// Creates a new device monitor.  The monitor's device list will be empty
+/// until the first call to tic_device_monitor_update().  The monitor must
+/// later be freed with tic_device_monitor_free().
+TIC_API TIC_WARN_UNUSED
+tic_error * tic_device_monitor_create(tic_device_monitor ** monitor);
+
+/// Frees a device monitor.  It is OK to pass NULL to this function.
+TIC_API
+void tic_device_monitor_free(tic_device_monitor *);
+
+/// Sets a function to be called by tic_device_monitor_update() whenever a
+/// device is added to or removed from the monitor's list.  The context pointer
+/// is passed to the callback.
+TIC_API
+void tic_device_monitor_set_callback(tic_device_monitor *,
+  tic_device_monitor_callback * callback, void * context);
+
+/// Returns a file descriptor that becomes readable when there are hotplug
+/// notifications for tic_device_monitor_update() to process, so you can use it
+/// with select() or poll().  Returns -1 if hotplug notifications are not
+/// available, in which case every call to tic_device_monitor_update() scans
+/// all the USB devices, so you should not call it too frequently.
+TIC_API TIC_WARN_UNUSED
+int tic_device_monitor_get_fd(const tic_device_monitor *);
+
+/// Processes any hotplug notifications, scans for new devices if needed, and
+/// calls the callback for each device that was added or removed.  This
+/// function does not block waiting for notifications.
+///
+/// The optional list_changed parameter is used to return whether any devices
+/// were added or removed.
+TIC_API TIC_WARN_UNUSED
+tic_error * tic_device_monitor_update(tic_device_monitor *, bool * list_changed);
+
+/// Makes the next call to tic_device_monitor_update() scan all the USB
+/// devices even if there were no hotplug notifications.  Notifications can be
+/// lost, so a program that keeps a monitor for a long time should call this
+/// every so often.  It is OK to pass NULL to this function.
+TIC_API
+void tic_device_monitor_request_scan(tic_device_monitor *);
+
+/// Returns the number of devices in the monitor's list.  The devices are in
+/// the same order that tic_list_connected_devices() returns them.
+TIC_API TIC_WARN_UNUSED
+size_t tic_device_monitor_get_device_count(const tic_device_monitor *);
+
+/// Returns the device in the monitor's list with the specified index, or NULL
+/// if the index is out of range.  The device is valid until the next call to
+/// tic_device_monitor_update() or tic_device_monitor_free().
+TIC_API TIC_WARN_UNUSED
+const tic_device * tic_device_monitor_get_device(
+  const tic_device_monitor *, size_t index);
+
 
 // tic_handle ///////////////////////////////////////////////////////////////////
 
@@ -1581,6 +1786,221 @@ typedef struct tic_handle tic_handle;
 TIC_API TIC_WARN_UNUSED
 tic_error * tic_handle_open(const tic_device *, tic_handle **);
 
+/// A set of functions for communicating with a Tic, which lets a handle use
+/// something other than USB.  Handles opened with tic_handle_open() use a
+/// built-in USB transport.
+///
+/// Requests are described the same way as in the Tic's USB protocol: a
+/// command byte (one of the TIC_CMD_* macros in tic_protocol.h) and two 16-bit
+/// parameters.  For commands that take a 32-bit value, the lower 16 bits are
+/// in value and the upper 16 bits are in index.  For TIC_CMD_GET_VARIABLE,
+/// TIC_CMD_GET_SETTING, and similar commands, index is the offset of the first
+/// byte to read.  For TIC_CMD_SET_SETTING, value is the byte to write and
+/// index is its address.
+///
+/// Each function receives the context pointer that was passed to
+/// tic_handle_open_transport().  The functions should return NULL on success
+/// or an error created with tic_transport_error_create() on failure.
+typedef struct tic_transport
+{
+  /// A short name for the transport, such as "serial".  This is used as the
+  /// OS ID of the handle's device.  Optional.
+  const char * name;
+
+  /// Sends a command that does not read any data.
+  tic_error * (*write)(void * context,
+    uint8_t request, uint16_t value, uint16_t index);
+
+  /// Sends a command that reads up to length bytes into buffer, and stores
+  /// the number of bytes actually read in transferred.
+  tic_error * (*read)(void * context,
+    uint8_t request, uint16_t value, uint16_t index,
+    uint8_t * buffer, size_t length, size_t * transferred);
+
+  /// Writes the firmware modification string (e.g. "nc"), which is usually
+  /// empty, into a buffer of the specified size.  Optional.
+  void (*get_firmware_modification)(void * context, char * buffer, size_t size);
+
+  /// Frees the context.  This is called by tic_handle_close().  Optional.
+  void (*close)(void * context);
+
+  /// Starts queuing commands that do not read any data so they can be sent
+  /// together.  See tic_handle_begin_batch().  Optional.
+  void (*begin_batch)(void * context);
+
+  /// Sends any queued commands and stops queuing.  Optional.
+  tic_error * (*end_batch)(void * context);
+} tic_transport;
+
+/// Opens a handle that uses the specified transport to communicate with a
+/// device.  The transport must remain valid as long as the handle is open.
+/// This function takes ownership of the context: it will be freed with the
+/// transport's close function when the handle is closed or if this function
+/// fails (unless the transport itself is invalid).  The product (one of the
+/// TIC_PRODUCT_* macros), firmware version (in BCD format), and optional
+/// serial number describe the device, since they cannot be read from a USB
+/// descriptor.  The handle must later be closed
+/// with tic_handle_close().
+TIC_API TIC_WARN_UNUSED
+tic_error * tic_handle_open_transport(const tic_transport * transport,
+  void * context, uint8_t product, uint16_t firmware_version,
+  const char * serial_number, tic_handle ** handle);
+
+/// Creates an error for a transport to return.  The format string and
+/// arguments work like printf().  The code should be a ::tic_error_code
+/// value, such as ::TIC_ERROR_TIMEOUT, or 0.
+TIC_API TIC_WARN_UNUSED
+tic_error * tic_transport_error_create(uint32_t code, const char * format, ...);
+
+/// Opens a handle that talks to a Tic over a TTL serial or RS-232 port, such
+/// as "/dev/ttyUSB0", using the Tic's serial command protocol.
+///
+/// The settings object describes how the Tic's serial interface is
+/// configured: this function uses its product, firmware version, baud rate,
+/// device number, 14-bit device number option, CRC options, and 7-bit
+/// response option.  You can make one with tic_settings_create() and
+/// tic_settings_fill_with_defaults() and then change the serial settings, or
+/// read it from a settings file.  If the firmware version is 0, version 1.09
+/// is assumed.
+///
+/// The flags argument is 0 or a combination of ::TIC_SERIAL_COMPACT_PROTOCOL,
+/// ::TIC_SERIAL_HALF_DUPLEX, and ::TIC_SERIAL_ECHO.  By default, every command is addressed to
+/// the device number using the Pololu protocol.  The compact protocol saves
+/// one or two bytes per command, but only works if there is one device on the
+/// line.  To talk to several Tics on one serial line, use
+/// tic_serial_bus_open() instead.
+///
+/// Serial handles support the commands for controlling the motor, and
+/// reading variables and settings.  Commands that only work over USB, such as
+/// tic_set_settings() and tic_reinitialize(), return an error.
+///
+/// This is only supported on POSIX systems such as Linux and macOS.  The
+/// handle must later be closed with tic_handle_close().
+TIC_API TIC_WARN_UNUSED
+tic_error * tic_handle_open_serial(const char * port_name,
+  const tic_settings * settings, uint32_t flags, tic_handle ** handle);
+
+/// A flag for tic_handle_open_serial() that selects the compact protocol.
+#define TIC_SERIAL_COMPACT_PROTOCOL 1
+
+/// A flag for tic_handle_open_serial() and tic_serial_bus_open() that
+/// specifies that the serial line is half-duplex, like a two-wire RS-485
+/// bus.  The host will not transmit while it is waiting for a response.
+#define TIC_SERIAL_HALF_DUPLEX 2
+
+/// A flag for tic_handle_open_serial() and tic_serial_bus_open() that
+/// specifies that the host receives every byte it transmits, like with many
+/// two-wire RS-485 adapters or a single-wire TTL line.  The echoed bytes are
+/// read back and checked after every write, so a collision on the line is
+/// reported as an error.  This implies ::TIC_SERIAL_HALF_DUPLEX.
+#define TIC_SERIAL_ECHO 4
+
+/// Represents a serial port that is shared by several Tics with different
+/// device numbers, such as a multi-drop TTL serial line or an RS-485 bus.
+///
+/// Each device on the bus gets its own handle from
+/// tic_serial_bus_open_device(), and those handles can be used from different
+/// threads.  The bus serves requests from different threads in the order they
+/// were made.  While the bus is batching (see tic_serial_bus_begin_batch()),
+/// each device has its own queue of commands, and the queued commands are
+/// sent taking one command from each device in turn, so every device gets
+/// its first command before any device gets its second.  Block reads for one
+/// device are pipelined (unless the bus is half-duplex), and the time the
+/// host waits for each response accounts for that device's serial response
+/// delay setting.
+typedef struct tic_serial_bus tic_serial_bus;
+
+/// Statistics about the communication with one device on a serial bus.  The
+/// latencies include the time spent waiting for other devices to use the bus.
+typedef struct tic_serial_device_stats
+{
+  /// The number of commands sent that do not read data.
+  uint64_t command_count;
+
+  /// The total time from when each command was requested until it was sent,
+  /// in microseconds.
+  uint64_t command_latency_total_us;
+
+  /// The longest time from when a command was requested until it was sent,
+  /// in microseconds.
+  uint64_t command_latency_max_us;
+
+  /// The number of successful reads, such as tic_get_variables() calls.
+  uint64_t read_count;
+
+  /// The total time taken by the successful reads, in microseconds.
+  uint64_t read_latency_total_us;
+
+  /// The longest time taken by a successful read, in microseconds.
+  uint64_t read_latency_max_us;
+
+  /// The number of failed commands and reads.
+  uint64_t error_count;
+
+  /// The number of reads that failed because the device did not respond.
+  uint64_t timeout_count;
+} tic_serial_device_stats;
+
+/// Opens a serial port that has one or more Tics on it.  The flags argument
+/// is 0 or a combination of ::TIC_SERIAL_HALF_DUPLEX and ::TIC_SERIAL_ECHO.
+/// The bus must later be freed with
+/// tic_serial_bus_free().
+///
+/// This is only supported on POSIX systems such as Linux and macOS.
+TIC_API TIC_WARN_UNUSED
+tic_error * tic_serial_bus_open(const char * port_name, uint32_t baud_rate,
+  uint32_t flags, tic_serial_bus ** bus);
+
+/// Frees the bus.  The serial port stays open until all of the handles
+/// opened with tic_serial_bus_open_device() are closed too.  It is OK to pass
+/// NULL to this function.
+TIC_API
+void tic_serial_bus_free(tic_serial_bus *);
+
+/// Opens a handle for one device on the bus.  The settings object describes
+/// how the device's serial interface is configured, as in
+/// tic_handle_open_serial(), and its baud rate must match the bus.  Every
+/// device on the bus must have a different device number.  The handle must
+/// later be closed with tic_handle_close().
+TIC_API TIC_WARN_UNUSED
+tic_error * tic_serial_bus_open_device(tic_serial_bus *,
+  const tic_settings * settings, tic_handle ** handle);
+
+/// Starts queuing commands for all devices on the bus.  This is the same as
+/// calling tic_handle_begin_batch() on one of the bus's handles.  Calls can
+/// be nested.
+TIC_API
+void tic_serial_bus_begin_batch(tic_serial_bus *);
+
+/// Ends a batch started by tic_serial_bus_begin_batch().  After the
+/// outermost batch ends, the queued commands of all devices are sent.
+TIC_API TIC_WARN_UNUSED
+tic_error * tic_serial_bus_end_batch(tic_serial_bus *);
+
+/// Gets the statistics for the device on the bus with the specified device
+/// number.
+TIC_API TIC_WARN_UNUSED
+tic_error * tic_serial_bus_get_device_stats(tic_serial_bus *,
+  uint16_t device_number, tic_serial_device_stats * stats);
+
+/// Starts queuing commands that do not read any data, such as
+/// tic_set_target_position(), so that the handle can send them together.
+/// The commands are sent when tic_handle_end_batch() is called, when the
+/// queue is full, or before a command that reads data.  Errors that happen
+/// while sending queued commands are returned by the function that sent
+/// them.
+///
+/// Over serial, this lets one write() carry many commands, which maximizes
+/// the command rate at a given baud rate.  Handles whose transport does not
+/// queue commands, such as USB handles, ignore this.
+TIC_API
+void tic_handle_begin_batch(tic_handle *);
+
+/// Sends any commands queued since tic_handle_begin_batch() and stops
+/// queuing commands.
+TIC_API TIC_WARN_UNUSED
+tic_error * tic_handle_end_batch(tic_handle *);
+
 /// Closes and frees the specified handle.  It is OK to pass NULL to this
 /// function.  Do not close the same non-NULL handle twice.
 TIC_API
@@ -1654,6 +2074,24 @@ tic_error * tic_halt_and_hold(tic_handle *);
 TIC_API TIC_WARN_UNUSED
 tic_error * tic_go_home(tic_handle *, uint8_t direction);
 
+/// Waits until the Tic reaches its target position or finishes homing.
+///
+/// This function reads the variables repeatedly.  The time between reads
+/// depends on when the motor is predicted to arrive (see
+/// ::tic_motion_profile), so the reads are infrequent while the motor is far
+/// from the target and frequent when it is close.  While waiting, this
+/// function sends tic_reset_command_timeout() occasionally to prevent a
+/// command timeout error.
+///
+/// Returns NULL once the current position equals the target position, or if
+/// the Tic is not moving toward a target and not homing.  Returns an error if
+/// the Tic has an error that is stopping the motor, if it has a target
+/// velocity instead of a target position, or if the timeout expires.  The
+/// timeout is in milliseconds, and 0 means to wait forever.  A timeout error
+/// has the ::TIC_ERROR_TIMEOUT code.
+TIC_API TIC_WARN_UNUSED
+tic_error * tic_wait_for_position(tic_handle *, uint32_t timeout_ms);
+
 /// Prevents the "Command timeout" error from happening for some time.
 ///
 /// This function sends a reset command timeout command to the Tic.
@@ -1902,6 +2340,35 @@ TIC_API TIC_WARN_UNUSED
 tic_error * tic_get_variables(tic_handle *, tic_variables ** variables,
   bool clear_errors_occurred);
 
+/// Reads all of the Tic's status variables and stores them in an existing
+/// variables object.
+///
+/// This is just like tic_get_variables(), except it does not allocate memory,
+/// so it is better for programs that read the variables frequently.  The
+/// variables object should have been created with tic_variables_create() or
+/// returned by another function in this library.  If this function fails, the
+/// contents of the variables object are unchanged.
+TIC_API TIC_WARN_UNUSED
+tic_error * tic_update_variables(tic_handle *, tic_variables * variables,
+  bool clear_errors_occurred);
+
+/// Reads a contiguous range of the Tic's status variables and stores them in
+/// an existing variables object.  This uses a smaller transfer than
+/// tic_update_variables(), so it can be used to poll a few variables at a
+/// higher rate.
+///
+/// The offset and length are in bytes and specify which variables to read.
+/// They should be based on the TIC_VAR_* macros in tic_protocol.h.  For
+/// example, to read the current position and velocity, use an offset of
+/// TIC_VAR_CURRENT_POSITION and a length of 8.
+///
+/// Variables outside of the range keep the values they had before, and are
+/// marked as stale until they are read again.  See tic_variables_is_stale().
+/// This function never clears the device's Errors Occurred variable.
+TIC_API TIC_WARN_UNUSED
+tic_error * tic_update_variables_segment(tic_handle *,
+  tic_variables * variables, size_t offset, size_t length);
+
 /// Reads all of the Tic's non-volatile settings and returns them as an object.
 ///
 /// The settings parameter should be a non-null pointer to a tic_settings
@@ -1928,6 +2395,21 @@ tic_error * tic_get_settings(tic_handle *, tic_settings ** settings);
 TIC_API TIC_WARN_UNUSED
 tic_error * tic_set_settings(tic_handle *, const tic_settings *);
 
+/// Writes the Tic's non-volatile settings, but only sends the bytes that are
+/// different from what is currently stored on the device.
+///
+/// This function reads the current settings from the device, so it is
+/// typically much faster than tic_set_settings() when only a few settings are
+/// changing, and it causes less wear on the Tic's EEPROM.  Otherwise, it
+/// behaves the same as tic_set_settings().
+///
+/// The optional bytes_written parameter is used to return the number of
+/// settings bytes that were actually written to the device.  It will be 0 if
+/// the device already had the specified settings.
+TIC_API TIC_WARN_UNUSED
+tic_error * tic_set_settings_differential(tic_handle *, const tic_settings *,
+  size_t * bytes_written);
+
 /// Resets the Tic's settings to their factory default values.
 TIC_API TIC_WARN_UNUSED
 tic_error * tic_restore_defaults(tic_handle * handle);
@@ -1985,6 +2467,435 @@ uint32_t tic_current_limit_code_to_ma(uint8_t product, uint8_t code);
 TIC_API
 uint8_t tic_current_limit_ma_to_code(uint8_t product, uint32_t ma);
 
+
+// tic_poller ///////////////////////////////////////////////////////////////////
+
+/// Reads the variables from a Tic periodically in a background thread.
+///
+/// Each snapshot of the variables is stored in a ring buffer along with a host
+/// timestamp, and can be read with tic_poller_read_latest() or
+/// tic_poller_read_next() without doing any USB transfers or taking any locks.
+/// This lets a program sample the device at a steady rate even if the threads
+/// that use the data are busy.
+///
+/// The poller thread never clears the device's Errors Occurred variable.
+typedef struct tic_poller tic_poller;
+
+/// Creates a poller and starts its thread.  The thread reads the variables
+/// using the specified handle every period_us microseconds, and the poller
+/// keeps the most recent snapshots, up to the specified capacity (which must be
+/// at least 2).
+///
+/// The handle must stay open until the poller is freed with tic_poller_free().
+/// Other threads can still send commands using the handle while the poller is
+/// running.
+TIC_API TIC_WARN_UNUSED
+tic_error * tic_poller_create(tic_handle *, uint32_t period_us,
+  size_t capacity, tic_poller ** poller);
+
+/// Stops the poller's thread and frees the poller.  This might block for up to
+/// one polling period.  It is OK to pass NULL to this function.
+TIC_API
+void tic_poller_free(tic_poller *);
+
+/// Copies the most recent snapshot into the variables object, which should
+/// have been created with tic_variables_create().  The optional timestamp_ns
+/// parameter receives the time when the snapshot was read, as returned by
+/// tic_poller_get_time_ns().  Returns false if there are no snapshots yet.
+///
+/// This does not affect which snapshot tic_poller_read_next() returns.
+TIC_API TIC_WARN_UNUSED
+bool tic_poller_read_latest(tic_poller *, tic_variables * variables,
+  uint64_t * timestamp_ns);
+
+/// Copies the oldest snapshot that has not been read by this function yet into
+/// the variables object, so you can process every snapshot in order.  Returns
+/// false if there are no unread snapshots.
+///
+/// If you do not call this function often enough, the poller will overwrite
+/// old snapshots before you read them.  See tic_poller_get_dropped_count().
+///
+/// Only one thread at a time should call this function for a given poller.
+TIC_API TIC_WARN_UNUSED
+bool tic_poller_read_next(tic_poller *, tic_variables * variables,
+  uint64_t * timestamp_ns);
+
+/// Gets the number of snapshots the poller has read from the device.
+TIC_API TIC_WARN_UNUSED
+uint64_t tic_poller_get_sample_count(const tic_poller *);
+
+/// Gets the number of snapshots that were overwritten before
+/// tic_poller_read_next() could return them.
+TIC_API TIC_WARN_UNUSED
+uint64_t tic_poller_get_dropped_count(const tic_poller *);
+
+/// Gets the number of times the poller failed to read the variables.
+TIC_API TIC_WARN_UNUSED
+uint64_t tic_poller_get_error_count(const tic_poller *);
+
+/// Returns true if the poller's thread is still running.  The thread stops if
+/// the device is disconnected.
+TIC_API TIC_WARN_UNUSED
+bool tic_poller_is_running(const tic_poller *);
+
+/// Gets the current time from the monotonic clock used for snapshot
+/// timestamps, in nanoseconds.
+TIC_API TIC_WARN_UNUSED
+uint64_t tic_poller_get_time_ns(void);
+
+
+// tic_emulator /////////////////////////////////////////////////////////////////
+
+/// A software model of a Tic that runs inside this process.  You can open
+/// handles to it with tic_emulator_open_handle() and use them like handles to
+/// real devices, which is useful for testing software and for load-testing
+/// systems with many axes without any hardware.
+///
+/// The emulator keeps an image of the Tic's settings and models the Tic's
+/// motion planner, errors, and safe start feature.  The motor moves
+/// according to the max speed, starting speed, max acceleration, max
+/// deceleration, and step mode, in steps of 1 ms.  It does not model the
+/// Tic's inputs, limit switches, or encoder, and homing finishes instantly.
+///
+/// By default, time passes in the emulator like it does in the real world.
+/// You can use tic_emulator_set_manual_time() and tic_emulator_advance_time()
+/// to control time yourself.
+///
+/// tic_list_connected_devices() also returns emulated devices for each Tic
+/// product named in the TIC_EMULATED_DEVICES environment variable, which is
+/// a comma-separated list of short product names such as "T825,T249".  These
+/// devices have serial numbers like "EMU00001" and last until the process
+/// exits, so programs like ticcmd can be used with them.
+typedef struct tic_emulator tic_emulator;
+
+/// Creates a new emulated Tic.  The product argument should be one of the
+/// TIC_PRODUCT_* macros.  The serial number can be NULL.
+///
+/// The emulator starts with the default settings for the product, as if it
+/// was just powered on.  It must later be freed with tic_emulator_free().
+TIC_API TIC_WARN_UNUSED
+tic_error * tic_emulator_create(uint8_t product, const char * serial_number,
+  tic_emulator ** emulator);
+
+/// Frees an emulator.  Handles to it stay valid until they are closed.
+TIC_API
+void tic_emulator_free(tic_emulator *);
+
+/// Opens a handle for talking to the emulator.  The handle must later be
+/// closed with tic_handle_close().  You can open several handles to one
+/// emulator.
+TIC_API TIC_WARN_UNUSED
+tic_error * tic_emulator_open_handle(tic_emulator *, tic_handle ** handle);
+
+/// Sets whether time in the emulator only passes when you call
+/// tic_emulator_advance_time().  This is false by default.
+TIC_API
+void tic_emulator_set_manual_time(tic_emulator *, bool manual);
+
+/// Advances the emulator's time by the specified number of microseconds.
+/// This only works if manual time is enabled.
+TIC_API
+void tic_emulator_advance_time(tic_emulator *, uint32_t microseconds);
+
+/// Makes every request to the emulator wait for the specified latency plus a
+/// pseudo-random amount of time between 0 and the specified jitter, in
+/// microseconds, to mimic the time it takes to talk to a real device.  The
+/// default is 0 for both.
+TIC_API
+void tic_emulator_set_latency(tic_emulator *,
+  uint32_t latency_us, uint32_t jitter_us);
+
+
+// tic_motion_profile ///////////////////////////////////////////////////////////
+
+/// A prediction of the trajectory that the Tic's motion planner will follow
+/// to reach a new target position.
+///
+/// The prediction starts from the current position and velocity and uses the
+/// max speed, starting speed, max acceleration, and max deceleration from a
+/// ::tic_variables object.  The Tic accelerates toward the target, possibly
+/// cruises at the max speed, and decelerates so that it arrives at the
+/// starting speed, changing speed instantly at speeds below the starting
+/// speed.  If the motor is moving away from the target or cannot stop before
+/// reaching it, the prediction includes stopping and coming back.
+///
+/// You can use the prediction to schedule actions that should happen when the
+/// motor arrives, and to avoid polling the Tic until the predicted arrival
+/// time is near.  The prediction assumes that the Tic has no errors that stop
+/// the motor and that no other commands are sent.  It does not model the
+/// Tic's internal timing exactly, so the predicted times can be slightly off,
+/// especially at the end of a move where the motor is moving slowly.
+typedef struct tic_motion_profile tic_motion_profile;
+
+/// Predicts the trajectory of a move to the specified target position,
+/// starting from the state in the variables object, which should be recent.
+/// The prediction starts at time 0, which is when the variables were read.
+///
+/// Returns an error if the target cannot be reached because the max speed or
+/// max acceleration is 0.  The profile must later be freed with
+/// tic_motion_profile_free().
+TIC_API TIC_WARN_UNUSED
+tic_error * tic_motion_profile_create(const tic_variables * variables,
+  int32_t target_position, tic_motion_profile ** profile);
+
+/// Frees a motion profile.
+TIC_API
+void tic_motion_profile_free(tic_motion_profile *);
+
+/// Gets the predicted time until the motor reaches the target and stops, in
+/// microseconds.
+TIC_API TIC_WARN_UNUSED
+uint64_t tic_motion_profile_get_duration_us(const tic_motion_profile *);
+
+/// Gets the velocity with the largest magnitude during the move, in
+/// microsteps per 10000 s.  This includes the starting velocity.
+TIC_API TIC_WARN_UNUSED
+int32_t tic_motion_profile_get_peak_velocity(const tic_motion_profile *);
+
+/// Gets the predicted position, in microsteps, at the specified number of
+/// microseconds after the start of the profile.  After the end of the
+/// profile, this returns the target position.
+TIC_API TIC_WARN_UNUSED
+int32_t tic_motion_profile_get_position(const tic_motion_profile *,
+  uint64_t time_us);
+
+/// Gets the predicted velocity, in microsteps per 10000 s, at the specified
+/// number of microseconds after the start of the profile.
+TIC_API TIC_WARN_UNUSED
+int32_t tic_motion_profile_get_velocity(const tic_motion_profile *,
+  uint64_t time_us);
+
+
+// tic_trajectory ///////////////////////////////////////////////////////////////
+
+/// A sequence of waypoints, each of which is a target position or target
+/// velocity to send to a Tic at a certain time, and a background thread that
+/// sends them.
+///
+/// The thread sleeps until the absolute time of each waypoint, so that the
+/// commands go out on schedule even if the program's other threads are busy,
+/// and errors in the timing do not accumulate.  Between waypoints, the thread
+/// resets the command timeout regularly.  For each command, the thread
+/// records how late it was sent.
+typedef struct tic_trajectory tic_trajectory;
+
+/// Statistics about the commands sent for a trajectory.
+typedef struct tic_trajectory_stats
+{
+  /// The number of waypoints that have been sent.
+  uint64_t command_count;
+
+  /// The total time between when the waypoints were scheduled to be sent and
+  /// when they were actually sent, in microseconds.
+  uint64_t lateness_total_us;
+
+  /// The latest that a waypoint has been sent, in microseconds.
+  uint64_t lateness_max_us;
+
+  /// The number of waypoints that failed to send.
+  uint64_t error_count;
+} tic_trajectory_stats;
+
+/// Creates a trajectory with no waypoints.  It must later be freed with
+/// tic_trajectory_free().
+TIC_API TIC_WARN_UNUSED
+tic_error * tic_trajectory_create(tic_trajectory ** trajectory);
+
+/// Stops the trajectory's thread (see tic_trajectory_stop()) and frees the
+/// trajectory.  It is OK to pass NULL to this function.
+TIC_API
+void tic_trajectory_free(tic_trajectory *);
+
+/// Adds a waypoint that sets the target position (see
+/// tic_set_target_position()) at the specified number of microseconds after
+/// the start of the trajectory.
+///
+/// Waypoints must be added in order of time, and cannot be added while the
+/// trajectory is started.
+TIC_API TIC_WARN_UNUSED
+tic_error * tic_trajectory_add_target_position(tic_trajectory *,
+  uint64_t time_us, int32_t position);
+
+/// Adds a waypoint that sets the target velocity (see
+/// tic_set_target_velocity()).  This works like
+/// tic_trajectory_add_target_position().
+TIC_API TIC_WARN_UNUSED
+tic_error * tic_trajectory_add_target_velocity(tic_trajectory *,
+  uint64_t time_us, int32_t velocity);
+
+/// Gets the number of waypoints in the trajectory.
+TIC_API TIC_WARN_UNUSED
+size_t tic_trajectory_get_waypoint_count(const tic_trajectory *);
+
+/// Starts a thread that sends the waypoints using the specified handle.  The
+/// start time uses the clock of tic_poller_get_time_ns(), so you can start
+/// several trajectories at the same time.  If the start time is 0, the
+/// trajectory starts now.  Waypoints whose time has already passed are sent
+/// immediately.
+///
+/// The thread stops after sending the last waypoint, or if the device is
+/// disconnected.  If the trajectory was already started, this function
+/// stops it first and clears its statistics.
+///
+/// The handle must stay open until the thread stops.  Other threads can still
+/// use the handle while the trajectory is running.  The thread does not reset
+/// the command timeout after the last waypoint, so you might want to call
+/// tic_wait_for_position() afterwards.
+TIC_API TIC_WARN_UNUSED
+tic_error * tic_trajectory_start(tic_trajectory *, tic_handle *,
+  uint64_t start_time_ns);
+
+/// Stops the trajectory's thread without sending the remaining waypoints.
+/// This does not stop the motor.  It might block for up to 50 ms.
+TIC_API
+void tic_trajectory_stop(tic_trajectory *);
+
+/// Returns true if the trajectory's thread is still sending waypoints.
+TIC_API TIC_WARN_UNUSED
+bool tic_trajectory_is_running(const tic_trajectory *);
+
+/// Gets statistics about the commands sent since the trajectory was started.
+/// It is OK to call this while the trajectory is running.
+TIC_API
+void tic_trajectory_get_stats(const tic_trajectory *,
+  tic_trajectory_stats * stats);
+
+/// Gets how late the waypoint with the specified index was sent, in
+/// microseconds.  Returns false if the waypoint has not been sent yet.
+TIC_API TIC_WARN_UNUSED
+bool tic_trajectory_get_lateness_us(const tic_trajectory *, size_t index,
+  uint64_t * lateness_us);
+
+
+// tic_axis_group ///////////////////////////////////////////////////////////////
+
+/// A group of Tics that each drive one axis of a machine, such as an XY
+/// stage, and can make coordinated moves along straight lines.
+///
+/// For a coordinated move, the group temporarily changes the max speed,
+/// starting speed, max acceleration, and max deceleration of each moving axis
+/// in proportion to the distance it has to travel, so that all the axes
+/// follow scaled copies of the same trapezoidal profile and arrive at the
+/// same time.  The limits are chosen so that no axis exceeds the limits it
+/// had when the group was created.  Then the group sends the target
+/// positions as close together in time as it can.
+typedef struct tic_axis_group tic_axis_group;
+
+/// Timing information about the last coordinated move.
+typedef struct tic_axis_group_stats
+{
+  /// The predicted duration of the move, in microseconds.
+  uint64_t predicted_duration_us;
+
+  /// The time it took to send the target positions to all the axes, in
+  /// microseconds.  This is an upper bound on the difference between the
+  /// times that the axes started moving.
+  uint64_t command_skew_us;
+
+  /// The time from sending the first target position until the last axis
+  /// arrived, in microseconds, as measured by tic_axis_group_wait().
+  uint64_t duration_us;
+
+  /// The time between the arrival of the first and last axes, in
+  /// microseconds, as measured by tic_axis_group_wait().  The accuracy of
+  /// this measurement is limited by how often tic_axis_group_wait() reads the
+  /// variables, which is every 2 ms or so near the end of a move.
+  uint64_t arrival_skew_us;
+} tic_axis_group_stats;
+
+/// Creates an axis group with the specified handles, one per axis.  This
+/// function reads the variables from each Tic to get the max speed, starting
+/// speed, max acceleration, and max deceleration that each axis should not
+/// exceed.
+///
+/// The handles must stay open until the group is freed with
+/// tic_axis_group_free().
+TIC_API TIC_WARN_UNUSED
+tic_error * tic_axis_group_create(tic_handle * const * handles,
+  size_t axis_count, tic_axis_group ** group);
+
+/// Frees an axis group.  This does not close the handles.
+TIC_API
+void tic_axis_group_free(tic_axis_group *);
+
+/// Starts a coordinated move to the specified target positions, one for each
+/// axis.  The axes must not be moving.
+///
+/// This function leaves the limits of each axis changed.  To restore them,
+/// call tic_axis_group_restore_limits().
+///
+/// If an axis moves so much less than the others that its share of a limit
+/// would be below what the Tic accepts, the axes could not stay on the line,
+/// so this function returns an error without changing anything.  If changing
+/// the limits fails partway, the limits that were changed are put back.
+TIC_API TIC_WARN_UNUSED
+tic_error * tic_axis_group_move(tic_axis_group *,
+  const int32_t * target_positions);
+
+/// Waits until all the axes reach their targets and measures when each one
+/// arrived.  This works like tic_wait_for_position(), including resetting the
+/// command timeout of the axes while waiting.  The timeout is in
+/// milliseconds, and 0 means to wait forever.
+TIC_API TIC_WARN_UNUSED
+tic_error * tic_axis_group_wait(tic_axis_group *, uint32_t timeout_ms);
+
+/// Sets the max speed, starting speed, max acceleration, and max deceleration
+/// of every axis back to the values they had when the group was created.
+TIC_API TIC_WARN_UNUSED
+tic_error * tic_axis_group_restore_limits(tic_axis_group *);
+
+/// Gets timing information about the last coordinated move.
+TIC_API
+void tic_axis_group_get_stats(const tic_axis_group *,
+  tic_axis_group_stats * stats);
+
+// tic_settings_diff ///////////////////////////////////////////////////////////
+
+/// Represents the differences between two settings objects, as a list of the
+/// fields that changed.  Each field has the name and value it would have in a
+/// settings file (see tic_settings_to_string()).
+typedef struct tic_settings_diff tic_settings_diff;
+
+/// Compares two settings objects and creates a list of the fields that are
+/// different.  The fields are listed in the order they appear in a settings
+/// file, followed by any fields that are only present in the old settings.
+/// The list is empty if the settings are the same.
+///
+/// This function does not fix the settings, so you might want to call
+/// tic_settings_fix() on both of them first.
+///
+/// The diff must later be freed with tic_settings_diff_free().
+TIC_API TIC_WARN_UNUSED
+tic_error * tic_settings_diff_create(const tic_settings * old_settings,
+  const tic_settings * new_settings, tic_settings_diff ** diff);
+
+/// Frees a settings diff.  It is OK to pass NULL to this function.
+TIC_API
+void tic_settings_diff_free(tic_settings_diff *);
+
+/// Gets the number of fields that are different.
+TIC_API
+size_t tic_settings_diff_get_count(const tic_settings_diff *);
+
+/// Gets the name of the field with the specified index, such as
+/// "max_speed".  Returns NULL if the index is out of range.
+TIC_API
+const char * tic_settings_diff_get_name(const tic_settings_diff *,
+  size_t index);
+
+/// Gets the value of the field with the specified index in the old settings.
+/// Returns NULL if the field is not present in the old settings, which can
+/// happen if the two settings are for different products.
+TIC_API
+const char * tic_settings_diff_get_old_value(const tic_settings_diff *,
+  size_t index);
+
+/// Gets the value of the field with the specified index in the new settings.
+/// Returns NULL if the field is not present in the new settings.
+TIC_API
+const char * tic_settings_diff_get_new_value(const tic_settings_diff *,
+  size_t index);
+
 #ifdef __cplusplus
 }
 #endif
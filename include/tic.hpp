@@ -62,6 +62,12 @@ namespace tic
     tic_settings_free(p);
   }
 
+  /// Wrapper for tic_settings_warnings_free().
+  inline void pointer_free(tic_settings_warnings * p) noexcept
+  {
+    tic_settings_warnings_free(p);
+  }
+
   /// Wrapper for tic_settings_copy().
   inline tic_settings * pointer_copy(const tic_settings * p)
   {
@@ -84,12 +90,60 @@ namespace tic
     return copy;
   }
 
+  /// Wrapper for tic_device_monitor_free().
+  inline void pointer_free(tic_device_monitor * p) noexcept
+  {
+    tic_device_monitor_free(p);
+  }
+
   /// Wrapper for tic_handle_close().
   inline void pointer_free(tic_handle * p) noexcept
   {
     tic_handle_close(p);
   }
 
+  /// Wrapper for tic_poller_free().
+  inline void pointer_free(tic_poller * p) noexcept
+  {
+    tic_poller_free(p);
+  }
+
+  /// Wrapper for tic_serial_bus_free().
+  inline void pointer_free(tic_serial_bus * p) noexcept
+  {
+    tic_serial_bus_free(p);
+  }
+
+  /// Wrapper for tic_emulator_free().
+  inline void pointer_free(tic_emulator * p) noexcept
+  {
+    tic_emulator_free(p);
+  }
+
+  /// Wrapper for tic_motion_profile_free().
+  inline void pointer_free(tic_motion_profile * p) noexcept
+  {
+    tic_motion_profile_free(p);
+  }
+
+  /// Wrapper for tic_trajectory_free().
+  inline void pointer_free(tic_trajectory * p) noexcept
+  {
+    tic_trajectory_free(p);
+  }
+
+  /// Wrapper for tic_axis_group_free().
+  inline void pointer_free(tic_axis_group * p) noexcept
+  {
+    tic_axis_group_free(p);
+  }
+
+  /// Wrapper for tic_settings_diff_free().
+  inline void pointer_free(tic_settings_diff * p) noexcept
+  {
+    tic_settings_diff_free(p);
+  }
+
   /// This class is not part of the public API of the library and you should
   /// not use it directly, but you can use the public methods it provides to
   /// the classes that inherit from it.
@@ -249,6 +303,45 @@ namespace tic
   }
   /// \endcond
 
+  /// Represents the warnings from fixing a settings object.  See
+  /// ::tic_settings_warnings and settings::fix_with_warnings().
+  class settings_warnings : public unique_pointer_wrapper<tic_settings_warnings>
+  {
+  public:
+    /// Constructor that takes a pointer from the C API.  This object will free
+    /// the pointer when it is destroyed.
+    explicit settings_warnings(tic_settings_warnings * p = NULL) noexcept
+      : unique_pointer_wrapper(p)
+    {
+    }
+
+    /// Wrapper for tic_settings_warnings_get_count().
+    size_t get_count() const noexcept
+    {
+      return tic_settings_warnings_get_count(pointer);
+    }
+
+    /// Wrapper for tic_settings_warnings_get_code().
+    uint8_t get_code(size_t index) const noexcept
+    {
+      return tic_settings_warnings_get_code(pointer, index);
+    }
+
+    /// Wrapper for tic_settings_warnings_get_field().
+    std::string get_field(size_t index) const
+    {
+      const char * field = tic_settings_warnings_get_field(pointer, index);
+      return field ? field : "";
+    }
+
+    /// Wrapper for tic_settings_warnings_get_message().
+    std::string get_message(size_t index) const
+    {
+      const char * message = tic_settings_warnings_get_message(pointer, index);
+      return message ? message : "";
+    }
+  };
+
   /// Represets the settings for a Tic.  This object just stores plain old data;
   /// it does not have any pointers or handles for other resources.
   ///
@@ -297,6 +390,14 @@ namespace tic
       if (warnings) { *warnings = std::string(cstr); }
     }
 
+    /// Wrapper for tic_settings_fix_with_warnings().
+    settings_warnings fix_with_warnings()
+    {
+      tic_settings_warnings * p;
+      throw_if_needed(tic_settings_fix_with_warnings(pointer, &p));
+      return settings_warnings(p);
+    }
+
     /// Wrapper for tic_settings_to_string().
     std::string to_string() const
     {
@@ -314,6 +415,24 @@ namespace tic
       return r;
     }
 
+    /// Wrapper for tic_settings_to_image().
+    std::vector<uint8_t> to_image() const
+    {
+      std::vector<uint8_t> image(TIC_SETTINGS_IMAGE_SIZE);
+      throw_if_needed(tic_settings_to_image(pointer,
+          image.data(), image.size()));
+      return image;
+    }
+
+    /// Wrapper for tic_settings_read_from_image().
+    static settings read_from_image(const std::vector<uint8_t> & image)
+    {
+      settings r;
+      throw_if_needed(tic_settings_read_from_image(
+          image.data(), image.size(), r.get_pointer_to_pointer()));
+      return r;
+    }
+
     /// Wrapper for tic_settings_set_product().
     void set_product(uint8_t product)
     {
@@ -338,6 +457,20 @@ namespace tic
     {
     }
 
+    /// Wrapper for tic_variables_create().
+    static variables create()
+    {
+      tic_variables * p;
+      throw_if_needed(tic_variables_create(&p));
+      return variables(p);
+    }
+
+    /// Wrapper for tic_variables_is_stale().
+    bool is_stale(size_t offset, size_t length) const noexcept
+    {
+      return tic_variables_is_stale(pointer, offset, length);
+    }
+
     /// Wrapper for tic_variables_get_operation_state().
     uint8_t get_operation_state() const noexcept
     {
@@ -657,6 +790,62 @@ namespace tic
     return vector;
   }
 
+  /// Keeps track of which Tics are connected to the computer.  See
+  /// ::tic_device_monitor.
+  class device_monitor : public unique_pointer_wrapper<tic_device_monitor>
+  {
+  public:
+    /// Constructor that takes a pointer from the C API.  This object will free
+    /// the pointer when it is destroyed.
+    explicit device_monitor(tic_device_monitor * p = NULL) noexcept
+      : unique_pointer_wrapper(p)
+    {
+    }
+
+    /// Wrapper for tic_device_monitor_create().
+    static device_monitor create()
+    {
+      tic_device_monitor * p;
+      throw_if_needed(tic_device_monitor_create(&p));
+      return device_monitor(p);
+    }
+
+    /// Returns true if the monitor gets hotplug notifications from the
+    /// operating system instead of scanning on every update.
+    bool has_hotplug_support() const noexcept
+    {
+      return tic_device_monitor_get_fd(pointer) >= 0;
+    }
+
+    /// Wrapper for tic_device_monitor_request_scan().
+    void request_scan() noexcept
+    {
+      tic_device_monitor_request_scan(pointer);
+    }
+
+    /// Wrapper for tic_device_monitor_update().  Returns true if any devices
+    /// were added or removed.
+    bool update()
+    {
+      bool list_changed;
+      throw_if_needed(tic_device_monitor_update(pointer, &list_changed));
+      return list_changed;
+    }
+
+    /// Returns copies of the devices in the monitor's list.
+    std::vector<tic::device> get_devices() const
+    {
+      std::vector<device> vector;
+      size_t count = tic_device_monitor_get_device_count(pointer);
+      for (size_t i = 0; i < count; i++)
+      {
+        vector.push_back(device(pointer_copy(
+          tic_device_monitor_get_device(pointer, i))));
+      }
+      return vector;
+    }
+  };
+
   /// Represents an open handle that can be used to read and write data from a
   /// device.  Can also be in a null state where it does not represent a device.
   class handle : public unique_pointer_wrapper<tic_handle>
@@ -675,12 +864,34 @@ namespace tic
       throw_if_needed(tic_handle_open(device.get_pointer(), &pointer));
     }
 
+    /// Wrapper for tic_handle_open_serial().
+    static handle open_serial(const std::string & port_name,
+      const settings & settings, uint32_t flags = 0)
+    {
+      tic_handle * p;
+      throw_if_needed(tic_handle_open_serial(port_name.c_str(),
+        settings.get_pointer(), flags, &p));
+      return handle(p);
+    }
+
     /// Closes the handle and puts this object into the null state.
     void close() noexcept
     {
       pointer_reset();
     }
 
+    /// Wrapper for tic_handle_begin_batch().
+    void begin_batch() noexcept
+    {
+      tic_handle_begin_batch(pointer);
+    }
+
+    /// Wrapper for tic_handle_end_batch().
+    void end_batch()
+    {
+      throw_if_needed(tic_handle_end_batch(pointer));
+    }
+
     /// Wrapper for tic_handle_get_device();
     device get_device() const
     {
@@ -723,6 +934,12 @@ namespace tic
       throw_if_needed(tic_go_home(pointer, direction));
     }
 
+    /// Wrapper for tic_wait_for_position().
+    void wait_until_reached(uint32_t timeout_ms = 0)
+    {
+      throw_if_needed(tic_wait_for_position(pointer, timeout_ms));
+    }
+
     /// Wrapper for tic_reset_command_timeout().
     void reset_command_timeout()
     {
@@ -845,6 +1062,29 @@ namespace tic
       return variables(v);
     }
 
+    /// Wrapper for tic_update_variables().
+    ///
+    /// If the variables object is in the null state, this function creates a
+    /// new variables object for it first.  Calling this function repeatedly
+    /// with the same object does not allocate memory.
+    void update_variables(variables & vars, bool clear_errors_occurred = false)
+    {
+      if (!vars) { vars = variables::create(); }
+      throw_if_needed(tic_update_variables(pointer, vars.get_pointer(),
+          clear_errors_occurred));
+    }
+
+    /// Wrapper for tic_update_variables_segment().
+    ///
+    /// If the variables object is in the null state, this function creates a
+    /// new variables object for it first.
+    void update_variables_segment(variables & vars, size_t offset, size_t length)
+    {
+      if (!vars) { vars = variables::create(); }
+      throw_if_needed(tic_update_variables_segment(pointer, vars.get_pointer(),
+          offset, length));
+    }
+
     /// Wrapper for tic_get_settings().
     settings get_settings()
     {
@@ -859,6 +1099,16 @@ namespace tic
       throw_if_needed(tic_set_settings(pointer, settings.get_pointer()));
     }
 
+    /// Wrapper for tic_set_settings_differential().  Returns the number of
+    /// bytes that were written to the device.
+    size_t set_settings_differential(const settings & settings)
+    {
+      size_t bytes_written;
+      throw_if_needed(tic_set_settings_differential(
+          pointer, settings.get_pointer(), &bytes_written));
+      return bytes_written;
+    }
+
     /// Wrapper for tic_restore_defaults().
     void restore_defaults()
     {
@@ -888,6 +1138,398 @@ namespace tic
 
   };
 
+  /// Reads the variables from a device periodically in a background thread.
+  /// See ::tic_poller.
+  class poller : public unique_pointer_wrapper<tic_poller>
+  {
+  public:
+    /// Constructor that takes a pointer from the C API.  This object will free
+    /// the pointer when it is destroyed.
+    explicit poller(tic_poller * p = NULL) noexcept
+      : unique_pointer_wrapper(p)
+    {
+    }
+
+    /// Wrapper for tic_poller_create().  The handle must stay open until this
+    /// object is destroyed.
+    static poller create(handle & handle, uint32_t period_us,
+      size_t capacity = 256)
+    {
+      tic_poller * p;
+      throw_if_needed(tic_poller_create(handle.get_pointer(), period_us,
+        capacity, &p));
+      return poller(p);
+    }
+
+    /// Wrapper for tic_poller_read_latest().  If the variables object is
+    /// null, this function creates it.
+    bool read_latest(variables & vars, uint64_t * timestamp_ns = NULL)
+    {
+      if (!vars) { vars = variables::create(); }
+      return tic_poller_read_latest(pointer, vars.get_pointer(), timestamp_ns);
+    }
+
+    /// Wrapper for tic_poller_read_next().  If the variables object is null,
+    /// this function creates it.
+    bool read_next(variables & vars, uint64_t * timestamp_ns = NULL)
+    {
+      if (!vars) { vars = variables::create(); }
+      return tic_poller_read_next(pointer, vars.get_pointer(), timestamp_ns);
+    }
+
+    /// Wrapper for tic_poller_get_sample_count().
+    uint64_t get_sample_count() const noexcept
+    {
+      return tic_poller_get_sample_count(pointer);
+    }
+
+    /// Wrapper for tic_poller_get_dropped_count().
+    uint64_t get_dropped_count() const noexcept
+    {
+      return tic_poller_get_dropped_count(pointer);
+    }
+
+    /// Wrapper for tic_poller_get_error_count().
+    uint64_t get_error_count() const noexcept
+    {
+      return tic_poller_get_error_count(pointer);
+    }
+
+    /// Wrapper for tic_poller_is_running().
+    bool is_running() const noexcept
+    {
+      return tic_poller_is_running(pointer);
+    }
+
+    /// Wrapper for tic_poller_get_time_ns().
+    static uint64_t get_time_ns() noexcept
+    {
+      return tic_poller_get_time_ns();
+    }
+  };
+
+  /// Represents a serial port shared by several devices.  See
+  /// ::tic_serial_bus.
+  class serial_bus : public unique_pointer_wrapper<tic_serial_bus>
+  {
+  public:
+    /// Constructor that takes a pointer from the C API.  This object will free
+    /// the pointer when it is destroyed.
+    explicit serial_bus(tic_serial_bus * p = NULL) noexcept
+      : unique_pointer_wrapper(p)
+    {
+    }
+
+    /// Wrapper for tic_serial_bus_open().
+    static serial_bus open(const std::string & port_name, uint32_t baud_rate,
+      uint32_t flags = 0)
+    {
+      tic_serial_bus * p;
+      throw_if_needed(tic_serial_bus_open(port_name.c_str(), baud_rate,
+        flags, &p));
+      return serial_bus(p);
+    }
+
+    /// Wrapper for tic_serial_bus_open_device().
+    handle open_device(const settings & settings)
+    {
+      tic_handle * p;
+      throw_if_needed(tic_serial_bus_open_device(pointer,
+        settings.get_pointer(), &p));
+      return handle(p);
+    }
+
+    /// Wrapper for tic_serial_bus_begin_batch().
+    void begin_batch() noexcept
+    {
+      tic_serial_bus_begin_batch(pointer);
+    }
+
+    /// Wrapper for tic_serial_bus_end_batch().
+    void end_batch()
+    {
+      throw_if_needed(tic_serial_bus_end_batch(pointer));
+    }
+
+    /// Wrapper for tic_serial_bus_get_device_stats().
+    tic_serial_device_stats get_device_stats(uint16_t device_number)
+    {
+      tic_serial_device_stats stats;
+      throw_if_needed(tic_serial_bus_get_device_stats(pointer,
+        device_number, &stats));
+      return stats;
+    }
+  };
+
+  /// Represents an emulated Tic.  See ::tic_emulator.
+  class emulator : public unique_pointer_wrapper<tic_emulator>
+  {
+  public:
+    /// Constructor that takes a pointer from the C API.  This object will free
+    /// the pointer when it is destroyed.
+    explicit emulator(tic_emulator * p = NULL) noexcept
+      : unique_pointer_wrapper(p)
+    {
+    }
+
+    /// Wrapper for tic_emulator_create().
+    static emulator create(uint8_t product,
+      const std::string & serial_number = "")
+    {
+      tic_emulator * p;
+      throw_if_needed(tic_emulator_create(product, serial_number.c_str(), &p));
+      return emulator(p);
+    }
+
+    /// Wrapper for tic_emulator_open_handle().
+    handle open_handle()
+    {
+      tic_handle * p;
+      throw_if_needed(tic_emulator_open_handle(pointer, &p));
+      return handle(p);
+    }
+
+    /// Wrapper for tic_emulator_set_manual_time().
+    void set_manual_time(bool manual) noexcept
+    {
+      tic_emulator_set_manual_time(pointer, manual);
+    }
+
+    /// Wrapper for tic_emulator_advance_time().
+    void advance_time(uint32_t microseconds) noexcept
+    {
+      tic_emulator_advance_time(pointer, microseconds);
+    }
+
+    /// Wrapper for tic_emulator_set_latency().
+    void set_latency(uint32_t latency_us, uint32_t jitter_us = 0) noexcept
+    {
+      tic_emulator_set_latency(pointer, latency_us, jitter_us);
+    }
+  };
+
+  /// Represents a predicted trajectory.  See ::tic_motion_profile.
+  class motion_profile : public unique_pointer_wrapper<tic_motion_profile>
+  {
+  public:
+    /// Constructor that takes a pointer from the C API.  This object will free
+    /// the pointer when it is destroyed.
+    explicit motion_profile(tic_motion_profile * p = NULL) noexcept
+      : unique_pointer_wrapper(p)
+    {
+    }
+
+    /// Wrapper for tic_motion_profile_create().
+    static motion_profile create(const variables & variables,
+      int32_t target_position)
+    {
+      tic_motion_profile * p;
+      throw_if_needed(tic_motion_profile_create(variables.get_pointer(),
+        target_position, &p));
+      return motion_profile(p);
+    }
+
+    /// Wrapper for tic_motion_profile_get_duration_us().
+    uint64_t get_duration_us() const noexcept
+    {
+      return tic_motion_profile_get_duration_us(pointer);
+    }
+
+    /// Wrapper for tic_motion_profile_get_peak_velocity().
+    int32_t get_peak_velocity() const noexcept
+    {
+      return tic_motion_profile_get_peak_velocity(pointer);
+    }
+
+    /// Wrapper for tic_motion_profile_get_position().
+    int32_t get_position(uint64_t time_us) const noexcept
+    {
+      return tic_motion_profile_get_position(pointer, time_us);
+    }
+
+    /// Wrapper for tic_motion_profile_get_velocity().
+    int32_t get_velocity(uint64_t time_us) const noexcept
+    {
+      return tic_motion_profile_get_velocity(pointer, time_us);
+    }
+  };
+
+  /// Represents a timed sequence of targets.  See ::tic_trajectory.
+  class trajectory : public unique_pointer_wrapper<tic_trajectory>
+  {
+  public:
+    /// Constructor that takes a pointer from the C API.  This object will free
+    /// the pointer when it is destroyed.
+    explicit trajectory(tic_trajectory * p = NULL) noexcept
+      : unique_pointer_wrapper(p)
+    {
+    }
+
+    /// Wrapper for tic_trajectory_create().
+    static trajectory create()
+    {
+      tic_trajectory * p;
+      throw_if_needed(tic_trajectory_create(&p));
+      return trajectory(p);
+    }
+
+    /// Wrapper for tic_trajectory_add_target_position().
+    void add_target_position(uint64_t time_us, int32_t position)
+    {
+      throw_if_needed(tic_trajectory_add_target_position(pointer,
+        time_us, position));
+    }
+
+    /// Wrapper for tic_trajectory_add_target_velocity().
+    void add_target_velocity(uint64_t time_us, int32_t velocity)
+    {
+      throw_if_needed(tic_trajectory_add_target_velocity(pointer,
+        time_us, velocity));
+    }
+
+    /// Wrapper for tic_trajectory_get_waypoint_count().
+    size_t get_waypoint_count() const noexcept
+    {
+      return tic_trajectory_get_waypoint_count(pointer);
+    }
+
+    /// Wrapper for tic_trajectory_start().
+    void start(handle & handle, uint64_t start_time_ns = 0)
+    {
+      throw_if_needed(tic_trajectory_start(pointer, handle.get_pointer(),
+        start_time_ns));
+    }
+
+    /// Wrapper for tic_trajectory_stop().
+    void stop() noexcept
+    {
+      tic_trajectory_stop(pointer);
+    }
+
+    /// Wrapper for tic_trajectory_is_running().
+    bool is_running() const noexcept
+    {
+      return tic_trajectory_is_running(pointer);
+    }
+
+    /// Wrapper for tic_trajectory_get_stats().
+    tic_trajectory_stats get_stats() const noexcept
+    {
+      tic_trajectory_stats stats;
+      tic_trajectory_get_stats(pointer, &stats);
+      return stats;
+    }
+
+    /// Wrapper for tic_trajectory_get_lateness_us().
+    bool get_lateness_us(size_t index, uint64_t * lateness_us) const noexcept
+    {
+      return tic_trajectory_get_lateness_us(pointer, index, lateness_us);
+    }
+  };
+
+  /// Represents a group of Tics that make coordinated moves.  See
+  /// ::tic_axis_group.
+  class axis_group : public unique_pointer_wrapper<tic_axis_group>
+  {
+  public:
+    /// Constructor that takes a pointer from the C API.  This object will free
+    /// the pointer when it is destroyed.
+    explicit axis_group(tic_axis_group * p = NULL) noexcept
+      : unique_pointer_wrapper(p)
+    {
+    }
+
+    /// Wrapper for tic_axis_group_create().
+    static axis_group create(const std::vector<handle *> & handles)
+    {
+      std::vector<tic_handle *> pointers;
+      for (handle * h : handles) { pointers.push_back(h->get_pointer()); }
+      tic_axis_group * p;
+      throw_if_needed(tic_axis_group_create(pointers.data(),
+        pointers.size(), &p));
+      return axis_group(p);
+    }
+
+    /// Wrapper for tic_axis_group_move().  There must be one target position
+    /// for each axis.
+    void move(const std::vector<int32_t> & target_positions)
+    {
+      throw_if_needed(tic_axis_group_move(pointer, target_positions.data()));
+    }
+
+    /// Wrapper for tic_axis_group_wait().
+    void wait(uint32_t timeout_ms = 0)
+    {
+      throw_if_needed(tic_axis_group_wait(pointer, timeout_ms));
+    }
+
+    /// Wrapper for tic_axis_group_restore_limits().
+    void restore_limits()
+    {
+      throw_if_needed(tic_axis_group_restore_limits(pointer));
+    }
+
+    /// Wrapper for tic_axis_group_get_stats().
+    tic_axis_group_stats get_stats() const noexcept
+    {
+      tic_axis_group_stats stats;
+      tic_axis_group_get_stats(pointer, &stats);
+      return stats;
+    }
+  };
+
+  /// Represents the differences between two settings objects.  See
+  /// ::tic_settings_diff.
+  class settings_diff : public unique_pointer_wrapper<tic_settings_diff>
+  {
+  public:
+    /// Constructor that takes a pointer from the C API.  This object will free
+    /// the pointer when it is destroyed.
+    explicit settings_diff(tic_settings_diff * p = NULL) noexcept
+      : unique_pointer_wrapper(p)
+    {
+    }
+
+    /// Wrapper for tic_settings_diff_create().
+    static settings_diff create(const settings & old_settings,
+      const settings & new_settings)
+    {
+      tic_settings_diff * p;
+      throw_if_needed(tic_settings_diff_create(old_settings.get_pointer(),
+        new_settings.get_pointer(), &p));
+      return settings_diff(p);
+    }
+
+    /// Wrapper for tic_settings_diff_get_count().
+    size_t get_count() const noexcept
+    {
+      return tic_settings_diff_get_count(pointer);
+    }
+
+    /// Wrapper for tic_settings_diff_get_name().
+    std::string get_name(size_t index) const
+    {
+      const char * name = tic_settings_diff_get_name(pointer, index);
+      return name ? name : "";
+    }
+
+    /// Wrapper for tic_settings_diff_get_old_value().  Returns an empty
+    /// string if the field is not present in the old settings.
+    std::string get_old_value(size_t index) const
+    {
+      const char * value = tic_settings_diff_get_old_value(pointer, index);
+      return value ? value : "";
+    }
+
+    /// Wrapper for tic_settings_diff_get_new_value().  Returns an empty
+    /// string if the field is not present in the new settings.
+    std::string get_new_value(size_t index) const
+    {
+      const char * value = tic_settings_diff_get_new_value(pointer, index);
+      return value ? value : "";
+    }
+  };
+
   /// Wrapper for tic_get_recommended_current_limit_codes().
   inline const std::vector<uint8_t> get_recommended_current_limit_codes(
     uint8_t product)
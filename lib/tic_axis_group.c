@@ -0,0 +1,533 @@
+// Functions for making several Tics move in a straight line together.
+//
+// To move along a straight line, every axis must follow the same trajectory
+// scaled by its distance.  If we describe the progress along the line by a
+// number s that goes from 0 to 1, axis i is at start_i + s * distance_i, so its
+// speed and acceleration are distance_i times the speed and acceleration of s.
+// We pick the largest limits for s that do not make any axis exceed its own
+// limits, and then give each Tic its share of those limits.  The Tics then
+// follow scaled copies of the same trapezoidal profile and arrive together.
+
+#include "tic_internal.h"
+
+#include <math.h>
+
+// How often to reset the command timeout while waiting.
+#define TIC_AXIS_GROUP_KEEPALIVE_NS 100000000
+
+typedef struct tic_axis
+{
+  tic_handle * handle;
+  tic_variables * variables;
+
+  // The limits the axis had when the group was created.
+  uint32_t max_speed;
+  uint32_t starting_speed;
+  uint32_t max_accel;
+  uint32_t max_decel;
+
+  // The limits for the current move.
+  uint32_t move_max_speed;
+  uint32_t move_starting_speed;
+  uint32_t move_accel;
+  uint32_t move_decel;
+
+  int32_t target_position;
+  uint32_t distance;
+  bool arrived;
+  uint64_t arrival_time_ns;
+} tic_axis;
+
+struct tic_axis_group
+{
+  tic_axis * axes;
+  size_t axis_count;
+  uint64_t move_start_ns;
+  tic_axis_group_stats stats;
+};
+
+void tic_axis_group_free(tic_axis_group * group)
+{
+  if (group == NULL) { return; }
+
+  if (group->axes != NULL)
+  {
+    for (size_t i = 0; i < group->axis_count; i++)
+    {
+      tic_variables_free(group->axes[i].variables);
+    }
+  }
+  free(group->axes);
+  free(group);
+}
+
+tic_error * tic_axis_group_create(tic_handle * const * handles,
+  size_t axis_count, tic_axis_group ** group)
+{
+  if (group == NULL)
+  {
+    return tic_error_create("Axis group output pointer is null.");
+  }
+
+  *group = NULL;
+
+  if (handles == NULL || axis_count == 0)
+  {
+    return tic_error_create("An axis group needs at least one handle.");
+  }
+
+  tic_error * error = NULL;
+
+  tic_axis_group * new_group = NULL;
+  if (error == NULL)
+  {
+    new_group = calloc(1, sizeof(tic_axis_group));
+    if (new_group == NULL) { error = &tic_error_no_memory; }
+  }
+
+  if (error == NULL)
+  {
+    new_group->axes = calloc(axis_count, sizeof(tic_axis));
+    if (new_group->axes == NULL) { error = &tic_error_no_memory; }
+  }
+
+  if (error == NULL)
+  {
+    new_group->axis_count = axis_count;
+  }
+
+  for (size_t i = 0; error == NULL && i < axis_count; i++)
+  {
+    tic_axis * axis = &new_group->axes[i];
+    axis->handle = handles[i];
+    if (axis->handle == NULL)
+    {
+      error = tic_error_create("Handle for axis %u is null.", (unsigned int)i);
+      break;
+    }
+
+    error = tic_variables_create(&axis->variables);
+
+    if (error == NULL)
+    {
+      error = tic_update_variables(axis->handle, axis->variables, false);
+    }
+
+    if (error == NULL)
+    {
+      axis->max_speed = tic_variables_get_max_speed(axis->variables);
+      axis->starting_speed = tic_variables_get_starting_speed(axis->variables);
+      axis->max_accel = tic_variables_get_max_accel(axis->variables);
+      axis->max_decel = tic_variables_get_max_decel(axis->variables);
+    }
+  }
+
+  if (error == NULL)
+  {
+    *group = new_group;
+    new_group = NULL;
+  }
+
+  tic_axis_group_free(new_group);
+
+  if (error != NULL)
+  {
+    error = tic_error_add(error, "There was an error creating an axis group.");
+  }
+
+  return error;
+}
+
+// Scales a limit of the path parameter to one axis, rounding to the nearest
+// value the Tic can use.  The shared limits are already as high as every axis
+// allows, so if an axis would get less than the Tic's minimum, raising its
+// value would take it off the line and there is no way to make the move.
+static tic_error * tic_axis_group_scale(double limit, size_t axis_index,
+  const tic_axis * axis, const char * name, uint32_t min, uint32_t * result)
+{
+  double value = floor(limit * axis->distance + 0.5);
+  if (value < min)
+  {
+    return tic_error_create(
+      "Axis %u cannot stay on the line because its %s would be %.0f, "
+      "which is less than %u.  Its move is too short compared to the others.",
+      (unsigned int)axis_index, name, value, min);
+  }
+  if (value > UINT32_MAX) { value = UINT32_MAX; }
+  *result = (uint32_t)value;
+  return NULL;
+}
+
+// Sets the limits of an axis back to what they were when the group was
+// created.
+static tic_error * tic_axis_restore_limits(const tic_axis * axis)
+{
+  tic_error * error = tic_set_max_speed(axis->handle, axis->max_speed);
+
+  if (error == NULL)
+  {
+    error = tic_set_starting_speed(axis->handle, axis->starting_speed);
+  }
+
+  if (error == NULL)
+  {
+    error = tic_set_max_accel(axis->handle, axis->max_accel);
+  }
+
+  if (error == NULL)
+  {
+    error = tic_set_max_decel(axis->handle, axis->max_decel);
+  }
+
+  return error;
+}
+
+// Predicts how long the move takes, in seconds, using the same trapezoidal
+// profile as tic_motion_profile, for the path parameter going from 0 to 1.
+// The limits are in Tic units per unit of distance.
+static double tic_axis_group_predict_duration(double max_speed,
+  double starting_speed, double accel, double decel)
+{
+  // Convert to units of seconds.
+  max_speed /= 10000;
+  starting_speed /= 10000;
+  accel /= 100;
+  decel /= 100;
+
+  double peak = max_speed;
+  double ramp_distance = (peak * peak - starting_speed * starting_speed) *
+    (1 / (2 * accel) + 1 / (2 * decel));
+  double cruise_time = 0;
+  if (ramp_distance <= 1)
+  {
+    cruise_time = (1 - ramp_distance) / peak;
+  }
+  else
+  {
+    peak = sqrt((2 * accel * decel + (accel + decel) *
+      starting_speed * starting_speed) / (accel + decel));
+  }
+  return (peak - starting_speed) / accel + cruise_time +
+    (peak - starting_speed) / decel;
+}
+
+tic_error * tic_axis_group_move(tic_axis_group * group,
+  const int32_t * target_positions)
+{
+  if (group == NULL)
+  {
+    return tic_error_create("Axis group is null.");
+  }
+
+  if (target_positions == NULL)
+  {
+    return tic_error_create("Target positions pointer is null.");
+  }
+
+  tic_error * error = NULL;
+
+  memset(&group->stats, 0, sizeof(group->stats));
+
+  // Find how far each axis has to go.
+  for (size_t i = 0; error == NULL && i < group->axis_count; i++)
+  {
+    tic_axis * axis = &group->axes[i];
+    error = tic_update_variables(axis->handle, axis->variables, false);
+    if (error != NULL) { break; }
+
+    if (tic_variables_get_current_velocity(axis->variables) != 0)
+    {
+      error = tic_error_create("Axis %u is moving.", (unsigned int)i);
+      break;
+    }
+
+    int64_t start = tic_variables_get_current_position(axis->variables);
+    int64_t distance = (int64_t)target_positions[i] - start;
+    axis->target_position = target_positions[i];
+    axis->distance = (uint32_t)(distance < 0 ? -distance : distance);
+    axis->arrived = axis->distance == 0;
+  }
+
+  // Find the limits of the path parameter.  We use doubles because they are
+  // ratios of the Tic's limits to the distances.
+  double max_speed = INFINITY;
+  double starting_speed = INFINITY;
+  double accel = INFINITY;
+  double decel = INFINITY;
+  size_t moving_count = 0;
+  for (size_t i = 0; error == NULL && i < group->axis_count; i++)
+  {
+    tic_axis * axis = &group->axes[i];
+    if (axis->distance == 0) { continue; }
+    if (axis->max_speed == 0)
+    {
+      error = tic_error_create("Axis %u has a max speed of 0.",
+        (unsigned int)i);
+      break;
+    }
+    moving_count++;
+    double distance = axis->distance;
+    max_speed = fmin(max_speed, axis->max_speed / distance);
+    starting_speed = fmin(starting_speed, axis->starting_speed / distance);
+    accel = fmin(accel, axis->max_accel / distance);
+    uint32_t axis_decel = axis->max_decel ? axis->max_decel : axis->max_accel;
+    decel = fmin(decel, axis_decel / distance);
+  }
+  starting_speed = fmin(starting_speed, max_speed);
+
+  if (error == NULL && moving_count == 0)
+  {
+    // Every axis is already at its target.
+    return NULL;
+  }
+
+  // Work out each axis's share of the limits before changing any of them.
+  for (size_t i = 0; error == NULL && i < group->axis_count; i++)
+  {
+    tic_axis * axis = &group->axes[i];
+    if (axis->distance == 0) { continue; }
+
+    error = tic_axis_group_scale(max_speed, i, axis,
+      "max speed", 1, &axis->move_max_speed);
+
+    if (error == NULL)
+    {
+      error = tic_axis_group_scale(starting_speed, i, axis,
+        "starting speed", 0, &axis->move_starting_speed);
+    }
+
+    if (error == NULL)
+    {
+      error = tic_axis_group_scale(accel, i, axis,
+        "max acceleration", TIC_MIN_ALLOWED_ACCEL, &axis->move_accel);
+    }
+
+    if (error == NULL)
+    {
+      error = tic_axis_group_scale(decel, i, axis,
+        "max deceleration", TIC_MIN_ALLOWED_ACCEL, &axis->move_decel);
+    }
+  }
+
+  // Give each axis its share of the limits.
+  size_t changed_count = 0;
+  for (size_t i = 0; error == NULL && i < group->axis_count; i++)
+  {
+    tic_axis * axis = &group->axes[i];
+    if (axis->distance == 0) { continue; }
+    tic_handle * handle = axis->handle;
+    changed_count = i + 1;
+
+    error = tic_set_max_speed(handle, axis->move_max_speed);
+
+    if (error == NULL)
+    {
+      error = tic_set_starting_speed(handle, axis->move_starting_speed);
+    }
+
+    if (error == NULL)
+    {
+      error = tic_set_max_accel(handle, axis->move_accel);
+    }
+
+    if (error == NULL)
+    {
+      error = tic_set_max_decel(handle, axis->move_decel);
+    }
+  }
+
+  // If we could not change the limits of every axis, put back the ones we
+  // changed so the axes are not left with a mix of limits.
+  if (error != NULL)
+  {
+    for (size_t i = 0; i < changed_count; i++)
+    {
+      tic_axis * axis = &group->axes[i];
+      if (axis->distance == 0) { continue; }
+      tic_error_free(tic_axis_restore_limits(axis));
+    }
+  }
+
+  // Send the targets as close together as we can.  Handles on the same serial
+  // bus will send them all in one write.
+  if (error == NULL)
+  {
+    for (size_t i = 0; i < group->axis_count; i++)
+    {
+      tic_handle_begin_batch(group->axes[i].handle);
+    }
+
+    uint64_t start = tic_poller_get_time_ns();
+    for (size_t i = 0; i < group->axis_count; i++)
+    {
+      tic_axis * axis = &group->axes[i];
+      if (error != NULL || axis->distance == 0) { continue; }
+      error = tic_set_target_position(axis->handle, axis->target_position);
+    }
+
+    for (size_t i = 0; i < group->axis_count; i++)
+    {
+      tic_error * batch_error = tic_handle_end_batch(group->axes[i].handle);
+      if (error == NULL) { error = batch_error; }
+      else { tic_error_free(batch_error); }
+    }
+    uint64_t end = tic_poller_get_time_ns();
+
+    group->move_start_ns = start;
+    group->stats.command_skew_us = (end - start) / 1000;
+    group->stats.predicted_duration_us = (uint64_t)ceil(1000000 *
+      tic_axis_group_predict_duration(max_speed, starting_speed,
+        accel, decel));
+  }
+
+  if (error != NULL)
+  {
+    error = tic_error_add(error,
+      "There was an error starting a coordinated move.");
+  }
+
+  return error;
+}
+
+tic_error * tic_axis_group_wait(tic_axis_group * group, uint32_t timeout_ms)
+{
+  if (group == NULL)
+  {
+    return tic_error_create("Axis group is null.");
+  }
+
+  tic_error * error = NULL;
+
+  uint64_t start = tic_poller_get_time_ns();
+  uint64_t end = start + (uint64_t)timeout_ms * 1000000;
+  uint64_t last_reset = start;
+
+  while (error == NULL)
+  {
+    bool done = true;
+    uint64_t interval = UINT64_MAX;
+    bool keepalive = tic_poller_get_time_ns() - last_reset >=
+      TIC_AXIS_GROUP_KEEPALIVE_NS;
+
+    for (size_t i = 0; error == NULL && i < group->axis_count; i++)
+    {
+      tic_axis * axis = &group->axes[i];
+      if (axis->arrived) { continue; }
+
+      uint64_t read_start = tic_poller_get_time_ns();
+      error = tic_update_variables(axis->handle, axis->variables, false);
+      uint64_t read_end = tic_poller_get_time_ns();
+      if (error != NULL) { break; }
+
+      tic_variables * vars = axis->variables;
+      if (tic_variables_get_error_status(vars))
+      {
+        error = tic_error_create("Axis %u stopped because of an error.",
+          (unsigned int)i);
+        break;
+      }
+
+      if (tic_variables_get_planning_mode(vars) !=
+        TIC_PLANNING_MODE_TARGET_POSITION ||
+        tic_variables_get_target_position(vars) != axis->target_position)
+      {
+        error = tic_error_create(
+          "Axis %u is no longer moving to its target.", (unsigned int)i);
+        break;
+      }
+
+      if (tic_variables_get_current_position(vars) == axis->target_position)
+      {
+        // Like tic_poller, use the midpoint of the transfer as our guess of
+        // when the device sampled its variables.
+        axis->arrived = true;
+        axis->arrival_time_ns = read_start + (read_end - read_start) / 2;
+        continue;
+      }
+
+      done = false;
+      uint64_t axis_interval = tic_wait_get_interval_ns(vars);
+      if (axis_interval < interval) { interval = axis_interval; }
+
+      if (keepalive)
+      {
+        error = tic_reset_command_timeout(axis->handle);
+      }
+    }
+
+    if (error != NULL || done) { break; }
+
+    uint64_t now = tic_poller_get_time_ns();
+    if (keepalive) { last_reset = now; }
+
+    if (timeout_ms != 0)
+    {
+      if (now >= end)
+      {
+        error = tic_error_add_code(tic_error_create(
+          "Timed out after %u ms.", timeout_ms), TIC_ERROR_TIMEOUT);
+        break;
+      }
+      if (now + interval > end) { interval = end - now; }
+    }
+
+    tic_poller_sleep_until(now + interval);
+  }
+
+  if (error == NULL)
+  {
+    uint64_t first = UINT64_MAX, last = 0;
+    for (size_t i = 0; i < group->axis_count; i++)
+    {
+      tic_axis * axis = &group->axes[i];
+      if (axis->distance == 0) { continue; }
+      if (axis->arrival_time_ns < first) { first = axis->arrival_time_ns; }
+      if (axis->arrival_time_ns > last) { last = axis->arrival_time_ns; }
+    }
+    if (last != 0)
+    {
+      group->stats.arrival_skew_us = (last - first) / 1000;
+      group->stats.duration_us = (last - group->move_start_ns) / 1000;
+    }
+  }
+
+  if (error != NULL)
+  {
+    error = tic_error_add(error,
+      "There was an error waiting for a coordinated move.");
+  }
+
+  return error;
+}
+
+tic_error * tic_axis_group_restore_limits(tic_axis_group * group)
+{
+  if (group == NULL)
+  {
+    return tic_error_create("Axis group is null.");
+  }
+
+  tic_error * error = NULL;
+
+  for (size_t i = 0; error == NULL && i < group->axis_count; i++)
+  {
+    error = tic_axis_restore_limits(&group->axes[i]);
+  }
+
+  if (error != NULL)
+  {
+    error = tic_error_add(error,
+      "There was an error restoring the limits of an axis group.");
+  }
+
+  return error;
+}
+
+void tic_axis_group_get_stats(const tic_axis_group * group,
+  tic_axis_group_stats * stats)
+{
+  if (stats == NULL) { return; }
+  memset(stats, 0, sizeof(tic_axis_group_stats));
+  if (group == NULL) { return; }
+  *stats = group->stats;
+}
@@ -34,13 +34,17 @@ tic_error * tic_list_connected_devices(
         &usb_device_list, &usb_device_count));
   }
 
+  size_t emulated_device_count = tic_emulator_get_listed_device_count();
+
   tic_device ** tic_device_list = NULL;
   size_t tic_device_count = 0;
   if (error == NULL)
   {
     // Allocate enough memory for the case where every USB device is
-    // relevant, without forgetting the NULL terminator.
-    tic_device_list = calloc(usb_device_count + 1, sizeof(tic_device *));
+    // relevant, plus the emulated devices, without forgetting the NULL
+    // terminator.
+    tic_device_list = calloc(usb_device_count + emulated_device_count + 1,
+      sizeof(tic_device *));
     if (tic_device_list == NULL)
     {
       error = &tic_error_no_memory;
@@ -145,6 +149,12 @@ tic_error * tic_list_connected_devices(
     }
   }
 
+  for (size_t i = 0; error == NULL && i < emulated_device_count; i++)
+  {
+    error = tic_emulator_create_listed_device(i,
+      &tic_device_list[tic_device_count++]);
+  }
+
   if (error == NULL)
   {
     // Success.  Give the list to the caller.
@@ -198,7 +208,7 @@ tic_error * tic_device_copy(const tic_device * source, tic_device ** dest)
     error = &tic_error_no_memory;
   }
 
-  if (error == NULL)
+  if (error == NULL && source->usb_interface != NULL)
   {
     error = tic_usb_error(libusbp_generic_interface_copy(
         source->usb_interface, &new_device->usb_interface));
@@ -245,6 +255,47 @@ tic_error * tic_device_copy(const tic_device * source, tic_device ** dest)
   return error;
 }
 
+tic_error * tic_device_create_virtual(uint8_t product,
+  uint16_t firmware_version, const char * serial_number, const char * os_id,
+  tic_device ** device)
+{
+  assert(device != NULL);
+  assert(serial_number != NULL);
+  assert(os_id != NULL);
+
+  *device = NULL;
+
+  tic_error * error = NULL;
+
+  tic_device * new_device = calloc(1, sizeof(tic_device));
+  if (new_device == NULL)
+  {
+    error = &tic_error_no_memory;
+  }
+
+  if (error == NULL)
+  {
+    new_device->product = product;
+    new_device->firmware_version = firmware_version;
+    new_device->serial_number = strdup(serial_number);
+    new_device->os_id = strdup(os_id);
+    if (new_device->serial_number == NULL || new_device->os_id == NULL)
+    {
+      error = &tic_error_no_memory;
+    }
+  }
+
+  if (error == NULL)
+  {
+    *device = new_device;
+    new_device = NULL;
+  }
+
+  tic_device_free(new_device);
+
+  return error;
+}
+
 void tic_device_free(tic_device * device)
 {
   if (device != NULL)
@@ -0,0 +1,358 @@
+// Functions for keeping track of which Tic devices are connected without
+// scanning all the USB devices periodically.
+//
+// On Linux, we listen for the kernel's USB hotplug events on a netlink socket.
+// Removal events are matched against the OS IDs of the devices we know about,
+// which are sysfs paths, so they do not require a scan.  Arrival events for a
+// Tic cause us to scan for new devices until the device is ready.
+//
+// On other platforms, or if the netlink socket cannot be opened, every update
+// does a full scan.
+
+#include "tic_internal.h"
+
+#ifdef __linux__
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#endif
+
+// How long to keep scanning for a device after we get an event saying it
+// arrived, in seconds.  The device might not be ready right away.
+#define TIC_DEVICE_MONITOR_ARRIVAL_WINDOW 3
+
+struct tic_device_monitor
+{
+  int netlink_fd;
+  bool scan_needed;
+  size_t pending_arrivals;
+  time_t arrival_deadline;
+  tic_device ** devices;
+  size_t device_count;
+  tic_device_monitor_callback * callback;
+  void * callback_context;
+};
+
+tic_error * tic_device_monitor_create(tic_device_monitor ** monitor)
+{
+  if (monitor == NULL)
+  {
+    return tic_error_create("Device monitor output pointer is null.");
+  }
+
+  *monitor = NULL;
+
+  tic_device_monitor * new_monitor = calloc(1, sizeof(tic_device_monitor));
+  if (new_monitor == NULL)
+  {
+    return &tic_error_no_memory;
+  }
+
+  new_monitor->netlink_fd = -1;
+  new_monitor->scan_needed = true;
+
+#ifdef __linux__
+  int fd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK,
+    NETLINK_KOBJECT_UEVENT);
+  if (fd >= 0)
+  {
+    struct sockaddr_nl address;
+    memset(&address, 0, sizeof(address));
+    address.nl_family = AF_NETLINK;
+    address.nl_groups = 1;  // Kernel events
+    if (bind(fd, (struct sockaddr *)&address, sizeof(address)) == 0)
+    {
+      new_monitor->netlink_fd = fd;
+    }
+    else
+    {
+      // Fall back to scanning on every update.
+      close(fd);
+    }
+  }
+#endif
+
+  *monitor = new_monitor;
+  return NULL;
+}
+
+void tic_device_monitor_free(tic_device_monitor * monitor)
+{
+  if (monitor == NULL) { return; }
+
+  if (monitor->netlink_fd >= 0)
+  {
+    close(monitor->netlink_fd);
+  }
+
+  for (size_t i = 0; i < monitor->device_count; i++)
+  {
+    tic_device_free(monitor->devices[i]);
+  }
+  free(monitor->devices);
+  free(monitor);
+}
+
+void tic_device_monitor_set_callback(tic_device_monitor * monitor,
+  tic_device_monitor_callback * callback, void * context)
+{
+  if (monitor == NULL) { return; }
+  monitor->callback = callback;
+  monitor->callback_context = context;
+}
+
+void tic_device_monitor_request_scan(tic_device_monitor * monitor)
+{
+  if (monitor == NULL) { return; }
+  monitor->scan_needed = true;
+}
+
+int tic_device_monitor_get_fd(const tic_device_monitor * monitor)
+{
+  if (monitor == NULL) { return -1; }
+  return monitor->netlink_fd;
+}
+
+size_t tic_device_monitor_get_device_count(const tic_device_monitor * monitor)
+{
+  if (monitor == NULL) { return 0; }
+  return monitor->device_count;
+}
+
+const tic_device * tic_device_monitor_get_device(
+  const tic_device_monitor * monitor, size_t index)
+{
+  if (monitor == NULL || index >= monitor->device_count) { return NULL; }
+  return monitor->devices[index];
+}
+
+static void tic_device_monitor_remove(tic_device_monitor * monitor,
+  size_t index)
+{
+  tic_device * device = monitor->devices[index];
+  if (monitor->callback != NULL)
+  {
+    monitor->callback(monitor->callback_context, device, false);
+  }
+  tic_device_free(device);
+  memmove(monitor->devices + index, monitor->devices + index + 1,
+    (monitor->device_count - index - 1) * sizeof(tic_device *));
+  monitor->device_count--;
+}
+
+static bool tic_device_list_has_os_id(tic_device ** list, size_t count,
+  const char * os_id)
+{
+  for (size_t i = 0; i < count; i++)
+  {
+    if (strcmp(tic_device_get_os_id(list[i]), os_id) == 0) { return true; }
+  }
+  return false;
+}
+
+// Scans for devices, and replaces our list with the result so that it stays
+// in the order tic_list_connected_devices() uses.  Returns the number of
+// devices that were added in added_count.
+static tic_error * tic_device_monitor_scan(tic_device_monitor * monitor,
+  size_t * added_count, bool * list_changed)
+{
+  *added_count = 0;
+
+  tic_device ** list = NULL;
+  size_t count = 0;
+  tic_error * error = tic_list_connected_devices(&list, &count);
+  if (error != NULL) { return error; }
+
+  // Remove devices that are gone.
+  for (size_t i = 0; i < monitor->device_count; )
+  {
+    if (tic_device_list_has_os_id(list, count,
+        tic_device_get_os_id(monitor->devices[i])))
+    {
+      i++;
+      continue;
+    }
+    tic_device_monitor_remove(monitor, i);
+    *list_changed = true;
+  }
+
+  // Report the devices that are new.
+  for (size_t i = 0; i < count; i++)
+  {
+    tic_device * device = list[i];
+    if (tic_device_list_has_os_id(monitor->devices, monitor->device_count,
+        tic_device_get_os_id(device)))
+    {
+      continue;
+    }
+
+    (*added_count)++;
+    *list_changed = true;
+    if (monitor->callback != NULL)
+    {
+      monitor->callback(monitor->callback_context, device, true);
+    }
+  }
+
+  for (size_t i = 0; i < monitor->device_count; i++)
+  {
+    tic_device_free(monitor->devices[i]);
+  }
+  tic_list_free(monitor->devices);
+  monitor->devices = list;
+  monitor->device_count = count;
+  return NULL;
+}
+
+#ifdef __linux__
+
+static bool tic_usb_product_is_tic(const char * product)
+{
+  unsigned int vendor_id, product_id, revision;
+  if (sscanf(product, "%x/%x/%x", &vendor_id, &product_id, &revision) != 3)
+  {
+    return false;
+  }
+  return vendor_id == TIC_VENDOR_ID && (
+    product_id == TIC_PRODUCT_ID_T825 ||
+    product_id == TIC_PRODUCT_ID_T834 ||
+    product_id == TIC_PRODUCT_ID_T500 ||
+    product_id == TIC_PRODUCT_ID_N825 ||
+    product_id == TIC_PRODUCT_ID_T249);
+}
+
+// Handles one kernel uevent message, which consists of a header followed by
+// null-terminated KEY=VALUE strings.
+static void tic_device_monitor_handle_uevent(tic_device_monitor * monitor,
+  const char * message, size_t length, bool * list_changed)
+{
+  const char * action = "";
+  const char * devpath = "";
+  const char * subsystem = "";
+  const char * devtype = "";
+  const char * product = "";
+
+  for (size_t i = strlen(message) + 1; i < length; i += strlen(message + i) + 1)
+  {
+    const char * entry = message + i;
+    if (strncmp(entry, "ACTION=", 7) == 0) { action = entry + 7; }
+    else if (strncmp(entry, "DEVPATH=", 8) == 0) { devpath = entry + 8; }
+    else if (strncmp(entry, "SUBSYSTEM=", 10) == 0) { subsystem = entry + 10; }
+    else if (strncmp(entry, "DEVTYPE=", 8) == 0) { devtype = entry + 8; }
+    else if (strncmp(entry, "PRODUCT=", 8) == 0) { product = entry + 8; }
+  }
+
+  if (strcmp(subsystem, "usb") || strcmp(devtype, "usb_device")) { return; }
+  if (!tic_usb_product_is_tic(product)) { return; }
+
+  if (strcmp(action, "add") == 0)
+  {
+    monitor->pending_arrivals++;
+    monitor->arrival_deadline = time(0) + TIC_DEVICE_MONITOR_ARRIVAL_WINDOW;
+  }
+  else if (strcmp(action, "remove") == 0)
+  {
+    for (size_t i = 0; i < monitor->device_count; i++)
+    {
+      const char * os_id = tic_device_get_os_id(monitor->devices[i]);
+      if (strncmp(os_id, "/sys", 4) == 0 && strcmp(os_id + 4, devpath) == 0)
+      {
+        tic_device_monitor_remove(monitor, i);
+        *list_changed = true;
+        return;
+      }
+    }
+
+    // We could not find the device by its path, so do a scan to be safe.
+    monitor->scan_needed = true;
+  }
+}
+
+static void tic_device_monitor_read_events(tic_device_monitor * monitor,
+  bool * list_changed)
+{
+  char buffer[8192];
+  while (true)
+  {
+    ssize_t length = recv(monitor->netlink_fd, buffer, sizeof(buffer) - 1,
+      MSG_DONTWAIT);
+    if (length < 0)
+    {
+      if (errno == ENOBUFS)
+      {
+        // We missed some events, so we have to scan.
+        monitor->scan_needed = true;
+        continue;
+      }
+      break;
+    }
+    buffer[length] = 0;
+    tic_device_monitor_handle_uevent(monitor, buffer, length, list_changed);
+  }
+}
+
+#endif
+
+tic_error * tic_device_monitor_update(tic_device_monitor * monitor,
+  bool * list_changed)
+{
+  bool changed = false;
+  if (list_changed != NULL) { *list_changed = false; }
+
+  if (monitor == NULL)
+  {
+    return tic_error_create("Device monitor is null.");
+  }
+
+  bool scan = monitor->scan_needed || monitor->netlink_fd < 0;
+
+#ifdef __linux__
+  if (monitor->netlink_fd >= 0)
+  {
+    tic_device_monitor_read_events(monitor, &changed);
+  }
+#endif
+
+  if (monitor->pending_arrivals)
+  {
+    if (difftime(time(0), monitor->arrival_deadline) > 0)
+    {
+      // Give up on devices that never became ready.
+      monitor->pending_arrivals = 0;
+    }
+    else
+    {
+      scan = true;
+    }
+  }
+
+  if (monitor->scan_needed) { scan = true; }
+
+  tic_error * error = NULL;
+  if (scan)
+  {
+    size_t added_count;
+    error = tic_device_monitor_scan(monitor, &added_count, &changed);
+    if (error == NULL)
+    {
+      monitor->scan_needed = false;
+      if (added_count >= monitor->pending_arrivals)
+      {
+        monitor->pending_arrivals = 0;
+      }
+      else
+      {
+        monitor->pending_arrivals -= added_count;
+      }
+    }
+  }
+
+  if (list_changed != NULL) { *list_changed = changed; }
+
+  if (error != NULL)
+  {
+    error = tic_error_add(error,
+      "There was an error updating the list of devices.");
+  }
+
+  return error;
+}
@@ -0,0 +1,988 @@
+// A software model of a Tic that runs in this process and can be used through
+// a tic_handle like a real device.
+//
+// The emulator keeps an image of the settings stored in the Tic's EEPROM and
+// the state that the Tic reports in its variables.  Time is divided into 1 ms
+// steps, and in each step the motion planner changes the velocity by at most
+// the acceleration or deceleration limit and then moves the position, like the
+// Tic's own planner.  The emulator only catches up to the current time when a
+// request arrives, so idle emulators cost nothing.
+//
+// Devices listed in the TIC_EMULATED_DEVICES environment variable (a comma-
+// separated list of product names like "T825,T249") are returned by
+// tic_list_connected_devices() in addition to the USB devices.  Each of them
+// has an emulator that lasts until the process exits.
+
+#include "tic_internal.h"
+
+#ifdef _WIN32
+#include <windows.h>
+typedef SRWLOCK tic_emulator_mutex;
+#define TIC_EMULATOR_MUTEX_INIT SRWLOCK_INIT
+#define tic_emulator_mutex_lock AcquireSRWLockExclusive
+#define tic_emulator_mutex_unlock ReleaseSRWLockExclusive
+#else
+#include <pthread.h>
+typedef pthread_mutex_t tic_emulator_mutex;
+#define TIC_EMULATOR_MUTEX_INIT PTHREAD_MUTEX_INITIALIZER
+#define tic_emulator_mutex_lock pthread_mutex_lock
+#define tic_emulator_mutex_unlock pthread_mutex_unlock
+#endif
+
+// The firmware version that the emulator reports.
+#define TIC_EMULATOR_FIRMWARE_VERSION 0x0109
+
+// The VIN voltage that the emulator reports, in millivolts.
+#define TIC_EMULATOR_VIN_VOLTAGE 12000
+
+// The most devices that can be listed in TIC_EMULATED_DEVICES.
+#define TIC_EMULATOR_MAX_LISTED_DEVICES 256
+
+// Errors that cause the Tic to de-energize the motor.
+#define TIC_EMULATOR_DEENERGIZING_ERRORS ( \
+  (1 << TIC_ERROR_INTENTIONALLY_DEENERGIZED) | \
+  (1 << TIC_ERROR_MOTOR_DRIVER_ERROR) | \
+  (1 << TIC_ERROR_LOW_VIN))
+
+struct tic_emulator
+{
+  tic_emulator_mutex mutex;
+
+  // One reference from the creator until tic_emulator_free(), and one from
+  // every open handle.
+  size_t reference_count;
+
+  tic_device * device;
+
+  bool manual_time;
+  uint64_t start_us;   // The real time when the emulator was created.
+  uint64_t manual_us;  // The emulated time if manual_time is true.
+
+  uint32_t latency_ns;
+  uint32_t jitter_ns;
+  uint32_t random_state;
+
+  uint8_t settings[TIC_SETTINGS_SIZE];
+
+  // The time of the last planner step and last command, in milliseconds.
+  uint64_t time_ms;
+  uint64_t last_command_ms;
+
+  // The position, in units of 1e-7 microsteps, that has been traveled but is
+  // not yet reflected in current_position.
+  int64_t position_fraction;
+  uint32_t time_since_last_step;
+
+  uint8_t device_reset;
+  uint16_t error_status;
+  uint32_t errors_occurred;
+  bool position_uncertain;
+  uint8_t planning_mode;
+  int32_t target_position;
+  int32_t target_velocity;
+  uint32_t starting_speed;
+  uint32_t max_speed;
+  uint32_t max_decel;
+  uint32_t max_accel;
+  int32_t current_position;
+  int32_t current_velocity;
+  uint8_t step_mode;
+  uint8_t current_limit;
+  uint8_t decay_mode;
+  uint8_t agc[4];
+};
+
+static uint64_t tic_emulator_real_time_us(void)
+{
+  return tic_poller_get_time_ns() / 1000;
+}
+
+static uint32_t tic_emulator_read_u32(const uint8_t * buf)
+{
+  return buf[0] | buf[1] << 8 | buf[2] << 16 | (uint32_t)buf[3] << 24;
+}
+
+static void tic_emulator_write_u16(uint8_t * buf, uint16_t value)
+{
+  buf[0] = value >> 0 & 0xFF;
+  buf[1] = value >> 8 & 0xFF;
+}
+
+static void tic_emulator_write_u32(uint8_t * buf, uint32_t value)
+{
+  buf[0] = value >> 0 & 0xFF;
+  buf[1] = value >> 8 & 0xFF;
+  buf[2] = value >> 16 & 0xFF;
+  buf[3] = value >> 24 & 0xFF;
+}
+
+static uint8_t tic_emulator_product(const tic_emulator * emulator)
+{
+  return tic_device_get_product(emulator->device);
+}
+
+static bool tic_emulator_safe_start_enabled(const tic_emulator * emulator)
+{
+  return emulator->settings[TIC_SETTING_CONTROL_MODE] ==
+    TIC_CONTROL_MODE_SERIAL &&
+    !emulator->settings[TIC_SETTING_DISABLE_SAFE_START];
+}
+
+static bool tic_emulator_step_mode_valid(const tic_emulator * emulator,
+  uint8_t step_mode)
+{
+  switch (tic_emulator_product(emulator))
+  {
+  case TIC_PRODUCT_T500:
+    return step_mode <= TIC_STEP_MODE_MICROSTEP8;
+  case TIC_PRODUCT_T249:
+    return step_mode <= TIC_STEP_MODE_MICROSTEP2_100P;
+  default:
+    return step_mode <= TIC_STEP_MODE_MICROSTEP32;
+  }
+}
+
+static uint32_t tic_emulator_limit_accel(uint32_t accel)
+{
+  if (accel < TIC_MIN_ALLOWED_ACCEL) { return TIC_MIN_ALLOWED_ACCEL; }
+  if (accel > TIC_MAX_ALLOWED_ACCEL) { return TIC_MAX_ALLOWED_ACCEL; }
+  return accel;
+}
+
+static uint32_t tic_emulator_limit_speed(uint32_t speed)
+{
+  if (speed > TIC_MAX_ALLOWED_SPEED) { return TIC_MAX_ALLOWED_SPEED; }
+  return speed;
+}
+
+static void tic_emulator_halt(tic_emulator * emulator)
+{
+  emulator->current_velocity = 0;
+  emulator->position_fraction = 0;
+  emulator->position_uncertain = true;
+}
+
+static void tic_emulator_set_error(tic_emulator * emulator, uint8_t error)
+{
+  uint16_t bit = 1 << error;
+  emulator->errors_occurred |= bit;
+  if (emulator->error_status & bit) { return; }
+  emulator->error_status |= bit;
+
+  // An error makes the Tic forget the last movement command.
+  emulator->planning_mode = TIC_PLANNING_MODE_OFF;
+
+  uint8_t response = emulator->settings[TIC_SETTING_SOFT_ERROR_RESPONSE];
+  if ((bit & TIC_EMULATOR_DEENERGIZING_ERRORS) ||
+    response == TIC_RESPONSE_DEENERGIZE ||
+    response == TIC_RESPONSE_HALT_AND_HOLD)
+  {
+    tic_emulator_halt(emulator);
+  }
+}
+
+static void tic_emulator_clear_error(tic_emulator * emulator, uint8_t error)
+{
+  emulator->error_status &= ~(1 << error);
+}
+
+// Loads the motion parameters from the settings, like the Tic does when it
+// starts up or reinitializes.
+static void tic_emulator_apply_settings(tic_emulator * emulator)
+{
+  const uint8_t * s = emulator->settings;
+  emulator->starting_speed = tic_emulator_limit_speed(
+    tic_emulator_read_u32(s + TIC_SETTING_STARTING_SPEED));
+  emulator->max_speed = tic_emulator_limit_speed(
+    tic_emulator_read_u32(s + TIC_SETTING_MAX_SPEED));
+  emulator->max_accel = tic_emulator_limit_accel(
+    tic_emulator_read_u32(s + TIC_SETTING_MAX_ACCEL));
+  emulator->max_decel = tic_emulator_read_u32(s + TIC_SETTING_MAX_DECEL);
+  if (emulator->max_decel != 0)
+  {
+    emulator->max_decel = tic_emulator_limit_accel(emulator->max_decel);
+  }
+  emulator->step_mode = s[TIC_SETTING_STEP_MODE];
+  emulator->current_limit = s[TIC_SETTING_CURRENT_LIMIT];
+  emulator->decay_mode = s[TIC_SETTING_DECAY_MODE];
+  emulator->agc[0] = s[TIC_SETTING_AGC_MODE];
+  emulator->agc[1] = s[TIC_SETTING_AGC_BOTTOM_CURRENT_LIMIT];
+  emulator->agc[2] = s[TIC_SETTING_AGC_CURRENT_BOOST_STEPS];
+  emulator->agc[3] = s[TIC_SETTING_AGC_FREQUENCY_LIMIT];
+}
+
+static tic_error * tic_emulator_restore_default_settings(
+  tic_emulator * emulator)
+{
+  tic_settings * settings = NULL;
+  tic_error * error = tic_settings_create(&settings);
+  if (error == NULL)
+  {
+    tic_settings_set_product(settings, tic_emulator_product(emulator));
+    tic_settings_set_firmware_version(settings,
+      tic_device_get_firmware_version(emulator->device));
+    tic_settings_fill_with_defaults(settings);
+    memset(emulator->settings, 0, sizeof(emulator->settings));
+    tic_write_settings_to_buffer(settings, emulator->settings);
+  }
+  tic_settings_free(settings);
+  return error;
+}
+
+// Puts the emulator in the state the Tic is in after a reset.
+static void tic_emulator_reset(tic_emulator * emulator, uint8_t reset_cause)
+{
+  tic_emulator_apply_settings(emulator);
+  tic_emulator_halt(emulator);
+  emulator->device_reset = reset_cause;
+  emulator->error_status = 0;
+  emulator->errors_occurred = 0;
+  emulator->planning_mode = TIC_PLANNING_MODE_OFF;
+  emulator->last_command_ms = emulator->time_ms;
+  if (tic_emulator_safe_start_enabled(emulator))
+  {
+    tic_emulator_set_error(emulator, TIC_ERROR_SAFE_START_VIOLATION);
+  }
+}
+
+// Returns true if the motor will not move until something changes.
+static bool tic_emulator_idle(const tic_emulator * emulator)
+{
+  if (emulator->current_velocity != 0) { return false; }
+  if (emulator->error_status) { return true; }
+  switch (emulator->planning_mode)
+  {
+  case TIC_PLANNING_MODE_TARGET_POSITION:
+    return emulator->current_position == emulator->target_position;
+  case TIC_PLANNING_MODE_TARGET_VELOCITY:
+    return emulator->target_velocity == 0;
+  default:
+    return true;
+  }
+}
+
+// Returns the velocity the planner is trying to reach.
+static int64_t tic_emulator_desired_velocity(tic_emulator * emulator)
+{
+  if (emulator->error_status) { return 0; }
+
+  int64_t max_speed = emulator->max_speed;
+
+  if (emulator->planning_mode == TIC_PLANNING_MODE_TARGET_VELOCITY)
+  {
+    int64_t target = emulator->target_velocity;
+    if (target > max_speed) { return max_speed; }
+    if (target < -max_speed) { return -max_speed; }
+    return target;
+  }
+
+  if (emulator->planning_mode != TIC_PLANNING_MODE_TARGET_POSITION)
+  {
+    return 0;
+  }
+
+  int64_t remaining = (int64_t)emulator->target_position -
+    emulator->current_position;
+  int64_t velocity = emulator->current_velocity;
+  int64_t speed = velocity < 0 ? -velocity : velocity;
+  int64_t direction = remaining > 0 ? 1 : -1;
+
+  if (velocity * direction < 0)
+  {
+    // Moving away from the target, so slow down first.
+    return 0;
+  }
+
+  // Distance in microsteps needed to slow down to the starting speed:
+  // (v^2 - s^2) / (2 * a), converting from the Tic's speed units
+  // (microsteps per 10000 s) and acceleration units (microsteps per 100 s^2).
+  // Add the distance traveled in one step to account for our time resolution.
+  int64_t starting_speed = emulator->starting_speed;
+  int64_t decel = emulator->max_decel ? emulator->max_decel :
+    emulator->max_accel;
+  int64_t stopping_distance = speed / 10000000;
+  if (speed > starting_speed)
+  {
+    stopping_distance += (speed * speed - starting_speed * starting_speed) /
+      (2000000 * decel);
+  }
+
+  int64_t distance = remaining < 0 ? -remaining : remaining;
+  if (stopping_distance >= distance)
+  {
+    return 0;
+  }
+  return direction * max_speed;
+}
+
+// Advances the emulator by one millisecond.
+static void tic_emulator_step(tic_emulator * emulator)
+{
+  emulator->time_ms++;
+
+  int64_t velocity = emulator->current_velocity;
+  int64_t desired = tic_emulator_desired_velocity(emulator);
+  int64_t speed = velocity < 0 ? -velocity : velocity;
+  int64_t starting_speed = emulator->starting_speed;
+
+  // Accelerations are in units of (microsteps per 10000 s) per 100 ms, so
+  // dividing by 10 gives the velocity change per millisecond.
+  int64_t accel = emulator->max_accel / 10;
+  int64_t decel = (emulator->max_decel ? emulator->max_decel :
+    emulator->max_accel) / 10;
+
+  if ((velocity >= 0 && desired > velocity) ||
+    (velocity <= 0 && desired < velocity))
+  {
+    // Speed up.  Below the starting speed, the Tic can change the speed
+    // instantly.
+    if (desired > velocity)
+    {
+      velocity = speed < starting_speed ? starting_speed : velocity + accel;
+      if (velocity > desired) { velocity = desired; }
+    }
+    else
+    {
+      velocity = speed < starting_speed ? -starting_speed : velocity - accel;
+      if (velocity < desired) { velocity = desired; }
+    }
+  }
+  else if (desired != velocity)
+  {
+    // Slow down, possibly to stop before reversing.
+    int64_t floor = desired * velocity > 0 ? desired : 0;
+    if (speed <= starting_speed)
+    {
+      velocity = floor;
+    }
+    else if (velocity > 0)
+    {
+      velocity -= decel;
+      if (velocity < floor) { velocity = floor; }
+    }
+    else
+    {
+      velocity += decel;
+      if (velocity > floor) { velocity = floor; }
+    }
+  }
+
+  emulator->current_velocity = velocity;
+
+  // Move, in units of 1e-7 microsteps.
+  emulator->position_fraction += velocity;
+  int64_t steps = emulator->position_fraction / 10000000;
+  emulator->position_fraction -= steps * 10000000;
+
+  int64_t old_position = emulator->current_position;
+  int64_t new_position = old_position + steps;
+  if (emulator->planning_mode == TIC_PLANNING_MODE_TARGET_POSITION)
+  {
+    // Stop exactly at the target.
+    int64_t target = emulator->target_position;
+    if ((old_position < target && new_position >= target) ||
+      (old_position > target && new_position <= target) ||
+      (new_position == target && velocity * velocity <=
+        starting_speed * starting_speed))
+    {
+      new_position = target;
+      emulator->current_velocity = 0;
+      emulator->position_fraction = 0;
+    }
+  }
+  emulator->current_position = (int32_t)new_position;
+
+  if (steps != 0)
+  {
+    emulator->time_since_last_step = 0;
+  }
+}
+
+// Advances the emulator to the current time.
+static void tic_emulator_update(tic_emulator * emulator)
+{
+  uint64_t now_ms;
+  if (emulator->manual_time)
+  {
+    now_ms = emulator->manual_us / 1000;
+  }
+  else
+  {
+    now_ms = (tic_emulator_real_time_us() - emulator->start_us) / 1000;
+  }
+
+  uint16_t command_timeout = emulator->settings[TIC_SETTING_COMMAND_TIMEOUT] |
+    emulator->settings[TIC_SETTING_COMMAND_TIMEOUT + 1] << 8;
+  bool timeout_enabled = command_timeout != 0 &&
+    emulator->settings[TIC_SETTING_CONTROL_MODE] == TIC_CONTROL_MODE_SERIAL;
+
+  while (emulator->time_ms < now_ms)
+  {
+    uint64_t timeout_ms = emulator->last_command_ms + command_timeout;
+    if (timeout_enabled && emulator->time_ms >= timeout_ms)
+    {
+      tic_emulator_set_error(emulator, TIC_ERROR_COMMAND_TIMEOUT);
+    }
+
+    if (tic_emulator_idle(emulator))
+    {
+      // Skip ahead, but stop when the command timeout expires.
+      uint64_t end = now_ms;
+      if (timeout_enabled && timeout_ms > emulator->time_ms &&
+        timeout_ms < end)
+      {
+        end = timeout_ms;
+      }
+      uint64_t elapsed = end - emulator->time_ms;
+      emulator->time_ms = end;
+      emulator->time_since_last_step += elapsed * 3000;
+      continue;
+    }
+
+    emulator->time_since_last_step += 3000;
+    tic_emulator_step(emulator);
+  }
+}
+
+static void tic_emulator_write_variables(const tic_emulator * emulator,
+  uint8_t * buf)
+{
+  memset(buf, 0, TIC_VARIABLES_SIZE);
+
+  uint8_t operation_state = TIC_OPERATION_STATE_NORMAL;
+  bool energized = true;
+  if (emulator->error_status & TIC_EMULATOR_DEENERGIZING_ERRORS)
+  {
+    operation_state = TIC_OPERATION_STATE_DEENERGIZED;
+    energized = false;
+  }
+  else if (emulator->error_status)
+  {
+    operation_state = TIC_OPERATION_STATE_SOFT_ERROR;
+  }
+
+  int32_t acting_target_position = emulator->current_position;
+  if (emulator->planning_mode == TIC_PLANNING_MODE_TARGET_POSITION &&
+    !emulator->error_status)
+  {
+    acting_target_position = emulator->target_position;
+  }
+
+  buf[TIC_VAR_OPERATION_STATE] = operation_state;
+  buf[TIC_VAR_MISC_FLAGS1] =
+    energized << TIC_MISC_FLAGS1_ENERGIZED |
+    emulator->position_uncertain << TIC_MISC_FLAGS1_POSITION_UNCERTAIN;
+  tic_emulator_write_u16(buf + TIC_VAR_ERROR_STATUS, emulator->error_status);
+  tic_emulator_write_u32(buf + TIC_VAR_ERRORS_OCCURRED,
+    emulator->errors_occurred);
+  buf[TIC_VAR_PLANNING_MODE] = emulator->planning_mode;
+  tic_emulator_write_u32(buf + TIC_VAR_TARGET_POSITION,
+    emulator->target_position);
+  tic_emulator_write_u32(buf + TIC_VAR_TARGET_VELOCITY,
+    emulator->target_velocity);
+  tic_emulator_write_u32(buf + TIC_VAR_STARTING_SPEED,
+    emulator->starting_speed);
+  tic_emulator_write_u32(buf + TIC_VAR_MAX_SPEED, emulator->max_speed);
+  tic_emulator_write_u32(buf + TIC_VAR_MAX_DECEL, emulator->max_decel);
+  tic_emulator_write_u32(buf + TIC_VAR_MAX_ACCEL, emulator->max_accel);
+  tic_emulator_write_u32(buf + TIC_VAR_CURRENT_POSITION,
+    emulator->current_position);
+  tic_emulator_write_u32(buf + TIC_VAR_CURRENT_VELOCITY,
+    emulator->current_velocity);
+  tic_emulator_write_u32(buf + TIC_VAR_ACTING_TARGET_POSITION,
+    acting_target_position);
+  tic_emulator_write_u32(buf + TIC_VAR_TIME_SINCE_LAST_STEP,
+    emulator->time_since_last_step);
+  buf[TIC_VAR_DEVICE_RESET] = emulator->device_reset;
+  tic_emulator_write_u16(buf + TIC_VAR_VIN_VOLTAGE, TIC_EMULATOR_VIN_VOLTAGE);
+  tic_emulator_write_u32(buf + TIC_VAR_UP_TIME, emulator->time_ms);
+  buf[TIC_VAR_STEP_MODE] = emulator->step_mode;
+  buf[TIC_VAR_CURRENT_LIMIT] = emulator->current_limit;
+  buf[TIC_VAR_DECAY_MODE] = emulator->decay_mode;
+  memcpy(buf + TIC_VAR_AGC_MODE, emulator->agc, sizeof(emulator->agc));
+}
+
+// Waits for the simulated request latency.
+static void tic_emulator_delay(tic_emulator * emulator)
+{
+  uint64_t delay = emulator->latency_ns;
+  if (delay == 0) { return; }
+  if (emulator->jitter_ns)
+  {
+    emulator->random_state = emulator->random_state * 1103515245 + 12345;
+    delay += (emulator->random_state >> 8) % (emulator->jitter_ns + 1);
+  }
+
+  // Busy-wait so that the latency is accurate even when it is short.
+  uint64_t end = tic_poller_get_time_ns() + delay;
+  while (tic_poller_get_time_ns() < end) { }
+}
+
+static tic_error * tic_emulator_handle_write(tic_emulator * emulator,
+  uint8_t request, uint16_t value, uint16_t index)
+{
+  int32_t value32 = (int32_t)((uint32_t)index << 16 | value);
+
+  emulator->last_command_ms = emulator->time_ms;
+  if (request != TIC_CMD_SET_SETTING && request != TIC_CMD_REINITIALIZE)
+  {
+    tic_emulator_clear_error(emulator, TIC_ERROR_COMMAND_TIMEOUT);
+  }
+
+  switch (request)
+  {
+  case TIC_CMD_SET_TARGET_POSITION:
+    emulator->planning_mode = TIC_PLANNING_MODE_TARGET_POSITION;
+    emulator->target_position = value32;
+    break;
+
+  case TIC_CMD_SET_TARGET_VELOCITY:
+    emulator->planning_mode = TIC_PLANNING_MODE_TARGET_VELOCITY;
+    emulator->target_velocity = value32;
+    break;
+
+  case TIC_CMD_HALT_AND_SET_POSITION:
+    tic_emulator_halt(emulator);
+    emulator->planning_mode = TIC_PLANNING_MODE_OFF;
+    emulator->current_position = value32;
+    emulator->position_uncertain = false;
+    break;
+
+  case TIC_CMD_HALT_AND_HOLD:
+    tic_emulator_halt(emulator);
+    emulator->planning_mode = TIC_PLANNING_MODE_OFF;
+    break;
+
+  case TIC_CMD_GO_HOME:
+    // The emulator has no limit switches, so homing finishes immediately.
+    tic_emulator_halt(emulator);
+    emulator->planning_mode = TIC_PLANNING_MODE_OFF;
+    emulator->current_position = 0;
+    emulator->position_uncertain = false;
+    break;
+
+  case TIC_CMD_RESET_COMMAND_TIMEOUT:
+    break;
+
+  case TIC_CMD_DEENERGIZE:
+    tic_emulator_set_error(emulator, TIC_ERROR_INTENTIONALLY_DEENERGIZED);
+    break;
+
+  case TIC_CMD_ENERGIZE:
+    tic_emulator_clear_error(emulator, TIC_ERROR_INTENTIONALLY_DEENERGIZED);
+    break;
+
+  case TIC_CMD_EXIT_SAFE_START:
+    tic_emulator_clear_error(emulator, TIC_ERROR_SAFE_START_VIOLATION);
+    break;
+
+  case TIC_CMD_ENTER_SAFE_START:
+    if (tic_emulator_safe_start_enabled(emulator))
+    {
+      tic_emulator_set_error(emulator, TIC_ERROR_SAFE_START_VIOLATION);
+    }
+    break;
+
+  case TIC_CMD_RESET:
+    tic_emulator_reset(emulator, TIC_RESET_SOFTWARE);
+    break;
+
+  case TIC_CMD_CLEAR_DRIVER_ERROR:
+    tic_emulator_clear_error(emulator, TIC_ERROR_MOTOR_DRIVER_ERROR);
+    break;
+
+  case TIC_CMD_SET_MAX_SPEED:
+    emulator->max_speed = tic_emulator_limit_speed(value32);
+    break;
+
+  case TIC_CMD_SET_STARTING_SPEED:
+    emulator->starting_speed = tic_emulator_limit_speed(value32);
+    break;
+
+  case TIC_CMD_SET_MAX_ACCEL:
+    emulator->max_accel = tic_emulator_limit_accel(value32);
+    break;
+
+  case TIC_CMD_SET_MAX_DECEL:
+    emulator->max_decel = value32 ? tic_emulator_limit_accel(value32) : 0;
+    break;
+
+  case TIC_CMD_SET_STEP_MODE:
+    if (tic_emulator_step_mode_valid(emulator, value))
+    {
+      emulator->step_mode = value;
+    }
+    break;
+
+  case TIC_CMD_SET_CURRENT_LIMIT:
+    emulator->current_limit = value;
+    break;
+
+  case TIC_CMD_SET_DECAY_MODE:
+    emulator->decay_mode = value;
+    break;
+
+  case TIC_CMD_SET_AGC_OPTION:
+    if ((value >> 4 & 7) < sizeof(emulator->agc))
+    {
+      emulator->agc[value >> 4 & 7] = value & 0x0F;
+    }
+    break;
+
+  case TIC_CMD_SET_SETTING:
+    if (index >= TIC_SETTINGS_SIZE)
+    {
+      return tic_transport_error_create(0,
+        "Invalid setting address 0x%x.", index);
+    }
+    emulator->settings[index] = value;
+    break;
+
+  case TIC_CMD_REINITIALIZE:
+    if (emulator->settings[TIC_SETTING_NOT_INITIALIZED])
+    {
+      tic_error * error = tic_emulator_restore_default_settings(emulator);
+      if (error != NULL) { return error; }
+    }
+    tic_emulator_apply_settings(emulator);
+    break;
+
+  default:
+    return tic_transport_error_create(0,
+      "The emulator does not support request 0x%x.", request);
+  }
+
+  return NULL;
+}
+
+static tic_error * tic_emulator_write(void * context,
+  uint8_t request, uint16_t value, uint16_t index)
+{
+  tic_emulator * emulator = context;
+  tic_emulator_delay(emulator);
+
+  tic_emulator_mutex_lock(&emulator->mutex);
+  tic_emulator_update(emulator);
+  tic_error * error = tic_emulator_handle_write(emulator,
+    request, value, index);
+  tic_emulator_mutex_unlock(&emulator->mutex);
+  return error;
+}
+
+static tic_error * tic_emulator_read(void * context,
+  uint8_t request, uint16_t value, uint16_t index,
+  uint8_t * buffer, size_t length, size_t * transferred)
+{
+  (void)value;
+  tic_emulator * emulator = context;
+  tic_emulator_delay(emulator);
+
+  if (transferred != NULL) { *transferred = 0; }
+
+  tic_emulator_mutex_lock(&emulator->mutex);
+  tic_emulator_update(emulator);
+
+  tic_error * error = NULL;
+  uint8_t variables[TIC_VARIABLES_SIZE];
+  const uint8_t * image = NULL;
+  size_t image_size = 0;
+
+  switch (request)
+  {
+  case TIC_CMD_GET_VARIABLE:
+  case TIC_CMD_GET_VARIABLE_AND_CLEAR_ERRORS_OCCURRED:
+    tic_emulator_write_variables(emulator, variables);
+    image = variables;
+    image_size = sizeof(variables);
+    if (request == TIC_CMD_GET_VARIABLE_AND_CLEAR_ERRORS_OCCURRED)
+    {
+      emulator->errors_occurred = 0;
+    }
+    break;
+
+  case TIC_CMD_GET_SETTING:
+    image = emulator->settings;
+    image_size = sizeof(emulator->settings);
+    break;
+
+  case TIC_CMD_GET_DEBUG_DATA:
+    // The emulator has no debug data.
+    break;
+
+  default:
+    error = tic_transport_error_create(0,
+      "The emulator does not support request 0x%x.", request);
+    break;
+  }
+
+  if (error == NULL && image != NULL)
+  {
+    if (index + length > image_size)
+    {
+      error = tic_transport_error_create(0,
+        "Invalid read of %u bytes at offset 0x%x.",
+        (unsigned int)length, index);
+    }
+    else
+    {
+      memcpy(buffer, image + index, length);
+      if (transferred != NULL) { *transferred = length; }
+    }
+  }
+
+  tic_emulator_mutex_unlock(&emulator->mutex);
+  return error;
+}
+
+static void tic_emulator_release(void * context)
+{
+  tic_emulator * emulator = context;
+  tic_emulator_mutex_lock(&emulator->mutex);
+  bool last = --emulator->reference_count == 0;
+  tic_emulator_mutex_unlock(&emulator->mutex);
+  if (!last) { return; }
+
+#ifndef _WIN32
+  pthread_mutex_destroy(&emulator->mutex);
+#endif
+  tic_device_free(emulator->device);
+  free(emulator);
+}
+
+static const tic_transport tic_emulator_transport = {
+  .name = "emulator",
+  .write = tic_emulator_write,
+  .read = tic_emulator_read,
+  .close = tic_emulator_release,
+};
+
+static tic_error * tic_emulator_create_with_id(uint8_t product,
+  const char * serial_number, const char * os_id, tic_emulator ** emulator)
+{
+  assert(emulator != NULL);
+
+  *emulator = NULL;
+
+  if (tic_look_up_product_name_short(product)[0] == 0)
+  {
+    return tic_error_create("Invalid product code: %u.", product);
+  }
+
+  tic_error * error = NULL;
+
+  tic_emulator * new_emulator = calloc(1, sizeof(tic_emulator));
+  if (new_emulator == NULL)
+  {
+    return &tic_error_no_memory;
+  }
+
+  tic_emulator_mutex mutex = TIC_EMULATOR_MUTEX_INIT;
+  new_emulator->mutex = mutex;
+  new_emulator->reference_count = 1;
+  new_emulator->start_us = tic_emulator_real_time_us();
+  new_emulator->random_state = 1;
+
+  error = tic_device_create_virtual(product, TIC_EMULATOR_FIRMWARE_VERSION,
+    serial_number ? serial_number : "", os_id, &new_emulator->device);
+
+  if (error == NULL)
+  {
+    error = tic_emulator_restore_default_settings(new_emulator);
+  }
+
+  if (error == NULL)
+  {
+    tic_emulator_reset(new_emulator, TIC_RESET_POWER_UP);
+    *emulator = new_emulator;
+    new_emulator = NULL;
+  }
+
+  if (new_emulator != NULL) { tic_emulator_release(new_emulator); }
+
+  return error;
+}
+
+tic_error * tic_emulator_create(uint8_t product, const char * serial_number,
+  tic_emulator ** emulator)
+{
+  if (emulator == NULL)
+  {
+    return tic_error_create("Emulator output pointer is null.");
+  }
+
+  return tic_emulator_create_with_id(product, serial_number,
+    tic_emulator_transport.name, emulator);
+}
+
+void tic_emulator_free(tic_emulator * emulator)
+{
+  if (emulator != NULL) { tic_emulator_release(emulator); }
+}
+
+tic_error * tic_emulator_open_handle(tic_emulator * emulator,
+  tic_handle ** handle)
+{
+  if (handle == NULL)
+  {
+    return tic_error_create("Handle output pointer is null.");
+  }
+
+  *handle = NULL;
+
+  if (emulator == NULL)
+  {
+    return tic_error_create("Emulator is null.");
+  }
+
+  tic_emulator_mutex_lock(&emulator->mutex);
+  emulator->reference_count++;
+  tic_emulator_mutex_unlock(&emulator->mutex);
+
+  // This takes the reference we just added.
+  return tic_handle_open_virtual(&tic_emulator_transport, emulator,
+    emulator->device, handle);
+}
+
+void tic_emulator_set_manual_time(tic_emulator * emulator, bool manual)
+{
+  if (emulator == NULL) { return; }
+  tic_emulator_mutex_lock(&emulator->mutex);
+  tic_emulator_update(emulator);
+  if (manual)
+  {
+    emulator->manual_us = emulator->time_ms * 1000;
+  }
+  else
+  {
+    emulator->start_us = tic_emulator_real_time_us() -
+      emulator->time_ms * 1000;
+  }
+  emulator->manual_time = manual;
+  tic_emulator_mutex_unlock(&emulator->mutex);
+}
+
+void tic_emulator_advance_time(tic_emulator * emulator, uint32_t microseconds)
+{
+  if (emulator == NULL) { return; }
+  tic_emulator_mutex_lock(&emulator->mutex);
+  if (emulator->manual_time)
+  {
+    emulator->manual_us += microseconds;
+    tic_emulator_update(emulator);
+  }
+  tic_emulator_mutex_unlock(&emulator->mutex);
+}
+
+void tic_emulator_set_latency(tic_emulator * emulator,
+  uint32_t latency_us, uint32_t jitter_us)
+{
+  if (emulator == NULL) { return; }
+  tic_emulator_mutex_lock(&emulator->mutex);
+  emulator->latency_ns = latency_us * 1000;
+  emulator->jitter_ns = jitter_us * 1000;
+  tic_emulator_mutex_unlock(&emulator->mutex);
+}
+
+// Parses TIC_EMULATED_DEVICES and returns the product code of each listed
+// device.  Unknown product names are ignored.
+static size_t tic_emulator_get_listed_products(uint8_t * products)
+{
+  const char * list = getenv("TIC_EMULATED_DEVICES");
+  if (list == NULL) { return 0; }
+
+  static const uint8_t known_products[] = {
+    TIC_PRODUCT_T825,
+    TIC_PRODUCT_T834,
+    TIC_PRODUCT_T500,
+    TIC_PRODUCT_N825,
+    TIC_PRODUCT_T249,
+  };
+
+  size_t count = 0;
+  while (*list && count < TIC_EMULATOR_MAX_LISTED_DEVICES)
+  {
+    size_t length = strcspn(list, ",");
+    for (size_t i = 0; i < sizeof(known_products); i++)
+    {
+      const char * name = tic_look_up_product_name_short(known_products[i]);
+      if (strlen(name) == length && memcmp(name, list, length) == 0)
+      {
+        products[count++] = known_products[i];
+        break;
+      }
+    }
+    list += length;
+    if (*list == ',') { list++; }
+  }
+  return count;
+}
+
+size_t tic_emulator_get_listed_device_count(void)
+{
+  uint8_t products[TIC_EMULATOR_MAX_LISTED_DEVICES];
+  return tic_emulator_get_listed_products(products);
+}
+
+static void tic_emulator_listed_ids(size_t index,
+  char * serial_number, char * os_id)
+{
+  sprintf(serial_number, "EMU%05u", (unsigned int)index + 1);
+  sprintf(os_id, "emulator:%u", (unsigned int)index + 1);
+}
+
+tic_error * tic_emulator_create_listed_device(size_t index,
+  tic_device ** device)
+{
+  uint8_t products[TIC_EMULATOR_MAX_LISTED_DEVICES];
+  size_t count = tic_emulator_get_listed_products(products);
+  assert(index < count);
+  (void)count;
+
+  char serial_number[16], os_id[32];
+  tic_emulator_listed_ids(index, serial_number, os_id);
+  return tic_device_create_virtual(products[index],
+    TIC_EMULATOR_FIRMWARE_VERSION, serial_number, os_id, device);
+}
+
+tic_error * tic_emulator_open_listed_device(const tic_device * device,
+  tic_handle ** handle)
+{
+  static tic_emulator_mutex listed_mutex = TIC_EMULATOR_MUTEX_INIT;
+  static tic_emulator * listed[TIC_EMULATOR_MAX_LISTED_DEVICES];
+
+  if (handle == NULL)
+  {
+    return tic_error_create("Handle output pointer is null.");
+  }
+
+  *handle = NULL;
+
+  unsigned int number = 0;
+  const char * os_id = tic_device_get_os_id(device);
+  if (sscanf(os_id, "emulator:%u", &number) != 1 || number == 0 ||
+    number > TIC_EMULATOR_MAX_LISTED_DEVICES)
+  {
+    return tic_error_create("The device is not a USB device.");
+  }
+  size_t index = number - 1;
+
+  tic_error * error = NULL;
+
+  tic_emulator_mutex_lock(&listed_mutex);
+  if (listed[index] == NULL)
+  {
+    char serial_number[16], listed_os_id[32];
+    tic_emulator_listed_ids(index, serial_number, listed_os_id);
+    error = tic_emulator_create_with_id(tic_device_get_product(device),
+      serial_number, listed_os_id, &listed[index]);
+  }
+  tic_emulator * emulator = listed[index];
+  tic_emulator_mutex_unlock(&listed_mutex);
+
+  if (error == NULL)
+  {
+    error = tic_emulator_open_handle(emulator, handle);
+  }
+
+  return error;
+}
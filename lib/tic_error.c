@@ -8,12 +8,25 @@
 #endif
 #endif
 
+// The most messages that can be added to an error with tic_error_add_static()
+// before its message gets built.
+#define TIC_ERROR_MAX_STATIC_MESSAGES 4
+
 struct tic_error
 {
   bool do_not_free;
   char * message;
   size_t code_count;
   uint32_t * code_array;
+
+  // Callers that just retry a command when it fails never look at the
+  // message, so errors from USB transfers build it lazily.  Until it is built,
+  // the innermost message comes from usb_error (or message if usb_error is
+  // NULL), and the outer messages are string literals in static_messages,
+  // ordered from innermost to outermost.
+  libusbp_error * usb_error;
+  size_t static_message_count;
+  const char * static_messages[TIC_ERROR_MAX_STATIC_MESSAGES];
 };
 
 static uint32_t tic_mem_error_code_array[1] = { TIC_ERROR_MEMORY };
@@ -52,17 +65,95 @@ void tic_error_free(tic_error * error)
   {
     free(error->message);
     free(error->code_array);
+    libusbp_error_free(error->usb_error);
     free(error);
   }
 }
 
+static bool tic_error_is_lazy(const tic_error * error)
+{
+  return error->usb_error != NULL || error->static_message_count != 0;
+}
+
+// Assembles the full message of a lazy error.  Returns NULL if memory cannot
+// be allocated.
+static char * tic_error_build_message(const tic_error * error)
+{
+  const char * parts[TIC_ERROR_MAX_STATIC_MESSAGES + 1];
+  size_t part_count = 0;
+  for (size_t i = error->static_message_count; i > 0; i--)
+  {
+    parts[part_count++] = error->static_messages[i - 1];
+  }
+  if (error->usb_error != NULL)
+  {
+    parts[part_count++] = libusbp_error_get_message(error->usb_error);
+  }
+  else if (error->message != NULL)
+  {
+    parts[part_count++] = error->message;
+  }
+
+  size_t message_length = 0;
+  for (size_t i = 0; i < part_count; i++)
+  {
+    size_t length = strlen(parts[i]);
+    if (length && message_length) { message_length += 2; }
+    message_length += length;
+  }
+
+  char * message = malloc(message_length + 1);
+  if (message == NULL) { return NULL; }
+
+  size_t index = 0;
+  for (size_t i = 0; i < part_count; i++)
+  {
+    size_t length = strlen(parts[i]);
+    if (length == 0) { continue; }
+    if (index)
+    {
+      message[index++] = ' ';
+      message[index++] = ' ';
+    }
+    memcpy(message + index, parts[i], length);
+    index += length;
+  }
+  message[index] = 0;
+  return message;
+}
+
+// Replaces the lazy parts of the error with a built message.  Returns false if
+// memory cannot be allocated, in which case the error is unchanged.
+static bool tic_error_finish_message(tic_error * error)
+{
+  if (!tic_error_is_lazy(error)) { return true; }
+
+  char * message = tic_error_build_message(error);
+  if (message == NULL) { return false; }
+
+  free(error->message);
+  error->message = message;
+  libusbp_error_free(error->usb_error);
+  error->usb_error = NULL;
+  error->static_message_count = 0;
+  return true;
+}
+
 // Copies the error.  If the input is not NULL, the output will always
 // be not NULL, but it might be a immutable error (do_not_free=1).
 tic_error * tic_error_copy(const tic_error * src_error)
 {
   if (src_error == NULL) { return NULL; }
 
+  char * built_message = NULL;
+  if (tic_error_is_lazy(src_error))
+  {
+    built_message = tic_error_build_message(src_error);
+    if (built_message == NULL) { return &tic_error_masked_by_no_memory; }
+  }
+
   const char * src_message = src_error->message;
+  if (built_message != NULL) { src_message = built_message; }
   if (src_message == NULL) { src_message = ""; }
   size_t message_length = strlen(src_message);
 
@@ -79,6 +170,7 @@ tic_error * tic_error_copy(const tic_error * src_error)
     free(new_error);
     free(new_message);
     free(new_code_array);
+    free(built_message);
     return &tic_error_masked_by_no_memory;
   }
 
@@ -87,7 +179,8 @@ tic_error * tic_error_copy(const tic_error * src_error)
     memcpy(new_code_array, src_error->code_array, code_count * sizeof(uint32_t));
   }
   strncpy(new_message, src_message, message_length + 1);
-  new_error->do_not_free = false;
+  free(built_message);
+  memset(new_error, 0, sizeof(tic_error));
   new_error->message = new_message;
   new_error->code_count = code_count;
   new_error->code_array = new_code_array;
@@ -117,6 +210,12 @@ tic_error * tic_error_add_v(tic_error * error, const char * format, va_list ap)
   error = tic_error_make_mutable(error);
   if (error == NULL || error->do_not_free) { return error; }
 
+  if (!tic_error_finish_message(error))
+  {
+    tic_error_free(error);
+    return &tic_error_masked_by_no_memory;
+  }
+
   if (error->message == NULL) { error->message = ""; }
 
   // Determine all the string lengths.
@@ -176,6 +275,26 @@ tic_error * tic_error_add_code(tic_error * error, uint32_t code)
   return error;
 }
 
+// Adds a message to the error without formatting or copying it; the message
+// gets assembled the first time someone asks for it.  The message must be a
+// string literal or otherwise outlive the error.  This is just like
+// error_add_v in terms of pointer ownership.
+tic_error * tic_error_add_static(tic_error * error, const char * message)
+{
+  if (message == NULL) { return error; }
+
+  error = tic_error_make_mutable(error);
+  if (error == NULL || error->do_not_free) { return error; }
+
+  if (error->static_message_count == TIC_ERROR_MAX_STATIC_MESSAGES)
+  {
+    return tic_error_add(error, "%s", message);
+  }
+
+  error->static_messages[error->static_message_count++] = message;
+  return error;
+}
+
 // Variadic version of error_add_v.
 tic_error * tic_error_add(tic_error * error, const char * format, ...)
 {
@@ -196,6 +315,19 @@ tic_error * tic_error_create(const char * format, ...)
   return error;
 }
 
+tic_error * tic_transport_error_create(uint32_t code, const char * format, ...)
+{
+  va_list ap;
+  va_start(ap, format);
+  tic_error * error = tic_error_add_v(NULL, format, ap);
+  va_end(ap);
+  if (code != 0)
+  {
+    error = tic_error_add_code(error, code);
+  }
+  return error;
+}
+
 bool tic_error_has_code(const tic_error * error, uint32_t code)
 {
   if (error == NULL) { return false; }
@@ -216,6 +348,15 @@ const char * tic_error_get_message(const tic_error * error)
   {
     return "No error.";
   }
+  if (tic_error_is_lazy(error))
+  {
+    // Building the message only fills in a cache, so the error is still
+    // logically const.
+    if (!tic_error_finish_message((tic_error *)error))
+    {
+      return tic_error_masked_by_no_memory_msg;
+    }
+  }
   if (error->message == NULL)
   {
     return "";
@@ -223,35 +364,55 @@ const char * tic_error_get_message(const tic_error * error)
   return error->message;
 }
 
-// Convert a libusbp_error into a tic_error and free the libusbp_error.
+// Convert a libusbp_error into a tic_error.  The tic_error takes ownership of
+// the libusbp_error and only copies its message when someone asks for it.
 tic_error * tic_usb_error(libusbp_error * usb_error)
 {
   if (usb_error == NULL) { return NULL; }
 
-  // Create the error and copy the message from libusbp.
-  tic_error * error = tic_error_create("%s", libusbp_error_get_message(usb_error));
+  uint32_t codes[4];
+  size_t code_count = 0;
 
   if (libusbp_error_has_code(usb_error, LIBUSBP_ERROR_MEMORY))
   {
-    tic_error_add_code(error, TIC_ERROR_MEMORY);
+    codes[code_count++] = TIC_ERROR_MEMORY;
   }
 
   if (libusbp_error_has_code(usb_error, LIBUSBP_ERROR_ACCESS_DENIED))
   {
-    tic_error_add_code(error, TIC_ERROR_ACCESS_DENIED);
+    codes[code_count++] = TIC_ERROR_ACCESS_DENIED;
   }
 
   if (libusbp_error_has_code(usb_error, LIBUSBP_ERROR_TIMEOUT))
   {
-    tic_error_add_code(error, TIC_ERROR_TIMEOUT);
+    codes[code_count++] = TIC_ERROR_TIMEOUT;
   }
 
   if (libusbp_error_has_code(usb_error, LIBUSBP_ERROR_DEVICE_DISCONNECTED))
   {
-    tic_error_add_code(error, TIC_ERROR_DEVICE_DISCONNECTED);
+    codes[code_count++] = TIC_ERROR_DEVICE_DISCONNECTED;
   }
 
-  libusbp_error_free(usb_error);
+  tic_error * error = calloc(1, sizeof(tic_error));
+  uint32_t * code_array = NULL;
+  if (code_count != 0)
+  {
+    code_array = malloc(code_count * sizeof(uint32_t));
+  }
+  if (error == NULL || (code_count != 0 && code_array == NULL))
+  {
+    free(error);
+    free(code_array);
+    libusbp_error_free(usb_error);
+    return &tic_error_masked_by_no_memory;
+  }
 
+  if (code_count != 0)
+  {
+    memcpy(code_array, codes, code_count * sizeof(uint32_t));
+  }
+  error->code_count = code_count;
+  error->code_array = code_array;
+  error->usb_error = usb_error;
   return error;
 }
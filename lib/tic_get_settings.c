@@ -2,7 +2,7 @@
 
 #include "tic_internal.h"
 
-static void write_buffer_to_settings(const uint8_t * buf, tic_settings * settings)
+void tic_write_buffer_to_settings(const uint8_t * buf, tic_settings * settings)
 {
   uint8_t product = tic_settings_get_product(settings);
 
@@ -426,7 +426,7 @@ tic_error * tic_get_settings(tic_handle * handle, tic_settings ** settings)
   // Store the settings in the new settings object.
   if (error == NULL)
   {
-    write_buffer_to_settings(buf, new_settings);
+    tic_write_buffer_to_settings(buf, new_settings);
   }
 
   // Pass the new settings to the caller.
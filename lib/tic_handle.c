@@ -1,14 +1,95 @@
-// Functions for communicating with Tic devices over USB.
+// Functions for communicating with Tic devices.
+//
+// Every request goes through the handle's transport, which is USB for handles
+// opened with tic_handle_open().
 
 #include "tic_internal.h"
 
 struct tic_handle
 {
-  libusbp_generic_handle * usb_handle;
+  const tic_transport * transport;
+  void * transport_context;
   tic_device * device;
   char * cached_firmware_version_string;
 };
 
+static tic_error * tic_usb_write(void * context,
+  uint8_t request, uint16_t value, uint16_t index)
+{
+  return tic_usb_error(libusbp_control_transfer(context,
+    0x40, request, value, index, NULL, 0, NULL));
+}
+
+static tic_error * tic_usb_read(void * context,
+  uint8_t request, uint16_t value, uint16_t index,
+  uint8_t * buffer, size_t length, size_t * transferred)
+{
+  return tic_usb_error(libusbp_control_transfer(context,
+    0xC0, request, value, index, buffer, length, transferred));
+}
+
+static void tic_usb_get_firmware_modification(void * context,
+  char * output, size_t size)
+{
+  size_t index = 0;
+
+  // Get the firmware modification string from the device.
+  size_t transferred = 0;
+  uint8_t buffer[256];
+  libusbp_error * usb_error = libusbp_control_transfer(context,
+    0x80, USB_REQUEST_GET_DESCRIPTOR,
+    (USB_DESCRIPTOR_TYPE_STRING << 8) | TIC_FIRMWARE_MODIFICATION_STRING_INDEX,
+    0,
+    buffer, sizeof(buffer), &transferred);
+  if (usb_error)
+  {
+    // Let's make this be a non-fatal error because it's not so important.
+    // Just add a question mark so we can tell if something is wrong.
+    libusbp_error_free(usb_error);
+    output[index++] = '0';
+  }
+
+  // Ignore the modification string if it is just a dash.
+  if (transferred == 4 && buffer[2] == '-')
+  {
+    transferred = 0;
+  }
+
+  for (size_t i = 2; i < transferred && index + 1 < size; i += 2)
+  {
+    output[index++] = buffer[i];
+  }
+
+  output[index] = 0;
+}
+
+static void tic_usb_close(void * context)
+{
+  libusbp_generic_handle_close(context);
+}
+
+static const tic_transport tic_usb_transport = {
+  .write = tic_usb_write,
+  .read = tic_usb_read,
+  .get_firmware_modification = tic_usb_get_firmware_modification,
+  .close = tic_usb_close,
+};
+
+static tic_error * tic_handle_write(tic_handle * handle,
+  uint8_t request, uint16_t value, uint16_t index)
+{
+  return handle->transport->write(handle->transport_context,
+    request, value, index);
+}
+
+static tic_error * tic_handle_read(tic_handle * handle,
+  uint8_t request, uint16_t value, uint16_t index,
+  uint8_t * buffer, size_t length, size_t * transferred)
+{
+  return handle->transport->read(handle->transport_context,
+    request, value, index, buffer, length, transferred);
+}
+
 tic_error * tic_handle_open(const tic_device * device, tic_handle ** handle)
 {
   if (handle == NULL)
@@ -23,6 +104,13 @@ tic_error * tic_handle_open(const tic_device * device, tic_handle ** handle)
     return tic_error_create("Device is null.");
   }
 
+  if (tic_device_get_generic_interface(device) == NULL)
+  {
+    // The device is not a USB device, so it must be an emulated device from
+    // tic_list_connected_devices().
+    return tic_emulator_open_listed_device(device, handle);
+  }
+
   tic_error * error = NULL;
 
   if (error == NULL)
@@ -52,23 +140,24 @@ tic_error * tic_handle_open(const tic_device * device, tic_handle ** handle)
     error = tic_device_copy(device, &new_handle->device);
   }
 
-
+  libusbp_generic_handle * usb_handle = NULL;
   if (error == NULL)
   {
-    const libusbp_generic_interface * usb_interface =
-      tic_device_get_generic_interface(device);
     error = tic_usb_error(libusbp_generic_handle_open(
-        usb_interface, &new_handle->usb_handle));
+        tic_device_get_generic_interface(device), &usb_handle));
   }
 
   if (error == NULL)
   {
+    new_handle->transport = &tic_usb_transport;
+    new_handle->transport_context = usb_handle;
+
     // Set a timeout for all control transfers to prevent the program from
     // hanging indefinitely.  Want it to be at least 1500 ms because that is how
     // long the Tic might take to respond after restoring its settings to their
     // defaults.
     error = tic_usb_error(libusbp_generic_handle_set_timeout(
-        new_handle->usb_handle, 0, 1600));
+        usb_handle, 0, 1600));
   }
 
   if (error == NULL)
@@ -83,17 +172,126 @@ tic_error * tic_handle_open(const tic_device * device, tic_handle ** handle)
   return error;
 }
 
+tic_error * tic_handle_open_transport(const tic_transport * transport,
+  void * context, uint8_t product, uint16_t firmware_version,
+  const char * serial_number, tic_handle ** handle)
+{
+  if (transport == NULL || transport->write == NULL || transport->read == NULL)
+  {
+    return tic_error_create("Transport is invalid.");
+  }
+
+  if (serial_number == NULL) { serial_number = ""; }
+
+  const char * os_id = transport->name ? transport->name : "";
+  tic_device * device = NULL;
+  tic_error * error = tic_device_create_virtual(product, firmware_version,
+    serial_number, os_id, &device);
+
+  if (error == NULL)
+  {
+    error = tic_handle_open_virtual(transport, context, device, handle);
+  }
+  else if (transport->close != NULL)
+  {
+    // The caller gave us ownership of the context, so free it.
+    transport->close(context);
+  }
+
+  tic_device_free(device);
+
+  return error;
+}
+
+tic_error * tic_handle_open_virtual(const tic_transport * transport,
+  void * context, const tic_device * device, tic_handle ** handle)
+{
+  assert(transport != NULL && transport->write != NULL &&
+    transport->read != NULL);
+  assert(device != NULL);
+
+  tic_error * error = NULL;
+
+  if (handle == NULL)
+  {
+    error = tic_error_create("Handle output pointer is null.");
+  }
+  else
+  {
+    *handle = NULL;
+  }
+
+  tic_handle * new_handle = NULL;
+  if (error == NULL)
+  {
+    new_handle = calloc(1, sizeof(tic_handle));
+    if (new_handle == NULL)
+    {
+      error = &tic_error_no_memory;
+    }
+  }
+
+  if (error == NULL)
+  {
+    error = tic_device_copy(device, &new_handle->device);
+  }
+
+  if (error == NULL)
+  {
+    new_handle->transport = transport;
+    new_handle->transport_context = context;
+    *handle = new_handle;
+    new_handle = NULL;
+  }
+  else if (transport->close != NULL)
+  {
+    // The caller gave us ownership of the context, so free it.
+    transport->close(context);
+  }
+
+  tic_handle_close(new_handle);
+
+  return error;
+}
+
 void tic_handle_close(tic_handle * handle)
 {
   if (handle != NULL)
   {
-    libusbp_generic_handle_close(handle->usb_handle);
+    if (handle->transport != NULL && handle->transport->close != NULL)
+    {
+      handle->transport->close(handle->transport_context);
+    }
     tic_device_free(handle->device);
     free(handle->cached_firmware_version_string);
     free(handle);
   }
 }
 
+void tic_handle_begin_batch(tic_handle * handle)
+{
+  if (handle == NULL || handle->transport->begin_batch == NULL) { return; }
+  handle->transport->begin_batch(handle->transport_context);
+}
+
+tic_error * tic_handle_end_batch(tic_handle * handle)
+{
+  if (handle == NULL)
+  {
+    return tic_error_create("Handle is null.");
+  }
+
+  if (handle->transport->end_batch == NULL) { return NULL; }
+
+  tic_error * error = handle->transport->end_batch(handle->transport_context);
+  if (error != NULL)
+  {
+    error = tic_error_add_static(error,
+      "There was an error sending a batch of commands.");
+  }
+  return error;
+}
+
 const tic_device * tic_handle_get_device(const tic_handle * handle)
 {
   if (handle == NULL) { return NULL; }
@@ -132,36 +330,15 @@ const char * tic_get_firmware_version_string(tic_handle * handle)
   new_string[index++] = '.';
   new_string[index++] = '0' + (version_bcd >> 4 & 0xF);
   new_string[index++] = '0' + (version_bcd >> 0 & 0xF);
-
-  // Get the firmware modification string from the device.
-  size_t transferred = 0;
-  uint8_t buffer[256];
-  libusbp_error * usb_error = libusbp_control_transfer(handle->usb_handle,
-    0x80, USB_REQUEST_GET_DESCRIPTOR,
-    (USB_DESCRIPTOR_TYPE_STRING << 8) | TIC_FIRMWARE_MODIFICATION_STRING_INDEX,
-    0,
-    buffer, sizeof(buffer), &transferred);
-  if (usb_error)
-  {
-    // Let's make this be a non-fatal error because it's not so important.
-    // Just add a question mark so we can tell if something is wrong.
-    new_string[index++] = '0';
-  }
-
-  // Ignore the modification string if it is just a dash.
-  if (transferred == 4 && buffer[2] == '-')
-  {
-    transferred = 0;
-  }
+  new_string[index] = 0;
 
   // Add the modification string to the firmware version string.
-  for (size_t i = 2; i < transferred; i += 2)
+  if (handle->transport->get_firmware_modification != NULL)
   {
-    new_string[index++] = buffer[i];
+    handle->transport->get_firmware_modification(
+      handle->transport_context, new_string + index, 133 - index);
   }
 
-  new_string[index] = 0;
-
   handle->cached_firmware_version_string = new_string;
 
   return new_string;
@@ -178,12 +355,12 @@ tic_error * tic_set_target_position(tic_handle * handle, int32_t position)
 
   uint16_t wValue = (uint32_t)position & 0xFFFF;
   uint16_t wIndex = (uint32_t)position >> 16 & 0xFFFF;
-  error = tic_usb_error(libusbp_control_transfer(handle->usb_handle,
-    0x40, TIC_CMD_SET_TARGET_POSITION, wValue, wIndex, NULL, 0, NULL));
+  error = tic_handle_write(handle,
+    TIC_CMD_SET_TARGET_POSITION, wValue, wIndex);
 
   if (error != NULL)
   {
-    error = tic_error_add(error,
+    error = tic_error_add_static(error,
       "There was an error setting the target position.");
   }
 
@@ -201,12 +378,12 @@ tic_error * tic_set_target_velocity(tic_handle * handle, int32_t velocity)
 
   uint16_t wValue = (uint32_t)velocity & 0xFFFF;
   uint16_t wIndex = (uint32_t)velocity >> 16 & 0xFFFF;
-  error = tic_usb_error(libusbp_control_transfer(handle->usb_handle,
-    0x40, TIC_CMD_SET_TARGET_VELOCITY, wValue, wIndex, NULL, 0, NULL));
+  error = tic_handle_write(handle,
+    TIC_CMD_SET_TARGET_VELOCITY, wValue, wIndex);
 
   if (error != NULL)
   {
-    error = tic_error_add(error,
+    error = tic_error_add_static(error,
       "There was an error setting the target velocity.");
   }
 
@@ -224,12 +401,12 @@ tic_error * tic_halt_and_set_position(tic_handle * handle, int32_t position)
 
   uint16_t wValue = (uint32_t)position & 0xFFFF;
   uint16_t wIndex = (uint32_t)position >> 16 & 0xFFFF;
-  error = tic_usb_error(libusbp_control_transfer(handle->usb_handle,
-    0x40, TIC_CMD_HALT_AND_SET_POSITION, wValue, wIndex, NULL, 0, NULL));
+  error = tic_handle_write(handle,
+    TIC_CMD_HALT_AND_SET_POSITION, wValue, wIndex);
 
   if (error != NULL)
   {
-    error = tic_error_add(error,
+    error = tic_error_add_static(error,
       "There was an error halting and setting the position.");
   }
 
@@ -245,12 +422,12 @@ tic_error * tic_halt_and_hold(tic_handle * handle)
 
   tic_error * error = NULL;
 
-  error = tic_usb_error(libusbp_control_transfer(handle->usb_handle,
-    0x40, TIC_CMD_HALT_AND_HOLD, 0, 0, NULL, 0, NULL));
+  error = tic_handle_write(handle,
+    TIC_CMD_HALT_AND_HOLD, 0, 0);
 
   if (error != NULL)
   {
-    error = tic_error_add(error,
+    error = tic_error_add_static(error,
       "There was an error halting.");
   }
 
@@ -266,12 +443,12 @@ tic_error * tic_go_home(tic_handle * handle, uint8_t direction)
 
   tic_error * error = NULL;
 
-  error = tic_usb_error(libusbp_control_transfer(handle->usb_handle,
-    0x40, TIC_CMD_GO_HOME, direction, 0, NULL, 0, NULL));
+  error = tic_handle_write(handle,
+    TIC_CMD_GO_HOME, direction, 0);
 
   if (error != NULL)
   {
-    error = tic_error_add(error,
+    error = tic_error_add_static(error,
       "There was an error sending the 'Go home' command.");
   }
 
@@ -287,12 +464,12 @@ tic_error * tic_reset_command_timeout(tic_handle * handle)
 
   tic_error * error = NULL;
 
-  error = tic_usb_error(libusbp_control_transfer(handle->usb_handle,
-    0x40, TIC_CMD_RESET_COMMAND_TIMEOUT, 0, 0, NULL, 0, NULL));
+  error = tic_handle_write(handle,
+    TIC_CMD_RESET_COMMAND_TIMEOUT, 0, 0);
 
   if (error != NULL)
   {
-    error = tic_error_add(error,
+    error = tic_error_add_static(error,
       "There was an error resetting the command timeout.");
   }
 
@@ -308,12 +485,12 @@ tic_error * tic_deenergize(tic_handle * handle)
 
   tic_error * error = NULL;
 
-  error = tic_usb_error(libusbp_control_transfer(handle->usb_handle,
-    0x40, TIC_CMD_DEENERGIZE, 0, 0, NULL, 0, NULL));
+  error = tic_handle_write(handle,
+    TIC_CMD_DEENERGIZE, 0, 0);
 
   if (error != NULL)
   {
-    error = tic_error_add(error,
+    error = tic_error_add_static(error,
       "There was an error deenergizing.");
   }
 
@@ -329,12 +506,12 @@ tic_error * tic_energize(tic_handle * handle)
 
   tic_error * error = NULL;
 
-  error = tic_usb_error(libusbp_control_transfer(handle->usb_handle,
-    0x40, TIC_CMD_ENERGIZE, 0, 0, NULL, 0, NULL));
+  error = tic_handle_write(handle,
+    TIC_CMD_ENERGIZE, 0, 0);
 
   if (error != NULL)
   {
-    error = tic_error_add(error,
+    error = tic_error_add_static(error,
       "There was an error energizing.");
   }
 
@@ -350,12 +527,12 @@ tic_error * tic_exit_safe_start(tic_handle * handle)
 
   tic_error * error = NULL;
 
-  error = tic_usb_error(libusbp_control_transfer(handle->usb_handle,
-    0x40, TIC_CMD_EXIT_SAFE_START, 0, 0, NULL, 0, NULL));
+  error = tic_handle_write(handle,
+    TIC_CMD_EXIT_SAFE_START, 0, 0);
 
   if (error != NULL)
   {
-    error = tic_error_add(error,
+    error = tic_error_add_static(error,
       "There was an error exiting safe start.");
   }
 
@@ -371,12 +548,12 @@ tic_error * tic_enter_safe_start(tic_handle * handle)
 
   tic_error * error = NULL;
 
-  error = tic_usb_error(libusbp_control_transfer(handle->usb_handle,
-    0x40, TIC_CMD_ENTER_SAFE_START, 0, 0, NULL, 0, NULL));
+  error = tic_handle_write(handle,
+    TIC_CMD_ENTER_SAFE_START, 0, 0);
 
   if (error != NULL)
   {
-    error = tic_error_add(error,
+    error = tic_error_add_static(error,
       "There was an error entering safe start.");
   }
 
@@ -392,12 +569,12 @@ tic_error * tic_reset(tic_handle * handle)
 
   tic_error * error = NULL;
 
-  error = tic_usb_error(libusbp_control_transfer(handle->usb_handle,
-    0x40, TIC_CMD_RESET, 0, 0, NULL, 0, NULL));
+  error = tic_handle_write(handle,
+    TIC_CMD_RESET, 0, 0);
 
   if (error != NULL)
   {
-    error = tic_error_add(error,
+    error = tic_error_add_static(error,
       "There was an error sending the Reset command.");
   }
 
@@ -413,12 +590,12 @@ tic_error * tic_clear_driver_error(tic_handle * handle)
 
   tic_error * error = NULL;
 
-  error = tic_usb_error(libusbp_control_transfer(handle->usb_handle,
-    0x40, TIC_CMD_CLEAR_DRIVER_ERROR, 0, 0, NULL, 0, NULL));
+  error = tic_handle_write(handle,
+    TIC_CMD_CLEAR_DRIVER_ERROR, 0, 0);
 
   if (error != NULL)
   {
-    error = tic_error_add(error,
+    error = tic_error_add_static(error,
       "There was an error clearing the driver error.");
   }
 
@@ -436,12 +613,12 @@ tic_error * tic_set_max_speed(tic_handle * handle, uint32_t max_speed)
 
   uint16_t wValue = (uint32_t)max_speed & 0xFFFF;
   uint16_t wIndex = (uint32_t)max_speed >> 16 & 0xFFFF;
-  error = tic_usb_error(libusbp_control_transfer(handle->usb_handle,
-    0x40, TIC_CMD_SET_MAX_SPEED, wValue, wIndex, NULL, 0, NULL));
+  error = tic_handle_write(handle,
+    TIC_CMD_SET_MAX_SPEED, wValue, wIndex);
 
   if (error != NULL)
   {
-    error = tic_error_add(error,
+    error = tic_error_add_static(error,
       "There was an error setting the maximum speed.");
   }
 
@@ -459,12 +636,12 @@ tic_error * tic_set_starting_speed(tic_handle * handle, uint32_t starting_speed)
 
   uint16_t wValue = (uint32_t)starting_speed & 0xFFFF;
   uint16_t wIndex = (uint32_t)starting_speed >> 16 & 0xFFFF;
-  error = tic_usb_error(libusbp_control_transfer(handle->usb_handle,
-    0x40, TIC_CMD_SET_STARTING_SPEED, wValue, wIndex, NULL, 0, NULL));
+  error = tic_handle_write(handle,
+    TIC_CMD_SET_STARTING_SPEED, wValue, wIndex);
 
   if (error != NULL)
   {
-    error = tic_error_add(error,
+    error = tic_error_add_static(error,
       "There was an error setting the starting speed.");
   }
 
@@ -482,12 +659,12 @@ tic_error * tic_set_max_accel(tic_handle * handle, uint32_t max_accel)
 
   uint16_t wValue = (uint32_t)max_accel & 0xFFFF;
   uint16_t wIndex = (uint32_t)max_accel >> 16 & 0xFFFF;
-  error = tic_usb_error(libusbp_control_transfer(handle->usb_handle,
-    0x40, TIC_CMD_SET_MAX_ACCEL, wValue, wIndex, NULL, 0, NULL));
+  error = tic_handle_write(handle,
+    TIC_CMD_SET_MAX_ACCEL, wValue, wIndex);
 
   if (error != NULL)
   {
-    error = tic_error_add(error,
+    error = tic_error_add_static(error,
       "There was an error setting the maximum acceleration.");
   }
 
@@ -505,12 +682,12 @@ tic_error * tic_set_max_decel(tic_handle * handle, uint32_t max_decel)
 
   uint16_t wValue = (uint32_t)max_decel & 0xFFFF;
   uint16_t wIndex = (uint32_t)max_decel >> 16 & 0xFFFF;
-  error = tic_usb_error(libusbp_control_transfer(handle->usb_handle,
-    0x40, TIC_CMD_SET_MAX_DECEL, wValue, wIndex, NULL, 0, NULL));
+  error = tic_handle_write(handle,
+    TIC_CMD_SET_MAX_DECEL, wValue, wIndex);
 
   if (error != NULL)
   {
-    error = tic_error_add(error,
+    error = tic_error_add_static(error,
       "There was an error setting the maximum deceleration.");
   }
 
@@ -527,12 +704,12 @@ tic_error * tic_set_step_mode(tic_handle * handle, uint8_t step_mode)
   tic_error * error = NULL;
 
   uint16_t wValue = step_mode;
-  error = tic_usb_error(libusbp_control_transfer(handle->usb_handle,
-    0x40, TIC_CMD_SET_STEP_MODE, wValue, 0, NULL, 0, NULL));
+  error = tic_handle_write(handle,
+    TIC_CMD_SET_STEP_MODE, wValue, 0);
 
   if (error != NULL)
   {
-    error = tic_error_add(error,
+    error = tic_error_add_static(error,
       "There was an error setting the step mode.");
   }
 
@@ -562,12 +739,12 @@ tic_error * tic_set_current_limit_code(tic_handle * handle, uint8_t code)
 
   tic_error * error = NULL;
 
-  error = tic_usb_error(libusbp_control_transfer(handle->usb_handle,
-    0x40, TIC_CMD_SET_CURRENT_LIMIT, code, 0, NULL, 0, NULL));
+  error = tic_handle_write(handle,
+    TIC_CMD_SET_CURRENT_LIMIT, code, 0);
 
   if (error != NULL)
   {
-    error = tic_error_add(error,
+    error = tic_error_add_static(error,
       "There was an error setting the current limit.");
   }
 
@@ -584,12 +761,12 @@ tic_error * tic_set_decay_mode(tic_handle * handle, uint8_t decay_mode)
   tic_error * error = NULL;
 
   uint16_t wValue = decay_mode;
-  error = tic_usb_error(libusbp_control_transfer(handle->usb_handle,
-    0x40, TIC_CMD_SET_DECAY_MODE, wValue, 0, NULL, 0, NULL));
+  error = tic_handle_write(handle,
+    TIC_CMD_SET_DECAY_MODE, wValue, 0);
 
   if (error != NULL)
   {
-    error = tic_error_add(error,
+    error = tic_error_add_static(error,
       "There was an error setting the decay mode.");
   }
 
@@ -615,8 +792,8 @@ static tic_error * tic_set_agc_option(tic_handle * handle,
   tic_error * error = NULL;
 
   uint16_t wValue = ((option & 0x07) << 4) | (value & 0x0F);
-  error = tic_usb_error(libusbp_control_transfer(handle->usb_handle,
-    0x40, TIC_CMD_SET_AGC_OPTION, wValue, 0, NULL, 0, NULL));
+  error = tic_handle_write(handle,
+    TIC_CMD_SET_AGC_OPTION, wValue, 0);
 
   if (error != NULL)
   {
@@ -653,12 +830,12 @@ tic_error * tic_set_setting_byte(tic_handle * handle,
 {
   assert(handle != NULL);
 
-  tic_error * error = tic_usb_error(libusbp_control_transfer(handle->usb_handle,
-    0x40, TIC_CMD_SET_SETTING, byte, address, NULL, 0, NULL));
+  tic_error * error = tic_handle_write(handle,
+    TIC_CMD_SET_SETTING, byte, address);
 
   if (error != NULL)
   {
-    error = tic_error_add(error,
+    error = tic_error_add_static(error,
       "There was an error applying settings.");
   }
   return error;
@@ -672,8 +849,8 @@ tic_error * tic_get_setting_segment(tic_handle * handle,
   assert(length && length <= TIC_MAX_USB_RESPONSE_SIZE);
 
   size_t transferred;
-  tic_error * error = tic_usb_error(libusbp_control_transfer(handle->usb_handle,
-    0xC0, TIC_CMD_GET_SETTING, 0, index, output, length, &transferred));
+  tic_error * error = tic_handle_read(handle,
+    TIC_CMD_GET_SETTING, 0, index, output, length, &transferred);
   if (error != NULL)
   {
     return error;
@@ -703,8 +880,8 @@ tic_error * tic_get_variable_segment(tic_handle * handle,
     cmd = TIC_CMD_GET_VARIABLE_AND_CLEAR_ERRORS_OCCURRED;
   }
   size_t transferred;
-  tic_error * error = tic_usb_error(libusbp_control_transfer(handle->usb_handle,
-    0xC0, cmd, 0, index, output, length, &transferred));
+  tic_error * error = tic_handle_read(handle,
+    cmd, 0, index, output, length, &transferred);
   if (error != NULL)
   {
     return error;
@@ -775,7 +952,7 @@ tic_error * tic_restore_defaults(tic_handle * handle)
 
   if (error != NULL)
   {
-    error = tic_error_add(error,
+    error = tic_error_add_static(error,
       "There was an error restoring the default settings.");
   }
 
@@ -789,12 +966,12 @@ tic_error * tic_reinitialize(tic_handle * handle)
     return tic_error_create("Handle is null.");
   }
 
-  tic_error * error = tic_usb_error(libusbp_control_transfer(handle->usb_handle,
-    0x40, TIC_CMD_REINITIALIZE, 0, 0, NULL, 0, NULL));
+  tic_error * error = tic_handle_write(handle,
+    TIC_CMD_REINITIALIZE, 0, 0);
 
   if (error != NULL)
   {
-    error = tic_error_add(error,
+    error = tic_error_add_static(error,
       "There was an error reinitializing the device.");
   }
 
@@ -808,12 +985,12 @@ tic_error * tic_start_bootloader(tic_handle * handle)
     return tic_error_create("Handle is null.");
   }
 
-  tic_error * error = tic_usb_error(libusbp_control_transfer(handle->usb_handle,
-    0x40, TIC_CMD_START_BOOTLOADER, 0, 0, NULL, 0, NULL));
+  tic_error * error = tic_handle_write(handle,
+    TIC_CMD_START_BOOTLOADER, 0, 0);
 
   if (error != NULL)
   {
-    error = tic_error_add(error,
+    error = tic_error_add_static(error,
       "There was an error starting the bootloader.");
   }
 
@@ -838,12 +1015,12 @@ tic_error * tic_get_debug_data(tic_handle * handle, uint8_t * data, size_t * siz
   }
 
   size_t transferred;
-  libusbp_error * usb_error = libusbp_control_transfer(handle->usb_handle,
-    0xC0, TIC_CMD_GET_DEBUG_DATA, 0, 0, data, *size, &transferred);
-  if (usb_error)
+  tic_error * error = tic_handle_read(handle,
+    TIC_CMD_GET_DEBUG_DATA, 0, 0, data, *size, &transferred);
+  if (error != NULL)
   {
     *size = 0;
-    return tic_usb_error(usb_error);
+    return error;
   }
 
   *size = transferred;
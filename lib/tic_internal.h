@@ -9,6 +9,7 @@
 #include <assert.h>
 #include <errno.h>
 #include <stdarg.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -21,6 +22,39 @@
 #define TIC_PRINTF(f, a) __attribute__((format (printf, f, a)))
 #endif
 
+// Atomic operations on the fields that tic_poller and tic_trajectory share
+// between their threads.  TIC_ATOMIC_LOAD has acquire semantics and
+// TIC_ATOMIC_STORE has release semantics.  MSVC does not have the GCC atomic
+// builtins, so there we use interlocked operations, which are full barriers.
+// The fields must be 1, 4, or 8 bytes.
+#ifdef _MSC_VER
+#include <windows.h>
+#define TIC_ATOMIC_LOAD(p) \
+  (sizeof(*(p)) == 1 ? \
+    (uint64_t)_InterlockedCompareExchange8((volatile char *)(p), 0, 0) : \
+  sizeof(*(p)) == 4 ? \
+    (uint64_t)InterlockedCompareExchange((volatile LONG *)(p), 0, 0) : \
+    (uint64_t)InterlockedCompareExchange64((volatile LONG64 *)(p), 0, 0))
+#define TIC_ATOMIC_STORE(p, v) \
+  (sizeof(*(p)) == 1 ? \
+    (void)_InterlockedExchange8((volatile char *)(p), (char)(v)) : \
+  sizeof(*(p)) == 4 ? \
+    (void)InterlockedExchange((volatile LONG *)(p), (LONG)(v)) : \
+    (void)InterlockedExchange64((volatile LONG64 *)(p), (LONG64)(v)))
+#define TIC_ATOMIC_LOAD_RELAXED(p) TIC_ATOMIC_LOAD(p)
+#define TIC_ATOMIC_STORE_RELAXED(p, v) TIC_ATOMIC_STORE(p, v)
+#define TIC_ATOMIC_FENCE_ACQUIRE() MemoryBarrier()
+#define TIC_ATOMIC_FENCE_RELEASE() MemoryBarrier()
+#else
+#define TIC_ATOMIC_LOAD(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define TIC_ATOMIC_STORE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define TIC_ATOMIC_LOAD_RELAXED(p) __atomic_load_n((p), __ATOMIC_RELAXED)
+#define TIC_ATOMIC_STORE_RELAXED(p, v) \
+  __atomic_store_n((p), (v), __ATOMIC_RELAXED)
+#define TIC_ATOMIC_FENCE_ACQUIRE() __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#define TIC_ATOMIC_FENCE_RELEASE() __atomic_thread_fence(__ATOMIC_RELEASE)
+#endif
+
 // A setup packet bRequest value from USB 2.0 Table 9-4
 #define USB_REQUEST_GET_DESCRIPTOR 6
 
@@ -42,6 +76,9 @@ void tic_string_setup_dummy(tic_string *);
 TIC_PRINTF(2, 3)
 void tic_sprintf(tic_string *, const char * format, ...);
 
+TIC_PRINTF(2, 0)
+void tic_vsprintf(tic_string *, const char * format, va_list ap);
+
 #define STRING_TO_INT_ERR_SMALL 1
 #define STRING_TO_INT_ERR_LARGE 2
 #define STRING_TO_INT_ERR_EMPTY 3
@@ -76,6 +113,7 @@ extern const tic_name tic_agc_frequency_limit_names[];
 // Intenral variables functions.
 
 void tic_variables_set_from_device(tic_variables *, const uint8_t * buffer);
+void tic_variables_copy_into(tic_variables * dest, const tic_variables * source);
 
 
 // Internal settings conversion functions.
@@ -89,9 +127,20 @@ uint16_t tic_baud_rate_to_brg(uint32_t baud_rate);
 const libusbp_generic_interface *
 tic_device_get_generic_interface(const tic_device * device);
 
+// Creates a device object that is not associated with a USB device, for use
+// with handles that communicate using some other transport.
+tic_error * tic_device_create_virtual(uint8_t product,
+  uint16_t firmware_version, const char * serial_number, const char * os_id,
+  tic_device ** device);
+
 
 // Internal tic_handle functions.
 
+// Opens a handle that uses a transport to talk to the specified device, which
+// is copied.  Takes ownership of the context like tic_handle_open_transport().
+tic_error * tic_handle_open_virtual(const tic_transport * transport,
+  void * context, const tic_device * device, tic_handle ** handle);
+
 tic_error * tic_set_setting_byte(tic_handle * handle,
   uint8_t address, uint8_t byte);
 
@@ -103,6 +152,100 @@ tic_error * tic_get_variable_segment(tic_handle * handle,
   bool clear_errors_occurred);
 
 
+// Internal tic_poller functions.
+
+// Sleeps until the time returned by tic_poller_get_time_ns() reaches the
+// deadline.
+void tic_poller_sleep_until(uint64_t deadline_ns);
+
+
+// Internal functions for waiting for the motor.
+
+// Returns how long to wait before reading the variables again when waiting
+// for the motor to reach its target, based on when it is predicted to arrive.
+uint64_t tic_wait_get_interval_ns(const tic_variables * variables);
+
+
+// Internal tic_settings functions.
+
+// Writes the settings into a buffer of TIC_SETTINGS_SIZE bytes in the format
+// of the Tic's EEPROM.  The buffer should be filled with zeros first.
+void tic_write_settings_to_buffer(const tic_settings * settings, uint8_t * buf);
+
+// Groups of settings fields that tic_settings_fix() checks together.  It only
+// runs the checks for the groups that changed since the settings were last
+// fixed.
+enum tic_settings_group
+{
+  TIC_SETTINGS_GROUP_DEVICE = 1 << 0,
+  TIC_SETTINGS_GROUP_CONTROL_MODE = 1 << 1,
+  TIC_SETTINGS_GROUP_SOFT_ERROR_RESPONSE = 1 << 2,
+  TIC_SETTINGS_GROUP_SERIAL_BAUD_RATE = 1 << 3,
+  TIC_SETTINGS_GROUP_SERIAL_DEVICE_NUMBER = 1 << 4,
+  TIC_SETTINGS_GROUP_COMMAND_TIMEOUT = 1 << 5,
+  TIC_SETTINGS_GROUP_SERIAL_RESPONSES = 1 << 6,
+  TIC_SETTINGS_GROUP_VIN = 1 << 7,
+  TIC_SETTINGS_GROUP_VIN_CALIBRATION = 1 << 8,
+  TIC_SETTINGS_GROUP_INPUT_SCALING_DEGREE = 1 << 9,
+  TIC_SETTINGS_GROUP_INPUT_SCALING = 1 << 10,
+  TIC_SETTINGS_GROUP_OUTPUT_SCALING = 1 << 11,
+  TIC_SETTINGS_GROUP_ENCODER = 1 << 12,
+  TIC_SETTINGS_GROUP_PINS = 1 << 13,
+  TIC_SETTINGS_GROUP_CURRENT_LIMIT = 1 << 14,
+  TIC_SETTINGS_GROUP_STEP_MODE = 1 << 15,
+  TIC_SETTINGS_GROUP_DECAY_MODE = 1 << 16,
+  TIC_SETTINGS_GROUP_AGC = 1 << 17,
+  TIC_SETTINGS_GROUP_SPEED = 1 << 18,
+  TIC_SETTINGS_GROUP_ACCEL = 1 << 19,
+  TIC_SETTINGS_GROUP_AUTO_HOMING = 1 << 20,
+};
+
+#define TIC_SETTINGS_GROUP_ALL 0xFFFFFFFF
+
+// Returns the groups that have a field that is different in the two settings
+// objects.
+uint32_t tic_settings_changed_groups(const tic_settings * a,
+  const tic_settings * b);
+
+// Gets the copy of the settings saved by tic_settings_save_fixed(), or NULL.
+const tic_settings * tic_settings_get_last_fixed(const tic_settings * settings);
+
+// Saves a copy of the settings to compare against the next time they are
+// fixed.  This should only be called when the settings are valid.
+void tic_settings_save_fixed(tic_settings * settings);
+
+// Receives the fields of a settings file, one at a time, with each value
+// formatted the way it appears in the file.  The name is a string literal, so
+// it can be kept, but the value must be copied.
+#define TIC_SETTINGS_FIELD_VALUE_SIZE 64
+typedef struct tic_settings_field_printer
+{
+  void (* print)(void * context, const char * name, const char * value);
+  void * context;
+} tic_settings_field_printer;
+
+// Calls the printer for each field that tic_settings_to_string() would write,
+// in the same order.
+void tic_settings_print_fields(const tic_settings * settings,
+  const tic_settings_field_printer * printer);
+
+// Reads settings from a buffer of TIC_SETTINGS_SIZE bytes in the format of the
+// Tic's EEPROM.  The product of the settings should be set first.
+void tic_write_buffer_to_settings(const uint8_t * buf, tic_settings * settings);
+
+
+// Internal emulator functions for the devices listed in the
+// TIC_EMULATED_DEVICES environment variable.
+
+size_t tic_emulator_get_listed_device_count(void);
+
+tic_error * tic_emulator_create_listed_device(size_t index,
+  tic_device ** device);
+
+tic_error * tic_emulator_open_listed_device(const tic_device * device,
+  tic_handle ** handle);
+
+
 // Error creation functions.
 
 tic_error * tic_error_add_code(tic_error * error, uint32_t code);
@@ -113,6 +256,8 @@ tic_error * tic_error_add(tic_error * error, const char * format, ...);
 TIC_PRINTF(1, 2)
 tic_error * tic_error_create(const char * format, ...);
 
+tic_error * tic_error_add_static(tic_error * error, const char * message);
+
 tic_error * tic_usb_error(libusbp_error *);
 
 extern tic_error tic_error_no_memory;
@@ -135,6 +280,20 @@ static inline uint32_t read_u16(const uint8_t * p)
   return p[0] + (p[1] << 8);
 }
 
+static inline void write_u16(uint8_t * p, uint16_t value)
+{
+  p[0] = value & 0xFF;
+  p[1] = value >> 8 & 0xFF;
+}
+
+static inline void write_u32(uint8_t * p, uint32_t value)
+{
+  p[0] = value & 0xFF;
+  p[1] = value >> 8 & 0xFF;
+  p[2] = value >> 16 & 0xFF;
+  p[3] = value >> 24 & 0xFF;
+}
+
 
 // Hidden settings, all of which are unimplemented in the firmware.
 
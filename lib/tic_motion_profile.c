@@ -0,0 +1,328 @@
+// Predicts the trapezoidal trajectory that the Tic's motion planner follows to
+// reach a target position.
+//
+// Calculations are done in floating point using steps, seconds, steps per
+// second, and steps per second squared.  The profile is stored as a list of
+// segments with constant acceleration.  Between segments the velocity can
+// jump, which is how we model the starting speed: the Tic changes speed
+// instantly at speeds below the starting speed.
+
+#include "tic_internal.h"
+
+#include <math.h>
+
+// The most segments a profile can have: stopping (because the motor is moving
+// away from the target or cannot stop before it), then slowing to the max
+// speed, accelerating, cruising, and decelerating.
+#define TIC_MOTION_PROFILE_MAX_SEGMENTS 5
+
+typedef struct tic_motion_segment
+{
+  double start_time;
+  double duration;
+  double position;
+  double velocity;
+  double accel;
+} tic_motion_segment;
+
+struct tic_motion_profile
+{
+  tic_motion_segment segments[TIC_MOTION_PROFILE_MAX_SEGMENTS];
+  size_t segment_count;
+
+  int32_t target_position;
+  double peak_velocity;
+  double duration;
+
+  // The state at the end of the last segment, used while building the
+  // profile.
+  double time;
+  double position;
+  double velocity;
+};
+
+static void tic_motion_profile_add_segment(tic_motion_profile * profile,
+  double duration, double accel)
+{
+  if (!(duration > 0)) { return; }
+
+  assert(profile->segment_count < TIC_MOTION_PROFILE_MAX_SEGMENTS);
+  tic_motion_segment * segment =
+    &profile->segments[profile->segment_count++];
+  segment->start_time = profile->time;
+  segment->duration = duration;
+  segment->position = profile->position;
+  segment->velocity = profile->velocity;
+  segment->accel = accel;
+
+  profile->time += duration;
+  profile->position += (profile->velocity + accel * duration / 2) * duration;
+  profile->velocity += accel * duration;
+}
+
+// Changes the velocity instantly.
+static void tic_motion_profile_jump(tic_motion_profile * profile,
+  double velocity)
+{
+  profile->velocity = velocity;
+}
+
+static void tic_motion_profile_note_speed(tic_motion_profile * profile,
+  double velocity)
+{
+  if (fabs(velocity) > fabs(profile->peak_velocity))
+  {
+    profile->peak_velocity = velocity;
+  }
+}
+
+// Slows down at the specified deceleration to the starting speed and then
+// stops.
+static void tic_motion_profile_stop(tic_motion_profile * profile,
+  double starting_speed, double decel)
+{
+  double speed = fabs(profile->velocity);
+  double direction = profile->velocity < 0 ? -1 : 1;
+  if (speed > starting_speed)
+  {
+    tic_motion_profile_add_segment(profile,
+      (speed - starting_speed) / decel, -direction * decel);
+  }
+  tic_motion_profile_jump(profile, 0);
+}
+
+static tic_error * tic_motion_profile_plan(tic_motion_profile * profile,
+  const tic_variables * variables)
+{
+  uint32_t max_speed_raw = tic_variables_get_max_speed(variables);
+  uint32_t starting_speed_raw = tic_variables_get_starting_speed(variables);
+  uint32_t accel_raw = tic_variables_get_max_accel(variables);
+  uint32_t decel_raw = tic_variables_get_max_decel(variables);
+  if (decel_raw == 0) { decel_raw = accel_raw; }
+  if (starting_speed_raw > max_speed_raw)
+  {
+    starting_speed_raw = max_speed_raw;
+  }
+
+  double target = profile->target_position;
+  profile->position = tic_variables_get_current_position(variables);
+  profile->velocity = tic_variables_get_current_velocity(variables) / 10000.0;
+  tic_motion_profile_note_speed(profile, profile->velocity);
+
+  if (max_speed_raw == 0 && profile->position != target)
+  {
+    return tic_error_create(
+      "The target cannot be reached because the max speed is 0.");
+  }
+
+  if (accel_raw == 0)
+  {
+    return tic_error_create(
+      "The target cannot be reached because the max acceleration is 0.");
+  }
+
+  // Convert from the Tic's units: speeds are in microsteps per 10000 s and
+  // accelerations are in microsteps per 100 s^2.
+  double max_speed = max_speed_raw / 10000.0;
+  double starting_speed = starting_speed_raw / 10000.0;
+  double accel = accel_raw / 100.0;
+  double decel = decel_raw / 100.0;
+
+  // The first pass either finishes the profile or stops the motor so that the
+  // second pass can start a fresh move toward the target.
+  for (int pass = 0; pass < 2; pass++)
+  {
+    double remaining = target - profile->position;
+    double speed = fabs(profile->velocity);
+
+    if (remaining == 0 && speed <= starting_speed)
+    {
+      break;
+    }
+
+    double direction;
+    if (remaining != 0)
+    {
+      direction = remaining > 0 ? 1 : -1;
+    }
+    else
+    {
+      direction = profile->velocity > 0 ? 1 : -1;
+    }
+    double distance = fabs(remaining);
+    double toward = profile->velocity * direction;
+
+    double stopping_distance = 0;
+    if (toward > starting_speed)
+    {
+      stopping_distance = (toward * toward -
+        starting_speed * starting_speed) / (2 * decel);
+    }
+
+    if (toward < 0 || stopping_distance > distance)
+    {
+      // We are moving away from the target, or too fast to stop before it.
+      // Stop and then try again from the new position.
+      tic_motion_profile_stop(profile, starting_speed, decel);
+      continue;
+    }
+
+    if (toward < starting_speed)
+    {
+      toward = starting_speed;
+    }
+
+    if (toward > max_speed)
+    {
+      // The max speed was lowered while moving, so slow down to it.
+      tic_motion_profile_jump(profile, direction * toward);
+      tic_motion_profile_add_segment(profile,
+        (toward - max_speed) / decel, -direction * decel);
+      toward = max_speed;
+      distance = fabs(target - profile->position);
+    }
+
+    // Find the peak speed, limited by the max speed or by the distance we
+    // have for accelerating and then decelerating to the starting speed.
+    double peak = max_speed;
+    if (peak == 0)
+    {
+      // The max speed is 0 and the first pass had to stop the motor
+      // somewhere other than the target.
+      return tic_error_create(
+        "The target cannot be reached because the max speed is 0.");
+    }
+    double ramp_distance = (peak * peak - toward * toward) / (2 * accel) +
+      (peak * peak - starting_speed * starting_speed) / (2 * decel);
+    double cruise_time = 0;
+    if (ramp_distance <= distance)
+    {
+      cruise_time = (distance - ramp_distance) / peak;
+    }
+    else
+    {
+      peak = sqrt((2 * accel * decel * distance + decel * toward * toward +
+        accel * starting_speed * starting_speed) / (accel + decel));
+      if (peak < toward) { peak = toward; }
+    }
+
+    tic_motion_profile_jump(profile, direction * toward);
+    tic_motion_profile_add_segment(profile,
+      (peak - toward) / accel, direction * accel);
+    tic_motion_profile_jump(profile, direction * peak);
+    tic_motion_profile_note_speed(profile, profile->velocity);
+    tic_motion_profile_add_segment(profile, cruise_time, 0);
+    tic_motion_profile_add_segment(profile,
+      (peak - starting_speed) / decel, -direction * decel);
+    break;
+  }
+
+  // Correct rounding errors so the motor ends exactly at the target.
+  profile->position = target;
+  profile->velocity = 0;
+  profile->duration = profile->time;
+  return NULL;
+}
+
+tic_error * tic_motion_profile_create(const tic_variables * variables,
+  int32_t target_position, tic_motion_profile ** profile)
+{
+  if (profile == NULL)
+  {
+    return tic_error_create("Motion profile output pointer is null.");
+  }
+
+  *profile = NULL;
+
+  if (variables == NULL)
+  {
+    return tic_error_create("Variables object is null.");
+  }
+
+  tic_error * error = NULL;
+
+  tic_motion_profile * new_profile = NULL;
+  if (error == NULL)
+  {
+    new_profile = calloc(1, sizeof(tic_motion_profile));
+    if (new_profile == NULL) { error = &tic_error_no_memory; }
+  }
+
+  if (error == NULL)
+  {
+    new_profile->target_position = target_position;
+    error = tic_motion_profile_plan(new_profile, variables);
+  }
+
+  if (error == NULL)
+  {
+    *profile = new_profile;
+    new_profile = NULL;
+  }
+
+  tic_motion_profile_free(new_profile);
+
+  if (error != NULL)
+  {
+    error = tic_error_add(error, "Failed to predict the motion profile.");
+  }
+
+  return error;
+}
+
+void tic_motion_profile_free(tic_motion_profile * profile)
+{
+  free(profile);
+}
+
+uint64_t tic_motion_profile_get_duration_us(const tic_motion_profile * profile)
+{
+  if (profile == NULL) { return 0; }
+  return (uint64_t)ceil(profile->duration * 1000000);
+}
+
+int32_t tic_motion_profile_get_peak_velocity(
+  const tic_motion_profile * profile)
+{
+  if (profile == NULL) { return 0; }
+  return (int32_t)lround(profile->peak_velocity * 10000);
+}
+
+// Finds the segment containing the specified time.  Returns NULL if the time
+// is after the end of the profile.
+static const tic_motion_segment * tic_motion_profile_find_segment(
+  const tic_motion_profile * profile, double time)
+{
+  for (size_t i = 0; i < profile->segment_count; i++)
+  {
+    const tic_motion_segment * segment = &profile->segments[i];
+    if (time < segment->start_time + segment->duration) { return segment; }
+  }
+  return NULL;
+}
+
+int32_t tic_motion_profile_get_position(const tic_motion_profile * profile,
+  uint64_t time_us)
+{
+  if (profile == NULL) { return 0; }
+  double time = time_us / 1000000.0;
+  const tic_motion_segment * segment =
+    tic_motion_profile_find_segment(profile, time);
+  if (segment == NULL) { return profile->target_position; }
+  double t = time - segment->start_time;
+  double position = segment->position +
+    (segment->velocity + segment->accel * t / 2) * t;
+  return (int32_t)lround(position);
+}
+
+int32_t tic_motion_profile_get_velocity(const tic_motion_profile * profile,
+  uint64_t time_us)
+{
+  if (profile == NULL) { return 0; }
+  double time = time_us / 1000000.0;
+  const tic_motion_segment * segment =
+    tic_motion_profile_find_segment(profile, time);
+  if (segment == NULL) { return 0; }
+  double t = time - segment->start_time;
+  return (int32_t)lround((segment->velocity + segment->accel * t) * 10000);
+}
@@ -600,9 +600,12 @@ bool tic_name_to_code(const tic_name * table, const char * name, uint32_t * code
   if (!table) { return false; }
   if (!name) { return false; }
 
+  // The tables are short and their order matters for tic_code_to_name, so we
+  // search them linearly, but we compare the first character before calling
+  // strcmp since most entries differ there.
   for (const tic_name * p = table; p->name; p++)
   {
-    if (!strcmp(p->name, name))
+    if (p->name[0] == name[0] && !strcmp(p->name, name))
     {
       if (code) { *code = p->code; }
       return true;
@@ -0,0 +1,360 @@
+// Functions for reading the variables from a Tic in a background thread.
+//
+// The polling thread is the only producer and writes each snapshot into a ring
+// of preallocated slots.  Every slot has a sequence number that is odd while
+// the slot is being written and equal to 2 * (n + 1) once it holds snapshot
+// number n, so readers can copy a slot without taking a lock and then check
+// whether it was overwritten while they were copying it (a seqlock).
+
+#include "tic_internal.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+typedef struct tic_poller_slot
+{
+  uint64_t sequence;
+  uint64_t timestamp_ns;
+  tic_variables * variables;
+} tic_poller_slot;
+
+struct tic_poller
+{
+  tic_handle * handle;
+  uint64_t period_ns;
+  size_t capacity;
+  tic_poller_slot * slots;
+  tic_variables * scratch;
+
+  // Written by the polling thread.
+  uint64_t sample_count;
+  uint64_t error_count;
+  bool running;
+
+  // Written by the consumer.
+  uint64_t read_count;
+  uint64_t dropped_count;
+  bool stop_requested;
+
+#ifdef _WIN32
+  HANDLE thread;
+#else
+  pthread_t thread;
+#endif
+  bool thread_started;
+};
+
+uint64_t tic_poller_get_time_ns(void)
+{
+#ifdef _WIN32
+  LARGE_INTEGER count, frequency;
+  QueryPerformanceCounter(&count);
+  QueryPerformanceFrequency(&frequency);
+  return (uint64_t)count.QuadPart / frequency.QuadPart * 1000000000 +
+    (uint64_t)count.QuadPart % frequency.QuadPart * 1000000000 /
+    frequency.QuadPart;
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+void tic_poller_sleep_until(uint64_t deadline_ns)
+{
+#if defined(__linux__)
+  // Sleep until an absolute time on the same clock that
+  // tic_poller_get_time_ns() uses, so that time spent getting here or being
+  // interrupted does not delay us further.
+  struct timespec deadline;
+  deadline.tv_sec = deadline_ns / 1000000000;
+  deadline.tv_nsec = deadline_ns % 1000000000;
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL)
+    == EINTR) { }
+#else
+  uint64_t now = tic_poller_get_time_ns();
+  if (now >= deadline_ns) { return; }
+  uint64_t delay = deadline_ns - now;
+#ifdef _WIN32
+  Sleep((DWORD)((delay + 999999) / 1000000));
+#else
+  struct timespec ts;
+  ts.tv_sec = delay / 1000000000;
+  ts.tv_nsec = delay % 1000000000;
+  while (nanosleep(&ts, &ts) != 0 && errno == EINTR) { }
+#endif
+#endif
+}
+
+static void tic_poller_publish(tic_poller * poller, uint64_t timestamp_ns)
+{
+  uint64_t n = poller->sample_count;
+  tic_poller_slot * slot = &poller->slots[n % poller->capacity];
+
+  TIC_ATOMIC_STORE_RELAXED(&slot->sequence, 2 * n + 1);
+  TIC_ATOMIC_FENCE_RELEASE();
+  slot->timestamp_ns = timestamp_ns;
+  tic_variables_copy_into(slot->variables, poller->scratch);
+  TIC_ATOMIC_STORE(&slot->sequence, 2 * n + 2);
+
+  TIC_ATOMIC_STORE(&poller->sample_count, n + 1);
+}
+
+static void tic_poller_run(tic_poller * poller)
+{
+  uint64_t deadline = tic_poller_get_time_ns();
+  while (!TIC_ATOMIC_LOAD(&poller->stop_requested))
+  {
+    uint64_t start = tic_poller_get_time_ns();
+    tic_error * error = tic_update_variables(poller->handle,
+      poller->scratch, false);
+    uint64_t end = tic_poller_get_time_ns();
+
+    if (error == NULL)
+    {
+      // The midpoint of the transfer is our best guess of when the device
+      // sampled its variables.
+      tic_poller_publish(poller, start + (end - start) / 2);
+    }
+    else
+    {
+      bool disconnected = tic_error_has_code(error,
+        TIC_ERROR_DEVICE_DISCONNECTED);
+      tic_error_free(error);
+      TIC_ATOMIC_STORE(&poller->error_count, poller->error_count + 1);
+      if (disconnected) { break; }
+    }
+
+    // Use absolute deadlines so the rate does not drift, but do not try to
+    // catch up on periods we missed.
+    deadline += poller->period_ns;
+    if (deadline < end) { deadline = end; }
+    tic_poller_sleep_until(deadline);
+  }
+  TIC_ATOMIC_STORE(&poller->running, false);
+}
+
+#ifdef _WIN32
+static DWORD WINAPI tic_poller_thread(LPVOID context)
+{
+  tic_poller_run((tic_poller *)context);
+  return 0;
+}
+#else
+static void * tic_poller_thread(void * context)
+{
+  tic_poller_run((tic_poller *)context);
+  return NULL;
+}
+#endif
+
+static void tic_poller_stop(tic_poller * poller)
+{
+  if (!poller->thread_started) { return; }
+  TIC_ATOMIC_STORE(&poller->stop_requested, true);
+#ifdef _WIN32
+  WaitForSingleObject(poller->thread, INFINITE);
+  CloseHandle(poller->thread);
+#else
+  pthread_join(poller->thread, NULL);
+#endif
+  poller->thread_started = false;
+}
+
+void tic_poller_free(tic_poller * poller)
+{
+  if (poller == NULL) { return; }
+
+  tic_poller_stop(poller);
+
+  if (poller->slots != NULL)
+  {
+    for (size_t i = 0; i < poller->capacity; i++)
+    {
+      tic_variables_free(poller->slots[i].variables);
+    }
+  }
+  free(poller->slots);
+  tic_variables_free(poller->scratch);
+  free(poller);
+}
+
+tic_error * tic_poller_create(tic_handle * handle, uint32_t period_us,
+  size_t capacity, tic_poller ** poller)
+{
+  if (poller == NULL)
+  {
+    return tic_error_create("Poller output pointer is null.");
+  }
+
+  *poller = NULL;
+
+  if (handle == NULL)
+  {
+    return tic_error_create("Handle is null.");
+  }
+
+  if (capacity < 2)
+  {
+    return tic_error_create("Poller capacity must be at least 2.");
+  }
+
+  tic_error * error = NULL;
+
+  tic_poller * new_poller = NULL;
+  if (error == NULL)
+  {
+    new_poller = calloc(1, sizeof(tic_poller));
+    if (new_poller == NULL) { error = &tic_error_no_memory; }
+  }
+
+  if (error == NULL)
+  {
+    new_poller->handle = handle;
+    new_poller->period_ns = (uint64_t)period_us * 1000;
+    new_poller->capacity = capacity;
+    new_poller->slots = calloc(capacity, sizeof(tic_poller_slot));
+    if (new_poller->slots == NULL) { error = &tic_error_no_memory; }
+  }
+
+  for (size_t i = 0; error == NULL && i < capacity; i++)
+  {
+    error = tic_variables_create(&new_poller->slots[i].variables);
+  }
+
+  if (error == NULL)
+  {
+    error = tic_variables_create(&new_poller->scratch);
+  }
+
+  if (error == NULL)
+  {
+    new_poller->running = true;
+#ifdef _WIN32
+    new_poller->thread = CreateThread(NULL, 0, tic_poller_thread,
+      new_poller, 0, NULL);
+    if (new_poller->thread == NULL)
+    {
+      error = tic_error_create("Failed to start the polling thread.");
+    }
+#else
+    int result = pthread_create(&new_poller->thread, NULL,
+      tic_poller_thread, new_poller);
+    if (result != 0)
+    {
+      error = tic_error_create("Failed to start the polling thread: "
+        "error code %d.", result);
+    }
+#endif
+    new_poller->thread_started = error == NULL;
+  }
+
+  if (error == NULL)
+  {
+    *poller = new_poller;
+    new_poller = NULL;
+  }
+
+  tic_poller_free(new_poller);
+
+  return error;
+}
+
+// Copies snapshot number n into the variables object.  Returns false if the
+// slot does not hold that snapshot, either because it has not been written yet
+// or because it was overwritten.
+static bool tic_poller_read_snapshot(tic_poller * poller, uint64_t n,
+  tic_variables * variables, uint64_t * timestamp_ns)
+{
+  tic_poller_slot * slot = &poller->slots[n % poller->capacity];
+
+  uint64_t sequence = TIC_ATOMIC_LOAD(&slot->sequence);
+  if (sequence != 2 * n + 2) { return false; }
+
+  uint64_t timestamp = slot->timestamp_ns;
+  tic_variables_copy_into(variables, slot->variables);
+
+  TIC_ATOMIC_FENCE_ACQUIRE();
+  if (TIC_ATOMIC_LOAD_RELAXED(&slot->sequence) != sequence)
+  {
+    return false;
+  }
+
+  if (timestamp_ns != NULL) { *timestamp_ns = timestamp; }
+  return true;
+}
+
+bool tic_poller_read_latest(tic_poller * poller,
+  tic_variables * variables, uint64_t * timestamp_ns)
+{
+  if (poller == NULL || variables == NULL) { return false; }
+
+  while (true)
+  {
+    uint64_t count = TIC_ATOMIC_LOAD(&poller->sample_count);
+    if (count == 0) { return false; }
+    if (tic_poller_read_snapshot(poller, count - 1, variables, timestamp_ns))
+    {
+      return true;
+    }
+  }
+}
+
+bool tic_poller_read_next(tic_poller * poller,
+  tic_variables * variables, uint64_t * timestamp_ns)
+{
+  if (poller == NULL || variables == NULL) { return false; }
+
+  while (true)
+  {
+    uint64_t count = TIC_ATOMIC_LOAD(&poller->sample_count);
+    uint64_t n = poller->read_count;
+    if (n == count) { return false; }
+
+    // The oldest slot might be getting overwritten right now, so skip it.
+    uint64_t oldest = count + 1 > poller->capacity ?
+      count + 1 - poller->capacity : 0;
+    if (n < oldest)
+    {
+      poller->dropped_count += oldest - n;
+      n = oldest;
+    }
+
+    if (tic_poller_read_snapshot(poller, n, variables, timestamp_ns))
+    {
+      poller->read_count = n + 1;
+      return true;
+    }
+
+    // The producer lapped us while we were reading.
+    poller->dropped_count++;
+    poller->read_count = n + 1;
+  }
+}
+
+uint64_t tic_poller_get_sample_count(const tic_poller * poller)
+{
+  if (poller == NULL) { return 0; }
+  return TIC_ATOMIC_LOAD(&poller->sample_count);
+}
+
+uint64_t tic_poller_get_dropped_count(const tic_poller * poller)
+{
+  if (poller == NULL) { return 0; }
+  return poller->dropped_count;
+}
+
+uint64_t tic_poller_get_error_count(const tic_poller * poller)
+{
+  if (poller == NULL) { return 0; }
+  return TIC_ATOMIC_LOAD(&poller->error_count);
+}
+
+bool tic_poller_is_running(const tic_poller * poller)
+{
+  if (poller == NULL) { return false; }
+  return TIC_ATOMIC_LOAD(&poller->running);
+}
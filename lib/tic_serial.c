@@ -0,0 +1,1047 @@
+// Functions for communicating with Tics over a serial port using the Tic's
+// serial command protocol.
+//
+// A serial bus (tic_serial_bus) owns the port and can have any number of
+// devices on it, each with its own handle.  Each request from tic_handle.c is
+// translated into a serial command for the handle's device.
+//
+// Serial commands are not acknowledged, so commands that do not read data
+// can be queued and sent together.  While the bus is batching, every device
+// has its own queue, and the queues are drained one command per device at a
+// time so that no device waits behind a long batch for another device.  When
+// we need to read more data than fits in one block read command, we can send
+// all of the block reads before reading any of the responses, since they all
+// go to the same device.  On a line that echoes what we send, every write is
+// followed by reading back and checking the echo.
+//
+// Only one thread can use the bus at a time, and threads take turns in the
+// order they asked for it (a ticket lock), so one busy thread cannot starve
+// the others.
+
+#include "tic_internal.h"
+
+#ifdef _WIN32
+
+tic_error * tic_serial_bus_open(const char * port_name, uint32_t baud_rate,
+  uint32_t flags, tic_serial_bus ** bus)
+{
+  (void)port_name;
+  (void)baud_rate;
+  (void)flags;
+  if (bus != NULL) { *bus = NULL; }
+  return tic_error_create("Serial ports are not supported on Windows.");
+}
+
+void tic_serial_bus_free(tic_serial_bus * bus)
+{
+  (void)bus;
+}
+
+tic_error * tic_serial_bus_open_device(tic_serial_bus * bus,
+  const tic_settings * settings, tic_handle ** handle)
+{
+  (void)bus;
+  (void)settings;
+  if (handle != NULL) { *handle = NULL; }
+  return tic_error_create("Serial ports are not supported on Windows.");
+}
+
+void tic_serial_bus_begin_batch(tic_serial_bus * bus)
+{
+  (void)bus;
+}
+
+tic_error * tic_serial_bus_end_batch(tic_serial_bus * bus)
+{
+  (void)bus;
+  return tic_error_create("Serial ports are not supported on Windows.");
+}
+
+tic_error * tic_serial_bus_get_device_stats(tic_serial_bus * bus,
+  uint16_t device_number, tic_serial_device_stats * stats)
+{
+  (void)bus;
+  (void)device_number;
+  (void)stats;
+  return tic_error_create("Serial ports are not supported on Windows.");
+}
+
+tic_error * tic_handle_open_serial(const char * port_name,
+  const tic_settings * settings, uint32_t flags, tic_handle ** handle)
+{
+  (void)port_name;
+  (void)settings;
+  (void)flags;
+  if (handle != NULL) { *handle = NULL; }
+  return tic_error_create("Serial ports are not supported on Windows.");
+}
+
+#else
+
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <termios.h>
+
+// The most bytes that one block read command can return.
+#define TIC_SERIAL_MAX_BLOCK_READ 15
+
+// With 7-bit responses, the most significant bits of the response bytes are
+// sent in an extra byte, so we read at most 7 bytes at a time.
+#define TIC_SERIAL_MAX_BLOCK_READ_7BIT 7
+
+// The longest command: 0xAA, two device number bytes, the command byte, five
+// data bytes, and a CRC byte.
+#define TIC_SERIAL_MAX_PACKET_SIZE 10
+
+// The number of commands each device can have queued while the bus is
+// batching.  When a queue is full, the queues of all devices are sent.
+#define TIC_SERIAL_QUEUE_LENGTH 32
+
+// How long to wait for a response, in addition to the time it takes to
+// transmit the bytes.
+#define TIC_SERIAL_RESPONSE_TIMEOUT_MS 100
+
+typedef struct tic_serial_packet
+{
+  uint8_t length;
+  uint8_t bytes[TIC_SERIAL_MAX_PACKET_SIZE];
+  uint64_t queued_us;
+} tic_serial_packet;
+
+typedef struct tic_serial_device
+{
+  tic_serial_bus * bus;
+  uint16_t device_number;
+  bool compact_protocol;
+  bool device_number_14bit;
+  bool crc_for_commands;
+  bool crc_for_responses;
+  bool responses_7bit;
+  uint8_t response_delay_us;
+
+  tic_serial_packet queue[TIC_SERIAL_QUEUE_LENGTH];
+  size_t queue_start;
+  size_t queue_count;
+
+  // Commands that were moved from the queue to the output buffer but might
+  // not be sent yet.
+  uint64_t unsent_count;
+  uint64_t unsent_queued_us_sum;
+  uint64_t unsent_oldest_us;
+
+  tic_serial_device_stats stats;
+} tic_serial_device;
+
+struct tic_serial_bus
+{
+  int fd;
+  uint32_t baud_rate;
+  bool half_duplex;
+  bool echo;
+
+  pthread_mutex_t mutex;
+  pthread_cond_t turn_changed;
+  uint64_t next_ticket;
+  uint64_t now_serving;
+
+  // The number of references to the bus: one from the caller of
+  // tic_serial_bus_open() until tic_serial_bus_free(), and one from every
+  // device.  Protected by the mutex.
+  size_t reference_count;
+
+  // The remaining members are only used by the thread whose turn it is.
+  tic_serial_device ** devices;
+  size_t device_count;
+  size_t next_device;
+  uint32_t batch_depth;
+  size_t output_length;
+  uint8_t output[256];
+};
+
+static uint64_t tic_serial_time_us(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// Computes the CRC-7 used by Pololu serial protocols.
+static uint8_t tic_serial_crc7(const uint8_t * buffer, size_t length)
+{
+  uint8_t crc = 0;
+  for (size_t i = 0; i < length; i++)
+  {
+    crc ^= buffer[i];
+    for (int j = 0; j < 8; j++)
+    {
+      if (crc & 1) { crc ^= 0x91; }
+      crc >>= 1;
+    }
+  }
+  return crc;
+}
+
+static tic_error * tic_serial_os_error(const char * action)
+{
+  uint32_t code = 0;
+  if (errno == EIO || errno == ENXIO || errno == ENODEV)
+  {
+    code = TIC_ERROR_DEVICE_DISCONNECTED;
+  }
+  return tic_transport_error_create(code, "Failed to %s the serial port: %s.",
+    action, strerror(errno));
+}
+
+// Waits until it is this thread's turn to use the bus.
+static void tic_serial_bus_lock(tic_serial_bus * bus)
+{
+  pthread_mutex_lock(&bus->mutex);
+  uint64_t ticket = bus->next_ticket++;
+  while (ticket != bus->now_serving)
+  {
+    pthread_cond_wait(&bus->turn_changed, &bus->mutex);
+  }
+  pthread_mutex_unlock(&bus->mutex);
+}
+
+static void tic_serial_bus_unlock(tic_serial_bus * bus)
+{
+  pthread_mutex_lock(&bus->mutex);
+  bus->now_serving++;
+  pthread_cond_broadcast(&bus->turn_changed);
+  pthread_mutex_unlock(&bus->mutex);
+}
+
+// Drops a reference to the bus and frees it if that was the last one.
+static void tic_serial_bus_release(tic_serial_bus * bus)
+{
+  pthread_mutex_lock(&bus->mutex);
+  bool last = --bus->reference_count == 0;
+  pthread_mutex_unlock(&bus->mutex);
+  if (!last) { return; }
+
+  close(bus->fd);
+  pthread_cond_destroy(&bus->turn_changed);
+  pthread_mutex_destroy(&bus->mutex);
+  free(bus->devices);
+  free(bus);
+}
+
+// Reads exactly the specified number of bytes, or fails if they do not
+// arrive before the deadline.
+static tic_error * tic_serial_bus_receive(tic_serial_bus * bus,
+  uint8_t * buffer, size_t length, uint64_t deadline_us)
+{
+  size_t received = 0;
+  while (received < length)
+  {
+    uint64_t now = tic_serial_time_us();
+    int timeout = now < deadline_us ? (int)((deadline_us - now + 999) / 1000) : 0;
+
+    struct pollfd pfd = { .fd = bus->fd, .events = POLLIN };
+    int result = poll(&pfd, 1, timeout);
+    if (result < 0)
+    {
+      if (errno == EINTR) { continue; }
+      return tic_serial_os_error("read from");
+    }
+
+    if (result == 0)
+    {
+      return tic_transport_error_create(TIC_ERROR_TIMEOUT,
+        "Timed out waiting for a response from the device.  "
+        "Expected %u bytes, got %u.",
+        (unsigned int)length, (unsigned int)received);
+    }
+
+    if (!(pfd.revents & POLLIN))
+    {
+      return tic_transport_error_create(TIC_ERROR_DEVICE_DISCONNECTED,
+        "The serial port was disconnected.");
+    }
+
+    ssize_t count = read(bus->fd, buffer + received, length - received);
+    if (count < 0)
+    {
+      if (errno == EINTR || errno == EAGAIN) { continue; }
+      return tic_serial_os_error("read from");
+    }
+    if (count == 0)
+    {
+      return tic_transport_error_create(TIC_ERROR_DEVICE_DISCONNECTED,
+        "The serial port was disconnected.");
+    }
+    received += count;
+  }
+  return NULL;
+}
+
+// Returns the time it takes to transmit the specified number of bytes.  Each
+// byte takes 10 bit times: a start bit, 8 data bits, and a stop bit.
+static uint64_t tic_serial_bus_transmit_time_us(const tic_serial_bus * bus,
+  size_t bytes)
+{
+  return ((uint64_t)bytes * 10 * 1000000 + bus->baud_rate - 1) /
+    bus->baud_rate;
+}
+
+// Sends everything in the output buffer.  If the line echoes, this also
+// reads back the echo and makes sure it matches what we sent.
+static tic_error * tic_serial_bus_write_output(tic_serial_bus * bus)
+{
+  tic_error * error = NULL;
+  size_t sent = 0;
+  while (error == NULL && sent < bus->output_length)
+  {
+    ssize_t result = write(bus->fd, bus->output + sent,
+      bus->output_length - sent);
+    if (result < 0)
+    {
+      if (errno != EINTR) { error = tic_serial_os_error("write to"); }
+      continue;
+    }
+    sent += result;
+  }
+
+  if (error == NULL && bus->echo)
+  {
+    uint8_t echo[sizeof(bus->output)];
+    uint64_t deadline = tic_serial_time_us() +
+      tic_serial_bus_transmit_time_us(bus, sent) +
+      TIC_SERIAL_RESPONSE_TIMEOUT_MS * 1000;
+    error = tic_serial_bus_receive(bus, echo, sent, deadline);
+    if (error == NULL && memcmp(echo, bus->output, sent) != 0)
+    {
+      error = tic_transport_error_create(0,
+        "The echo of the bytes sent did not match.  "
+        "There might be a collision on the serial line.");
+    }
+    if (error != NULL)
+    {
+      error = tic_error_add_static(error, "Failed to read back the echo.");
+    }
+  }
+
+  bus->output_length = 0;
+  return error;
+}
+
+static tic_error * tic_serial_bus_output(tic_serial_bus * bus,
+  const uint8_t * packet, size_t length)
+{
+  if (bus->output_length + length > sizeof(bus->output))
+  {
+    tic_error * error = tic_serial_bus_write_output(bus);
+    if (error != NULL) { return error; }
+  }
+  memcpy(bus->output + bus->output_length, packet, length);
+  bus->output_length += length;
+  return NULL;
+}
+
+// Sends the queued commands of every device, one command per device at a
+// time.  The device that goes first changes every time.
+static tic_error * tic_serial_bus_send_queued(tic_serial_bus * bus)
+{
+  tic_error * error = NULL;
+
+  bool more = true;
+  while (error == NULL && more)
+  {
+    more = false;
+    for (size_t i = 0; error == NULL && i < bus->device_count; i++)
+    {
+      tic_serial_device * device =
+        bus->devices[(bus->next_device + i) % bus->device_count];
+      if (device->queue_count == 0) { continue; }
+
+      tic_serial_packet * packet = &device->queue[device->queue_start];
+      device->queue_start = (device->queue_start + 1) % TIC_SERIAL_QUEUE_LENGTH;
+      device->queue_count--;
+      more = more || device->queue_count;
+
+      if (device->unsent_count == 0)
+      {
+        device->unsent_oldest_us = packet->queued_us;
+      }
+      device->unsent_count++;
+      device->unsent_queued_us_sum += packet->queued_us;
+
+      error = tic_serial_bus_output(bus, packet->bytes, packet->length);
+    }
+  }
+
+  if (error == NULL)
+  {
+    error = tic_serial_bus_write_output(bus);
+  }
+
+  if (bus->device_count)
+  {
+    bus->next_device = (bus->next_device + 1) % bus->device_count;
+  }
+
+  // Record how long each command waited before it was sent.
+  uint64_t now = tic_serial_time_us();
+  for (size_t i = 0; i < bus->device_count; i++)
+  {
+    tic_serial_device * device = bus->devices[i];
+    if (device->unsent_count == 0) { continue; }
+
+    tic_serial_device_stats * stats = &device->stats;
+    if (error == NULL)
+    {
+      stats->command_count += device->unsent_count;
+      stats->command_latency_total_us +=
+        now * device->unsent_count - device->unsent_queued_us_sum;
+      if (now - device->unsent_oldest_us > stats->command_latency_max_us)
+      {
+        stats->command_latency_max_us = now - device->unsent_oldest_us;
+      }
+    }
+    else
+    {
+      stats->error_count++;
+    }
+    device->unsent_count = 0;
+    device->unsent_queued_us_sum = 0;
+  }
+
+  return error;
+}
+
+// Encodes a command for the specified device.  Returns the length.
+static size_t tic_serial_device_encode(const tic_serial_device * device,
+  uint8_t command, const uint8_t * data, size_t data_length, uint8_t * packet)
+{
+  size_t length = 0;
+  if (device->compact_protocol)
+  {
+    packet[length++] = command;
+  }
+  else
+  {
+    packet[length++] = 0xAA;
+    packet[length++] = device->device_number & 0x7F;
+    if (device->device_number_14bit)
+    {
+      packet[length++] = device->device_number >> 7 & 0x7F;
+    }
+    packet[length++] = command & 0x7F;
+  }
+
+  memcpy(packet + length, data, data_length);
+  length += data_length;
+
+  if (device->crc_for_commands)
+  {
+    packet[length] = tic_serial_crc7(packet, length);
+    length++;
+  }
+
+  return length;
+}
+
+static tic_error * tic_serial_write(void * context,
+  uint8_t request, uint16_t value, uint16_t index)
+{
+  tic_serial_device * device = context;
+  tic_serial_bus * bus = device->bus;
+
+  uint8_t data[5];
+  size_t data_length = 0;
+  uint32_t value32 = (uint32_t)index << 16 | value;
+
+  switch (request)
+  {
+  case TIC_CMD_SET_TARGET_POSITION:
+  case TIC_CMD_SET_TARGET_VELOCITY:
+  case TIC_CMD_HALT_AND_SET_POSITION:
+  case TIC_CMD_SET_MAX_SPEED:
+  case TIC_CMD_SET_STARTING_SPEED:
+  case TIC_CMD_SET_MAX_ACCEL:
+  case TIC_CMD_SET_MAX_DECEL:
+    // The first data byte holds the most significant bit of each byte of
+    // the value, and the rest hold the lower 7 bits, least significant first.
+    data[0] = (value32 >> 7 & 1) | (value32 >> 14 & 2) |
+      (value32 >> 21 & 4) | (value32 >> 28 & 8);
+    data[1] = value32 >> 0 & 0x7F;
+    data[2] = value32 >> 8 & 0x7F;
+    data[3] = value32 >> 16 & 0x7F;
+    data[4] = value32 >> 24 & 0x7F;
+    data_length = 5;
+    break;
+
+  case TIC_CMD_GO_HOME:
+  case TIC_CMD_SET_STEP_MODE:
+  case TIC_CMD_SET_CURRENT_LIMIT:
+  case TIC_CMD_SET_DECAY_MODE:
+  case TIC_CMD_SET_AGC_OPTION:
+    if (value > 0x7F)
+    {
+      return tic_transport_error_create(0,
+        "The value %u cannot be sent over serial.", value);
+    }
+    data[0] = value;
+    data_length = 1;
+    break;
+
+  case TIC_CMD_HALT_AND_HOLD:
+  case TIC_CMD_RESET_COMMAND_TIMEOUT:
+  case TIC_CMD_DEENERGIZE:
+  case TIC_CMD_ENERGIZE:
+  case TIC_CMD_EXIT_SAFE_START:
+  case TIC_CMD_ENTER_SAFE_START:
+  case TIC_CMD_RESET:
+  case TIC_CMD_CLEAR_DRIVER_ERROR:
+    break;
+
+  default:
+    return tic_transport_error_create(0,
+      "Command 0x%02x is not supported over serial.", request);
+  }
+
+  tic_serial_bus_lock(bus);
+
+  tic_error * error = NULL;
+
+  if (device->queue_count == TIC_SERIAL_QUEUE_LENGTH)
+  {
+    error = tic_serial_bus_send_queued(bus);
+  }
+
+  if (error == NULL)
+  {
+    size_t i = (device->queue_start + device->queue_count) %
+      TIC_SERIAL_QUEUE_LENGTH;
+    tic_serial_packet * packet = &device->queue[i];
+    packet->length = tic_serial_device_encode(device, request,
+      data, data_length, packet->bytes);
+    packet->queued_us = tic_serial_time_us();
+    device->queue_count++;
+
+    if (bus->batch_depth == 0)
+    {
+      error = tic_serial_bus_send_queued(bus);
+    }
+  }
+
+  tic_serial_bus_unlock(bus);
+
+  return error;
+}
+
+static tic_error * tic_serial_read(void * context,
+  uint8_t request, uint16_t value, uint16_t index,
+  uint8_t * buffer, size_t length, size_t * transferred)
+{
+  (void)value;
+  tic_serial_device * device = context;
+  tic_serial_bus * bus = device->bus;
+
+  if (transferred != NULL) { *transferred = 0; }
+
+  if (request != TIC_CMD_GET_VARIABLE &&
+    request != TIC_CMD_GET_VARIABLE_AND_CLEAR_ERRORS_OCCURRED &&
+    request != TIC_CMD_GET_SETTING)
+  {
+    return tic_transport_error_create(0,
+      "Command 0x%02x is not supported over serial.", request);
+  }
+
+  // Block read offsets are sent as 7-bit data bytes.
+  if (length == 0 || index + length > 0x80)
+  {
+    return tic_transport_error_create(0,
+      "Cannot read %u bytes at offset 0x%x over serial.",
+      (unsigned int)length, index);
+  }
+
+  size_t block_size = device->responses_7bit ?
+    TIC_SERIAL_MAX_BLOCK_READ_7BIT : TIC_SERIAL_MAX_BLOCK_READ;
+  size_t overhead = device->responses_7bit + device->crc_for_responses;
+
+  uint64_t start = tic_serial_time_us();
+
+  tic_serial_bus_lock(bus);
+
+  // Send the queued commands first, so the commands for this device are
+  // received in order.
+  tic_error * error = tic_serial_bus_send_queued(bus);
+
+  // Discard any stale input so it cannot be mistaken for a response.
+  tcflush(bus->fd, TCIFLUSH);
+
+  // The block reads all go to one device, which answers them in order, so
+  // we can send them all at once unless the bus is half-duplex.
+  size_t sent = 0;
+  size_t received = 0;
+  uint64_t deadline = 0;
+  uint64_t expected_time = 0;
+  while (error == NULL && received < length)
+  {
+    while (error == NULL && sent < length &&
+      (!bus->half_duplex || sent == received))
+    {
+      size_t size = length - sent;
+      if (size > block_size) { size = block_size; }
+      uint8_t data[2] = { index + sent, size };
+      uint8_t packet[TIC_SERIAL_MAX_PACKET_SIZE];
+      size_t packet_length = tic_serial_device_encode(device, request,
+        data, sizeof(data), packet);
+      error = tic_serial_bus_output(bus, packet, packet_length);
+      expected_time += tic_serial_bus_transmit_time_us(bus,
+        packet_length + size + overhead) + device->response_delay_us;
+      sent += size;
+    }
+
+    if (error == NULL && bus->output_length)
+    {
+      error = tic_serial_bus_write_output(bus);
+      deadline = tic_serial_time_us() + expected_time +
+        TIC_SERIAL_RESPONSE_TIMEOUT_MS * 1000;
+      expected_time = 0;
+    }
+    if (error != NULL) { break; }
+
+    size_t size = length - received;
+    if (size > block_size) { size = block_size; }
+
+    uint8_t response[TIC_SERIAL_MAX_BLOCK_READ + 2];
+    size_t response_size = size + overhead;
+    error = tic_serial_bus_receive(bus, response, response_size, deadline);
+    if (error != NULL) { break; }
+
+    if (device->crc_for_responses)
+    {
+      response_size--;
+      if (tic_serial_crc7(response, response_size) != response[response_size])
+      {
+        error = tic_transport_error_create(0,
+          "The response from the device had an incorrect CRC byte.");
+        break;
+      }
+    }
+
+    for (size_t i = 0; i < size; i++)
+    {
+      uint8_t byte = response[i];
+      if (device->responses_7bit)
+      {
+        byte = (byte & 0x7F) | (response[size] >> i & 1) << 7;
+      }
+      buffer[received + i] = byte;
+    }
+
+    received += size;
+    if (transferred != NULL) { *transferred = received; }
+  }
+
+  tic_serial_device_stats * stats = &device->stats;
+  if (error == NULL)
+  {
+    uint64_t latency = tic_serial_time_us() - start;
+    stats->read_count++;
+    stats->read_latency_total_us += latency;
+    if (latency > stats->read_latency_max_us)
+    {
+      stats->read_latency_max_us = latency;
+    }
+  }
+  else
+  {
+    stats->error_count++;
+    if (tic_error_has_code(error, TIC_ERROR_TIMEOUT))
+    {
+      stats->timeout_count++;
+    }
+  }
+
+  tic_serial_bus_unlock(bus);
+
+  return error;
+}
+
+static void tic_serial_close(void * context)
+{
+  tic_serial_device * device = context;
+  tic_serial_bus * bus = device->bus;
+
+  tic_serial_bus_lock(bus);
+
+  // Send any commands that were queued but never sent.
+  if (device->queue_count)
+  {
+    tic_error_free(tic_serial_bus_send_queued(bus));
+  }
+
+  for (size_t i = 0; i < bus->device_count; i++)
+  {
+    if (bus->devices[i] == device)
+    {
+      memmove(bus->devices + i, bus->devices + i + 1,
+        (bus->device_count - i - 1) * sizeof(tic_serial_device *));
+      bus->device_count--;
+      break;
+    }
+  }
+  bus->next_device = 0;
+
+  tic_serial_bus_unlock(bus);
+
+  free(device);
+  tic_serial_bus_release(bus);
+}
+
+static void tic_serial_begin_batch(void * context)
+{
+  tic_serial_bus_begin_batch(((tic_serial_device *)context)->bus);
+}
+
+static tic_error * tic_serial_end_batch(void * context)
+{
+  return tic_serial_bus_end_batch(((tic_serial_device *)context)->bus);
+}
+
+static const tic_transport tic_serial_transport = {
+  .name = "serial",
+  .write = tic_serial_write,
+  .read = tic_serial_read,
+  .close = tic_serial_close,
+  .begin_batch = tic_serial_begin_batch,
+  .end_batch = tic_serial_end_batch,
+};
+
+// Finds the standard serial port speed closest to a baud rate.  The Tic's
+// baud rate generator cannot produce most baud rates exactly, so we allow a 3%
+// difference.
+static bool tic_serial_look_up_speed(uint32_t baud_rate, speed_t * speed)
+{
+  static const struct { uint32_t baud_rate; speed_t speed; } speeds[] = {
+    { 1200, B1200 },
+    { 2400, B2400 },
+    { 4800, B4800 },
+    { 9600, B9600 },
+    { 19200, B19200 },
+    { 38400, B38400 },
+    { 57600, B57600 },
+    { 115200, B115200 },
+  };
+
+  for (size_t i = 0; i < sizeof(speeds) / sizeof(speeds[0]); i++)
+  {
+    uint32_t difference = baud_rate > speeds[i].baud_rate ?
+      baud_rate - speeds[i].baud_rate : speeds[i].baud_rate - baud_rate;
+    if (difference * 100 <= speeds[i].baud_rate * 3)
+    {
+      *speed = speeds[i].speed;
+      return true;
+    }
+  }
+  return false;
+}
+
+static tic_error * tic_serial_configure(int fd, speed_t speed)
+{
+  struct termios options;
+  if (tcgetattr(fd, &options))
+  {
+    return tic_serial_os_error("get the settings of");
+  }
+
+  cfmakeraw(&options);
+  options.c_cflag |= CLOCAL | CREAD;
+  options.c_cflag &= ~(CSTOPB | PARENB | CRTSCTS);
+  options.c_cc[VMIN] = 0;
+  options.c_cc[VTIME] = 0;
+  cfsetispeed(&options, speed);
+  cfsetospeed(&options, speed);
+
+  if (tcsetattr(fd, TCSANOW, &options))
+  {
+    return tic_serial_os_error("configure");
+  }
+
+  // We opened the port in non-blocking mode so that the open would not wait
+  // for a carrier signal.  Use blocking writes from now on.
+  int fd_flags = fcntl(fd, F_GETFL);
+  if (fd_flags == -1 || fcntl(fd, F_SETFL, fd_flags & ~O_NONBLOCK) == -1)
+  {
+    return tic_serial_os_error("configure");
+  }
+
+  return NULL;
+}
+
+tic_error * tic_serial_bus_open(const char * port_name, uint32_t baud_rate,
+  uint32_t flags, tic_serial_bus ** bus)
+{
+  if (bus == NULL)
+  {
+    return tic_error_create("Bus output pointer is null.");
+  }
+
+  *bus = NULL;
+
+  if (port_name == NULL)
+  {
+    return tic_error_create("Serial port name is null.");
+  }
+
+  tic_error * error = NULL;
+
+  speed_t speed = 0;
+  if (!tic_serial_look_up_speed(baud_rate, &speed))
+  {
+    error = tic_error_create(
+      "The baud rate %u is not supported by the serial port.", baud_rate);
+  }
+
+  tic_serial_bus * new_bus = NULL;
+  if (error == NULL)
+  {
+    new_bus = calloc(1, sizeof(tic_serial_bus));
+    if (new_bus == NULL) { error = &tic_error_no_memory; }
+  }
+
+  if (error == NULL)
+  {
+    new_bus->fd = open(port_name, O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (new_bus->fd == -1)
+    {
+      error = tic_serial_os_error("open");
+      free(new_bus);
+      new_bus = NULL;
+    }
+  }
+
+  if (error == NULL)
+  {
+    new_bus->baud_rate = baud_rate;
+    new_bus->echo = flags & TIC_SERIAL_ECHO;
+    new_bus->half_duplex = flags & TIC_SERIAL_HALF_DUPLEX || new_bus->echo;
+    new_bus->reference_count = 1;
+    pthread_mutex_init(&new_bus->mutex, NULL);
+    pthread_cond_init(&new_bus->turn_changed, NULL);
+    error = tic_serial_configure(new_bus->fd, speed);
+  }
+
+  if (error == NULL)
+  {
+    *bus = new_bus;
+    new_bus = NULL;
+  }
+
+  if (new_bus != NULL) { tic_serial_bus_release(new_bus); }
+
+  if (error != NULL)
+  {
+    error = tic_error_add(error,
+      "There was an error opening the serial port %s.", port_name);
+  }
+
+  return error;
+}
+
+void tic_serial_bus_free(tic_serial_bus * bus)
+{
+  if (bus != NULL) { tic_serial_bus_release(bus); }
+}
+
+static tic_error * tic_serial_bus_add_device(tic_serial_bus * bus,
+  const tic_settings * settings, bool compact_protocol, tic_handle ** handle)
+{
+  if (handle == NULL)
+  {
+    return tic_error_create("Handle output pointer is null.");
+  }
+
+  *handle = NULL;
+
+  if (bus == NULL)
+  {
+    return tic_error_create("Bus is null.");
+  }
+
+  if (settings == NULL)
+  {
+    return tic_error_create("Settings object is null.");
+  }
+
+  uint32_t baud_rate = tic_settings_get_serial_baud_rate(settings);
+  speed_t bus_speed = 0, device_speed = 0;
+  tic_serial_look_up_speed(bus->baud_rate, &bus_speed);
+  if (!tic_serial_look_up_speed(baud_rate, &device_speed) ||
+    device_speed != bus_speed)
+  {
+    return tic_error_create(
+      "The device's baud rate (%u) does not match the bus (%u).",
+      baud_rate, bus->baud_rate);
+  }
+
+  tic_error * error = NULL;
+
+  tic_serial_device * device = calloc(1, sizeof(tic_serial_device));
+  if (device == NULL) { return &tic_error_no_memory; }
+
+  device->bus = bus;
+  device->device_number = tic_settings_get_serial_device_number_u16(settings);
+  device->compact_protocol = compact_protocol;
+  device->device_number_14bit =
+    tic_settings_get_serial_14bit_device_number(settings);
+  device->crc_for_commands = tic_settings_get_serial_crc_for_commands(settings);
+  device->crc_for_responses =
+    tic_settings_get_serial_crc_for_responses(settings);
+  device->responses_7bit = tic_settings_get_serial_7bit_responses(settings);
+  device->response_delay_us = tic_settings_get_serial_response_delay(settings);
+
+  tic_serial_bus_lock(bus);
+
+  for (size_t i = 0; error == NULL && i < bus->device_count; i++)
+  {
+    if (compact_protocol || bus->devices[i]->compact_protocol)
+    {
+      error = tic_error_create(
+        "The compact protocol only works with one device on the bus.");
+    }
+    else if (bus->devices[i]->device_number == device->device_number)
+    {
+      error = tic_error_create("Device number %u is already on the bus.",
+        device->device_number);
+    }
+  }
+
+  if (error == NULL)
+  {
+    tic_serial_device ** devices = realloc(bus->devices,
+      (bus->device_count + 1) * sizeof(tic_serial_device *));
+    if (devices == NULL)
+    {
+      error = &tic_error_no_memory;
+    }
+    else
+    {
+      bus->devices = devices;
+      bus->devices[bus->device_count++] = device;
+    }
+  }
+
+  tic_serial_bus_unlock(bus);
+
+  if (error != NULL)
+  {
+    free(device);
+    return error;
+  }
+
+  pthread_mutex_lock(&bus->mutex);
+  bus->reference_count++;
+  pthread_mutex_unlock(&bus->mutex);
+
+  uint16_t firmware_version = tic_settings_get_firmware_version(settings);
+  if (firmware_version == 0) { firmware_version = 0x0109; }
+
+  // This takes ownership of the device and closes it on failure.
+  return tic_handle_open_transport(&tic_serial_transport, device,
+    tic_settings_get_product(settings), firmware_version, NULL, handle);
+}
+
+tic_error * tic_serial_bus_open_device(tic_serial_bus * bus,
+  const tic_settings * settings, tic_handle ** handle)
+{
+  return tic_serial_bus_add_device(bus, settings, false, handle);
+}
+
+void tic_serial_bus_begin_batch(tic_serial_bus * bus)
+{
+  if (bus == NULL) { return; }
+  tic_serial_bus_lock(bus);
+  bus->batch_depth++;
+  tic_serial_bus_unlock(bus);
+}
+
+tic_error * tic_serial_bus_end_batch(tic_serial_bus * bus)
+{
+  if (bus == NULL)
+  {
+    return tic_error_create("Bus is null.");
+  }
+
+  tic_error * error = NULL;
+  tic_serial_bus_lock(bus);
+  if (bus->batch_depth) { bus->batch_depth--; }
+  if (bus->batch_depth == 0)
+  {
+    error = tic_serial_bus_send_queued(bus);
+  }
+  tic_serial_bus_unlock(bus);
+  return error;
+}
+
+tic_error * tic_serial_bus_get_device_stats(tic_serial_bus * bus,
+  uint16_t device_number, tic_serial_device_stats * stats)
+{
+  if (bus == NULL)
+  {
+    return tic_error_create("Bus is null.");
+  }
+
+  if (stats == NULL)
+  {
+    return tic_error_create("Stats output pointer is null.");
+  }
+
+  bool found = false;
+  tic_serial_bus_lock(bus);
+  for (size_t i = 0; !found && i < bus->device_count; i++)
+  {
+    if (bus->devices[i]->device_number == device_number)
+    {
+      *stats = bus->devices[i]->stats;
+      found = true;
+    }
+  }
+  tic_serial_bus_unlock(bus);
+
+  if (!found)
+  {
+    return tic_error_create("Device number %u is not on the bus.",
+      device_number);
+  }
+
+  return NULL;
+}
+
+tic_error * tic_handle_open_serial(const char * port_name,
+  const tic_settings * settings, uint32_t flags, tic_handle ** handle)
+{
+  if (handle == NULL)
+  {
+    return tic_error_create("Handle output pointer is null.");
+  }
+
+  *handle = NULL;
+
+  if (settings == NULL)
+  {
+    return tic_error_create("Settings object is null.");
+  }
+
+  tic_serial_bus * bus = NULL;
+  tic_error * error = tic_serial_bus_open(port_name,
+    tic_settings_get_serial_baud_rate(settings), flags, &bus);
+
+  if (error == NULL)
+  {
+    error = tic_serial_bus_add_device(bus, settings,
+      flags & TIC_SERIAL_COMPACT_PROTOCOL, handle);
+  }
+
+  // The handle keeps the bus open.
+  tic_serial_bus_free(bus);
+
+  return error;
+}
+
+#endif
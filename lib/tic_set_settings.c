@@ -2,7 +2,7 @@
 
 #include "tic_internal.h"
 
-static void tic_write_settings_to_buffer(const tic_settings * settings, uint8_t * buf)
+void tic_write_settings_to_buffer(const tic_settings * settings, uint8_t * buf)
 {
   assert(settings != NULL);
   assert(buf != NULL);
@@ -342,17 +342,14 @@ static void tic_write_settings_to_buffer(const tic_settings * settings, uint8_t
     tic_settings_get_invert_motor_direction(settings);
 }
 
-tic_error * tic_set_settings(tic_handle * handle, const tic_settings * settings)
+// Makes a fixed copy of the settings for the device the handle is connected to
+// and writes the bytes we want to store in its EEPROM into buf.
+static tic_error * tic_prepare_settings_buffer(tic_handle * handle,
+  const tic_settings * settings, uint8_t * buf)
 {
-  if (handle == NULL)
-  {
-    return tic_error_create("Handle is null.");
-  }
-
-  if (settings == NULL)
-  {
-    return tic_error_create("Settings object is null.");
-  }
+  assert(handle != NULL);
+  assert(settings != NULL);
+  assert(buf != NULL);
 
   tic_error * error = NULL;
 
@@ -379,9 +376,36 @@ tic_error * tic_set_settings(tic_handle * handle, const tic_settings * settings)
   }
 
   // Construct a buffer holding the bytes we want to write.
+  if (error == NULL)
+  {
+    memset(buf, 0, TIC_SETTINGS_SIZE);
+    tic_write_settings_to_buffer(fixed_settings, buf);
+  }
+
+  tic_settings_free(fixed_settings);
+
+  return error;
+}
+
+tic_error * tic_set_settings(tic_handle * handle, const tic_settings * settings)
+{
+  if (handle == NULL)
+  {
+    return tic_error_create("Handle is null.");
+  }
+
+  if (settings == NULL)
+  {
+    return tic_error_create("Settings object is null.");
+  }
+
+  tic_error * error = NULL;
+
   uint8_t buf[TIC_SETTINGS_SIZE];
-  memset(buf, 0, sizeof(buf));
-  tic_write_settings_to_buffer(fixed_settings, buf);
+  if (error == NULL)
+  {
+    error = tic_prepare_settings_buffer(handle, settings, buf);
+  }
 
   // Write the bytes to the device.
   for (uint8_t i = 1; i < sizeof(buf) && error == NULL; i++)
@@ -389,7 +413,68 @@ tic_error * tic_set_settings(tic_handle * handle, const tic_settings * settings)
     error = tic_set_setting_byte(handle, i, buf[i]);
   }
 
-  tic_settings_free(fixed_settings);
+  if (error != NULL)
+  {
+    error = tic_error_add(error,
+      "There was an error applying settings to the device.");
+  }
+
+  return error;
+}
+
+tic_error * tic_set_settings_differential(tic_handle * handle,
+  const tic_settings * settings, size_t * bytes_written)
+{
+  if (bytes_written != NULL)
+  {
+    *bytes_written = 0;
+  }
+
+  if (handle == NULL)
+  {
+    return tic_error_create("Handle is null.");
+  }
+
+  if (settings == NULL)
+  {
+    return tic_error_create("Settings object is null.");
+  }
+
+  tic_error * error = NULL;
+
+  uint8_t buf[TIC_SETTINGS_SIZE];
+  if (error == NULL)
+  {
+    error = tic_prepare_settings_buffer(handle, settings, buf);
+  }
+
+  // Read the settings currently stored on the device.
+  uint8_t old_buf[TIC_SETTINGS_SIZE];
+  {
+    memset(old_buf, 0, sizeof(old_buf));
+    size_t index = 1;
+    while (index < sizeof(old_buf) && error == NULL)
+    {
+      size_t length = TIC_MAX_USB_RESPONSE_SIZE;
+      if (index + length > sizeof(old_buf))
+      {
+        length = sizeof(old_buf) - index;
+      }
+      error = tic_get_setting_segment(handle, index, length, old_buf + index);
+      index += length;
+    }
+  }
+
+  // Write only the bytes that are different.
+  for (uint8_t i = 1; i < sizeof(buf) && error == NULL; i++)
+  {
+    if (buf[i] == old_buf[i]) { continue; }
+    error = tic_set_setting_byte(handle, i, buf[i]);
+    if (error == NULL && bytes_written != NULL)
+    {
+      (*bytes_written)++;
+    }
+  }
 
   if (error != NULL)
   {
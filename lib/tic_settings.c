@@ -71,20 +71,119 @@ struct tic_settings
   uint32_t homing_speed_towards;
   uint32_t homing_speed_away;
   bool invert_motor_direction;
+
+  // A copy of the settings from the last time they were fixed, which lets
+  // tic_settings_fix() skip the checks for fields that have not changed.
+  tic_settings * last_fixed;
+};
+
+// The fields that tic_settings_fix() checks, and the group each belongs to.
+// Fields that are not listed here are never changed by tic_settings_fix().
+static const struct
+{
+  size_t offset;
+  size_t size;
+  uint32_t group;
+} tic_settings_group_fields[] = {
+#define TIC_SETTINGS_GROUP_FIELD(field, group) \
+  { offsetof(tic_settings, field), \
+    sizeof(((tic_settings *)0)->field), TIC_SETTINGS_GROUP_##group }
+  TIC_SETTINGS_GROUP_FIELD(product, DEVICE),
+  TIC_SETTINGS_GROUP_FIELD(firmware_version, DEVICE),
+  TIC_SETTINGS_GROUP_FIELD(control_mode, CONTROL_MODE),
+  TIC_SETTINGS_GROUP_FIELD(soft_error_response, SOFT_ERROR_RESPONSE),
+  TIC_SETTINGS_GROUP_FIELD(serial_baud_rate, SERIAL_BAUD_RATE),
+  TIC_SETTINGS_GROUP_FIELD(serial_device_number, SERIAL_DEVICE_NUMBER),
+  TIC_SETTINGS_GROUP_FIELD(serial_alt_device_number, SERIAL_DEVICE_NUMBER),
+  TIC_SETTINGS_GROUP_FIELD(serial_enable_alt_device_number, SERIAL_DEVICE_NUMBER),
+  TIC_SETTINGS_GROUP_FIELD(serial_14bit_device_number, SERIAL_DEVICE_NUMBER),
+  TIC_SETTINGS_GROUP_FIELD(command_timeout, COMMAND_TIMEOUT),
+  TIC_SETTINGS_GROUP_FIELD(serial_crc_for_responses, SERIAL_RESPONSES),
+  TIC_SETTINGS_GROUP_FIELD(serial_7bit_responses, SERIAL_RESPONSES),
+  TIC_SETTINGS_GROUP_FIELD(low_vin_shutoff_voltage, VIN),
+  TIC_SETTINGS_GROUP_FIELD(low_vin_startup_voltage, VIN),
+  TIC_SETTINGS_GROUP_FIELD(high_vin_shutoff_voltage, VIN),
+  TIC_SETTINGS_GROUP_FIELD(vin_calibration, VIN_CALIBRATION),
+  TIC_SETTINGS_GROUP_FIELD(input_scaling_degree, INPUT_SCALING_DEGREE),
+  TIC_SETTINGS_GROUP_FIELD(input_min, INPUT_SCALING),
+  TIC_SETTINGS_GROUP_FIELD(input_neutral_min, INPUT_SCALING),
+  TIC_SETTINGS_GROUP_FIELD(input_neutral_max, INPUT_SCALING),
+  TIC_SETTINGS_GROUP_FIELD(input_max, INPUT_SCALING),
+  TIC_SETTINGS_GROUP_FIELD(output_min, OUTPUT_SCALING),
+  TIC_SETTINGS_GROUP_FIELD(output_max, OUTPUT_SCALING),
+  TIC_SETTINGS_GROUP_FIELD(encoder_prescaler, ENCODER),
+  TIC_SETTINGS_GROUP_FIELD(encoder_postscaler, ENCODER),
+  TIC_SETTINGS_GROUP_FIELD(pin_settings, PINS),
+  TIC_SETTINGS_GROUP_FIELD(current_limit, CURRENT_LIMIT),
+  TIC_SETTINGS_GROUP_FIELD(current_limit_during_error, CURRENT_LIMIT),
+  TIC_SETTINGS_GROUP_FIELD(step_mode, STEP_MODE),
+  TIC_SETTINGS_GROUP_FIELD(decay_mode, DECAY_MODE),
+  TIC_SETTINGS_GROUP_FIELD(agc_mode, AGC),
+  TIC_SETTINGS_GROUP_FIELD(agc_bottom_current_limit, AGC),
+  TIC_SETTINGS_GROUP_FIELD(agc_current_boost_steps, AGC),
+  TIC_SETTINGS_GROUP_FIELD(agc_frequency_limit, AGC),
+  TIC_SETTINGS_GROUP_FIELD(starting_speed, SPEED),
+  TIC_SETTINGS_GROUP_FIELD(max_speed, SPEED),
+  TIC_SETTINGS_GROUP_FIELD(max_accel, ACCEL),
+  TIC_SETTINGS_GROUP_FIELD(max_decel, ACCEL),
+  TIC_SETTINGS_GROUP_FIELD(auto_homing, AUTO_HOMING),
+  TIC_SETTINGS_GROUP_FIELD(homing_speed_towards, SPEED),
+  TIC_SETTINGS_GROUP_FIELD(homing_speed_away, SPEED),
+#undef TIC_SETTINGS_GROUP_FIELD
 };
 
+uint32_t tic_settings_changed_groups(const tic_settings * a,
+  const tic_settings * b)
+{
+  if (a == NULL || b == NULL) { return TIC_SETTINGS_GROUP_ALL; }
+
+  uint32_t groups = 0;
+  size_t count = sizeof(tic_settings_group_fields) /
+    sizeof(tic_settings_group_fields[0]);
+  for (size_t i = 0; i < count; i++)
+  {
+    size_t offset = tic_settings_group_fields[i].offset;
+    if (memcmp((const uint8_t *)a + offset, (const uint8_t *)b + offset,
+      tic_settings_group_fields[i].size))
+    {
+      groups |= tic_settings_group_fields[i].group;
+    }
+  }
+  return groups;
+}
+
+const tic_settings * tic_settings_get_last_fixed(const tic_settings * settings)
+{
+  if (settings == NULL) { return NULL; }
+  return settings->last_fixed;
+}
+
+void tic_settings_save_fixed(tic_settings * settings)
+{
+  if (settings == NULL) { return; }
+  if (settings->last_fixed == NULL)
+  {
+    settings->last_fixed = (tic_settings *)malloc(sizeof(tic_settings));
+    if (settings->last_fixed == NULL) { return; }
+  }
+  memcpy(settings->last_fixed, settings, sizeof(tic_settings));
+  settings->last_fixed->last_fixed = NULL;
+}
+
 void tic_settings_fill_with_defaults(tic_settings * settings)
 {
   if (settings == NULL) { return; }
 
   uint8_t product = tic_settings_get_product(settings);
   uint16_t version = tic_settings_get_firmware_version(settings);
+  tic_settings * last_fixed = settings->last_fixed;
 
-  // Reset all fields to zero and then restore the product and
-  // firmware version.
+  // Reset all fields to zero and then restore the product, firmware version,
+  // and the copy used by tic_settings_fix().
   memset(settings, 0, sizeof(tic_settings));
   tic_settings_set_product(settings, product);
   tic_settings_set_firmware_version(settings, version);
+  settings->last_fixed = last_fixed;
 
   // The product should be set beforehand, and if it is not then quit.
   if (!product)
@@ -189,6 +288,8 @@ tic_error * tic_settings_create(tic_settings ** settings)
 
 void tic_settings_free(tic_settings * settings)
 {
+  if (settings == NULL) { return; }
+  free(settings->last_fixed);
   free(settings);
 }
 
@@ -218,6 +319,19 @@ tic_error * tic_settings_copy(const tic_settings * source, tic_settings ** dest)
   if (error == NULL)
   {
     memcpy(new_settings, source, sizeof(tic_settings));
+    new_settings->last_fixed = NULL;
+
+    // Copy the last fixed settings too, so that fixing the copy is fast.
+    // This is optional, so a memory allocation failure is not an error.
+    if (source->last_fixed != NULL)
+    {
+      new_settings->last_fixed = (tic_settings *)malloc(sizeof(tic_settings));
+      if (new_settings->last_fixed != NULL)
+      {
+        memcpy(new_settings->last_fixed, source->last_fixed,
+          sizeof(tic_settings));
+      }
+    }
   }
 
   if (error == NULL)
@@ -0,0 +1,185 @@
+// Functions for finding the differences between two settings objects.
+//
+// The fields are compared in the form they have in a settings file, as
+// generated by tic_settings_print_fields(), so the differences are reported
+// with the same names and values that tic_settings_to_string() uses.
+
+#include "tic_internal.h"
+
+// More than the number of fields in a settings file for any product.
+#define TIC_SETTINGS_DIFF_MAX_FIELDS 96
+
+typedef struct tic_settings_field
+{
+  const char * name;
+  char value[TIC_SETTINGS_FIELD_VALUE_SIZE];
+} tic_settings_field;
+
+typedef struct tic_settings_field_list
+{
+  size_t count;
+  tic_settings_field fields[TIC_SETTINGS_DIFF_MAX_FIELDS];
+} tic_settings_field_list;
+
+typedef struct tic_settings_diff_entry
+{
+  const char * name;
+  bool has_old_value;
+  bool has_new_value;
+  char old_value[TIC_SETTINGS_FIELD_VALUE_SIZE];
+  char new_value[TIC_SETTINGS_FIELD_VALUE_SIZE];
+} tic_settings_diff_entry;
+
+struct tic_settings_diff
+{
+  size_t count;
+  tic_settings_diff_entry entries[];
+};
+
+static void add_field_to_list(void * context,
+  const char * name, const char * value)
+{
+  tic_settings_field_list * list = (tic_settings_field_list *)context;
+  assert(list->count < TIC_SETTINGS_DIFF_MAX_FIELDS);
+  if (list->count >= TIC_SETTINGS_DIFF_MAX_FIELDS) { return; }
+  tic_settings_field * field = &list->fields[list->count++];
+  field->name = name;
+  strncpy(field->value, value, sizeof(field->value) - 1);
+  field->value[sizeof(field->value) - 1] = 0;
+}
+
+static void get_field_list(const tic_settings * settings,
+  tic_settings_field_list * list)
+{
+  list->count = 0;
+  tic_settings_field_printer printer = { add_field_to_list, list };
+  tic_settings_print_fields(settings, &printer);
+}
+
+// Returns the index of the field with the given name, or SIZE_MAX.  The two
+// lists usually have the fields in the same order, so we start looking at the
+// hint and wrap around.
+static size_t find_field(const tic_settings_field_list * list,
+  const char * name, size_t hint)
+{
+  for (size_t i = 0; i < list->count; i++)
+  {
+    size_t index = (hint + i) % list->count;
+    if (strcmp(list->fields[index].name, name) == 0) { return index; }
+  }
+  return SIZE_MAX;
+}
+
+static void add_entry(tic_settings_diff * diff, const char * name,
+  const char * old_value, const char * new_value)
+{
+  tic_settings_diff_entry * entry = &diff->entries[diff->count++];
+  entry->name = name;
+  entry->has_old_value = old_value != NULL;
+  entry->has_new_value = new_value != NULL;
+  if (old_value != NULL) { strcpy(entry->old_value, old_value); }
+  if (new_value != NULL) { strcpy(entry->new_value, new_value); }
+}
+
+tic_error * tic_settings_diff_create(const tic_settings * old_settings,
+  const tic_settings * new_settings, tic_settings_diff ** diff)
+{
+  if (diff == NULL)
+  {
+    return tic_error_create("Settings diff output pointer is null.");
+  }
+
+  *diff = NULL;
+
+  if (old_settings == NULL || new_settings == NULL)
+  {
+    return tic_error_create("Settings pointer is null.");
+  }
+
+  tic_settings_field_list * lists = malloc(2 * sizeof(tic_settings_field_list));
+  if (lists == NULL)
+  {
+    return &tic_error_no_memory;
+  }
+  tic_settings_field_list * old_list = &lists[0];
+  tic_settings_field_list * new_list = &lists[1];
+  get_field_list(old_settings, old_list);
+  get_field_list(new_settings, new_list);
+
+  // Every field in either list could be different, so this is enough room.
+  size_t capacity = old_list->count + new_list->count;
+  tic_settings_diff * new_diff = malloc(sizeof(tic_settings_diff) +
+    capacity * sizeof(tic_settings_diff_entry));
+  if (new_diff == NULL)
+  {
+    free(lists);
+    return &tic_error_no_memory;
+  }
+  new_diff->count = 0;
+
+  bool old_matched[TIC_SETTINGS_DIFF_MAX_FIELDS] = { false };
+  size_t hint = 0;
+  for (size_t i = 0; i < new_list->count; i++)
+  {
+    const tic_settings_field * field = &new_list->fields[i];
+    size_t j = find_field(old_list, field->name, hint);
+    if (j == SIZE_MAX)
+    {
+      add_entry(new_diff, field->name, NULL, field->value);
+      continue;
+    }
+    old_matched[j] = true;
+    hint = j + 1;
+    if (strcmp(old_list->fields[j].value, field->value) != 0)
+    {
+      add_entry(new_diff, field->name, old_list->fields[j].value, field->value);
+    }
+  }
+
+  for (size_t j = 0; j < old_list->count; j++)
+  {
+    if (!old_matched[j])
+    {
+      add_entry(new_diff, old_list->fields[j].name,
+        old_list->fields[j].value, NULL);
+    }
+  }
+
+  free(lists);
+  *diff = new_diff;
+  return NULL;
+}
+
+void tic_settings_diff_free(tic_settings_diff * diff)
+{
+  free(diff);
+}
+
+size_t tic_settings_diff_get_count(const tic_settings_diff * diff)
+{
+  if (diff == NULL) { return 0; }
+  return diff->count;
+}
+
+const char * tic_settings_diff_get_name(const tic_settings_diff * diff,
+  size_t index)
+{
+  if (diff == NULL || index >= diff->count) { return NULL; }
+  return diff->entries[index].name;
+}
+
+const char * tic_settings_diff_get_old_value(const tic_settings_diff * diff,
+  size_t index)
+{
+  if (diff == NULL || index >= diff->count) { return NULL; }
+  const tic_settings_diff_entry * entry = &diff->entries[index];
+  return entry->has_old_value ? entry->old_value : NULL;
+}
+
+const char * tic_settings_diff_get_new_value(const tic_settings_diff * diff,
+  size_t index)
+{
+  if (diff == NULL || index >= diff->count) { return NULL; }
+  const tic_settings_diff_entry * entry = &diff->entries[index];
+  return entry->has_new_value ? entry->new_value : NULL;
+}
@@ -1,7 +1,106 @@
 // Functions for fixing settings to be valid.
+//
+// The checks are organized as a table of rules.  Each rule lists the groups of
+// fields that it reads and the groups that it might change (see
+// tic_settings_group).  The settings remember a copy of themselves from the
+// last time they were fixed, and tic_settings_fix() only runs the rules that
+// read a group that changed since then, or that was changed by an earlier rule.
+// Those copies are known to be valid, so skipping the other rules gives the
+// same result as running all of them.
+//
+// The rules must stay in this order: some of them assume that earlier rules
+// have already fixed the fields they read.
 
 #include "tic_internal.h"
 
+typedef struct tic_settings_warning
+{
+  uint8_t code;
+  const char * field;
+  char * message;
+} tic_settings_warning;
+
+struct tic_settings_warnings
+{
+  tic_settings_warning * entries;
+  size_t count;
+  size_t capacity;
+  bool no_memory;
+};
+
+typedef struct tic_settings_fixer
+{
+  tic_settings * settings;
+  uint8_t product;
+  uint16_t firmware_version;
+
+  // Where to put the warnings.  Either one can be NULL.
+  tic_string * string;
+  tic_settings_warnings * list;
+} tic_settings_fixer;
+
+TIC_PRINTF(4, 0)
+static void add_warning_to_list(tic_settings_warnings * list, uint8_t code,
+  const char * field, const char * format, va_list ap)
+{
+  if (list->no_memory) { return; }
+
+  if (list->count == list->capacity)
+  {
+    size_t capacity = list->capacity ? list->capacity * 2 : 4;
+    tic_settings_warning * entries = realloc(list->entries,
+      capacity * sizeof(tic_settings_warning));
+    if (entries == NULL)
+    {
+      list->no_memory = true;
+      return;
+    }
+    list->entries = entries;
+    list->capacity = capacity;
+  }
+
+  tic_string message;
+  tic_string_setup(&message);
+  tic_vsprintf(&message, format, ap);
+  if (message.data == NULL)
+  {
+    list->no_memory = true;
+    return;
+  }
+
+  tic_settings_warning * warning = &list->entries[list->count++];
+  warning->code = code;
+  warning->field = field;
+  warning->message = message.data;
+}
+
+// Records a warning.  The field is the name of the setting in a settings file,
+// and the message is a series of complete English sentences.
+TIC_PRINTF(4, 5)
+static void warn(tic_settings_fixer * fixer, uint8_t code, const char * field,
+  const char * format, ...)
+{
+  va_list ap;
+
+  if (fixer->string != NULL)
+  {
+    // Format the whole line at once; this is a hot path when fixing many
+    // settings files.
+    char line_format[512];
+    snprintf(line_format, sizeof(line_format), "Warning: %s\n", format);
+    va_start(ap, format);
+    tic_vsprintf(fixer->string, line_format, ap);
+    va_end(ap);
+  }
+
+  if (fixer->list != NULL)
+  {
+    va_start(ap, format);
+    add_warning_to_list(fixer->list, code, field, format, ap);
+    va_end(ap);
+  }
+}
+
 static bool enum_is_valid(uint8_t code, uint8_t * valid_codes, uint8_t code_count)
 {
   for (uint32_t i = 0; i < code_count; i++)
@@ -11,7 +110,26 @@ static bool enum_is_valid(uint8_t code, uint8_t * valid_codes, uint8_t code_coun
   return false;
 }
 
-// Fixes enumerated values to be valid (e.g. control_mode).
+static bool is_speed_control_mode(uint8_t control_mode)
+{
+  return control_mode == TIC_CONTROL_MODE_RC_SPEED ||
+    control_mode == TIC_CONTROL_MODE_ANALOG_SPEED ||
+    control_mode == TIC_CONTROL_MODE_ENCODER_SPEED;
+}
+
+static bool is_analog_control_mode(uint8_t control_mode)
+{
+  return control_mode == TIC_CONTROL_MODE_ANALOG_POSITION ||
+    control_mode == TIC_CONTROL_MODE_ANALOG_SPEED;
+}
+
+static bool is_limit_switch(uint8_t pin_func)
+{
+  return pin_func == TIC_PIN_FUNC_LIMIT_SWITCH_FORWARD ||
+    pin_func == TIC_PIN_FUNC_LIMIT_SWITCH_REVERSE;
+}
+
+// The first few rules fix enumerated values to be valid (e.g. control_mode).
 //
 // These enumerated values could only be wrong if buggy software was used to
 // write to the Tic's EEPROM.
@@ -20,946 +138,1133 @@ static bool enum_is_valid(uint8_t code, uint8_t * valid_codes, uint8_t code_coun
 // object cannot even hold invalid values, so there is no need to check them
 // here.  If the EEPROM has invalid boolean values, they got corrected by
 // tic_get_settings, which knows how the firmware treats booleans.
-static void tic_settings_fix_enums(tic_settings * settings, tic_string * warnings)
+
+static void fix_control_mode(tic_settings_fixer * fixer)
 {
-  uint8_t product = tic_settings_get_product(settings);
+  tic_settings * settings = fixer->settings;
+  uint8_t control_mode = tic_settings_get_control_mode(settings);
+  if (control_mode > TIC_CONTROL_MODE_ENCODER_SPEED)
+  {
+    control_mode = TIC_CONTROL_MODE_SERIAL;
+    warn(fixer, TIC_SETTINGS_WARNING_INVALID, "control_mode",
+      "The control mode was invalid "
+      "so it will be changed to Serial/I2C/USB.");
+  }
+  tic_settings_set_control_mode(settings, control_mode);
+}
 
+static void fix_soft_error_response(tic_settings_fixer * fixer)
+{
+  tic_settings * settings = fixer->settings;
+  uint8_t response = tic_settings_get_soft_error_response(settings);
+  if (response > TIC_RESPONSE_GO_TO_POSITION)
   {
-    uint8_t control_mode = tic_settings_get_control_mode(settings);
-    if (control_mode > TIC_CONTROL_MODE_ENCODER_SPEED)
-    {
-      control_mode = TIC_CONTROL_MODE_SERIAL;
-      tic_sprintf(warnings,
-        "Warning: The control mode was invalid "
-        "so it will be changed to Serial/I2C/USB.\n");
-    }
-    tic_settings_set_control_mode(settings, control_mode);
+    response = TIC_RESPONSE_DECEL_TO_HOLD;
+    warn(fixer, TIC_SETTINGS_WARNING_INVALID, "soft_error_response",
+      "The soft error response was invalid "
+      "so it will be changed to \"Decelerate to hold\".");
   }
+  tic_settings_set_soft_error_response(settings, response);
+}
 
+static void fix_input_scaling_degree(tic_settings_fixer * fixer)
+{
+  tic_settings * settings = fixer->settings;
+  uint8_t scaling_degree = tic_settings_get_input_scaling_degree(settings);
+  if (scaling_degree > TIC_SCALING_DEGREE_CUBIC)
   {
-    uint8_t response = tic_settings_get_soft_error_response(settings);
-    if (response > TIC_RESPONSE_GO_TO_POSITION)
-    {
-      response = TIC_RESPONSE_DECEL_TO_HOLD;
-      tic_sprintf(warnings,
-        "Warning: The soft error response was invalid "
-        "so it will be changed to \"Decelerate to hold\".\n");
-    }
-    tic_settings_set_soft_error_response(settings, response);
+    scaling_degree = TIC_SCALING_DEGREE_LINEAR;
+    warn(fixer, TIC_SETTINGS_WARNING_INVALID, "input_scaling_degree",
+      "The scaling degree was invalid "
+      "so it will be changed to linear.");
   }
+  tic_settings_set_input_scaling_degree(settings, scaling_degree);
+}
 
+static void fix_step_mode(tic_settings_fixer * fixer)
+{
+  tic_settings * settings = fixer->settings;
+  uint8_t mode = tic_settings_get_step_mode(settings);
+
+  uint8_t valid_step_modes[] = {
+    TIC_STEP_MODE_MICROSTEP1,
+    TIC_STEP_MODE_MICROSTEP2,
+    TIC_STEP_MODE_MICROSTEP4,
+    TIC_STEP_MODE_MICROSTEP8,
+    TIC_STEP_MODE_MICROSTEP16,
+    TIC_STEP_MODE_MICROSTEP32,
+    TIC_STEP_MODE_MICROSTEP2_100P,
+  };
+  if (fixer->product == TIC_PRODUCT_T500)
   {
-    uint8_t scaling_degree = tic_settings_get_input_scaling_degree(settings);
-    if (scaling_degree > TIC_SCALING_DEGREE_CUBIC)
-    {
-      scaling_degree = TIC_SCALING_DEGREE_LINEAR;
-      tic_sprintf(warnings,
-        "Warning: The scaling degree was invalid "
-        "so it will be changed to linear.\n");
-    }
-    tic_settings_set_input_scaling_degree(settings, scaling_degree);
+    valid_step_modes[4] = 0;  // 1/16 step is not allowed
+    valid_step_modes[5] = 0;  // 1/32 step is not allowed
+  }
+  if (fixer->product != TIC_PRODUCT_T249)
+  {
+    valid_step_modes[6] = 0;  // 2_100p is not allowed
   }
 
+  if (!enum_is_valid(mode, valid_step_modes, sizeof(valid_step_modes)))
   {
-    uint8_t mode = tic_settings_get_step_mode(settings);
+    mode = TIC_STEP_MODE_MICROSTEP1;
+    warn(fixer, TIC_SETTINGS_WARNING_INVALID, "step_mode",
+      "The step mode is invalid "
+      "so it will be changed to 1 (full step).");
+  }
 
-    uint8_t valid_step_modes[] = {
-      TIC_STEP_MODE_MICROSTEP1,
-      TIC_STEP_MODE_MICROSTEP2,
-      TIC_STEP_MODE_MICROSTEP4,
-      TIC_STEP_MODE_MICROSTEP8,
-      TIC_STEP_MODE_MICROSTEP16,
-      TIC_STEP_MODE_MICROSTEP32,
-      TIC_STEP_MODE_MICROSTEP2_100P,
-    };
-    if (product == TIC_PRODUCT_T500)
-    {
-      valid_step_modes[4] = 0;  // 1/16 step is not allowed
-      valid_step_modes[5] = 0;  // 1/32 step is not allowed
-    }
-    if (product != TIC_PRODUCT_T249)
-    {
-      valid_step_modes[6] = 0;  // 2_100p is not allowed
-    }
+  tic_settings_set_step_mode(settings, mode);
+}
 
-    if (!enum_is_valid(mode, valid_step_modes, sizeof(valid_step_modes)))
+static void fix_decay_mode(tic_settings_fixer * fixer)
+{
+  tic_settings * settings = fixer->settings;
+  uint8_t mode = tic_settings_get_decay_mode(settings);
+
+  // The name tables can tell us whether the selected decay mode is valid.
+  //
+  // If it was a valid decay mode for some other product, just silently change
+  // it to 0, like the firmware.  If it was a totally invalid decay mode,
+  // print a warning.
+  if (!tic_look_up_decay_mode_name(mode, fixer->product, 0, NULL))
+  {
+    if (!tic_look_up_decay_mode_name(mode, 0, 0, NULL))
     {
-      mode = TIC_STEP_MODE_MICROSTEP1;
-      tic_sprintf(warnings,
-        "Warning: The step mode is invalid "
-        "so it will be changed to 1 (full step).\n");
+      warn(fixer, TIC_SETTINGS_WARNING_INVALID, "decay_mode",
+        "The decay mode is invalid "
+        "so it will be changed to the default.");
     }
-
-    tic_settings_set_step_mode(settings, mode);
+    mode = TIC_DECAY_MODE_MIXED;
   }
+  tic_settings_set_decay_mode(settings, mode);
+}
 
-  {
-    uint8_t mode = tic_settings_get_decay_mode(settings);
+static void fix_agc_mode(tic_settings_fixer * fixer)
+{
+  tic_settings * settings = fixer->settings;
+  uint8_t mode = tic_settings_get_agc_mode(settings);
 
-    // The name tables can tell us whether the selected decay mode is valid.
-    //
-    // If it was a valid decay mode for some other product, just silently change
-    // it to 0, like the firmware.  If it was a totally invalid decay mode,
-    // print a warning.
-    if (!tic_look_up_decay_mode_name(mode, product, 0, NULL))
+  if (fixer->product == TIC_PRODUCT_T249)
+  {
+    if (!tic_code_to_name(tic_agc_mode_names, mode, NULL))
     {
-      if (!tic_look_up_decay_mode_name(mode, 0, 0, NULL))
-      {
-        tic_sprintf(warnings,
-          "Warning: The decay mode is invalid "
-          "so it will be changed to the default.\n");
-      }
-      mode = TIC_DECAY_MODE_MIXED;
+      warn(fixer, TIC_SETTINGS_WARNING_INVALID, "agc_mode",
+        "The AGC mode was invalid "
+        "so it will be changed to on.");
+      mode = TIC_AGC_MODE_ON;
     }
-    tic_settings_set_decay_mode(settings, mode);
   }
-
+  else
   {
-    uint8_t mode = tic_settings_get_agc_mode(settings);
+    mode = 0;
+  }
 
-    if (product == TIC_PRODUCT_T249)
-    {
-      if (!tic_code_to_name(tic_agc_mode_names, mode, NULL))
-      {
-        tic_sprintf(warnings,
-          "Warning: The AGC mode was invalid "
-          "so it will be changed to on.\n");
-        mode = TIC_AGC_MODE_ON;
-      }
-    }
-    else
-    {
-      mode = 0;
-    }
+  tic_settings_set_agc_mode(settings, mode);
+}
 
-    tic_settings_set_agc_mode(settings, mode);
-  }
+static void fix_agc_bottom_current_limit(tic_settings_fixer * fixer)
+{
+  tic_settings * settings = fixer->settings;
+  uint8_t limit = tic_settings_get_agc_bottom_current_limit(settings);
 
+  if (fixer->product == TIC_PRODUCT_T249)
   {
-    uint8_t limit = tic_settings_get_agc_bottom_current_limit(settings);
-
-    if (product == TIC_PRODUCT_T249)
-    {
-      if (!tic_code_to_name(tic_agc_bottom_current_limit_names, limit, NULL))
-      {
-        tic_sprintf(warnings,
-          "Warning: The AGC bottom current limit was invalid "
-          "so it will be changed to 75%%.\n");
-        limit = TIC_AGC_BOTTOM_CURRENT_LIMIT_75;
-      }
-    }
-    else
+    if (!tic_code_to_name(tic_agc_bottom_current_limit_names, limit, NULL))
     {
-      limit = 0;
+      warn(fixer, TIC_SETTINGS_WARNING_INVALID, "agc_bottom_current_limit",
+        "The AGC bottom current limit was invalid "
+        "so it will be changed to 75%%.");
+      limit = TIC_AGC_BOTTOM_CURRENT_LIMIT_75;
     }
-
-    tic_settings_set_agc_bottom_current_limit(settings, limit);
   }
-
+  else
   {
-    uint8_t steps = tic_settings_get_agc_current_boost_steps(settings);
+    limit = 0;
+  }
 
-    if (product == TIC_PRODUCT_T249)
-    {
-      if (!tic_code_to_name(tic_agc_current_boost_steps_names, steps, NULL))
-      {
-        tic_sprintf(warnings,
-          "Warning: The AGC current boost steps setting was invalid "
-          "so it will be changed to 5.\n");
-        steps = TIC_AGC_CURRENT_BOOST_STEPS_5;
-      }
-    }
-    else
-    {
-      steps = 0;
-    }
+  tic_settings_set_agc_bottom_current_limit(settings, limit);
+}
 
-    tic_settings_set_agc_current_boost_steps(settings, steps);
-  }
+static void fix_agc_current_boost_steps(tic_settings_fixer * fixer)
+{
+  tic_settings * settings = fixer->settings;
+  uint8_t steps = tic_settings_get_agc_current_boost_steps(settings);
 
+  if (fixer->product == TIC_PRODUCT_T249)
   {
-    uint8_t limit = tic_settings_get_agc_frequency_limit(settings);
-
-    if (product == TIC_PRODUCT_T249)
+    if (!tic_code_to_name(tic_agc_current_boost_steps_names, steps, NULL))
     {
-      if (!tic_code_to_name(tic_agc_frequency_limit_names, limit, NULL))
-      {
-        tic_sprintf(warnings,
-          "Warning: The AGC frequency limit was invalid "
-          "so it will be changed to off.\n");
-        limit = TIC_AGC_FREQUENCY_LIMIT_OFF;
-      }
-    }
-    else
-    {
-      limit = 0;
+      warn(fixer, TIC_SETTINGS_WARNING_INVALID, "agc_current_boost_steps",
+        "The AGC current boost steps setting was invalid "
+        "so it will be changed to 5.");
+      steps = TIC_AGC_CURRENT_BOOST_STEPS_5;
     }
-
-    tic_settings_set_agc_frequency_limit(settings, limit);
   }
-}
+  else
+  {
+    steps = 0;
+  }
 
-static bool is_limit_switch(uint8_t pin_func)
-{
-  return pin_func == TIC_PIN_FUNC_LIMIT_SWITCH_FORWARD ||
-    pin_func == TIC_PIN_FUNC_LIMIT_SWITCH_REVERSE;
+  tic_settings_set_agc_current_boost_steps(settings, steps);
 }
 
-static void tic_settings_fix_core(tic_settings * settings, tic_string * warnings)
+static void fix_agc_frequency_limit(tic_settings_fixer * fixer)
 {
-  tic_settings_fix_enums(settings, warnings);
+  tic_settings * settings = fixer->settings;
+  uint8_t limit = tic_settings_get_agc_frequency_limit(settings);
+
+  if (fixer->product == TIC_PRODUCT_T249)
+  {
+    if (!tic_code_to_name(tic_agc_frequency_limit_names, limit, NULL))
+    {
+      warn(fixer, TIC_SETTINGS_WARNING_INVALID, "agc_frequency_limit",
+        "The AGC frequency limit was invalid "
+        "so it will be changed to off.");
+      limit = TIC_AGC_FREQUENCY_LIMIT_OFF;
+    }
+  }
+  else
+  {
+    limit = 0;
+  }
 
-  uint8_t product = tic_settings_get_product(settings);
-  uint16_t firmware_version = tic_settings_get_firmware_version(settings);
+  tic_settings_set_agc_frequency_limit(settings, limit);
+}
 
+static void fix_soft_error_response_for_mode(tic_settings_fixer * fixer)
+{
+  tic_settings * settings = fixer->settings;
   uint8_t control_mode = tic_settings_get_control_mode(settings);
+  uint8_t response = tic_settings_get_soft_error_response(settings);
+  if (response == TIC_RESPONSE_GO_TO_POSITION &&
+    is_speed_control_mode(control_mode))
+  {
+    response = TIC_RESPONSE_DECEL_TO_HOLD;
+    warn(fixer, TIC_SETTINGS_WARNING_CONFLICT, "soft_error_response",
+      "The soft error response cannot be \"Go to position\" in a "
+      "speed control mode, so it will be changed to \"Decelerate to hold\".");
+  }
+  tic_settings_set_soft_error_response(settings, response);
+}
 
-  bool speed_control_mode = false;
-
-  switch (control_mode)
+static void fix_serial_baud_rate(tic_settings_fixer * fixer)
+{
+  tic_settings * settings = fixer->settings;
+  uint32_t baud = tic_settings_get_serial_baud_rate(settings);
+  if (baud < TIC_MIN_ALLOWED_BAUD_RATE)
   {
-  case TIC_CONTROL_MODE_RC_SPEED:
-  case TIC_CONTROL_MODE_ANALOG_SPEED:
-  case TIC_CONTROL_MODE_ENCODER_SPEED:
-    speed_control_mode = true;
-    break;
+    baud = TIC_MIN_ALLOWED_BAUD_RATE;
+    warn(fixer, TIC_SETTINGS_WARNING_TOO_LOW, "serial_baud_rate",
+      "The serial baud rate is too low "
+      "so it will be changed to %u.", baud);
+  }
+  if (baud > TIC_MAX_ALLOWED_BAUD_RATE)
+  {
+    baud = TIC_MAX_ALLOWED_BAUD_RATE;
+    warn(fixer, TIC_SETTINGS_WARNING_TOO_HIGH, "serial_baud_rate",
+      "The serial baud rate is too high "
+      "so it will be changed to %u.", baud);
   }
 
-  bool analog_control_mode = false;
+  baud = tic_settings_achievable_serial_baud_rate(settings, baud);
+  tic_settings_set_serial_baud_rate(settings, baud);
+}
 
-  switch (control_mode)
+static void fix_serial_device_number(tic_settings_fixer * fixer)
+{
+  tic_settings * settings = fixer->settings;
+  uint16_t firmware_version = fixer->firmware_version;
+  uint16_t device_number =
+    tic_settings_get_serial_device_number_u16(settings);
+  uint16_t alt_device_number =
+    tic_settings_get_serial_alt_device_number(settings);
+  bool enable_14bit = tic_settings_get_serial_14bit_device_number(settings);
+  bool enable_alt = tic_settings_get_serial_enable_alt_device_number(settings);
+
+  if (enable_14bit && firmware_version && firmware_version < 0x0105)
   {
-  case TIC_CONTROL_MODE_ANALOG_POSITION:
-  case TIC_CONTROL_MODE_ANALOG_SPEED:
-    analog_control_mode = true;
-    break;
+    enable_14bit = false;
+    warn(fixer, TIC_SETTINGS_WARNING_NOT_SUPPORTED,
+      "serial_14bit_device_number",
+      "The firmware version on your device does not support "
+      "14-bit device numbers, so that option will be disabled.  "
+      "See " DOCUMENTATION_URL " for firmware upgrade instructions.");
   }
 
+  if (enable_alt && firmware_version && firmware_version < 0x0105)
   {
-    uint8_t response = tic_settings_get_soft_error_response(settings);
-    if (response == TIC_RESPONSE_GO_TO_POSITION && speed_control_mode)
-    {
-      response = TIC_RESPONSE_DECEL_TO_HOLD;
-      tic_sprintf(warnings,
-        "Warning: The soft error response cannot be \"Go to position\" in a "
-        "speed control mode, so it will be changed to \"Decelerate to hold\".\n");
-    }
-    tic_settings_set_soft_error_response(settings, response);
+    enable_alt = false;
+    warn(fixer, TIC_SETTINGS_WARNING_NOT_SUPPORTED,
+      "serial_enable_alt_device_number",
+      "The firmware version on your device does not support "
+      "the alternative device number, so it will be disabled.  "
+      "See " DOCUMENTATION_URL " for firmware upgrade instructions.");
   }
 
+  uint16_t mask = 0x7F;
+  if (enable_14bit)
   {
-    uint32_t baud = tic_settings_get_serial_baud_rate(settings);
-    if (baud < TIC_MIN_ALLOWED_BAUD_RATE)
-    {
-      baud = TIC_MIN_ALLOWED_BAUD_RATE;
-      tic_sprintf(warnings,
-        "Warning: The serial baud rate is too low "
-        "so it will be changed to %u.\n", baud);
-    }
-    if (baud > TIC_MAX_ALLOWED_BAUD_RATE)
-    {
-      baud = TIC_MAX_ALLOWED_BAUD_RATE;
-      tic_sprintf(warnings,
-        "Warning: The serial baud rate is too high "
-        "so it will be changed to %u.\n",
-        baud);
-    }
-
-    baud = tic_settings_achievable_serial_baud_rate(settings, baud);
-    tic_settings_set_serial_baud_rate(settings, baud);
+    mask = 0x3FFF;
   }
 
+  if (device_number > mask)
   {
-    uint16_t device_number =
-      tic_settings_get_serial_device_number_u16(settings);
-    uint16_t alt_device_number =
-      tic_settings_get_serial_alt_device_number(settings);
-    bool enable_14bit = tic_settings_get_serial_14bit_device_number(settings);
-    bool enable_alt = tic_settings_get_serial_enable_alt_device_number(settings);
-
-    if (enable_14bit && firmware_version && firmware_version < 0x0105)
-    {
-      enable_14bit = false;
-      tic_sprintf(warnings,
-        "Warning: The firmware version on your device does not support "
-        "14-bit device numbers, so that option will be disabled.  "
-        "See " DOCUMENTATION_URL " for firmware upgrade instructions.\n");
-    }
+    device_number &= mask;
+    warn(fixer, TIC_SETTINGS_WARNING_TOO_HIGH, "serial_device_number",
+      "The device number is higher than %u "
+      "so it will be changed to %u.", mask, device_number);
+  }
 
-    if (enable_alt && firmware_version && firmware_version < 0x0105)
-    {
-      enable_alt = false;
-      tic_sprintf(warnings,
-        "Warning: The firmware version on your device does not support "
-        "the alternative device number, so it will be disabled.  "
-        "See " DOCUMENTATION_URL " for firmware upgrade instructions.\n");
-    }
+  if (alt_device_number > mask)
+  {
+    alt_device_number &= mask;
+    warn(fixer, TIC_SETTINGS_WARNING_TOO_HIGH, "serial_alt_device_number",
+      "The alternative device number is higher than %u "
+      "so it will be changed to %u.", mask, alt_device_number);
+  }
 
-    uint16_t mask = 0x7F;
-    if (enable_14bit)
-    {
-      mask = 0x3FFF;
-    }
+  tic_settings_set_serial_device_number_u16(settings, device_number);
+  tic_settings_set_serial_alt_device_number(settings, alt_device_number);
+  tic_settings_set_serial_14bit_device_number(settings, enable_14bit);
+  tic_settings_set_serial_enable_alt_device_number(settings, enable_alt);
+}
 
-    if (device_number > mask)
-    {
-      device_number &= mask;
-      tic_sprintf(warnings,
-        "Warning: The device number is higher than %u "
-        "so it will be changed to %u.\n", mask, device_number);
-    }
+static void fix_command_timeout(tic_settings_fixer * fixer)
+{
+  tic_settings * settings = fixer->settings;
+  uint16_t command_timeout = tic_settings_get_command_timeout(settings);
+  if (command_timeout > TIC_MAX_ALLOWED_COMMAND_TIMEOUT)
+  {
+    command_timeout = TIC_MAX_ALLOWED_COMMAND_TIMEOUT;
+    warn(fixer, TIC_SETTINGS_WARNING_TOO_HIGH, "command_timeout",
+      "The command timeout is too high "
+      "so it will be changed to %u ms.", command_timeout);
+  }
+  tic_settings_set_command_timeout(settings, command_timeout);
+}
 
-    if (alt_device_number > mask)
-    {
-      alt_device_number &= mask;
-      tic_sprintf(warnings,
-        "Warning: The alternative device number is higher than %u "
-        "so it will be changed to %u.\n", mask, alt_device_number);
-    }
+static void fix_serial_responses(tic_settings_fixer * fixer)
+{
+  tic_settings * settings = fixer->settings;
+  uint16_t firmware_version = fixer->firmware_version;
 
-    tic_settings_set_serial_device_number_u16(settings, device_number);
-    tic_settings_set_serial_alt_device_number(settings, alt_device_number);
-    tic_settings_set_serial_14bit_device_number(settings, enable_14bit);
-    tic_settings_set_serial_enable_alt_device_number(settings, enable_alt);
+  bool crc_enabled = tic_settings_get_serial_crc_for_responses(settings);
+  if (crc_enabled && firmware_version && firmware_version < 0x0105)
+  {
+    crc_enabled = false;
+    warn(fixer, TIC_SETTINGS_WARNING_NOT_SUPPORTED, "serial_crc_for_responses",
+      "The firmware version on your device does not support "
+      "CRC for serial responses, so that option will be disabled.  "
+      "See " DOCUMENTATION_URL " for firmware upgrade instructions.");
   }
+  tic_settings_set_serial_crc_for_responses(settings, crc_enabled);
 
+  bool enabled_7bit = tic_settings_get_serial_7bit_responses(settings);
+  if (enabled_7bit && firmware_version && firmware_version < 0x0105)
   {
-    uint16_t command_timeout = tic_settings_get_command_timeout(settings);
-    if (command_timeout > TIC_MAX_ALLOWED_COMMAND_TIMEOUT)
-    {
-      command_timeout = TIC_MAX_ALLOWED_COMMAND_TIMEOUT;
-      tic_sprintf(warnings,
-        "Warning: The command timeout is too high "
-        "so it will be changed to %u ms.\n", command_timeout);
-    }
-    tic_settings_set_command_timeout(settings, command_timeout);
+    enabled_7bit = false;
+    warn(fixer, TIC_SETTINGS_WARNING_NOT_SUPPORTED, "serial_7bit_responses",
+      "The firmware version on your device does not support "
+      "7-bit serial responses, so that option will be disabled.  "
+      "See " DOCUMENTATION_URL " for firmware upgrade instructions.");
   }
+  tic_settings_set_serial_7bit_responses(settings, enabled_7bit);
+}
 
+static void fix_vin(tic_settings_fixer * fixer)
+{
+  tic_settings * settings = fixer->settings;
+  uint16_t low_shutoff = tic_settings_get_low_vin_shutoff_voltage(settings);
+  uint16_t low_startup = tic_settings_get_low_vin_startup_voltage(settings);
+  uint16_t high_shutoff = tic_settings_get_high_vin_shutoff_voltage(settings);
+
+  // Move low_shutoff down a little bit to prevent overflows below.
+  if (low_shutoff > 64000)
   {
-    bool enabled = tic_settings_get_serial_crc_for_responses(settings);
-    if (enabled && firmware_version && firmware_version < 0x0105)
-    {
-      enabled = false;
-      tic_sprintf(warnings,
-        "Warning: The firmware version on your device does not support "
-        "CRC for serial responses, so that option will be disabled.  "
-        "See " DOCUMENTATION_URL " for firmware upgrade instructions.\n");
-    }
-    tic_settings_set_serial_crc_for_responses(settings, enabled);
+    low_shutoff = 64000;
+    warn(fixer, TIC_SETTINGS_WARNING_TOO_HIGH, "low_vin_shutoff_voltage",
+      "The low VIN shutoff voltage will be changed to %u mV.",
+      low_shutoff);
   }
 
+  if (low_startup < low_shutoff)
   {
-    bool enabled = tic_settings_get_serial_7bit_responses(settings);
-    if (enabled && firmware_version && firmware_version < 0x0105)
-    {
-      enabled = false;
-      tic_sprintf(warnings,
-        "Warning: The firmware version on your device does not support "
-        "7-bit serial responses, so that option will be disabled.  "
-        "See " DOCUMENTATION_URL " for firmware upgrade instructions.\n");
-    }
-    tic_settings_set_serial_7bit_responses(settings, enabled);
+    low_startup = low_shutoff + 500;
+    warn(fixer, TIC_SETTINGS_WARNING_CONFLICT, "low_vin_startup_voltage",
+      "The low VIN startup voltage will be changed to %u mV.",
+      low_startup);
   }
 
+  if (high_shutoff < low_startup)
   {
-    uint16_t low_shutoff = tic_settings_get_low_vin_shutoff_voltage(settings);
-    uint16_t low_startup = tic_settings_get_low_vin_startup_voltage(settings);
-    uint16_t high_shutoff = tic_settings_get_high_vin_shutoff_voltage(settings);
-
-    // Move low_shutoff down a little bit to prevent overflows below.
-    if (low_shutoff > 64000)
-    {
-      low_shutoff = 64000;
-      tic_sprintf(warnings,
-        "Warning: The low VIN shutoff voltage will be changed to %u mV.\n",
-        low_shutoff);
-    }
+    high_shutoff = low_startup + 500;
+    warn(fixer, TIC_SETTINGS_WARNING_CONFLICT, "high_vin_shutoff_voltage",
+      "The high VIN shutoff voltage will be changed to %u mV.",
+      high_shutoff);
+  }
 
-    if (low_startup < low_shutoff)
-    {
-      low_startup = low_shutoff + 500;
-      tic_sprintf(warnings,
-        "Warning: The low VIN startup voltage will be changed to %u mV.\n",
-        low_startup);
-    }
+  tic_settings_set_low_vin_shutoff_voltage(settings, low_shutoff);
+  tic_settings_set_low_vin_startup_voltage(settings, low_startup);
+  tic_settings_set_high_vin_shutoff_voltage(settings, high_shutoff);
+}
 
-    if (high_shutoff < low_startup)
-    {
-      high_shutoff = low_startup + 500;
-      tic_sprintf(warnings,
-        "Warning: The high VIN shutoff voltage will be changed to %u mV.\n",
-        high_shutoff);
-    }
+static void fix_vin_calibration(tic_settings_fixer * fixer)
+{
+  tic_settings * settings = fixer->settings;
+  int16_t calibration = tic_settings_get_vin_calibration(settings);
 
-    tic_settings_set_low_vin_shutoff_voltage(settings, low_shutoff);
-    tic_settings_set_low_vin_startup_voltage(settings, low_startup);
-    tic_settings_set_high_vin_shutoff_voltage(settings, high_shutoff);
+  if (calibration < -500)
+  {
+    calibration = -500;
+    warn(fixer, TIC_SETTINGS_WARNING_TOO_LOW, "vin_calibration",
+      "The VIN calibration is too low "
+      "so it will be raised to -500.");
   }
 
+  if (calibration > 500)
   {
-    int16_t calibration = tic_settings_get_vin_calibration(settings);
+    calibration = 500;
+    warn(fixer, TIC_SETTINGS_WARNING_TOO_HIGH, "vin_calibration",
+      "The VIN calibration is too high "
+      "so it will be lowered to 500.");
+  }
 
-    if (calibration < -500)
-    {
-      calibration = -500;
-      tic_sprintf(warnings,
-        "Warning: The VIN calibration is too low "
-        "so it will be raised to -500.\n");
-    }
+  tic_settings_set_vin_calibration(settings, calibration);
+}
 
-    if (calibration > 500)
-    {
-      calibration = 500;
-      tic_sprintf(warnings,
-        "Warning: The VIN calibration is too high "
-        "so it will be lowered to 500.\n");
-    }
+static void fix_input_scaling(tic_settings_fixer * fixer)
+{
+  tic_settings * settings = fixer->settings;
+  uint16_t min = tic_settings_get_input_min(settings);
+  uint16_t neutral_min = tic_settings_get_input_neutral_min(settings);
+  uint16_t neutral_max = tic_settings_get_input_neutral_max(settings);
+  uint16_t max = tic_settings_get_input_max(settings);
 
-    tic_settings_set_vin_calibration(settings, calibration);
+  if (min > neutral_min || neutral_min > neutral_max || neutral_max > max)
+  {
+    min = 0;
+    neutral_min = 2015;
+    neutral_max = 2080;
+    max = 4095;
+
+    warn(fixer, TIC_SETTINGS_WARNING_CONFLICT, "input_min",
+      "The input scaling values are out of order "
+      "so they will be reset to their default values.");
   }
 
+  if (min > 4095)
+  {
+    warn(fixer, TIC_SETTINGS_WARNING_TOO_HIGH, "input_min",
+      "The input minimum is too high "
+      "so it will be lowered to 4095.");
+    min = 4095;
+  }
+  if (neutral_min > 4095)
   {
-    uint16_t min = tic_settings_get_input_min(settings);
-    uint16_t neutral_min = tic_settings_get_input_neutral_min(settings);
-    uint16_t neutral_max = tic_settings_get_input_neutral_max(settings);
-    uint16_t max = tic_settings_get_input_max(settings);
+    warn(fixer, TIC_SETTINGS_WARNING_TOO_HIGH, "input_neutral_min",
+      "The input neutral min is too high "
+      "so it will be lowered to 4095.");
+    neutral_min = 4095;
+  }
+  if (neutral_max > 4095)
+  {
+    warn(fixer, TIC_SETTINGS_WARNING_TOO_HIGH, "input_neutral_max",
+      "The input neutral max is too high "
+      "so it will be lowered to 4095.");
+    neutral_max = 4095;
+  }
+  if (max > 4095)
+  {
+    warn(fixer, TIC_SETTINGS_WARNING_TOO_HIGH, "input_max",
+      "The input maximum is too high "
+      "so it will be lowered to 4095.");
+    max = 4095;
+  }
 
-    if (min > neutral_min || neutral_min > neutral_max || neutral_max > max)
-    {
-      min = 0;
-      neutral_min = 2015;
-      neutral_max = 2080;
-      max = 4095;
-
-      tic_sprintf(warnings,
-        "Warning: The input scaling values are out of order "
-        "so they will be reset to their default values.\n");
-    }
+  tic_settings_set_input_min(settings, min);
+  tic_settings_set_input_neutral_min(settings, neutral_min);
+  tic_settings_set_input_neutral_max(settings, neutral_max);
+  tic_settings_set_input_max(settings, max);
+}
 
-    if (min > 4095)
-    {
-      tic_sprintf(warnings,
-        "Warning: The input minimum is too high "
-        "so it will be lowered to 4095.\n");
-      min = 4095;
-    }
-    if (neutral_min > 4095)
-    {
-      tic_sprintf(warnings,
-        "Warning: The input neutral min is too high "
-        "so it will be lowered to 4095.\n");
-      neutral_min = 4095;
-    }
-    if (neutral_max > 4095)
-    {
-      tic_sprintf(warnings,
-        "Warning: The input neutral max is too high "
-        "so it will be lowered to 4095.\n");
-      neutral_max = 4095;
-    }
-    if (max > 4095)
-    {
-      tic_sprintf(warnings,
-        "Warning: The input maximum is too high "
-        "so it will be lowered to 4095.\n");
-      max = 4095;
-    }
+static void fix_output_scaling(tic_settings_fixer * fixer)
+{
+  tic_settings * settings = fixer->settings;
 
-    tic_settings_set_input_min(settings, min);
-    tic_settings_set_input_neutral_min(settings, neutral_min);
-    tic_settings_set_input_neutral_max(settings, neutral_max);
-    tic_settings_set_input_max(settings, max);
+  int32_t output_min = tic_settings_get_output_min(settings);
+  if (output_min > 0)
+  {
+    output_min = 0;
+    warn(fixer, TIC_SETTINGS_WARNING_TOO_HIGH, "output_min",
+      "The scaling output minimum is above 0 "
+      "so it will be lowered to 0.");
   }
+  tic_settings_set_output_min(settings, output_min);
 
+  int32_t output_max = tic_settings_get_output_max(settings);
+  if (output_max < 0)
   {
-    int32_t output_min = tic_settings_get_output_min(settings);
-    if (output_min > 0)
-    {
-      output_min = 0;
-      tic_sprintf(warnings,
-        "Warning: The scaling output minimum is above 0 "
-        "so it will be lowered to 0.\n");
-    }
-    tic_settings_set_output_min(settings, output_min);
+    output_max = 0;
+    warn(fixer, TIC_SETTINGS_WARNING_TOO_LOW, "output_max",
+      "The scaling output maximum is below 0 "
+      "so it will be raised to 0.");
   }
+  tic_settings_set_output_max(settings, output_max);
+}
+
+static void fix_encoder(tic_settings_fixer * fixer)
+{
+  tic_settings * settings = fixer->settings;
+
+  uint32_t prescaler = tic_settings_get_encoder_prescaler(settings);
 
+  if (prescaler > TIC_MAX_ALLOWED_ENCODER_PRESCALER)
   {
-    int32_t output_max = tic_settings_get_output_max(settings);
-    if (output_max < 0)
-    {
-      output_max = 0;
-      tic_sprintf(warnings,
-        "Warning: The scaling output maximum is below 0 "
-        "so it will be raised to 0.\n");
-    }
-    tic_settings_set_output_max(settings, output_max);
+    prescaler = TIC_MAX_ALLOWED_ENCODER_PRESCALER;
+    warn(fixer, TIC_SETTINGS_WARNING_TOO_HIGH, "encoder_prescaler",
+      "The encoder prescaler is too high "
+      "so it will be lowered to %u.", prescaler);
   }
 
+  if (prescaler < 1)
   {
-    uint32_t prescaler = tic_settings_get_encoder_prescaler(settings);
+    prescaler = 1;
+    warn(fixer, TIC_SETTINGS_WARNING_TOO_LOW, "encoder_prescaler",
+      "The encoder prescaler is zero "
+      "so it will be changed to 1.");
+  }
 
-    if (prescaler > TIC_MAX_ALLOWED_ENCODER_PRESCALER)
-    {
-      prescaler = TIC_MAX_ALLOWED_ENCODER_PRESCALER;
-      tic_sprintf(warnings,
-        "Warning: The encoder prescaler is too high "
-        "so it will be lowered to %u.\n", prescaler);
-    }
+  tic_settings_set_encoder_prescaler(settings, prescaler);
 
-    if (prescaler < 1)
-    {
-      prescaler = 1;
-      tic_sprintf(warnings,
-        "Warning: The encoder prescaler is zero "
-        "so it will be changed to 1.\n");
-    }
+  uint32_t postscaler = tic_settings_get_encoder_postscaler(settings);
 
-    tic_settings_set_encoder_prescaler(settings, prescaler);
+  if (postscaler > TIC_MAX_ALLOWED_ENCODER_POSTSCALER)
+  {
+    postscaler = TIC_MAX_ALLOWED_ENCODER_POSTSCALER;
+    warn(fixer, TIC_SETTINGS_WARNING_TOO_HIGH, "encoder_postscaler",
+      "The encoder postscaler is too high "
+      "so it will be lowered to %u.", postscaler);
   }
 
+  if (postscaler < 1)
   {
-    uint32_t postscaler = tic_settings_get_encoder_postscaler(settings);
-
-    if (postscaler > TIC_MAX_ALLOWED_ENCODER_POSTSCALER)
-    {
-      postscaler = TIC_MAX_ALLOWED_ENCODER_POSTSCALER;
-      tic_sprintf(warnings,
-        "Warning: The encoder postscaler is too high "
-        "so it will be lowered to %u.\n", postscaler);
-    }
+    postscaler = 1;
+    warn(fixer, TIC_SETTINGS_WARNING_TOO_LOW, "encoder_postscaler",
+      "The encoder postscaler is zero "
+      "so it will be changed to 1.");
+  }
 
-    if (postscaler < 1)
-    {
-      postscaler = 1;
-      tic_sprintf(warnings,
-        "Warning: The encoder postscaler is zero "
-        "so it will be changed to 1.\n");
-    }
+  tic_settings_set_encoder_postscaler(settings, postscaler);
+}
 
-    tic_settings_set_encoder_postscaler(settings, postscaler);
-  }
+static void fix_current_limit(tic_settings_fixer * fixer)
+{
+  tic_settings * settings = fixer->settings;
+  uint32_t current = tic_settings_get_current_limit(settings);
+  uint32_t max_current = tic_get_max_allowed_current(fixer->product);
 
+  if (current > max_current)
   {
-    uint32_t current = tic_settings_get_current_limit(settings);
-    uint32_t max_current = tic_get_max_allowed_current(product);
-
-    if (current > max_current)
-    {
-      current = max_current;
-      tic_sprintf(warnings,
-        "Warning: The current limit is too high "
-        "so it will be lowered to %u mA.\n", current);
-    }
+    current = max_current;
+    warn(fixer, TIC_SETTINGS_WARNING_TOO_HIGH, "current_limit",
+      "The current limit is too high "
+      "so it will be lowered to %u mA.", current);
+  }
 
-    current = tic_settings_achievable_current_limit(settings, current);
-    tic_settings_set_current_limit(settings, current);
+  current = tic_settings_achievable_current_limit(settings, current);
+  tic_settings_set_current_limit(settings, current);
 
-    int32_t current_during_error =
-      tic_settings_get_current_limit_during_error(settings);
+  int32_t current_during_error =
+    tic_settings_get_current_limit_during_error(settings);
 
-    if (current_during_error > (int32_t)current)
-    {
-      current_during_error = -1;
-      tic_sprintf(warnings,
-        "Warning: The current limit during error is higher than "
-        "the default current limit so it will be changed to be the same.\n");
-    }
+  if (current_during_error > (int32_t)current)
+  {
+    current_during_error = -1;
+    warn(fixer, TIC_SETTINGS_WARNING_CONFLICT, "current_limit_during_error",
+      "The current limit during error is higher than "
+      "the default current limit so it will be changed to be the same.");
+  }
 
-    if (current_during_error < -1)
-    {
-      current_during_error = -1;
-      tic_sprintf(warnings,
-        "Warning: The current limit during error is an invalid negative number "
-        "so it will be changed to be the same as the default current limit.\n");
-    }
+  if (current_during_error < -1)
+  {
+    current_during_error = -1;
+    warn(fixer, TIC_SETTINGS_WARNING_INVALID, "current_limit_during_error",
+      "The current limit during error is an invalid negative number "
+      "so it will be changed to be the same as the default current limit.");
+  }
 
-    if (current_during_error >= 0)
-    {
-      current_during_error = tic_settings_achievable_current_limit(
-        settings, current_during_error);
-    }
-    tic_settings_set_current_limit_during_error(settings, current_during_error);
+  if (current_during_error >= 0)
+  {
+    current_during_error = tic_settings_achievable_current_limit(
+      settings, current_during_error);
   }
+  tic_settings_set_current_limit_during_error(settings, current_during_error);
+}
 
+static void fix_auto_homing(tic_settings_fixer * fixer)
+{
+  tic_settings * settings = fixer->settings;
+  uint16_t firmware_version = fixer->firmware_version;
   if (firmware_version && firmware_version < 0x0106 &&
     tic_settings_get_auto_homing(settings))
   {
     tic_settings_set_auto_homing(settings, false);
-    tic_sprintf(warnings,
-      "Warning: The firmware version on your device does not support"
+    warn(fixer, TIC_SETTINGS_WARNING_NOT_SUPPORTED, "auto_homing",
+      "The firmware version on your device does not support "
       "auto homing (or homing in general), so it will be disabled.");
 
     // Note: It would also be nice to check that the user has enabled proper
     // limit switches and disable auto homing if needed.
   }
+}
 
-  {
-    uint32_t max_speed = tic_settings_get_max_speed(settings);
-    uint32_t starting_speed = tic_settings_get_starting_speed(settings);
-    uint32_t homing_speed_towards = tic_settings_get_homing_speed_towards(settings);
-    uint32_t homing_speed_away = tic_settings_get_homing_speed_away(settings);
-
-    if (max_speed > TIC_MAX_ALLOWED_SPEED)
-    {
-      max_speed = TIC_MAX_ALLOWED_SPEED;
-      uint32_t max_speed_khz = max_speed / TIC_SPEED_UNITS_PER_HZ / 1000;
-      tic_sprintf(warnings,
-        "Warning: The maximum speed is too high "
-        "so it will be lowered to %u (%u kHz).\n",
-        max_speed, max_speed_khz);
-    }
-
-    if (starting_speed > max_speed)
-    {
-      starting_speed = max_speed;
-      tic_sprintf(warnings,
-        "Warning: The starting speed is greater than the maximum speed "
-        "so it will be lowered to %u.\n", starting_speed);
-    }
+static void fix_speeds(tic_settings_fixer * fixer)
+{
+  tic_settings * settings = fixer->settings;
+  uint32_t max_speed = tic_settings_get_max_speed(settings);
+  uint32_t starting_speed = tic_settings_get_starting_speed(settings);
+  uint32_t homing_speed_towards = tic_settings_get_homing_speed_towards(settings);
+  uint32_t homing_speed_away = tic_settings_get_homing_speed_away(settings);
 
-    // We'll let the homing speed be higher than the max speed because I think
-    // people will be annoyed if they are playing around with low max_speeds and
-    // they get warnings about the homing speeds, which they probably do not
-    // care about.
+  if (max_speed > TIC_MAX_ALLOWED_SPEED)
+  {
+    max_speed = TIC_MAX_ALLOWED_SPEED;
+    uint32_t max_speed_khz = max_speed / TIC_SPEED_UNITS_PER_HZ / 1000;
+    warn(fixer, TIC_SETTINGS_WARNING_TOO_HIGH, "max_speed",
+      "The maximum speed is too high "
+      "so it will be lowered to %u (%u kHz).",
+      max_speed, max_speed_khz);
+  }
 
-    if (homing_speed_towards > TIC_MAX_ALLOWED_SPEED)
-    {
-      homing_speed_towards = TIC_MAX_ALLOWED_SPEED;
-      tic_sprintf(warnings,
-        "Warning: The homing speed towards is too high "
-        "so it will be lowered to %u.\n", homing_speed_towards);
-    }
+  if (starting_speed > max_speed)
+  {
+    starting_speed = max_speed;
+    warn(fixer, TIC_SETTINGS_WARNING_CONFLICT, "starting_speed",
+      "The starting speed is greater than the maximum speed "
+      "so it will be lowered to %u.", starting_speed);
+  }
 
-    if (homing_speed_away > TIC_MAX_ALLOWED_SPEED)
-    {
-      homing_speed_away = TIC_MAX_ALLOWED_SPEED;
-      tic_sprintf(warnings,
-        "Warning: The homing speed away is too high "
-        "so it will be lowered to %u.\n", homing_speed_away);
-    }
+  // We'll let the homing speed be higher than the max speed because I think
+  // people will be annoyed if they are playing around with low max_speeds and
+  // they get warnings about the homing speeds, which they probably do not
+  // care about.
 
-    tic_settings_set_max_speed(settings, max_speed);
-    tic_settings_set_starting_speed(settings, starting_speed);
-    tic_settings_set_homing_speed_towards(settings, homing_speed_towards);
-    tic_settings_set_homing_speed_away(settings, homing_speed_away);
+  if (homing_speed_towards > TIC_MAX_ALLOWED_SPEED)
+  {
+    homing_speed_towards = TIC_MAX_ALLOWED_SPEED;
+    warn(fixer, TIC_SETTINGS_WARNING_TOO_HIGH, "homing_speed_towards",
+      "The homing speed towards is too high "
+      "so it will be lowered to %u.", homing_speed_towards);
   }
 
+  if (homing_speed_away > TIC_MAX_ALLOWED_SPEED)
   {
-    uint32_t max_accel = tic_settings_get_max_accel(settings);
+    homing_speed_away = TIC_MAX_ALLOWED_SPEED;
+    warn(fixer, TIC_SETTINGS_WARNING_TOO_HIGH, "homing_speed_away",
+      "The homing speed away is too high "
+      "so it will be lowered to %u.", homing_speed_away);
+  }
 
-    if (max_accel > TIC_MAX_ALLOWED_ACCEL)
-    {
-      max_accel = TIC_MAX_ALLOWED_ACCEL;
-      tic_sprintf(warnings,
-        "Warning: The maximum acceleration is too high "
-        "so it will be lowered to %u.\n", max_accel);
-    }
+  tic_settings_set_max_speed(settings, max_speed);
+  tic_settings_set_starting_speed(settings, starting_speed);
+  tic_settings_set_homing_speed_towards(settings, homing_speed_towards);
+  tic_settings_set_homing_speed_away(settings, homing_speed_away);
+}
 
-    if (max_accel < TIC_MIN_ALLOWED_ACCEL)
-    {
-      max_accel = TIC_MIN_ALLOWED_ACCEL;
-      tic_sprintf(warnings,
-        "Warning: The maximum acceleration is too low "
-        "so it will be raised to %u.\n", max_accel);
-    }
+static void fix_accel(tic_settings_fixer * fixer)
+{
+  tic_settings * settings = fixer->settings;
 
-    tic_settings_set_max_accel(settings, max_accel);
+  uint32_t max_accel = tic_settings_get_max_accel(settings);
+
+  if (max_accel > TIC_MAX_ALLOWED_ACCEL)
+  {
+    max_accel = TIC_MAX_ALLOWED_ACCEL;
+    warn(fixer, TIC_SETTINGS_WARNING_TOO_HIGH, "max_accel",
+      "The maximum acceleration is too high "
+      "so it will be lowered to %u.", max_accel);
   }
 
+  if (max_accel < TIC_MIN_ALLOWED_ACCEL)
   {
-    uint32_t max_decel = tic_settings_get_max_decel(settings);
+    max_accel = TIC_MIN_ALLOWED_ACCEL;
+    warn(fixer, TIC_SETTINGS_WARNING_TOO_LOW, "max_accel",
+      "The maximum acceleration is too low "
+      "so it will be raised to %u.", max_accel);
+  }
 
-    if (max_decel > TIC_MAX_ALLOWED_ACCEL)
-    {
-      max_decel = TIC_MAX_ALLOWED_ACCEL;
-      tic_sprintf(warnings,
-        "Warning: The maximum deceleration is too high "
-        "so it will be lowered to %u.\n", max_decel);
-    }
+  tic_settings_set_max_accel(settings, max_accel);
 
-    if (max_decel != 0 && max_decel < TIC_MIN_ALLOWED_ACCEL)
-    {
-      max_decel = TIC_MIN_ALLOWED_ACCEL;
-      tic_sprintf(warnings,
-        "Warning: The maximum deceleration is too low "
-        "so it will be raised to %u.\n", max_decel);
-    }
+  uint32_t max_decel = tic_settings_get_max_decel(settings);
 
-    tic_settings_set_max_decel(settings, max_decel);
+  if (max_decel > TIC_MAX_ALLOWED_ACCEL)
+  {
+    max_decel = TIC_MAX_ALLOWED_ACCEL;
+    warn(fixer, TIC_SETTINGS_WARNING_TOO_HIGH, "max_decel",
+      "The maximum deceleration is too high "
+      "so it will be lowered to %u.", max_decel);
   }
 
+  if (max_decel != 0 && max_decel < TIC_MIN_ALLOWED_ACCEL)
   {
-    uint8_t scl_func = tic_settings_get_pin_func(settings, TIC_PIN_NUM_SCL);
-    uint8_t sda_func = tic_settings_get_pin_func(settings, TIC_PIN_NUM_SDA);
-    uint8_t tx_func = tic_settings_get_pin_func(settings, TIC_PIN_NUM_TX);
-    uint8_t rx_func = tic_settings_get_pin_func(settings, TIC_PIN_NUM_RX);
-    uint8_t rc_func = tic_settings_get_pin_func(settings, TIC_PIN_NUM_RC);
-    bool rc_analog = tic_settings_get_pin_analog(settings, TIC_PIN_NUM_RC);
+    max_decel = TIC_MIN_ALLOWED_ACCEL;
+    warn(fixer, TIC_SETTINGS_WARNING_TOO_LOW, "max_decel",
+      "The maximum deceleration is too low "
+      "so it will be raised to %u.", max_decel);
+  }
 
-    // First, we make sure the pins are configured to provide the primary
-    // input that will be used to control the motor.
+  tic_settings_set_max_decel(settings, max_decel);
+}
 
-    switch (control_mode)
-    {
-    case TIC_CONTROL_MODE_ANALOG_POSITION:
-    case TIC_CONTROL_MODE_ANALOG_SPEED:
-      if (sda_func != TIC_PIN_FUNC_DEFAULT &&
-        sda_func != TIC_PIN_FUNC_USER_INPUT)
-      {
-        sda_func = TIC_PIN_FUNC_DEFAULT;
-        tic_sprintf(warnings,
-          "Warning: The SDA pin must be used as an analog input "
-          "so its function will be changed to the default.\n");
-      }
-      break;
-    case TIC_CONTROL_MODE_RC_POSITION:
-    case TIC_CONTROL_MODE_RC_SPEED:
-      // Skip this warning for the N825, because the RC pin function
-      // will be set to its default later and that part gives a better
-      // error message.
-      if (rc_func != TIC_PIN_FUNC_DEFAULT &&
-        rc_func != TIC_PIN_FUNC_RC && product != TIC_PRODUCT_N825)
-      {
-        rc_func = TIC_PIN_FUNC_DEFAULT;
-        tic_sprintf(warnings,
-          "Warning: The RC pin must be used as an RC input "
-          "so its function will be changed to the default.\n");
-      }
-      break;
-    case TIC_CONTROL_MODE_ENCODER_POSITION:
-    case TIC_CONTROL_MODE_ENCODER_SPEED:
-      if (tx_func != TIC_PIN_FUNC_DEFAULT &&
-        tx_func != TIC_PIN_FUNC_ENCODER)
-      {
-        tx_func = TIC_PIN_FUNC_DEFAULT;
-        tic_sprintf(warnings,
-          "Warning: The TX pin must be used as an encoder input "
-          "so its function will be changed to the default.\n");
-      }
-      if (rx_func != TIC_PIN_FUNC_DEFAULT &&
-        rx_func != TIC_PIN_FUNC_ENCODER)
-      {
-        rx_func = TIC_PIN_FUNC_DEFAULT;
-        tic_sprintf(warnings,
-          "Warning: The RX pin must be used as an encoder input "
-          "so its function will be changed to the default.\n");
-      }
-      break;
-    }
+static void fix_pins(tic_settings_fixer * fixer)
+{
+  tic_settings * settings = fixer->settings;
+  uint8_t product = fixer->product;
+  uint16_t firmware_version = fixer->firmware_version;
+  uint8_t control_mode = tic_settings_get_control_mode(settings);
 
-    // Next, we make sure no pin is configured to do something that it cannot
-    // do.  These checks are in order by pin function.
+  uint8_t scl_func = tic_settings_get_pin_func(settings, TIC_PIN_NUM_SCL);
+  uint8_t sda_func = tic_settings_get_pin_func(settings, TIC_PIN_NUM_SDA);
+  uint8_t tx_func = tic_settings_get_pin_func(settings, TIC_PIN_NUM_TX);
+  uint8_t rx_func = tic_settings_get_pin_func(settings, TIC_PIN_NUM_RX);
+  uint8_t rc_func = tic_settings_get_pin_func(settings, TIC_PIN_NUM_RC);
+  bool rc_analog = tic_settings_get_pin_analog(settings, TIC_PIN_NUM_RC);
 
-    if (product == TIC_PRODUCT_N825 && rc_func != TIC_PIN_FUNC_DEFAULT)
-    {
-      rc_func = TIC_PIN_FUNC_DEFAULT;
-      tic_sprintf(warnings,
-        "Warning: On the Tic N825, the RC pin is always used for controlling "
-        "the RS-485 transceiver and cannot be used for anything else, so its "
-        "function will be changed to the default.\n");
-      // This might change in future firmware versions.
-    }
+  // First, we make sure the pins are configured to provide the primary
+  // input that will be used to control the motor.
 
-    if (rc_func == TIC_PIN_FUNC_USER_IO)
+  switch (control_mode)
+  {
+  case TIC_CONTROL_MODE_ANALOG_POSITION:
+  case TIC_CONTROL_MODE_ANALOG_SPEED:
+    if (sda_func != TIC_PIN_FUNC_DEFAULT &&
+      sda_func != TIC_PIN_FUNC_USER_INPUT)
     {
-      rc_func = TIC_PIN_FUNC_DEFAULT;
-      tic_sprintf(warnings,
-        "Warning: The RC pin cannot be a user I/O pin "
-        "so its function will be changed to the default.\n");
+      sda_func = TIC_PIN_FUNC_DEFAULT;
+      warn(fixer, TIC_SETTINGS_WARNING_CONFLICT, "sda_config",
+        "The SDA pin must be used as an analog input "
+        "so its function will be changed to the default.");
     }
-
-    if (sda_func == TIC_PIN_FUNC_POT_POWER)
+    break;
+  case TIC_CONTROL_MODE_RC_POSITION:
+  case TIC_CONTROL_MODE_RC_SPEED:
+    // Skip this warning for the N825, because the RC pin function
+    // will be set to its default later and that part gives a better
+    // error message.
+    if (rc_func != TIC_PIN_FUNC_DEFAULT &&
+      rc_func != TIC_PIN_FUNC_RC && product != TIC_PRODUCT_N825)
     {
-      sda_func = TIC_PIN_FUNC_DEFAULT;
-      tic_sprintf(warnings,
-        "Warning: The SDA pin cannot be used as a potentiometer power pin "
-        "so its function will be changed to the default.\n");
+      rc_func = TIC_PIN_FUNC_DEFAULT;
+      warn(fixer, TIC_SETTINGS_WARNING_CONFLICT, "rc_config",
+        "The RC pin must be used as an RC input "
+        "so its function will be changed to the default.");
     }
-
-    if (tx_func == TIC_PIN_FUNC_POT_POWER)
+    break;
+  case TIC_CONTROL_MODE_ENCODER_POSITION:
+  case TIC_CONTROL_MODE_ENCODER_SPEED:
+    if (tx_func != TIC_PIN_FUNC_DEFAULT &&
+      tx_func != TIC_PIN_FUNC_ENCODER)
     {
       tx_func = TIC_PIN_FUNC_DEFAULT;
-      tic_sprintf(warnings,
-        "Warning: The TX pin cannot be used as a potentiometer power pin "
-        "so its function will be changed to the default.\n");
+      warn(fixer, TIC_SETTINGS_WARNING_CONFLICT, "tx_config",
+        "The TX pin must be used as an encoder input "
+        "so its function will be changed to the default.");
     }
-
-    if (rx_func == TIC_PIN_FUNC_POT_POWER)
+    if (rx_func != TIC_PIN_FUNC_DEFAULT &&
+      rx_func != TIC_PIN_FUNC_ENCODER)
     {
       rx_func = TIC_PIN_FUNC_DEFAULT;
-      tic_sprintf(warnings,
-        "Warning: The RX pin cannot be used as a potentiometer power pin "
-        "so its function will be changed to the default.\n");
+      warn(fixer, TIC_SETTINGS_WARNING_CONFLICT, "rx_config",
+        "The RX pin must be used as an encoder input "
+        "so its function will be changed to the default.");
     }
+    break;
+  }
 
-    if (rc_func == TIC_PIN_FUNC_POT_POWER)
-    {
-      rc_func = TIC_PIN_FUNC_DEFAULT;
-      tic_sprintf(warnings,
-        "Warning: The RC pin cannot be used as a potentiometer power pin "
-        "so its function will be changed to the default.\n");
-    }
+  // Next, we make sure no pin is configured to do something that it cannot
+  // do.  These checks are in order by pin function.
 
-    if (rc_func == TIC_PIN_FUNC_SERIAL)
-    {
-      rc_func = TIC_PIN_FUNC_DEFAULT;
-      tic_sprintf(warnings,
-        "Warning: The RC pin cannot be a serial pin "
-        "so its function will be changed to the default.\n");
-    }
+  if (product == TIC_PRODUCT_N825 && rc_func != TIC_PIN_FUNC_DEFAULT)
+  {
+    rc_func = TIC_PIN_FUNC_DEFAULT;
+    warn(fixer, TIC_SETTINGS_WARNING_INVALID, "rc_config",
+      "On the Tic N825, the RC pin is always used for controlling "
+      "the RS-485 transceiver and cannot be used for anything else, so its "
+      "function will be changed to the default.");
+    // This might change in future firmware versions.
+  }
 
-    if (sda_func == TIC_PIN_FUNC_RC)
-    {
-      sda_func = TIC_PIN_FUNC_DEFAULT;
-      tic_sprintf(warnings,
-        "Warning: The SDA pin cannot be used as an RC input "
-        "so its function will be changed to the default.\n");
-    }
+  if (rc_func == TIC_PIN_FUNC_USER_IO)
+  {
+    rc_func = TIC_PIN_FUNC_DEFAULT;
+    warn(fixer, TIC_SETTINGS_WARNING_INVALID, "rc_config",
+      "The RC pin cannot be a user I/O pin "
+      "so its function will be changed to the default.");
+  }
+
+  if (sda_func == TIC_PIN_FUNC_POT_POWER)
+  {
+    sda_func = TIC_PIN_FUNC_DEFAULT;
+    warn(fixer, TIC_SETTINGS_WARNING_INVALID, "sda_config",
+      "The SDA pin cannot be used as a potentiometer power pin "
+      "so its function will be changed to the default.");
+  }
+
+  if (tx_func == TIC_PIN_FUNC_POT_POWER)
+  {
+    tx_func = TIC_PIN_FUNC_DEFAULT;
+    warn(fixer, TIC_SETTINGS_WARNING_INVALID, "tx_config",
+      "The TX pin cannot be used as a potentiometer power pin "
+      "so its function will be changed to the default.");
+  }
+
+  if (rx_func == TIC_PIN_FUNC_POT_POWER)
+  {
+    rx_func = TIC_PIN_FUNC_DEFAULT;
+    warn(fixer, TIC_SETTINGS_WARNING_INVALID, "rx_config",
+      "The RX pin cannot be used as a potentiometer power pin "
+      "so its function will be changed to the default.");
+  }
+
+  if (rc_func == TIC_PIN_FUNC_POT_POWER)
+  {
+    rc_func = TIC_PIN_FUNC_DEFAULT;
+    warn(fixer, TIC_SETTINGS_WARNING_INVALID, "rc_config",
+      "The RC pin cannot be used as a potentiometer power pin "
+      "so its function will be changed to the default.");
+  }
+
+  if (rc_func == TIC_PIN_FUNC_SERIAL)
+  {
+    rc_func = TIC_PIN_FUNC_DEFAULT;
+    warn(fixer, TIC_SETTINGS_WARNING_INVALID, "rc_config",
+      "The RC pin cannot be a serial pin "
+      "so its function will be changed to the default.");
+  }
+
+  if (sda_func == TIC_PIN_FUNC_RC)
+  {
+    sda_func = TIC_PIN_FUNC_DEFAULT;
+    warn(fixer, TIC_SETTINGS_WARNING_INVALID, "sda_config",
+      "The SDA pin cannot be used as an RC input "
+      "so its function will be changed to the default.");
+  }
+
+  if (scl_func == TIC_PIN_FUNC_RC)
+  {
+    scl_func = TIC_PIN_FUNC_DEFAULT;
+    warn(fixer, TIC_SETTINGS_WARNING_INVALID, "scl_config",
+      "The SCL pin cannot be used as an RC input "
+      "so its function will be changed to the default.");
+  }
 
-    if (scl_func == TIC_PIN_FUNC_RC)
+  if (tx_func == TIC_PIN_FUNC_RC)
+  {
+    tx_func = TIC_PIN_FUNC_DEFAULT;
+    warn(fixer, TIC_SETTINGS_WARNING_INVALID, "tx_config",
+      "The TX pin cannot be used as an RC input "
+      "so its function will be changed to the default.");
+  }
+
+  if (rx_func == TIC_PIN_FUNC_RC)
+  {
+    rx_func = TIC_PIN_FUNC_DEFAULT;
+    warn(fixer, TIC_SETTINGS_WARNING_INVALID, "rx_config",
+      "The RX pin cannot be used as an RC input "
+      "so its function will be changed to the default.");
+  }
+
+  if (scl_func == TIC_PIN_FUNC_ENCODER)
+  {
+    scl_func = TIC_PIN_FUNC_DEFAULT;
+    warn(fixer, TIC_SETTINGS_WARNING_INVALID, "scl_config",
+      "The SCL pin cannot be used as an encoder input "
+      "so its function will be changed to the default.");
+  }
+
+  if (sda_func == TIC_PIN_FUNC_ENCODER)
+  {
+    sda_func = TIC_PIN_FUNC_DEFAULT;
+    warn(fixer, TIC_SETTINGS_WARNING_INVALID, "sda_config",
+      "The SDA pin cannot be used as an encoder input "
+      "so its function will be changed to the default.");
+  }
+
+  if (rc_func == TIC_PIN_FUNC_ENCODER)
+  {
+    rc_func = TIC_PIN_FUNC_DEFAULT;
+    warn(fixer, TIC_SETTINGS_WARNING_INVALID, "rc_config",
+      "The RC pin cannot be used as an encoder input "
+      "so its function will be changed to the default.");
+  }
+
+  if (firmware_version && firmware_version < 0x0105)
+  {
+    // One warning covers all the pins, so it names the first one changed.
+    const char * field = NULL;
+    if (is_limit_switch(scl_func))
     {
+      if (!field) { field = "scl_config"; }
       scl_func = TIC_PIN_FUNC_DEFAULT;
-      tic_sprintf(warnings,
-        "Warning: The SCL pin cannot be used as an RC input "
-        "so its function will be changed to the default.\n");
     }
-
-    if (tx_func == TIC_PIN_FUNC_RC)
+    if (is_limit_switch(sda_func))
+    {
+      if (!field) { field = "sda_config"; }
+      sda_func = TIC_PIN_FUNC_DEFAULT;
+    }
+    if (is_limit_switch(tx_func))
     {
+      if (!field) { field = "tx_config"; }
       tx_func = TIC_PIN_FUNC_DEFAULT;
-      tic_sprintf(warnings,
-        "Warning: The TX pin cannot be used as an RC input "
-        "so its function will be changed to the default.\n");
     }
-
-    if (rx_func == TIC_PIN_FUNC_RC)
+    if (is_limit_switch(rx_func))
     {
+      if (!field) { field = "rx_config"; }
       rx_func = TIC_PIN_FUNC_DEFAULT;
-      tic_sprintf(warnings,
-        "Warning: The RX pin cannot be used as an RC input "
-        "so its function will be changed to the default.\n");
     }
-
-    if (scl_func == TIC_PIN_FUNC_ENCODER)
+    if (is_limit_switch(rc_func))
     {
-      scl_func = TIC_PIN_FUNC_DEFAULT;
-      tic_sprintf(warnings,
-        "Warning: The SCL pin cannot be used as an encoder input "
-        "so its function will be changed to the default.\n");
+      if (!field) { field = "rc_config"; }
+      rc_func = TIC_PIN_FUNC_DEFAULT;
     }
-
-    if (sda_func == TIC_PIN_FUNC_ENCODER)
+    if (field)
     {
-      sda_func = TIC_PIN_FUNC_DEFAULT;
-      tic_sprintf(warnings,
-        "Warning: The SDA pin cannot be used as an encoder input "
-        "so its function will be changed to the default.\n");
+      warn(fixer, TIC_SETTINGS_WARNING_NOT_SUPPORTED, field,
+        "The firmware version on your device does not support "
+        "limit switches, so any pin configured as a limit switch "
+        "will be changed to its default function.  "
+        "See " DOCUMENTATION_URL " for firmware upgrade instructions.");
     }
+  }
 
-    if (rc_func == TIC_PIN_FUNC_ENCODER)
+  // Next, enforce proper values for pin booleans.
+  if (rc_analog)
+  {
+    rc_analog = false;
+    warn(fixer, TIC_SETTINGS_WARNING_INVALID, "rc_config",
+      "The RC pin cannot be an analog input "
+      "so that feature will be disabled.");
+  }
+
+  // Note: aren't enforcing proper values for the "pullup" boolean yet.  That
+  // setting is more of a suggestion from the firmware; the RC line cannot
+  // have a pull-up and the TX and RX lines always do if they are inputs.
+  // The firmware's default settings for TX and RX don't set the pull-up bit,
+  // so it would be bad to complain to the user about that.
+
+  // Finally, if one of the SCL/SDA pins is configured for I2C, make sure the other one
+  // is configured that way too.  This should be last because other checks in this
+  // code might change SCL or SDA to be used for I2C.
+  bool analog_control_mode = is_analog_control_mode(control_mode);
+  bool scl_is_i2c = (scl_func == TIC_PIN_FUNC_DEFAULT && !analog_control_mode) ||
+    (scl_func == TIC_PIN_FUNC_SERIAL);
+  bool sda_is_i2c = (sda_func == TIC_PIN_FUNC_DEFAULT && !analog_control_mode) ||
+    (sda_func == TIC_PIN_FUNC_SERIAL);
+  if (sda_is_i2c != scl_is_i2c)
+  {
+    scl_func = TIC_PIN_FUNC_DEFAULT;
+    sda_func = TIC_PIN_FUNC_DEFAULT;
+    if (sda_is_i2c)
     {
-      rc_func = TIC_PIN_FUNC_DEFAULT;
-      tic_sprintf(warnings,
-        "Warning: The RC pin cannot be used as an encoder input "
-        "so its function will be changed to the default.\n");
+      warn(fixer, TIC_SETTINGS_WARNING_CONFLICT, "scl_config",
+        "The SCL pin must be used for I2C if the SDA pin is, "
+        "so the SCL and SDA pin functions will be changed to the default.");
     }
-
-    if (firmware_version && firmware_version < 0x0105)
+    else
     {
-      bool warn = false;
-      if (is_limit_switch(scl_func))
-      {
-        warn = true;
-        scl_func = TIC_PIN_FUNC_DEFAULT;
-      }
-      if (is_limit_switch(sda_func))
-      {
-        warn = true;
-        sda_func = TIC_PIN_FUNC_DEFAULT;
-      }
-      if (is_limit_switch(tx_func))
-      {
-        warn = true;
-        tx_func = TIC_PIN_FUNC_DEFAULT;
-      }
-      if (is_limit_switch(rx_func))
-      {
-        warn = true;
-        rx_func = TIC_PIN_FUNC_DEFAULT;
-      }
-      if (is_limit_switch(rc_func))
-      {
-        warn = true;
-        rc_func = TIC_PIN_FUNC_DEFAULT;
-      }
-      if (warn)
-      {
-        tic_sprintf(warnings,
-          "Warning: The firmware version on your device does not support "
-          "limit switches, so any pin configured as a limit switch "
-          "will be changed to its default function.  "
-          "See " DOCUMENTATION_URL " for firmware upgrade instructions.\n");
-      }
+      warn(fixer, TIC_SETTINGS_WARNING_CONFLICT, "sda_config",
+        "The SDA pin must be used for I2C if the SCL pin is, "
+        "so the SCL and SDA pin functions will be changed to the default.");
     }
+  }
+
+  tic_settings_set_pin_func(settings, TIC_PIN_NUM_SCL, scl_func);
+  tic_settings_set_pin_func(settings, TIC_PIN_NUM_SDA, sda_func);
+  tic_settings_set_pin_func(settings, TIC_PIN_NUM_TX, tx_func);
+  tic_settings_set_pin_func(settings, TIC_PIN_NUM_RX, rx_func);
+  tic_settings_set_pin_func(settings, TIC_PIN_NUM_RC, rc_func);
+  tic_settings_set_pin_analog(settings, TIC_PIN_NUM_RC, rc_analog);
+}
+
+// Every rule also depends on the product and firmware version, which are in
+// TIC_SETTINGS_GROUP_DEVICE.  If those change, all the rules run.
+static const struct
+{
+  void (* fix)(tic_settings_fixer *);
+  uint32_t reads;
+  uint32_t writes;
+} tic_settings_rules[] = {
+  { fix_control_mode,
+    TIC_SETTINGS_GROUP_CONTROL_MODE,
+    TIC_SETTINGS_GROUP_CONTROL_MODE },
+  { fix_soft_error_response,
+    TIC_SETTINGS_GROUP_SOFT_ERROR_RESPONSE,
+    TIC_SETTINGS_GROUP_SOFT_ERROR_RESPONSE },
+  { fix_input_scaling_degree,
+    TIC_SETTINGS_GROUP_INPUT_SCALING_DEGREE,
+    TIC_SETTINGS_GROUP_INPUT_SCALING_DEGREE },
+  { fix_step_mode,
+    TIC_SETTINGS_GROUP_STEP_MODE,
+    TIC_SETTINGS_GROUP_STEP_MODE },
+  { fix_decay_mode,
+    TIC_SETTINGS_GROUP_DECAY_MODE,
+    TIC_SETTINGS_GROUP_DECAY_MODE },
+  { fix_agc_mode,
+    TIC_SETTINGS_GROUP_AGC,
+    TIC_SETTINGS_GROUP_AGC },
+  { fix_agc_bottom_current_limit,
+    TIC_SETTINGS_GROUP_AGC,
+    TIC_SETTINGS_GROUP_AGC },
+  { fix_agc_current_boost_steps,
+    TIC_SETTINGS_GROUP_AGC,
+    TIC_SETTINGS_GROUP_AGC },
+  { fix_agc_frequency_limit,
+    TIC_SETTINGS_GROUP_AGC,
+    TIC_SETTINGS_GROUP_AGC },
+  { fix_soft_error_response_for_mode,
+    TIC_SETTINGS_GROUP_SOFT_ERROR_RESPONSE | TIC_SETTINGS_GROUP_CONTROL_MODE,
+    TIC_SETTINGS_GROUP_SOFT_ERROR_RESPONSE },
+  { fix_serial_baud_rate,
+    TIC_SETTINGS_GROUP_SERIAL_BAUD_RATE,
+    TIC_SETTINGS_GROUP_SERIAL_BAUD_RATE },
+  { fix_serial_device_number,
+    TIC_SETTINGS_GROUP_SERIAL_DEVICE_NUMBER,
+    TIC_SETTINGS_GROUP_SERIAL_DEVICE_NUMBER },
+  { fix_command_timeout,
+    TIC_SETTINGS_GROUP_COMMAND_TIMEOUT,
+    TIC_SETTINGS_GROUP_COMMAND_TIMEOUT },
+  { fix_serial_responses,
+    TIC_SETTINGS_GROUP_SERIAL_RESPONSES,
+    TIC_SETTINGS_GROUP_SERIAL_RESPONSES },
+  { fix_vin,
+    TIC_SETTINGS_GROUP_VIN,
+    TIC_SETTINGS_GROUP_VIN },
+  { fix_vin_calibration,
+    TIC_SETTINGS_GROUP_VIN_CALIBRATION,
+    TIC_SETTINGS_GROUP_VIN_CALIBRATION },
+  { fix_input_scaling,
+    TIC_SETTINGS_GROUP_INPUT_SCALING,
+    TIC_SETTINGS_GROUP_INPUT_SCALING },
+  { fix_output_scaling,
+    TIC_SETTINGS_GROUP_OUTPUT_SCALING,
+    TIC_SETTINGS_GROUP_OUTPUT_SCALING },
+  { fix_encoder,
+    TIC_SETTINGS_GROUP_ENCODER,
+    TIC_SETTINGS_GROUP_ENCODER },
+  { fix_current_limit,
+    TIC_SETTINGS_GROUP_CURRENT_LIMIT,
+    TIC_SETTINGS_GROUP_CURRENT_LIMIT },
+  { fix_auto_homing,
+    TIC_SETTINGS_GROUP_AUTO_HOMING,
+    TIC_SETTINGS_GROUP_AUTO_HOMING },
+  { fix_speeds,
+    TIC_SETTINGS_GROUP_SPEED,
+    TIC_SETTINGS_GROUP_SPEED },
+  { fix_accel,
+    TIC_SETTINGS_GROUP_ACCEL,
+    TIC_SETTINGS_GROUP_ACCEL },
+  { fix_pins,
+    TIC_SETTINGS_GROUP_PINS | TIC_SETTINGS_GROUP_CONTROL_MODE,
+    TIC_SETTINGS_GROUP_PINS },
+};
+
+// Runs the rules that read any of the specified groups.
+static void tic_settings_fix_core(tic_settings * settings, uint32_t changed,
+  tic_string * string, tic_settings_warnings * list)
+{
+  tic_settings_fixer fixer;
+  fixer.settings = settings;
+  fixer.product = tic_settings_get_product(settings);
+  fixer.firmware_version = tic_settings_get_firmware_version(settings);
+  fixer.string = string;
+  fixer.list = list;
+
+  if (changed & TIC_SETTINGS_GROUP_DEVICE)
+  {
+    changed = TIC_SETTINGS_GROUP_ALL;
+  }
 
-    // Next, enforce proper values for pin booleans.
-    if (rc_analog)
+  size_t count = sizeof(tic_settings_rules) / sizeof(tic_settings_rules[0]);
+  for (size_t i = 0; i < count; i++)
+  {
+    if (tic_settings_rules[i].reads & changed)
     {
-      rc_analog = false;
-      tic_sprintf(warnings,
-        "Warning: The RC pin cannot be an analog input "
-        "so that feature will be disabled.\n");
+      tic_settings_rules[i].fix(&fixer);
+      changed |= tic_settings_rules[i].writes;
     }
+  }
+}
 
-    // Note: aren't enforcing proper values for the "pullup" boolean yet.  That
-    // setting is more of a suggestion from the firmware; the RC line cannot
-    // have a pull-up and the TX and RX lines always do if they are inputs.
-    // The firmware's default settings for TX and RX don't set the pull-up bit,
-    // so it would be bad to complain to the user about that.
-
-    // Finally, if one of the SCL/SDA pins is configured for I2C, make sure the other one
-    // is configured that way too.  This should be last because other checks in this
-    // code might change SCL or SDA to be used for I2C.
-    bool scl_is_i2c = (scl_func == TIC_PIN_FUNC_DEFAULT && !analog_control_mode) ||
-      (scl_func == TIC_PIN_FUNC_SERIAL);
-    bool sda_is_i2c = (sda_func == TIC_PIN_FUNC_DEFAULT && !analog_control_mode) ||
-      (sda_func == TIC_PIN_FUNC_SERIAL);
-    if (sda_is_i2c != scl_is_i2c)
-    {
-      scl_func = TIC_PIN_FUNC_DEFAULT;
-      sda_func = TIC_PIN_FUNC_DEFAULT;
-      if (sda_is_i2c)
-      {
-        tic_sprintf(warnings,
-          "Warning: The SCL pin must be used for I2C if the SDA pin is, "
-          "so the SCL and SDA pin functions will be changed to the default.\n");
-      }
-      else
+#ifndef NDEBUG
+static void tic_settings_check_fix(const tic_settings * settings,
+  uint32_t changed)
+{
+  tic_settings * incremental = NULL;
+  tic_settings * full = NULL;
+  tic_error_free(tic_settings_copy(settings, &incremental));
+  tic_error_free(tic_settings_copy(settings, &full));
+  tic_settings_warnings * incremental_list = calloc(1,
+    sizeof(tic_settings_warnings));
+  tic_settings_warnings * full_list = calloc(1, sizeof(tic_settings_warnings));
+  tic_settings_warnings * extra_list = calloc(1, sizeof(tic_settings_warnings));
+
+  if (incremental && full && incremental_list && full_list && extra_list)
+  {
+    // Assert that only checking the groups that changed gives the same result
+    // as checking everything.
+    tic_settings_fix_core(incremental, changed, NULL, incremental_list);
+    tic_settings_fix_core(full, TIC_SETTINGS_GROUP_ALL, NULL, full_list);
+    assert(tic_settings_changed_groups(incremental, full) == 0);
+    if (!incremental_list->no_memory && !full_list->no_memory)
+    {
+      assert(incremental_list->count == full_list->count);
+      for (size_t i = 0; i < full_list->count; i++)
       {
-        tic_sprintf(warnings,
-          "Warning: The SDA pin must be used for I2C if the SCL pin is, "
-          "so the SCL and SDA pin functions will be changed to the default.\n");
+        assert(incremental_list->entries[i].code == full_list->entries[i].code);
+        assert(!strcmp(incremental_list->entries[i].field,
+          full_list->entries[i].field));
+        assert(!strcmp(incremental_list->entries[i].message,
+          full_list->entries[i].message));
       }
     }
 
-    tic_settings_set_pin_func(settings, TIC_PIN_NUM_SCL, scl_func);
-    tic_settings_set_pin_func(settings, TIC_PIN_NUM_SDA, sda_func);
-    tic_settings_set_pin_func(settings, TIC_PIN_NUM_TX, tx_func);
-    tic_settings_set_pin_func(settings, TIC_PIN_NUM_RX, rx_func);
-    tic_settings_set_pin_func(settings, TIC_PIN_NUM_RC, rc_func);
-    tic_settings_set_pin_analog(settings, TIC_PIN_NUM_RC, rc_analog);
+    // Assert that fixing is idempotent.
+    tic_settings_fix_core(full, TIC_SETTINGS_GROUP_ALL, NULL, extra_list);
+    assert(extra_list->count == 0);
   }
+
+  tic_settings_warnings_free(extra_list);
+  tic_settings_warnings_free(full_list);
+  tic_settings_warnings_free(incremental_list);
+  tic_settings_free(full);
+  tic_settings_free(incremental);
 }
+#endif
 
-tic_error * tic_settings_fix(tic_settings * settings, char ** warnings)
+static tic_error * tic_settings_fix_internal(tic_settings * settings,
+  tic_string * string, tic_settings_warnings * list)
 {
-  if (warnings) { *warnings = NULL; }
-
   if (settings == NULL)
   {
     return tic_error_create("Tic settings pointer is null.");
   }
 
+  uint32_t changed = tic_settings_changed_groups(settings,
+    tic_settings_get_last_fixed(settings));
+
+  #ifndef NDEBUG
+  tic_settings_check_fix(settings, changed);
+  #endif
+
+  tic_settings_fix_core(settings, changed, string, list);
+  tic_settings_save_fixed(settings);
+  return NULL;
+}
+
+tic_error * tic_settings_fix(tic_settings * settings, char ** warnings)
+{
+  if (warnings) { *warnings = NULL; }
+
   // Make a string to store the warnings we accumulate in this function.
   tic_string str;
   if (warnings)
@@ -971,30 +1276,96 @@ tic_error * tic_settings_fix(tic_settings * settings, char ** warnings)
     tic_string_setup_dummy(&str);
   }
 
-  tic_settings_fix_core(settings, &str);
+  tic_error * error = tic_settings_fix_internal(settings,
+    warnings ? &str : NULL, NULL);
 
-  #ifndef NDEBUG
+  if (error == NULL && warnings && str.data == NULL)
   {
-    // In debug builds, assert that this function is idempotent.
-    tic_string str2;
-    tic_string_setup(&str2);
-    tic_settings_fix_core(settings, &str2);
-    assert(str2.data != NULL && str2.data[0] == 0);
-    tic_string_free(str2.data);
+    // Memory allocation for the warning string failed at some point.
+    error = &tic_error_no_memory;
   }
-  #endif
 
-  if (warnings && str.data == NULL)
+  if (error == NULL && warnings)
   {
-    // Memory allocation for the warning string failed at some point.
-    return &tic_error_no_memory;
+    *warnings = str.data;
+    str.data = NULL;
   }
 
+  tic_string_free(str.data);
+
+  return error;
+}
+
+tic_error * tic_settings_fix_with_warnings(tic_settings * settings,
+  tic_settings_warnings ** warnings)
+{
+  if (warnings) { *warnings = NULL; }
+
+  tic_error * error = NULL;
+
+  tic_settings_warnings * list = NULL;
   if (warnings)
   {
-    *warnings = str.data;
-    str.data = NULL;
+    list = calloc(1, sizeof(tic_settings_warnings));
+    if (list == NULL) { error = &tic_error_no_memory; }
   }
 
-  return NULL;
+  if (error == NULL)
+  {
+    error = tic_settings_fix_internal(settings, NULL, list);
+  }
+
+  if (error == NULL && list && list->no_memory)
+  {
+    // Memory allocation for a warning failed at some point.
+    error = &tic_error_no_memory;
+  }
+
+  if (error == NULL && warnings)
+  {
+    *warnings = list;
+    list = NULL;
+  }
+
+  tic_settings_warnings_free(list);
+
+  return error;
+}
+
+void tic_settings_warnings_free(tic_settings_warnings * warnings)
+{
+  if (warnings == NULL) { return; }
+  for (size_t i = 0; i < warnings->count; i++)
+  {
+    free(warnings->entries[i].message);
+  }
+  free(warnings->entries);
+  free(warnings);
+}
+
+size_t tic_settings_warnings_get_count(const tic_settings_warnings * warnings)
+{
+  if (warnings == NULL) { return 0; }
+  return warnings->count;
+}
+
+uint8_t tic_settings_warnings_get_code(const tic_settings_warnings * warnings,
+  size_t index)
+{
+  if (warnings == NULL || index >= warnings->count) { return 0; }
+  return warnings->entries[index].code;
+}
+
+const char * tic_settings_warnings_get_field(
+  const tic_settings_warnings * warnings, size_t index)
+{
+  if (warnings == NULL || index >= warnings->count) { return NULL; }
+  return warnings->entries[index].field;
+}
+
+const char * tic_settings_warnings_get_message(
+  const tic_settings_warnings * warnings, size_t index)
+{
+  if (warnings == NULL || index >= warnings->count) { return NULL; }
+  return warnings->entries[index].message;
 }
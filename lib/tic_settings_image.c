@@ -0,0 +1,168 @@
+// Functions for converting settings to and from binary settings images, which
+// hold the raw bytes of the Tic's EEPROM along with a small header.
+//
+// Image format (all multi-byte fields are little-endian):
+//
+//   Offset  Size  Contents
+//   0       4     Magic bytes: "TICS"
+//   4       1     Format version: 1
+//   5       1     Product (TIC_PRODUCT_*)
+//   6       2     Firmware version (BCD, 0 if unknown)
+//   8       2     Length of the settings bytes: TIC_SETTINGS_SIZE
+//   10      2     Reserved, must be 0
+//   12      4     CRC-32 of bytes 0-11 and the settings bytes
+//   16      ...   Settings bytes, in the format of the Tic's EEPROM
+
+#include "tic_internal.h"
+
+#define TIC_SETTINGS_IMAGE_FORMAT_VERSION 1
+#define TIC_SETTINGS_IMAGE_HEADER_SIZE 16
+#define TIC_SETTINGS_IMAGE_CRC_OFFSET 12
+
+static const uint8_t tic_settings_image_magic[4] = { 'T', 'I', 'C', 'S' };
+
+static uint32_t tic_crc32(uint32_t crc, const uint8_t * buffer, size_t length)
+{
+  crc = ~crc;
+  for (size_t i = 0; i < length; i++)
+  {
+    crc ^= buffer[i];
+    for (uint8_t j = 0; j < 8; j++)
+    {
+      crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+    }
+  }
+  return ~crc;
+}
+
+static uint32_t tic_settings_image_crc(const uint8_t * image)
+{
+  uint32_t crc = tic_crc32(0, image, TIC_SETTINGS_IMAGE_CRC_OFFSET);
+  return tic_crc32(crc, image + TIC_SETTINGS_IMAGE_HEADER_SIZE,
+    TIC_SETTINGS_SIZE);
+}
+
+tic_error * tic_settings_to_image(const tic_settings * settings,
+  uint8_t * image, size_t size)
+{
+  if (settings == NULL)
+  {
+    return tic_error_create("Settings pointer is null.");
+  }
+
+  if (image == NULL)
+  {
+    return tic_error_create("Image output pointer is null.");
+  }
+
+  if (size < TIC_SETTINGS_IMAGE_SIZE)
+  {
+    return tic_error_create(
+      "The image buffer is too small: %u bytes are needed.",
+      (unsigned int)TIC_SETTINGS_IMAGE_SIZE);
+  }
+
+  memset(image, 0, TIC_SETTINGS_IMAGE_SIZE);
+  memcpy(image, tic_settings_image_magic, sizeof(tic_settings_image_magic));
+  image[4] = TIC_SETTINGS_IMAGE_FORMAT_VERSION;
+  image[5] = tic_settings_get_product(settings);
+  write_u16(image + 6, tic_settings_get_firmware_version(settings));
+  write_u16(image + 8, TIC_SETTINGS_SIZE);
+  tic_write_settings_to_buffer(settings,
+    image + TIC_SETTINGS_IMAGE_HEADER_SIZE);
+
+  write_u32(image + TIC_SETTINGS_IMAGE_CRC_OFFSET,
+    tic_settings_image_crc(image));
+
+  return NULL;
+}
+
+static tic_error * tic_settings_check_image(const uint8_t * image, size_t size)
+{
+  if (size < TIC_SETTINGS_IMAGE_HEADER_SIZE ||
+    memcmp(image, tic_settings_image_magic, sizeof(tic_settings_image_magic)))
+  {
+    return tic_error_create("The data is not a Tic settings image.");
+  }
+
+  if (image[4] != TIC_SETTINGS_IMAGE_FORMAT_VERSION)
+  {
+    return tic_error_create(
+      "The settings image has format version %u, which is not supported by "
+      "this software.", image[4]);
+  }
+
+  if (read_u16(image + 8) != TIC_SETTINGS_SIZE || size != TIC_SETTINGS_IMAGE_SIZE)
+  {
+    return tic_error_create(
+      "The settings image has the wrong size.  "
+      "Expected %u bytes, got %u.",
+      (unsigned int)TIC_SETTINGS_IMAGE_SIZE, (unsigned int)size);
+  }
+
+  if (read_u32(image + TIC_SETTINGS_IMAGE_CRC_OFFSET) !=
+    tic_settings_image_crc(image))
+  {
+    return tic_error_create("The settings image is corrupt: "
+      "its checksum is incorrect.");
+  }
+
+  if (!tic_code_to_name(tic_product_names_short, image[5], NULL))
+  {
+    return tic_error_create(
+      "The settings image is for an unknown product (%u).", image[5]);
+  }
+
+  return NULL;
+}
+
+tic_error * tic_settings_read_from_image(const uint8_t * image, size_t size,
+  tic_settings ** settings)
+{
+  if (image == NULL)
+  {
+    return tic_error_create("Image input pointer is null.");
+  }
+
+  if (settings == NULL)
+  {
+    return tic_error_create("Settings output pointer is null.");
+  }
+
+  tic_error * error = NULL;
+
+  if (error == NULL)
+  {
+    error = tic_settings_check_image(image, size);
+  }
+
+  tic_settings * new_settings = NULL;
+  if (error == NULL)
+  {
+    error = tic_settings_create(&new_settings);
+  }
+
+  if (error == NULL)
+  {
+    tic_settings_set_product(new_settings, image[5]);
+    tic_settings_set_firmware_version(new_settings, read_u16(image + 6));
+    tic_write_buffer_to_settings(image + TIC_SETTINGS_IMAGE_HEADER_SIZE,
+      new_settings);
+  }
+
+  if (error == NULL)
+  {
+    *settings = new_settings;
+    new_settings = NULL;
+  }
+
+  tic_settings_free(new_settings);
+
+  if (error != NULL)
+  {
+    error = tic_error_add(error,
+      "There was an error reading the settings image.");
+  }
+
+  return error;
+}
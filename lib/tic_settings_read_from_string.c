@@ -12,15 +12,19 @@ static bool tic_parse_pin_config(const char * input,
   tic_settings_set_pin_analog(settings, pin, false);
   tic_settings_set_pin_polarity(settings, pin, false);
 
+  // We split the string ourselves instead of using strtok because strtok is
+  // not thread-safe.
   char str[256];
   strcpy(str, input);
 
   char * p = str;
   while (true)
   {
-    char * token = strtok(p, " ");
-    p = NULL;
-    if (token == NULL) { break; }
+    while (*p == ' ') { p++; }
+    if (*p == 0) { break; }
+    char * token = p;
+    while (*p != ' ' && *p != 0) { p++; }
+    if (*p == ' ') { *p++ = 0; }
 
     if (0 == strcmp(token, "pullup"))
     {
@@ -61,6 +65,244 @@ static tic_error * apply_product_name(tic_settings * settings, const char * prod
   return NULL;
 }
 
+// The types of values that a key in the settings file can have.
+enum tic_settings_key_type
+{
+  TIC_KEY_IGNORE,
+  TIC_KEY_NAME,
+  TIC_KEY_INT,
+  TIC_KEY_PIN_CONFIG,
+  TIC_KEY_DECAY_MODE,
+};
+
+typedef struct tic_settings_key
+{
+  const char * name;
+  uint8_t type;
+
+  // For TIC_KEY_NAME: the names that the value can have.
+  const tic_name * names;
+
+  // For TIC_KEY_INT: the range of values that the setter function accepts.
+  int64_t min;
+  int64_t max;
+
+  // For TIC_KEY_PIN_CONFIG: the pin number.
+  uint8_t pin;
+
+  void (* set)(tic_settings *, int64_t);
+} tic_settings_key;
+
+// Defines a function with a common signature that calls a tic_settings setter
+// function, so we can use it in the key table.
+#define TIC_KEY_SETTER(field) \
+  static void set_##field(tic_settings * settings, int64_t value) \
+  { \
+    tic_settings_set_##field(settings, value); \
+  }
+
+static void set_serial_device_number(tic_settings * settings, int64_t value)
+{
+  tic_settings_set_serial_device_number_u16(settings, value);
+}
+
+TIC_KEY_SETTER(agc_bottom_current_limit)
+TIC_KEY_SETTER(agc_current_boost_steps)
+TIC_KEY_SETTER(agc_frequency_limit)
+TIC_KEY_SETTER(agc_mode)
+TIC_KEY_SETTER(auto_clear_driver_error)
+TIC_KEY_SETTER(auto_homing)
+TIC_KEY_SETTER(auto_homing_forward)
+TIC_KEY_SETTER(command_timeout)
+TIC_KEY_SETTER(control_mode)
+TIC_KEY_SETTER(current_limit)
+TIC_KEY_SETTER(current_limit_during_error)
+TIC_KEY_SETTER(disable_safe_start)
+TIC_KEY_SETTER(encoder_postscaler)
+TIC_KEY_SETTER(encoder_prescaler)
+TIC_KEY_SETTER(encoder_unlimited)
+TIC_KEY_SETTER(high_vin_shutoff_voltage)
+TIC_KEY_SETTER(homing_speed_away)
+TIC_KEY_SETTER(homing_speed_towards)
+TIC_KEY_SETTER(ignore_err_line_high)
+TIC_KEY_SETTER(input_averaging_enabled)
+TIC_KEY_SETTER(input_error_max)
+TIC_KEY_SETTER(input_error_min)
+TIC_KEY_SETTER(input_hysteresis)
+TIC_KEY_SETTER(input_invert)
+TIC_KEY_SETTER(input_max)
+TIC_KEY_SETTER(input_min)
+TIC_KEY_SETTER(input_neutral_max)
+TIC_KEY_SETTER(input_neutral_min)
+TIC_KEY_SETTER(input_scaling_degree)
+TIC_KEY_SETTER(invert_motor_direction)
+TIC_KEY_SETTER(low_vin_shutoff_voltage)
+TIC_KEY_SETTER(low_vin_startup_voltage)
+TIC_KEY_SETTER(low_vin_timeout)
+TIC_KEY_SETTER(max_accel)
+TIC_KEY_SETTER(max_decel)
+TIC_KEY_SETTER(max_speed)
+TIC_KEY_SETTER(never_sleep)
+TIC_KEY_SETTER(output_max)
+TIC_KEY_SETTER(output_min)
+TIC_KEY_SETTER(rc_bad_signal_timeout)
+TIC_KEY_SETTER(rc_consecutive_good_pulses)
+TIC_KEY_SETTER(rc_max_pulse_period)
+TIC_KEY_SETTER(serial_14bit_device_number)
+TIC_KEY_SETTER(serial_7bit_responses)
+TIC_KEY_SETTER(serial_alt_device_number)
+TIC_KEY_SETTER(serial_baud_rate)
+TIC_KEY_SETTER(serial_crc_for_commands)
+TIC_KEY_SETTER(serial_crc_for_responses)
+TIC_KEY_SETTER(serial_enable_alt_device_number)
+TIC_KEY_SETTER(serial_response_delay)
+TIC_KEY_SETTER(soft_error_position)
+TIC_KEY_SETTER(soft_error_response)
+TIC_KEY_SETTER(starting_speed)
+TIC_KEY_SETTER(step_mode)
+TIC_KEY_SETTER(vin_calibration)
+
+// This table must be sorted by key so we can use a binary search.
+static const tic_settings_key tic_settings_keys[] =
+{
+  { "agc_bottom_current_limit", TIC_KEY_NAME,
+    .names = tic_agc_bottom_current_limit_names,
+    .set = set_agc_bottom_current_limit },
+  { "agc_current_boost_steps", TIC_KEY_NAME,
+    .names = tic_agc_current_boost_steps_names,
+    .set = set_agc_current_boost_steps },
+  { "agc_frequency_limit", TIC_KEY_NAME,
+    .names = tic_agc_frequency_limit_names, .set = set_agc_frequency_limit },
+  { "agc_mode", TIC_KEY_NAME,
+    .names = tic_agc_mode_names, .set = set_agc_mode },
+  { "auto_clear_driver_error", TIC_KEY_NAME,
+    .names = tic_bool_names, .set = set_auto_clear_driver_error },
+  { "auto_homing", TIC_KEY_NAME,
+    .names = tic_bool_names, .set = set_auto_homing },
+  { "auto_homing_forward", TIC_KEY_NAME,
+    .names = tic_bool_names, .set = set_auto_homing_forward },
+  { "command_timeout", TIC_KEY_INT,
+    .min = 0, .max = 0xFFFF, .set = set_command_timeout },
+  { "control_mode", TIC_KEY_NAME,
+    .names = tic_control_mode_names, .set = set_control_mode },
+  { "current_limit", TIC_KEY_INT,
+    .min = 0, .max = UINT32_MAX, .set = set_current_limit },
+  { "current_limit_during_error", TIC_KEY_INT,
+    .min = INT32_MIN, .max = INT32_MAX, .set = set_current_limit_during_error },
+  { "decay_mode", TIC_KEY_DECAY_MODE, .set = NULL },
+  { "disable_safe_start", TIC_KEY_NAME,
+    .names = tic_bool_names, .set = set_disable_safe_start },
+  { "encoder_postscaler", TIC_KEY_INT,
+    .min = 0, .max = UINT32_MAX, .set = set_encoder_postscaler },
+  { "encoder_prescaler", TIC_KEY_INT,
+    .min = 0, .max = UINT32_MAX, .set = set_encoder_prescaler },
+  { "encoder_unlimited", TIC_KEY_NAME,
+    .names = tic_bool_names, .set = set_encoder_unlimited },
+  { "high_vin_shutoff_voltage", TIC_KEY_INT,
+    .min = 0, .max = 0xFFFF, .set = set_high_vin_shutoff_voltage },
+  { "homing_speed_away", TIC_KEY_INT,
+    .min = 0, .max = UINT32_MAX, .set = set_homing_speed_away },
+  { "homing_speed_towards", TIC_KEY_INT,
+    .min = 0, .max = UINT32_MAX, .set = set_homing_speed_towards },
+  { "ignore_err_line_high", TIC_KEY_NAME,
+    .names = tic_bool_names, .set = set_ignore_err_line_high },
+  { "input_averaging_enabled", TIC_KEY_NAME,
+    .names = tic_bool_names, .set = set_input_averaging_enabled },
+  { "input_error_max", TIC_KEY_INT,
+    .min = 0, .max = 0xFFFF, .set = set_input_error_max },
+  { "input_error_min", TIC_KEY_INT,
+    .min = 0, .max = 0xFFFF, .set = set_input_error_min },
+  { "input_hysteresis", TIC_KEY_INT,
+    .min = 0, .max = 0xFFFF, .set = set_input_hysteresis },
+  { "input_invert", TIC_KEY_NAME,
+    .names = tic_bool_names, .set = set_input_invert },
+  { "input_max", TIC_KEY_INT,
+    .min = 0, .max = 0xFFFF, .set = set_input_max },
+  { "input_min", TIC_KEY_INT,
+    .min = 0, .max = 0xFFFF, .set = set_input_min },
+  { "input_neutral_max", TIC_KEY_INT,
+    .min = 0, .max = 0xFFFF, .set = set_input_neutral_max },
+  { "input_neutral_min", TIC_KEY_INT,
+    .min = 0, .max = 0xFFFF, .set = set_input_neutral_min },
+  { "input_scaling_degree", TIC_KEY_NAME,
+    .names = tic_scaling_degree_names, .set = set_input_scaling_degree },
+  { "invert_motor_direction", TIC_KEY_NAME,
+    .names = tic_bool_names, .set = set_invert_motor_direction },
+  { "low_vin_shutoff_voltage", TIC_KEY_INT,
+    .min = 0, .max = 0xFFFF, .set = set_low_vin_shutoff_voltage },
+  { "low_vin_startup_voltage", TIC_KEY_INT,
+    .min = 0, .max = 0xFFFF, .set = set_low_vin_startup_voltage },
+  { "low_vin_timeout", TIC_KEY_INT,
+    .min = 0, .max = 0xFFFF, .set = set_low_vin_timeout },
+  { "max_accel", TIC_KEY_INT,
+    .min = 0, .max = UINT32_MAX, .set = set_max_accel },
+  { "max_decel", TIC_KEY_INT,
+    .min = 0, .max = UINT32_MAX, .set = set_max_decel },
+  { "max_speed", TIC_KEY_INT,
+    .min = 0, .max = UINT32_MAX, .set = set_max_speed },
+  { "never_sleep", TIC_KEY_NAME,
+    .names = tic_bool_names, .set = set_never_sleep },
+  { "output_max", TIC_KEY_INT,
+    .min = INT32_MIN, .max = INT32_MAX, .set = set_output_max },
+  { "output_min", TIC_KEY_INT,
+    .min = INT32_MIN, .max = INT32_MAX, .set = set_output_min },
+  // We process the product key separately, before the other keys.
+  { "product", TIC_KEY_IGNORE, .set = NULL },
+  { "rc_bad_signal_timeout", TIC_KEY_INT,
+    .min = 0, .max = 0xFFFF, .set = set_rc_bad_signal_timeout },
+  { "rc_config", TIC_KEY_PIN_CONFIG, .pin = TIC_PIN_NUM_RC },
+  { "rc_consecutive_good_pulses", TIC_KEY_INT,
+    .min = 0, .max = 0xFF, .set = set_rc_consecutive_good_pulses },
+  { "rc_max_pulse_period", TIC_KEY_INT,
+    .min = 0, .max = 0xFFFF, .set = set_rc_max_pulse_period },
+  { "rx_config", TIC_KEY_PIN_CONFIG, .pin = TIC_PIN_NUM_RX },
+  { "scl_config", TIC_KEY_PIN_CONFIG, .pin = TIC_PIN_NUM_SCL },
+  { "sda_config", TIC_KEY_PIN_CONFIG, .pin = TIC_PIN_NUM_SDA },
+  { "serial_14bit_device_number", TIC_KEY_NAME,
+    .names = tic_bool_names, .set = set_serial_14bit_device_number },
+  { "serial_7bit_responses", TIC_KEY_NAME,
+    .names = tic_bool_names, .set = set_serial_7bit_responses },
+  { "serial_alt_device_number", TIC_KEY_INT,
+    .min = 0, .max = 0xFFFF, .set = set_serial_alt_device_number },
+  { "serial_baud_rate", TIC_KEY_INT,
+    .min = 0, .max = UINT32_MAX - 1, .set = set_serial_baud_rate },
+  { "serial_crc_enabled", TIC_KEY_NAME,
+    .names = tic_bool_names, .set = set_serial_crc_for_commands },
+  { "serial_crc_for_commands", TIC_KEY_NAME,
+    .names = tic_bool_names, .set = set_serial_crc_for_commands },
+  { "serial_crc_for_responses", TIC_KEY_NAME,
+    .names = tic_bool_names, .set = set_serial_crc_for_responses },
+  { "serial_device_number", TIC_KEY_INT,
+    .min = 0, .max = 0xFFFF, .set = set_serial_device_number },
+  { "serial_enable_alt_device_number", TIC_KEY_NAME,
+    .names = tic_bool_names, .set = set_serial_enable_alt_device_number },
+  { "serial_response_delay", TIC_KEY_INT,
+    .min = 0, .max = 0xFF, .set = set_serial_response_delay },
+  { "soft_error_position", TIC_KEY_INT,
+    .min = INT32_MIN, .max = INT32_MAX, .set = set_soft_error_position },
+  { "soft_error_response", TIC_KEY_NAME,
+    .names = tic_response_names, .set = set_soft_error_response },
+  { "starting_speed", TIC_KEY_INT,
+    .min = 0, .max = UINT32_MAX, .set = set_starting_speed },
+  { "step_mode", TIC_KEY_NAME,
+    .names = tic_step_mode_names, .set = set_step_mode },
+  { "tx_config", TIC_KEY_PIN_CONFIG, .pin = TIC_PIN_NUM_TX },
+  { "vin_calibration", TIC_KEY_INT,
+    .min = INT16_MIN, .max = INT16_MAX, .set = set_vin_calibration },
+};
+
+static int tic_settings_key_compare(const void * key, const void * entry)
+{
+  return strcmp(key, ((const tic_settings_key *)entry)->name);
+}
+
+static const tic_settings_key * tic_settings_key_find(const char * key)
+{
+  return bsearch(key, tic_settings_keys,
+    sizeof(tic_settings_keys) / sizeof(tic_settings_keys[0]),
+    sizeof(tic_settings_key), tic_settings_key_compare);
+}
+
 // Note: The range checking we do in this function is solely to make sure the
 // value will fit in the argument to the tic_settings setter function.  If the
 // value is otherwise outside the allowed range, that will be checked in
@@ -68,707 +310,61 @@ static tic_error * apply_product_name(tic_settings * settings, const char * prod
 static tic_error * apply_string_pair(tic_settings * settings,
   const char * key, const char * value, uint32_t line)
 {
-  if (!strcmp(key, "product"))
-  {
-    // We already processed the product field separately.
-  }
-  else if (!strcmp(key, "control_mode"))
-  {
-    uint32_t control_mode;
-    if (!tic_name_to_code(tic_control_mode_names, value, &control_mode))
-    {
-      return tic_error_create("Unrecognized control_mode value.");
-    }
-    tic_settings_set_control_mode(settings, control_mode);
-  }
-  else if (!strcmp(key, "never_sleep"))
-  {
-    uint32_t never_sleep;
-    if (!tic_name_to_code(tic_bool_names, value, &never_sleep))
-    {
-      return tic_error_create("Unrecognized never_sleep value.");
-    }
-    tic_settings_set_never_sleep(settings, never_sleep);
-  }
-  else if (!strcmp(key, "disable_safe_start"))
-  {
-    uint32_t disable_safe_start;
-    if (!tic_name_to_code(tic_bool_names, value, &disable_safe_start))
-    {
-      return tic_error_create("Unrecognized disable_safe_start value.");
-    }
-    tic_settings_set_disable_safe_start(settings, disable_safe_start);
-  }
-  else if (!strcmp(key, "ignore_err_line_high"))
-  {
-    uint32_t ignore_err_line_high;
-    if (!tic_name_to_code(tic_bool_names, value, &ignore_err_line_high))
-    {
-      return tic_error_create("Unrecognized ignore_err_line_high value.");
-    }
-    tic_settings_set_ignore_err_line_high(settings, ignore_err_line_high);
-  }
-  else if (!strcmp(key, "auto_clear_driver_error"))
-  {
-    uint32_t auto_clear_driver_error;
-    if (!tic_name_to_code(tic_bool_names, value, &auto_clear_driver_error))
-    {
-      return tic_error_create("Unrecognized auto_clear_driver_error value.");
-    }
-    tic_settings_set_auto_clear_driver_error(settings, auto_clear_driver_error);
-  }
-  else if (!strcmp(key, "soft_error_response"))
-  {
-    uint32_t response;
-    if (!tic_name_to_code(tic_response_names, value, &response))
-    {
-      return tic_error_create("Unrecognized soft_error_response value.");
-    }
-    tic_settings_set_soft_error_response(settings, response);
-  }
-  else if (!strcmp(key, "soft_error_position"))
-  {
-    int64_t position;
-    if (tic_string_to_i64(value, &position))
-    {
-      return tic_error_create("Invalid soft_error_position value.");
-    }
-    if (position < INT32_MIN || position > INT32_MAX)
-    {
-      return tic_error_create(
-        "The soft_error_position value is out of range.");
-    }
-    tic_settings_set_soft_error_position(settings, position);
-  }
-  else if (!strcmp(key, "serial_baud_rate"))
-  {
-    int64_t baud;
-    if (tic_string_to_i64(value, &baud))
-    {
-      return tic_error_create("Invalid serial_baud_rate value.");
-    }
-    if (baud < 0 || baud >= UINT32_MAX)
-    {
-      return tic_error_create("The serial_baud_rate value is out of range.");
-    }
-    tic_settings_set_serial_baud_rate(settings, baud);
-  }
-  else if (!strcmp(key, "serial_device_number"))
-  {
-    int64_t num;
-    if (tic_string_to_i64(value, &num))
-    {
-      return tic_error_create("Invalid serial_device_number value.");
-    }
-    if (num < 0 || num > 0xFFFF)
-    {
-      return tic_error_create("The serial_device_number value is out of range.");
-    }
-    tic_settings_set_serial_device_number_u16(settings, num);
-  }
-  else if (!strcmp(key, "serial_alt_device_number"))
-  {
-    int64_t num;
-    if (tic_string_to_i64(value, &num))
-    {
-      return tic_error_create("Invalid serial_alt_device_number value.");
-    }
-    if (num < 0 || num > 0xFFFF)
-    {
-      return tic_error_create(
-        "The serial_alt_device_number value is out of range.");
-    }
-    tic_settings_set_serial_alt_device_number(settings, num);
-  }
-  else if (!strcmp(key, "serial_enable_alt_device_number"))
-  {
-    uint32_t enabled;
-    if (!tic_name_to_code(tic_bool_names, value, &enabled))
-    {
-      return tic_error_create(
-        "Unrecognized serial_enable_alt_device_number value.");
-    }
-    tic_settings_set_serial_enable_alt_device_number(settings, enabled);
-  }
-  else if (!strcmp(key, "serial_14bit_device_number"))
-  {
-    uint32_t enabled;
-    if (!tic_name_to_code(tic_bool_names, value, &enabled))
-    {
-      return tic_error_create("Unrecognized serial_14bit_device_number value.");
-    }
-    tic_settings_set_serial_14bit_device_number(settings, enabled);
-  }
-  else if (!strcmp(key, "command_timeout"))
-  {
-    int64_t command_timeout;
-    if (tic_string_to_i64(value, &command_timeout))
-    {
-      return tic_error_create("Invalid command_timeout value.");
-    }
-    if (command_timeout < 0 || command_timeout > 0xFFFF)
-    {
-      return tic_error_create("The command_timeout value is out of range.");
-    }
-    tic_settings_set_command_timeout(settings, command_timeout);
-  }
-  else if (!strcmp(key, "serial_crc_for_commands") ||
-    !strcmp(key, "serial_crc_enabled"))
-  {
-    uint32_t enabled;
-    if (!tic_name_to_code(tic_bool_names, value, &enabled))
-    {
-      return tic_error_create("Unrecognized serial_crc_for_commands value.");
-    }
-    tic_settings_set_serial_crc_for_commands(settings, enabled);
-  }
-  else if (!strcmp(key, "serial_crc_for_responses"))
-  {
-    uint32_t enabled;
-    if (!tic_name_to_code(tic_bool_names, value, &enabled))
-    {
-      return tic_error_create("Unrecognized serial_crc_for_responses value.");
-    }
-    tic_settings_set_serial_crc_for_responses(settings, enabled);
-  }
-  else if (!strcmp(key, "serial_7bit_responses"))
-  {
-    uint32_t enabled;
-    if (!tic_name_to_code(tic_bool_names, value, &enabled))
-    {
-      return tic_error_create("Unrecognized serial_7bit_responses value.");
-    }
-    tic_settings_set_serial_7bit_responses(settings, enabled);
-  }
-  else if (!strcmp(key, "serial_response_delay"))
-  {
-    int64_t delay;
-    if (tic_string_to_i64(value, &delay))
-    {
-      return tic_error_create("Invalid serial_response_delay value.");
-    }
-    if (delay < 0 || delay > 0xFF)
-    {
-      return tic_error_create("The serial_response_delay value is out of range.");
-    }
-    tic_settings_set_serial_response_delay(settings, delay);
-  }
-  else if (!strcmp(key, "low_vin_timeout"))
-  {
-    int64_t low_vin_timeout;
-    if (tic_string_to_i64(value, &low_vin_timeout))
-    {
-      return tic_error_create("Invalid low_vin_timeout value.");
-    }
-    if (low_vin_timeout < 0 || low_vin_timeout > 0xFFFF)
-    {
-      return tic_error_create("The low_vin_timeout value is out of range.");
-    }
-    tic_settings_set_low_vin_timeout(settings, low_vin_timeout);
-  }
-  else if (!strcmp(key, "low_vin_shutoff_voltage"))
-  {
-    int64_t low_vin_shutoff_voltage;
-    if (tic_string_to_i64(value, &low_vin_shutoff_voltage))
-    {
-      return tic_error_create("Invalid low_vin_shutoff_voltage value.");
-    }
-    if (low_vin_shutoff_voltage < 0 || low_vin_shutoff_voltage > 0xFFFF)
-    {
-      return tic_error_create(
-        "The low_vin_shutoff_voltage value is out of range.");
-    }
-    tic_settings_set_low_vin_shutoff_voltage(settings, low_vin_shutoff_voltage);
-  }
-  else if (!strcmp(key, "low_vin_startup_voltage"))
-  {
-    int64_t low_vin_startup_voltage;
-    if (tic_string_to_i64(value, &low_vin_startup_voltage))
-    {
-      return tic_error_create("Invalid low_vin_startup_voltage value.");
-    }
-    if (low_vin_startup_voltage < 0 || low_vin_startup_voltage > 0xFFFF)
-    {
-      return tic_error_create(
-        "The low_vin_startup_voltage value is out of range.");
-    }
-    tic_settings_set_low_vin_startup_voltage(settings, low_vin_startup_voltage);
-  }
-  else if (!strcmp(key, "high_vin_shutoff_voltage"))
-  {
-    int64_t high_vin_shutoff_voltage;
-    if (tic_string_to_i64(value, &high_vin_shutoff_voltage))
-    {
-      return tic_error_create("Invalid high_vin_shutoff_voltage value.");
-    }
-    if (high_vin_shutoff_voltage < 0 || high_vin_shutoff_voltage > 0xFFFF)
-    {
-      return tic_error_create(
-        "The high_vin_shutoff_voltage value is out of range.");
-    }
-    tic_settings_set_high_vin_shutoff_voltage(settings,
-      high_vin_shutoff_voltage);
-  }
-  else if (!strcmp(key, "vin_calibration"))
-  {
-    int64_t vin_calibration;
-    if (tic_string_to_i64(value, &vin_calibration))
-    {
-      return tic_error_create("Invalid vin_calibration value.");
-    }
-    if (vin_calibration < INT16_MIN || vin_calibration > INT16_MAX)
-    {
-      return tic_error_create(
-        "The vin_calibration value is out of range.");
-    }
-    tic_settings_set_vin_calibration(settings, vin_calibration);
-  }
-  else if (!strcmp(key, "rc_max_pulse_period"))
-  {
-    int64_t rc_max_pulse_period;
-    if (tic_string_to_i64(value, &rc_max_pulse_period))
-    {
-      return tic_error_create("Invalid rc_max_pulse_period value.");
-    }
-    if (rc_max_pulse_period < 0 || rc_max_pulse_period > 0xFFFF)
-    {
-      return tic_error_create(
-        "The rc_max_pulse_period value is out of range.");
-    }
-    tic_settings_set_rc_max_pulse_period(settings, rc_max_pulse_period);
-  }
-  else if (!strcmp(key, "rc_bad_signal_timeout"))
-  {
-    int64_t rc_bad_signal_timeout;
-    if (tic_string_to_i64(value, &rc_bad_signal_timeout))
-    {
-      return tic_error_create("Invalid rc_bad_signal_timeout value.");
-    }
-    if (rc_bad_signal_timeout < 0 || rc_bad_signal_timeout > 0xFFFF)
-    {
-      return tic_error_create(
-        "The rc_bad_signal_timeout value is out of range.");
-    }
-    tic_settings_set_rc_bad_signal_timeout(settings, rc_bad_signal_timeout);
-  }
-  else if (!strcmp(key, "rc_consecutive_good_pulses"))
-  {
-    int64_t rc_consecutive_good_pulses;
-    if (tic_string_to_i64(value, &rc_consecutive_good_pulses))
-    {
-      return tic_error_create("Invalid rc_consecutive_good_pulses value.");
-    }
-    if (rc_consecutive_good_pulses < 0 || rc_consecutive_good_pulses > 0xFF)
-    {
-      return tic_error_create(
-        "The rc_consecutive_good_pulses value is out of range.");
-    }
-    tic_settings_set_rc_consecutive_good_pulses(settings,
-      rc_consecutive_good_pulses);
-  }
-  else if (!strcmp(key, "input_averaging_enabled"))
-  {
-    uint32_t input_averaging_enabled;
-    if (!tic_name_to_code(tic_bool_names, value, &input_averaging_enabled))
-    {
-      return tic_error_create("Unrecognized input_averaging_enabled value.");
-    }
-    tic_settings_set_input_averaging_enabled(settings, input_averaging_enabled);
-  }
-  else if (!strcmp(key, "input_hysteresis"))
-  {
-    int64_t hysteresis;
-    if (tic_string_to_i64(value, &hysteresis))
-    {
-      return tic_error_create("Invalid input_hysteresis value.");
-    }
-    if (hysteresis < 0 || hysteresis > 0xFFFF)
-    {
-      return tic_error_create("The input_hysteresis value is out of range.");
-    }
-    tic_settings_set_input_hysteresis(settings, hysteresis);
-  }
-  else if (!strcmp(key, "input_error_min"))
-  {
-    int64_t input_error_min;
-    if (tic_string_to_i64(value, &input_error_min))
-    {
-      return tic_error_create("Invalid input_error_min value.");
-    }
-    if (input_error_min < 0 || input_error_min > 0xFFFF)
-    {
-      return tic_error_create("The input_error_min value is out of range.");
-    }
-    tic_settings_set_input_error_min(settings, input_error_min);
-  }
-  else if (!strcmp(key, "input_error_max"))
-  {
-    int64_t input_error_max;
-    if (tic_string_to_i64(value, &input_error_max))
-    {
-      return tic_error_create("Invalid input_error_max value.");
-    }
-    if (input_error_max < 0 || input_error_max > 0xFFFF)
-    {
-      return tic_error_create("The input_error_max value is out of range.");
-    }
-    tic_settings_set_input_error_max(settings, input_error_max);
-  }
-  else if (!strcmp(key, "input_scaling_degree"))
+  const tic_settings_key * entry = tic_settings_key_find(key);
+  if (entry == NULL)
   {
-    uint32_t input_scaling_degree;
-    if (!tic_name_to_code(tic_scaling_degree_names, value, &input_scaling_degree))
-    {
-      return tic_error_create("Unrecognized input_scaling_degree value.");
-    }
-    tic_settings_set_input_scaling_degree(settings, input_scaling_degree);
-  }
-  else if (!strcmp(key, "input_invert"))
-  {
-    uint32_t input_invert;
-    if (!tic_name_to_code(tic_bool_names, value, &input_invert))
-    {
-      return tic_error_create("Unrecognized input_invert value.");
-    }
-    tic_settings_set_input_invert(settings, input_invert);
-  }
-  else if (!strcmp(key, "input_min"))
-  {
-    int64_t input_min;
-    if (tic_string_to_i64(value, &input_min))
-    {
-      return tic_error_create("Invalid input_min value.");
-    }
-    if (input_min < 0 || input_min > 0xFFFF)
-    {
-      return tic_error_create("The input_min value is out of range.");
-    }
-    tic_settings_set_input_min(settings, input_min);
-  }
-  else if (!strcmp(key, "input_neutral_min"))
-  {
-    int64_t input_neutral_min;
-    if (tic_string_to_i64(value, &input_neutral_min))
-    {
-      return tic_error_create("Invalid input_neutral_min value.");
-    }
-    if (input_neutral_min < 0 || input_neutral_min > 0xFFFF)
-    {
-      return tic_error_create("The input_neutral_min value is out of range.");
-    }
-    tic_settings_set_input_neutral_min(settings, input_neutral_min);
-  }
-  else if (!strcmp(key, "input_neutral_max"))
-  {
-    int64_t input_neutral_max;
-    if (tic_string_to_i64(value, &input_neutral_max))
-    {
-      return tic_error_create("Invalid input_neutral_max value.");
-    }
-    if (input_neutral_max < 0 || input_neutral_max > 0xFFFF)
-    {
-      return tic_error_create("The input_neutral_max value is out of range.");
-    }
-    tic_settings_set_input_neutral_max(settings, input_neutral_max);
-  }
-  else if (!strcmp(key, "input_max"))
-  {
-    int64_t input_max;
-    if (tic_string_to_i64(value, &input_max))
-    {
-      return tic_error_create("Invalid input_max value.");
-    }
-    if (input_max < 0 || input_max > 0xFFFF)
-    {
-      return tic_error_create("The input_max value is out of range.");
-    }
-    tic_settings_set_input_max(settings, input_max);
-  }
-  else if (!strcmp(key, "output_min"))
-  {
-    int64_t output_min;
-    if (tic_string_to_i64(value, &output_min))
-    {
-      return tic_error_create("Invalid output_min value.");
-    }
-    if (output_min < INT32_MIN || output_min > INT32_MAX)
-    {
-      return tic_error_create("The output_min value is out of range.");
-    }
-    tic_settings_set_output_min(settings, output_min);
-  }
-  else if (!strcmp(key, "output_max"))
-  {
-    int64_t output_max;
-    if (tic_string_to_i64(value, &output_max))
-    {
-      return tic_error_create("Invalid output_max value.");
-    }
-    if (output_max < INT32_MIN || output_max > INT32_MAX)
-    {
-      return tic_error_create("The output_max value is out of range.");
-    }
-    tic_settings_set_output_max(settings, output_max);
-  }
-  else if (!strcmp(key, "encoder_prescaler"))
-  {
-    int64_t encoder_prescaler;
-    if (tic_string_to_i64(value, &encoder_prescaler))
-    {
-      return tic_error_create("Invalid encoder_prescaler value.");
-    }
-    if (encoder_prescaler < 0 || encoder_prescaler > UINT32_MAX)
-    {
-      return tic_error_create("The encoder_prescaler value is out of range.");
-    }
-    tic_settings_set_encoder_prescaler(settings, encoder_prescaler);
-  }
-  else if (!strcmp(key, "encoder_postscaler"))
-  {
-    int64_t encoder_postscaler;
-    if (tic_string_to_i64(value, &encoder_postscaler))
-    {
-      return tic_error_create("Invalid encoder_postscaler value.");
-    }
-    if (encoder_postscaler < 0 || encoder_postscaler > UINT32_MAX)
-    {
-      return tic_error_create("The encoder_postscaler value is out of range.");
-    }
-    tic_settings_set_encoder_postscaler(settings, encoder_postscaler);
-  }
-  else if (!strcmp(key, "encoder_unlimited"))
-  {
-    uint32_t encoder_unlimited;
-    if (!tic_name_to_code(tic_bool_names, value, &encoder_unlimited))
-    {
-      return tic_error_create("Unrecognized encoder_unlimited value.");
-    }
-    tic_settings_set_encoder_unlimited(settings, encoder_unlimited);
-  }
-  else if (!strcmp(key, "scl_config"))
-  {
-    if (!tic_parse_pin_config(value, settings, TIC_PIN_NUM_SCL))
-    {
-      return tic_error_create("Invalid scl_config value.");
-    }
-  }
-  else if (!strcmp(key, "sda_config"))
-  {
-    if (!tic_parse_pin_config(value, settings, TIC_PIN_NUM_SDA))
-    {
-      return tic_error_create("Invalid sda_config value.");
-    }
-  }
-  else if (!strcmp(key, "tx_config"))
-  {
-    if (!tic_parse_pin_config(value, settings, TIC_PIN_NUM_TX))
-    {
-      return tic_error_create("Invalid tx_config value.");
-    }
-  }
-  else if (!strcmp(key, "rx_config"))
-  {
-    if (!tic_parse_pin_config(value, settings, TIC_PIN_NUM_RX))
-    {
-      return tic_error_create("Invalid rx_config value.");
-    }
-  }
-  else if (!strcmp(key, "rc_config"))
-  {
-    if (!tic_parse_pin_config(value, settings, TIC_PIN_NUM_RC))
-    {
-      return tic_error_create("Invalid rc_config value.");
-    }
-  }
-  else if (!strcmp(key, "current_limit"))
-  {
-    int64_t current_limit;
-    if (tic_string_to_i64(value, &current_limit))
-    {
-      return tic_error_create("Invalid current_limit value.");
-    }
-    if (current_limit < 0 || current_limit > UINT32_MAX)
-    {
-      return tic_error_create("The current_limit value is out of range.");
-    }
-    tic_settings_set_current_limit(settings, current_limit);
-  }
-  else if (!strcmp(key, "current_limit_during_error"))
-  {
-    int64_t current_limit;
-    if (tic_string_to_i64(value, &current_limit))
-    {
-      return tic_error_create("Invalid current_limit_during_error value.");
-    }
-    if (current_limit < INT32_MIN || current_limit > INT32_MAX)
-    {
-      return tic_error_create("The current_limit_during_error value is out of range.");
-    }
-    tic_settings_set_current_limit_during_error(settings, current_limit);
-  }
-  else if (!strcmp(key, "step_mode"))
-  {
-    uint32_t step_mode;
-    if (!tic_name_to_code(tic_step_mode_names, value, &step_mode))
-    {
-      return tic_error_create("Invalid step_mode value.");
-    }
-    tic_settings_set_step_mode(settings, step_mode);
-  }
-  else if (!strcmp(key, "decay_mode"))
-  {
-    uint8_t decay_mode;
-    if (!tic_look_up_decay_mode_code(value, 0, TIC_NAME_SNAKE_CASE, &decay_mode))
-    {
-      return tic_error_create("Invalid decay_mode value.");
-    }
-    tic_settings_set_decay_mode(settings, decay_mode);
-  }
-  else if (!strcmp(key, "agc_mode"))
-  {
-    uint32_t mode;
-    if (!tic_name_to_code(tic_agc_mode_names, value, &mode))
-    {
-      return tic_error_create("Invalid agc_mode value.");
-    }
-    tic_settings_set_agc_mode(settings, mode);
-  }
-  else if (!strcmp(key, "agc_bottom_current_limit"))
-  {
-    uint32_t limit;
-    if (!tic_name_to_code(tic_agc_bottom_current_limit_names, value, &limit))
-    {
-      return tic_error_create("Invalid agc_bottom_current_limit value.");
-    }
-    tic_settings_set_agc_bottom_current_limit(settings, limit);
-  }
-  else if (!strcmp(key, "agc_current_boost_steps"))
-  {
-    uint32_t steps;
-    if (!tic_name_to_code(tic_agc_current_boost_steps_names, value, &steps))
-    {
-      return tic_error_create("Invalid agc_current_boost_steps value.");
-    }
-    tic_settings_set_agc_current_boost_steps(settings, steps);
-  }
-  else if (!strcmp(key, "agc_frequency_limit"))
-  {
-    uint32_t limit;
-    if (!tic_name_to_code(tic_agc_frequency_limit_names, value, &limit))
-    {
-      return tic_error_create("Invalid agc_frequency_limit value.");
-    }
-    tic_settings_set_agc_frequency_limit(settings, limit);
-  }
-  else if (!strcmp(key, "max_speed"))
-  {
-    int64_t max_speed;
-    if (tic_string_to_i64(value, &max_speed))
-    {
-      return tic_error_create("Invalid max_speed value.");
-    }
-    if (max_speed < 0 || max_speed > UINT32_MAX)
-    {
-      return tic_error_create("The max_speed value is out of range.");
-    }
-    tic_settings_set_max_speed(settings, max_speed);
-  }
-  else if (!strcmp(key, "starting_speed"))
-  {
-    int64_t starting_speed;
-    if (tic_string_to_i64(value, &starting_speed))
-    {
-      return tic_error_create("Invalid starting_speed value.");
-    }
-    if (starting_speed < 0 || starting_speed > UINT32_MAX)
-    {
-      return tic_error_create("The starting_speed value is out of range.");
-    }
-    tic_settings_set_starting_speed(settings, starting_speed);
-  }
-  else if (!strcmp(key, "max_accel"))
-  {
-    int64_t max_accel;
-    if (tic_string_to_i64(value, &max_accel))
-    {
-      return tic_error_create("Invalid max_accel value.");
-    }
-    if (max_accel < 0 || max_accel > UINT32_MAX)
-    {
-      return tic_error_create("The max_accel value is out of range.");
-    }
-    tic_settings_set_max_accel(settings, max_accel);
-  }
-  else if (!strcmp(key, "max_decel"))
-  {
-    int64_t max_decel;
-    if (tic_string_to_i64(value, &max_decel))
-    {
-      return tic_error_create("Invalid max_decel value.");
-    }
-    if (max_decel < 0 || max_decel > UINT32_MAX)
-    {
-      return tic_error_create("The max_decel value is out of range.");
-    }
-    tic_settings_set_max_decel(settings, max_decel);
-  }
-  else if (!strcmp(key, "auto_homing"))
-  {
-    uint32_t auto_homing;
-    if (!tic_name_to_code(tic_bool_names, value, &auto_homing))
-    {
-      return tic_error_create("Unrecognized auto_homing value.");
-    }
-    tic_settings_set_auto_homing(settings, auto_homing);
-  }
-  else if (!strcmp(key, "auto_homing_forward"))
-  {
-    uint32_t forward;
-    if (!tic_name_to_code(tic_bool_names, value, &forward))
-    {
-      return tic_error_create("Unrecognized auto_homing_forward value.");
-    }
-    tic_settings_set_auto_homing_forward(settings, forward);
+    return tic_error_create("Unrecognized key on line %d: \"%s\".", line, key);
   }
-  else if (!strcmp(key, "homing_speed_towards"))
+
+  switch (entry->type)
   {
-    int64_t speed;
-    if (tic_string_to_i64(value, &speed))
-    {
-      return tic_error_create("Invalid homing_speed_towards value.");
-    }
-    if (speed < 0 || speed > UINT32_MAX)
+  case TIC_KEY_IGNORE:
+    break;
+
+  case TIC_KEY_NAME:
     {
-      return tic_error_create(
-        "The homing_speed_towards value is out of range.");
+      uint32_t code;
+      if (!tic_name_to_code(entry->names, value, &code))
+      {
+        return tic_error_create("Unrecognized %s value.", key);
+      }
+      entry->set(settings, code);
+      break;
     }
-    tic_settings_set_homing_speed_towards(settings, speed);
-  }
-  else if (!strcmp(key, "homing_speed_away"))
-  {
-    int64_t speed;
-    if (tic_string_to_i64(value, &speed))
+
+  case TIC_KEY_INT:
     {
-      return tic_error_create("Invalid homing_speed_away value.");
+      int64_t number;
+      if (tic_string_to_i64(value, &number))
+      {
+        return tic_error_create("Invalid %s value.", key);
+      }
+      if (number < entry->min || number > entry->max)
+      {
+        return tic_error_create("The %s value is out of range.", key);
+      }
+      entry->set(settings, number);
+      break;
     }
-    if (speed < 0 || speed > UINT32_MAX)
+
+  case TIC_KEY_PIN_CONFIG:
+    if (!tic_parse_pin_config(value, settings, entry->pin))
     {
-      return tic_error_create("The homing_speed_away value is out of range.");
+      return tic_error_create("Invalid %s value.", key);
     }
-    tic_settings_set_homing_speed_away(settings, speed);
-  }
-  else if (!strcmp(key, "invert_motor_direction"))
-  {
-    uint32_t invert;
-    if (!tic_name_to_code(tic_bool_names, value, &invert))
+    break;
+
+  case TIC_KEY_DECAY_MODE:
     {
-      return tic_error_create("Unrecognized invert_motor_direction value.");
+      uint8_t decay_mode;
+      if (!tic_look_up_decay_mode_code(value, 0, TIC_NAME_SNAKE_CASE,
+          &decay_mode))
+      {
+        return tic_error_create("Invalid decay_mode value.");
+      }
+      tic_settings_set_decay_mode(settings, decay_mode);
+      break;
     }
-    tic_settings_set_invert_motor_direction(settings, invert);
-  }
-  else
-  {
-    return tic_error_create("Unrecognized key on line %d: \"%s\".", line, key);
   }
 
   return NULL;
@@ -869,6 +465,10 @@ static tic_error * read_from_yaml_doc(
 
   // Get the root node and make sure it is a mapping.
   yaml_node_t * root = yaml_document_get_root_node(doc);
+  if (root == NULL)
+  {
+    return tic_error_create("The settings file is empty.");
+  }
   if (root->type != YAML_MAPPING_NODE)
   {
     return tic_error_create("YAML root node is not a mapping.");
@@ -1,11 +1,32 @@
 // Functions for converting settings to a settings file string.
+//
+// The fields are generated by tic_settings_print_fields(), which is also used
+// by tic_settings_diff() so that differences are reported with the same names
+// and values as the settings file.
 
 #include "tic_internal.h"
 
-static void print_pin_config_to_yaml(tic_string * str,
+static void print_field_to_string(void * context,
+  const char * name, const char * value)
+{
+  tic_sprintf((tic_string *)context, "%s: %s\n", name, value);
+}
+
+TIC_PRINTF(3, 4)
+static void print_field(const tic_settings_field_printer * printer,
+  const char * name, const char * format, ...)
+{
+  char value[TIC_SETTINGS_FIELD_VALUE_SIZE];
+  va_list ap;
+  va_start(ap, format);
+  vsnprintf(value, sizeof(value), format, ap);
+  va_end(ap);
+  printer->print(printer->context, name, value);
+}
+
+static void print_pin_config(const tic_settings_field_printer * printer,
   const tic_settings * settings, uint8_t pin,  const char * config_name)
 {
-  assert(str != NULL);
   assert(config_name != NULL);
 
   const char * pullup_str = "";
@@ -21,66 +42,50 @@ static void print_pin_config_to_yaml(tic_string * str,
   tic_code_to_name(tic_pin_func_names,
     tic_settings_get_pin_func(settings, pin), &func_str);
 
-  tic_sprintf(str, "%s: %s%s%s%s\n", config_name, func_str,
+  print_field(printer, config_name, "%s%s%s%s", func_str,
     pullup_str, analog_str, polarity_str);
 }
 
-tic_error * tic_settings_to_string(const tic_settings * settings, char ** string)
+void tic_settings_print_fields(const tic_settings * settings,
+  const tic_settings_field_printer * printer)
 {
-  if (string == NULL)
-  {
-    return tic_error_create("String output pointer is null.");
-  }
-
-  *string = NULL;
-
-  if (settings == NULL)
-  {
-    return tic_error_create("Settings pointer is null.");
-  }
-
-  tic_error * error = NULL;
-
-  tic_string str;
-  tic_string_setup(&str);
-
-  tic_sprintf(&str, "# Pololu Tic USB Stepper Controller settings file.\n");
-  tic_sprintf(&str, "# " DOCUMENTATION_URL "\n");
+  assert(settings != NULL);
+  assert(printer != NULL);
 
   uint8_t product = tic_settings_get_product(settings);
 
   {
     const char * product_str = tic_look_up_product_name_short(product);
-    tic_sprintf(&str, "product: %s\n", product_str);
+    print_field(printer, "product", "%s", product_str);
   }
 
   {
     uint8_t control_mode = tic_settings_get_control_mode(settings);
     const char * mode_str = "";
     tic_code_to_name(tic_control_mode_names, control_mode, &mode_str);
-    tic_sprintf(&str, "control_mode: %s\n", mode_str);
+    print_field(printer, "control_mode", "%s", mode_str);
   }
 
   {
     bool never_sleep = tic_settings_get_never_sleep(settings);
-    tic_sprintf(&str, "never_sleep: %s\n", never_sleep ? "true" : "false");
+    print_field(printer, "never_sleep", "%s", never_sleep ? "true" : "false");
   }
 
   {
     bool disable_safe_start = tic_settings_get_disable_safe_start(settings);
-    tic_sprintf(&str, "disable_safe_start: %s\n",
+    print_field(printer, "disable_safe_start", "%s",
       disable_safe_start ? "true" : "false");
   }
 
   {
     bool ignore_err_line_high = tic_settings_get_ignore_err_line_high(settings);
-    tic_sprintf(&str, "ignore_err_line_high: %s\n",
+    print_field(printer, "ignore_err_line_high", "%s",
       ignore_err_line_high ? "true" : "false");
   }
 
   {
     bool auto_clear = tic_settings_get_auto_clear_driver_error(settings);
-    tic_sprintf(&str, "auto_clear_driver_error: %s\n",
+    print_field(printer, "auto_clear_driver_error", "%s",
       auto_clear ? "true" : "false");
   }
 
@@ -88,219 +93,219 @@ tic_error * tic_settings_to_string(const tic_settings * settings, char ** string
     uint8_t response = tic_settings_get_soft_error_response(settings);
     const char * response_str = "";
     tic_code_to_name(tic_response_names, response, &response_str);
-    tic_sprintf(&str, "soft_error_response: %s\n", response_str);
+    print_field(printer, "soft_error_response", "%s", response_str);
   }
 
   {
     int32_t position = tic_settings_get_soft_error_position(settings);
-    tic_sprintf(&str, "soft_error_position: %d\n", position);
+    print_field(printer, "soft_error_position", "%d", position);
   }
 
   {
     uint32_t baud = tic_settings_get_serial_baud_rate(settings);
-    tic_sprintf(&str, "serial_baud_rate: %u\n", baud);
+    print_field(printer, "serial_baud_rate", "%u", baud);
   }
 
   {
     uint16_t number = tic_settings_get_serial_device_number_u16(settings);
-    tic_sprintf(&str, "serial_device_number: %u\n", number);
+    print_field(printer, "serial_device_number", "%u", number);
   }
 
   {
     uint16_t number = tic_settings_get_serial_alt_device_number(settings);
-    tic_sprintf(&str, "serial_alt_device_number: %u\n", number);
+    print_field(printer, "serial_alt_device_number", "%u", number);
   }
 
   {
     bool enabled = tic_settings_get_serial_enable_alt_device_number(settings);
-    tic_sprintf(&str, "serial_enable_alt_device_number: %s\n",
+    print_field(printer, "serial_enable_alt_device_number", "%s",
       enabled ? "true" : "false");
   }
 
   {
     bool enabled = tic_settings_get_serial_14bit_device_number(settings);
-    tic_sprintf(&str, "serial_14bit_device_number: %s\n",
+    print_field(printer, "serial_14bit_device_number", "%s",
       enabled ? "true" : "false");
   }
 
   {
     uint16_t command_timeout = tic_settings_get_command_timeout(settings);
-    tic_sprintf(&str, "command_timeout: %u\n", command_timeout);
+    print_field(printer, "command_timeout", "%u", command_timeout);
   }
 
   {
     bool enabled = tic_settings_get_serial_crc_for_commands(settings);
-    tic_sprintf(&str, "serial_crc_for_commands: %s\n",
+    print_field(printer, "serial_crc_for_commands", "%s",
       enabled ? "true" : "false");
   }
 
   {
     bool enabled = tic_settings_get_serial_crc_for_responses(settings);
-    tic_sprintf(&str, "serial_crc_for_responses: %s\n",
+    print_field(printer, "serial_crc_for_responses", "%s",
       enabled ? "true" : "false");
   }
 
   {
     bool enabled = tic_settings_get_serial_7bit_responses(settings);
-    tic_sprintf(&str, "serial_7bit_responses: %s\n",
+    print_field(printer, "serial_7bit_responses", "%s",
       enabled ? "true" : "false");
   }
 
   {
     uint8_t delay = tic_settings_get_serial_response_delay(settings);
-    tic_sprintf(&str, "serial_response_delay: %u\n", delay);
+    print_field(printer, "serial_response_delay", "%u", delay);
   }
 
   if (0) // not implemented in firmware
   {
     uint16_t low_vin_timeout = tic_settings_get_low_vin_timeout(settings);
-    tic_sprintf(&str, "low_vin_timeout: %u\n", low_vin_timeout);
+    print_field(printer, "low_vin_timeout", "%u", low_vin_timeout);
   }
 
   if (0) // not implemented in firmware
   {
     uint16_t voltage = tic_settings_get_low_vin_shutoff_voltage(settings);
-    tic_sprintf(&str, "low_vin_shutoff_voltage: %u\n", voltage);
+    print_field(printer, "low_vin_shutoff_voltage", "%u", voltage);
   }
 
   if (0) // not implemented in firmware
   {
     uint16_t voltage = tic_settings_get_low_vin_startup_voltage(settings);
-    tic_sprintf(&str, "low_vin_startup_voltage: %u\n", voltage);
+    print_field(printer, "low_vin_startup_voltage", "%u", voltage);
   }
 
   if (0) // not implemented in firmware
   {
     uint16_t voltage = tic_settings_get_high_vin_shutoff_voltage(settings);
-    tic_sprintf(&str, "high_vin_shutoff_voltage: %u\n", voltage);
+    print_field(printer, "high_vin_shutoff_voltage", "%u", voltage);
   }
 
   {
     int16_t offset = tic_settings_get_vin_calibration(settings);
-    tic_sprintf(&str, "vin_calibration: %d\n", offset);
+    print_field(printer, "vin_calibration", "%d", offset);
   }
 
   if (0) // not implemented in firmware
   {
     uint16_t pulse_period = tic_settings_get_rc_max_pulse_period(settings);
-    tic_sprintf(&str, "rc_max_pulse_period: %u\n", pulse_period);
+    print_field(printer, "rc_max_pulse_period", "%u", pulse_period);
   }
 
   if (0) // not implemented in firmware
   {
     uint16_t timeout = tic_settings_get_rc_bad_signal_timeout(settings);
-    tic_sprintf(&str, "rc_bad_signal_timeout: %u\n", timeout);
+    print_field(printer, "rc_bad_signal_timeout", "%u", timeout);
   }
 
   if (0) // not implemented in firmware
   {
     uint16_t pulses = tic_settings_get_rc_consecutive_good_pulses(settings);
-    tic_sprintf(&str, "rc_consecutive_good_pulses: %u\n", pulses);
+    print_field(printer, "rc_consecutive_good_pulses", "%u", pulses);
   }
 
   {
     bool enabled = tic_settings_get_input_averaging_enabled(settings);
-    tic_sprintf(&str, "input_averaging_enabled: %s\n",
+    print_field(printer, "input_averaging_enabled", "%s",
       enabled ? "true" : "false");
   }
 
   {
     uint16_t input_hysteresis = tic_settings_get_input_hysteresis(settings);
-    tic_sprintf(&str, "input_hysteresis: %u\n", input_hysteresis);
+    print_field(printer, "input_hysteresis", "%u", input_hysteresis);
   }
 
   if (0) // not implemented in firmware
   {
     uint16_t input_error_min = tic_settings_get_input_error_min(settings);
-    tic_sprintf(&str, "input_error_min: %u\n", input_error_min);
+    print_field(printer, "input_error_min", "%u", input_error_min);
   }
 
   if (0) // not implemented in firmware
   {
     uint16_t input_error_max = tic_settings_get_input_error_max(settings);
-    tic_sprintf(&str, "input_error_max: %u\n", input_error_max);
+    print_field(printer, "input_error_max", "%u", input_error_max);
   }
 
   {
     uint8_t degree = tic_settings_get_input_scaling_degree(settings);
     const char * degree_str = "";
     tic_code_to_name(tic_scaling_degree_names, degree, &degree_str);
-    tic_sprintf(&str, "input_scaling_degree: %s\n", degree_str);
+    print_field(printer, "input_scaling_degree", "%s", degree_str);
   }
 
   {
     bool input_invert = tic_settings_get_input_invert(settings);
-    tic_sprintf(&str, "input_invert: %s\n", input_invert ? "true" : "false");
+    print_field(printer, "input_invert", "%s", input_invert ? "true" : "false");
   }
 
   {
     uint16_t input_min = tic_settings_get_input_min(settings);
-    tic_sprintf(&str, "input_min: %u\n", input_min);
+    print_field(printer, "input_min", "%u", input_min);
   }
 
   {
     uint16_t input_neutral_min = tic_settings_get_input_neutral_min(settings);
-    tic_sprintf(&str, "input_neutral_min: %u\n", input_neutral_min);
+    print_field(printer, "input_neutral_min", "%u", input_neutral_min);
   }
 
   {
     uint16_t input_neutral_max = tic_settings_get_input_neutral_max(settings);
-    tic_sprintf(&str, "input_neutral_max: %u\n", input_neutral_max);
+    print_field(printer, "input_neutral_max", "%u", input_neutral_max);
   }
 
   {
     uint16_t input_max = tic_settings_get_input_max(settings);
-    tic_sprintf(&str, "input_max: %u\n", input_max);
+    print_field(printer, "input_max", "%u", input_max);
   }
 
   {
     int32_t output = tic_settings_get_output_min(settings);
-    tic_sprintf(&str, "output_min: %d\n", output);
+    print_field(printer, "output_min", "%d", output);
   }
 
   {
     int32_t output = tic_settings_get_output_max(settings);
-    tic_sprintf(&str, "output_max: %d\n", output);
+    print_field(printer, "output_max", "%d", output);
   }
 
   {
     uint32_t encoder_prescaler = tic_settings_get_encoder_prescaler(settings);
-    tic_sprintf(&str, "encoder_prescaler: %u\n", encoder_prescaler);
+    print_field(printer, "encoder_prescaler", "%u", encoder_prescaler);
   }
 
   {
     uint32_t encoder_postscaler = tic_settings_get_encoder_postscaler(settings);
-    tic_sprintf(&str, "encoder_postscaler: %u\n", encoder_postscaler);
+    print_field(printer, "encoder_postscaler", "%u", encoder_postscaler);
   }
 
   {
     bool encoder_unlimited = tic_settings_get_encoder_unlimited(settings);
-    tic_sprintf(&str, "encoder_unlimited: %s\n", encoder_unlimited ? "true" : "false");
+    print_field(printer, "encoder_unlimited", "%s", encoder_unlimited ? "true" : "false");
   }
 
   {
-    print_pin_config_to_yaml(&str, settings, TIC_PIN_NUM_SCL, "scl_config");
-    print_pin_config_to_yaml(&str, settings, TIC_PIN_NUM_SDA, "sda_config");
-    print_pin_config_to_yaml(&str, settings, TIC_PIN_NUM_TX, "tx_config");
-    print_pin_config_to_yaml(&str, settings, TIC_PIN_NUM_RX, "rx_config");
-    print_pin_config_to_yaml(&str, settings, TIC_PIN_NUM_RC, "rc_config");
+    print_pin_config(printer, settings, TIC_PIN_NUM_SCL, "scl_config");
+    print_pin_config(printer, settings, TIC_PIN_NUM_SDA, "sda_config");
+    print_pin_config(printer, settings, TIC_PIN_NUM_TX, "tx_config");
+    print_pin_config(printer, settings, TIC_PIN_NUM_RX, "rx_config");
+    print_pin_config(printer, settings, TIC_PIN_NUM_RC, "rc_config");
   }
 
   {
     uint32_t current = tic_settings_get_current_limit(settings);
-    tic_sprintf(&str, "current_limit: %u\n", current);
+    print_field(printer, "current_limit", "%u", current);
   }
 
   {
     int32_t current = tic_settings_get_current_limit_during_error(settings);
-    tic_sprintf(&str, "current_limit_during_error: %d\n", current);
+    print_field(printer, "current_limit_during_error", "%d", current);
   }
 
   {
     uint8_t mode = tic_settings_get_step_mode(settings);
     const char * name = "";
     tic_code_to_name(tic_step_mode_names, mode, &name);
-    tic_sprintf(&str, "step_mode: %s\n", name);
+    print_field(printer, "step_mode", "%s", name);
   }
 
   // The decay mode setting for the Tic T500 and T249 is useless because there
@@ -310,7 +315,7 @@ tic_error * tic_settings_to_string(const tic_settings * settings, char ** string
     uint8_t mode = tic_settings_get_decay_mode(settings);
     const char * name;
     tic_look_up_decay_mode_name(mode, product, TIC_NAME_SNAKE_CASE, &name);
-    tic_sprintf(&str, "decay_mode: %s\n", name);
+    print_field(printer, "decay_mode", "%s", name);
   }
 
   if (product == TIC_PRODUCT_T249)
@@ -318,7 +323,7 @@ tic_error * tic_settings_to_string(const tic_settings * settings, char ** string
     uint8_t mode = tic_settings_get_agc_mode(settings);
     const char * name;
     tic_code_to_name(tic_agc_mode_names, mode, &name);
-    tic_sprintf(&str, "agc_mode: %s\n", name);
+    print_field(printer, "agc_mode", "%s", name);
   }
 
   if (product == TIC_PRODUCT_T249)
@@ -326,7 +331,7 @@ tic_error * tic_settings_to_string(const tic_settings * settings, char ** string
     uint8_t limit = tic_settings_get_agc_bottom_current_limit(settings);
     const char * name;
     tic_code_to_name(tic_agc_bottom_current_limit_names, limit, &name);
-    tic_sprintf(&str, "agc_bottom_current_limit: %s\n", name);
+    print_field(printer, "agc_bottom_current_limit", "%s", name);
   }
 
   if (product == TIC_PRODUCT_T249)
@@ -334,7 +339,7 @@ tic_error * tic_settings_to_string(const tic_settings * settings, char ** string
     uint8_t steps = tic_settings_get_agc_current_boost_steps(settings);
     const char * name;
     tic_code_to_name(tic_agc_current_boost_steps_names, steps, &name);
-    tic_sprintf(&str, "agc_current_boost_steps: %s\n", name);
+    print_field(printer, "agc_current_boost_steps", "%s", name);
   }
 
   if (product == TIC_PRODUCT_T249)
@@ -342,54 +347,80 @@ tic_error * tic_settings_to_string(const tic_settings * settings, char ** string
     uint8_t mode = tic_settings_get_agc_frequency_limit(settings);
     const char * name;
     tic_code_to_name(tic_agc_frequency_limit_names, mode, &name);
-    tic_sprintf(&str, "agc_frequency_limit: %s\n", name);
+    print_field(printer, "agc_frequency_limit", "%s", name);
   }
 
   {
     uint32_t max_speed = tic_settings_get_max_speed(settings);
-    tic_sprintf(&str, "max_speed: %u\n", max_speed);
+    print_field(printer, "max_speed", "%u", max_speed);
   }
 
   {
     uint32_t starting_speed = tic_settings_get_starting_speed(settings);
-    tic_sprintf(&str, "starting_speed: %u\n", starting_speed);
+    print_field(printer, "starting_speed", "%u", starting_speed);
   }
 
   {
     uint32_t accel = tic_settings_get_max_accel(settings);
-    tic_sprintf(&str, "max_accel: %u\n", accel);
+    print_field(printer, "max_accel", "%u", accel);
   }
 
   {
     uint32_t decel = tic_settings_get_max_decel(settings);
-    tic_sprintf(&str, "max_decel: %u\n", decel);
+    print_field(printer, "max_decel", "%u", decel);
   }
 
   {
     bool auto_homing = tic_settings_get_auto_homing(settings);
-    tic_sprintf(&str, "auto_homing: %s\n", auto_homing ? "true" : "false");
+    print_field(printer, "auto_homing", "%s", auto_homing ? "true" : "false");
   }
 
   {
     bool forward = tic_settings_get_auto_homing_forward(settings);
-    tic_sprintf(&str, "auto_homing_forward: %s\n", forward ? "true" : "false");
+    print_field(printer, "auto_homing_forward", "%s", forward ? "true" : "false");
   }
 
   {
     uint32_t speed = tic_settings_get_homing_speed_towards(settings);
-    tic_sprintf(&str, "homing_speed_towards: %u\n", speed);
+    print_field(printer, "homing_speed_towards", "%u", speed);
   }
 
   {
     uint32_t speed = tic_settings_get_homing_speed_away(settings);
-    tic_sprintf(&str, "homing_speed_away: %u\n", speed);
+    print_field(printer, "homing_speed_away", "%u", speed);
   }
 
   {
     bool invert = tic_settings_get_invert_motor_direction(settings);
-    tic_sprintf(&str, "invert_motor_direction: %s\n",
+    print_field(printer, "invert_motor_direction", "%s",
       invert ? "true" : "false");
   }
+}
+
+tic_error * tic_settings_to_string(const tic_settings * settings, char ** string)
+{
+  if (string == NULL)
+  {
+    return tic_error_create("String output pointer is null.");
+  }
+
+  *string = NULL;
+
+  if (settings == NULL)
+  {
+    return tic_error_create("Settings pointer is null.");
+  }
+
+  tic_error * error = NULL;
+
+  tic_string str;
+  tic_string_setup(&str);
+
+  tic_sprintf(&str, "# Pololu Tic USB Stepper Controller settings file.\n");
+  tic_sprintf(&str, "# " DOCUMENTATION_URL "\n");
+
+  tic_settings_field_printer printer = { print_field_to_string, &str };
+  tic_settings_print_fields(settings, &printer);
 
   if (error == NULL && str.data == NULL)
   {
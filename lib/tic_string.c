@@ -31,7 +31,7 @@ void tic_string_setup_dummy(tic_string * str)
   str->capacity = str->length = 0;
 }
 
-void tic_sprintf(tic_string * str, const char * format, ...)
+void tic_vsprintf(tic_string * str, const char * format, va_list ap)
 {
   assert(format != NULL);
 
@@ -43,9 +43,6 @@ void tic_sprintf(tic_string * str, const char * format, ...)
 
   assert(str->length == strlen(str->data));
 
-  va_list ap;
-  va_start(ap, format);
-
   // Determine how much the string length will increase.
   size_t length_increase = 0;
   {
@@ -66,7 +63,6 @@ void tic_sprintf(tic_string * str, const char * format, ...)
       free(str->data);
       str->data = NULL;
       str->length = str->capacity = 0;
-      va_end(ap);
       return;
     }
   }
@@ -79,7 +75,6 @@ void tic_sprintf(tic_string * str, const char * format, ...)
     free(str->data);
     str->data = NULL;
     str->length = str->capacity = 0;
-    va_end(ap);
     return;
   }
 
@@ -102,7 +97,6 @@ void tic_sprintf(tic_string * str, const char * format, ...)
       free(str->data);
       str->data = NULL;
       str->length = str->capacity = 0;
-      va_end(ap);
       return;
     }
     str->data = resized_data;
@@ -117,6 +111,13 @@ void tic_sprintf(tic_string * str, const char * format, ...)
   str->length = new_length;
 
   assert(str->length == strlen(str->data));
+}
+
+void tic_sprintf(tic_string * str, const char * format, ...)
+{
+  va_list ap;
+  va_start(ap, format);
+  tic_vsprintf(str, format, ap);
   va_end(ap);
 }
 
@@ -0,0 +1,329 @@
+// Functions for sending a timed sequence of targets to a Tic from a background
+// thread.
+//
+// The waypoints cannot change while the thread is running, so the thread reads
+// them without locking.  The thread is the only writer of the statistics and
+// of each waypoint's lateness, and publishes them with atomic stores.
+
+#include "tic_internal.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+// The longest the thread sleeps at once, so it can notice a stop request and
+// reset the command timeout.
+#define TIC_TRAJECTORY_MAX_SLEEP_NS 50000000
+
+// How often to reset the command timeout while waiting for the next waypoint.
+#define TIC_TRAJECTORY_KEEPALIVE_NS 100000000
+
+typedef struct tic_trajectory_waypoint
+{
+  uint64_t time_us;
+  int32_t value;
+  bool velocity;
+  bool sent;
+  uint64_t lateness_us;
+} tic_trajectory_waypoint;
+
+struct tic_trajectory
+{
+  tic_trajectory_waypoint * waypoints;
+  size_t waypoint_count;
+  size_t waypoint_capacity;
+
+  tic_handle * handle;
+  uint64_t start_time_ns;
+
+  // Written by the thread.
+  tic_trajectory_stats stats;
+  bool running;
+
+  // Written by the caller.
+  bool stop_requested;
+
+#ifdef _WIN32
+  HANDLE thread;
+#else
+  pthread_t thread;
+#endif
+  bool thread_started;
+};
+
+// Sleeps until the deadline, but resets the command timeout regularly and
+// returns early if a stop is requested.  Returns false if a stop was
+// requested.
+static bool tic_trajectory_wait_until(tic_trajectory * trajectory,
+  uint64_t deadline, uint64_t * last_command)
+{
+  while (!TIC_ATOMIC_LOAD(&trajectory->stop_requested))
+  {
+    uint64_t now = tic_poller_get_time_ns();
+    if (now >= deadline) { return true; }
+
+    if (now - *last_command >= TIC_TRAJECTORY_KEEPALIVE_NS)
+    {
+      tic_error_free(tic_reset_command_timeout(trajectory->handle));
+      *last_command = now;
+    }
+
+    uint64_t wake = *last_command + TIC_TRAJECTORY_KEEPALIVE_NS;
+    if (wake > now + TIC_TRAJECTORY_MAX_SLEEP_NS)
+    {
+      wake = now + TIC_TRAJECTORY_MAX_SLEEP_NS;
+    }
+    if (wake > deadline) { wake = deadline; }
+    tic_poller_sleep_until(wake);
+  }
+  return false;
+}
+
+static void tic_trajectory_run(tic_trajectory * trajectory)
+{
+  tic_trajectory_stats * stats = &trajectory->stats;
+  uint64_t last_command = tic_poller_get_time_ns();
+
+  for (size_t i = 0; i < trajectory->waypoint_count; i++)
+  {
+    tic_trajectory_waypoint * waypoint = &trajectory->waypoints[i];
+    uint64_t deadline = trajectory->start_time_ns + waypoint->time_us * 1000;
+    if (!tic_trajectory_wait_until(trajectory, deadline, &last_command))
+    {
+      break;
+    }
+
+    uint64_t now = tic_poller_get_time_ns();
+    tic_error * error;
+    if (waypoint->velocity)
+    {
+      error = tic_set_target_velocity(trajectory->handle, waypoint->value);
+    }
+    else
+    {
+      error = tic_set_target_position(trajectory->handle, waypoint->value);
+    }
+    last_command = now;
+
+    uint64_t lateness_us = (now - deadline) / 1000;
+    waypoint->lateness_us = lateness_us;
+    TIC_ATOMIC_STORE(&waypoint->sent, true);
+
+    TIC_ATOMIC_STORE(&stats->command_count, stats->command_count + 1);
+    TIC_ATOMIC_STORE(&stats->lateness_total_us,
+      stats->lateness_total_us + lateness_us);
+    if (lateness_us > stats->lateness_max_us)
+    {
+      TIC_ATOMIC_STORE(&stats->lateness_max_us, lateness_us);
+    }
+
+    if (error != NULL)
+    {
+      bool disconnected = tic_error_has_code(error,
+        TIC_ERROR_DEVICE_DISCONNECTED);
+      tic_error_free(error);
+      TIC_ATOMIC_STORE(&stats->error_count, stats->error_count + 1);
+      if (disconnected) { break; }
+    }
+  }
+  TIC_ATOMIC_STORE(&trajectory->running, false);
+}
+
+#ifdef _WIN32
+static DWORD WINAPI tic_trajectory_thread(LPVOID context)
+{
+  tic_trajectory_run((tic_trajectory *)context);
+  return 0;
+}
+#else
+static void * tic_trajectory_thread(void * context)
+{
+  tic_trajectory_run((tic_trajectory *)context);
+  return NULL;
+}
+#endif
+
+tic_error * tic_trajectory_create(tic_trajectory ** trajectory)
+{
+  if (trajectory == NULL)
+  {
+    return tic_error_create("Trajectory output pointer is null.");
+  }
+
+  *trajectory = calloc(1, sizeof(tic_trajectory));
+  if (*trajectory == NULL)
+  {
+    return &tic_error_no_memory;
+  }
+
+  return NULL;
+}
+
+void tic_trajectory_free(tic_trajectory * trajectory)
+{
+  if (trajectory == NULL) { return; }
+
+  tic_trajectory_stop(trajectory);
+  free(trajectory->waypoints);
+  free(trajectory);
+}
+
+static tic_error * tic_trajectory_add_waypoint(tic_trajectory * trajectory,
+  uint64_t time_us, int32_t value, bool velocity)
+{
+  if (trajectory == NULL)
+  {
+    return tic_error_create("Trajectory is null.");
+  }
+
+  if (trajectory->thread_started)
+  {
+    return tic_error_create(
+      "Waypoints cannot be added while the trajectory is started.");
+  }
+
+  size_t count = trajectory->waypoint_count;
+  if (count > 0 && time_us < trajectory->waypoints[count - 1].time_us)
+  {
+    return tic_error_create(
+      "Waypoints must be added in order of increasing time.");
+  }
+
+  if (count == trajectory->waypoint_capacity)
+  {
+    size_t capacity = trajectory->waypoint_capacity * 2;
+    if (capacity == 0) { capacity = 16; }
+    tic_trajectory_waypoint * waypoints = realloc(trajectory->waypoints,
+      capacity * sizeof(tic_trajectory_waypoint));
+    if (waypoints == NULL)
+    {
+      return &tic_error_no_memory;
+    }
+    trajectory->waypoints = waypoints;
+    trajectory->waypoint_capacity = capacity;
+  }
+
+  tic_trajectory_waypoint * waypoint = &trajectory->waypoints[count];
+  memset(waypoint, 0, sizeof(tic_trajectory_waypoint));
+  waypoint->time_us = time_us;
+  waypoint->value = value;
+  waypoint->velocity = velocity;
+  trajectory->waypoint_count++;
+  return NULL;
+}
+
+tic_error * tic_trajectory_add_target_position(tic_trajectory * trajectory,
+  uint64_t time_us, int32_t position)
+{
+  return tic_trajectory_add_waypoint(trajectory, time_us, position, false);
+}
+
+tic_error * tic_trajectory_add_target_velocity(tic_trajectory * trajectory,
+  uint64_t time_us, int32_t velocity)
+{
+  return tic_trajectory_add_waypoint(trajectory, time_us, velocity, true);
+}
+
+size_t tic_trajectory_get_waypoint_count(const tic_trajectory * trajectory)
+{
+  if (trajectory == NULL) { return 0; }
+  return trajectory->waypoint_count;
+}
+
+tic_error * tic_trajectory_start(tic_trajectory * trajectory,
+  tic_handle * handle, uint64_t start_time_ns)
+{
+  if (trajectory == NULL)
+  {
+    return tic_error_create("Trajectory is null.");
+  }
+
+  if (handle == NULL)
+  {
+    return tic_error_create("Handle is null.");
+  }
+
+  tic_trajectory_stop(trajectory);
+
+  trajectory->handle = handle;
+  trajectory->start_time_ns = start_time_ns ? start_time_ns :
+    tic_poller_get_time_ns();
+  memset(&trajectory->stats, 0, sizeof(trajectory->stats));
+  for (size_t i = 0; i < trajectory->waypoint_count; i++)
+  {
+    trajectory->waypoints[i].sent = false;
+    trajectory->waypoints[i].lateness_us = 0;
+  }
+  trajectory->stop_requested = false;
+  trajectory->running = true;
+
+  tic_error * error = NULL;
+#ifdef _WIN32
+  trajectory->thread = CreateThread(NULL, 0, tic_trajectory_thread,
+    trajectory, 0, NULL);
+  if (trajectory->thread == NULL)
+  {
+    error = tic_error_create("Failed to start the trajectory thread.");
+  }
+#else
+  int result = pthread_create(&trajectory->thread, NULL,
+    tic_trajectory_thread, trajectory);
+  if (result != 0)
+  {
+    error = tic_error_create("Failed to start the trajectory thread: "
+      "error code %d.", result);
+  }
+#endif
+  trajectory->thread_started = error == NULL;
+  if (error != NULL) { trajectory->running = false; }
+
+  return error;
+}
+
+void tic_trajectory_stop(tic_trajectory * trajectory)
+{
+  if (trajectory == NULL || !trajectory->thread_started) { return; }
+  TIC_ATOMIC_STORE(&trajectory->stop_requested, true);
+#ifdef _WIN32
+  WaitForSingleObject(trajectory->thread, INFINITE);
+  CloseHandle(trajectory->thread);
+#else
+  pthread_join(trajectory->thread, NULL);
+#endif
+  trajectory->thread_started = false;
+}
+
+bool tic_trajectory_is_running(const tic_trajectory * trajectory)
+{
+  if (trajectory == NULL) { return false; }
+  return TIC_ATOMIC_LOAD(&trajectory->running);
+}
+
+void tic_trajectory_get_stats(const tic_trajectory * trajectory,
+  tic_trajectory_stats * stats)
+{
+  if (stats == NULL) { return; }
+  memset(stats, 0, sizeof(tic_trajectory_stats));
+  if (trajectory == NULL) { return; }
+  stats->command_count = TIC_ATOMIC_LOAD(&trajectory->stats.command_count);
+  stats->lateness_total_us =
+    TIC_ATOMIC_LOAD(&trajectory->stats.lateness_total_us);
+  stats->lateness_max_us = TIC_ATOMIC_LOAD(&trajectory->stats.lateness_max_us);
+  stats->error_count = TIC_ATOMIC_LOAD(&trajectory->stats.error_count);
+}
+
+bool tic_trajectory_get_lateness_us(const tic_trajectory * trajectory,
+  size_t index, uint64_t * lateness_us)
+{
+  if (trajectory == NULL || index >= trajectory->waypoint_count)
+  {
+    return false;
+  }
+
+  const tic_trajectory_waypoint * waypoint = &trajectory->waypoints[index];
+  if (!TIC_ATOMIC_LOAD(&waypoint->sent)) { return false; }
+  if (lateness_us != NULL) { *lateness_us = waypoint->lateness_us; }
+  return true;
+}
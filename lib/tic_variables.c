@@ -49,6 +49,11 @@ struct tic_variables
     bool digital_reading;
     uint8_t pin_state;
   } pin_info[TIC_CONTROL_PIN_COUNT];
+
+  // The raw variable data most recently read from the device, and a flag for
+  // each byte that is true if the byte was read by the last update.
+  uint8_t raw[TIC_VARIABLES_SIZE];
+  bool fresh[TIC_VARIABLES_SIZE];
 };
 
 tic_error * tic_variables_create(tic_variables ** variables)
@@ -124,6 +129,13 @@ void tic_variables_free(tic_variables * variables)
   free(variables);
 }
 
+void tic_variables_copy_into(tic_variables * dest, const tic_variables * source)
+{
+  assert(dest != NULL);
+  assert(source != NULL);
+  memcpy(dest, source, sizeof(tic_variables));
+}
+
 static void write_buffer_to_variables(const uint8_t * buf, tic_variables * vars)
 {
   assert(vars != NULL);
@@ -227,6 +239,39 @@ tic_error * tic_get_variables(tic_handle * handle, tic_variables ** variables,
     error = tic_variables_create(&new_variables);
   }
 
+  // Read all the variables from the device into the new object.
+  if (error == NULL)
+  {
+    error = tic_update_variables(handle, new_variables, clear_errors_occurred);
+  }
+
+  // Pass the new variables to the caller.
+  if (error == NULL)
+  {
+    *variables = new_variables;
+    new_variables = NULL;
+  }
+
+  tic_variables_free(new_variables);
+
+  return error;
+}
+
+tic_error * tic_update_variables(tic_handle * handle, tic_variables * variables,
+  bool clear_errors_occurred)
+{
+  if (variables == NULL)
+  {
+    return tic_error_create("Variables pointer is null.");
+  }
+
+  if (handle == NULL)
+  {
+    return tic_error_create("Handle is null.");
+  }
+
+  tic_error * error = NULL;
+
   // Read all the variables from the device.
   uint8_t buf[TIC_VARIABLES_SIZE];
   if (error == NULL)
@@ -236,31 +281,92 @@ tic_error * tic_get_variables(tic_handle * handle, tic_variables ** variables,
       clear_errors_occurred);
   }
 
-  // Store the variables in the new variables object.
+  // Store the variables in the caller's variables object.
   if (error == NULL)
   {
-    new_variables->product = tic_device_get_product(tic_handle_get_device(handle));
-    write_buffer_to_variables(buf, new_variables);
+    variables->product = tic_device_get_product(tic_handle_get_device(handle));
+    memcpy(variables->raw, buf, sizeof(buf));
+    for (size_t i = 0; i < TIC_VARIABLES_SIZE; i++)
+    {
+      variables->fresh[i] = true;
+    }
+    write_buffer_to_variables(variables->raw, variables);
   }
 
-  // Pass the new variables to the caller.
+  if (error != NULL)
+  {
+    error = tic_error_add_static(error,
+      "There was an error reading variables from the device.");
+  }
+
+  return error;
+}
+
+tic_error * tic_update_variables_segment(tic_handle * handle,
+  tic_variables * variables, size_t offset, size_t length)
+{
+  if (variables == NULL)
+  {
+    return tic_error_create("Variables pointer is null.");
+  }
+
+  if (handle == NULL)
+  {
+    return tic_error_create("Handle is null.");
+  }
+
+  if (length == 0 || length > TIC_VARIABLES_SIZE ||
+    offset > TIC_VARIABLES_SIZE - length)
+  {
+    return tic_error_create(
+      "Invalid variable segment: offset 0x%x, length %u.",
+      (unsigned int)offset, (unsigned int)length);
+  }
+
+  tic_error * error = NULL;
+
+  // Read the requested variables from the device.
+  uint8_t buf[TIC_VARIABLES_SIZE];
   if (error == NULL)
   {
-    *variables = new_variables;
-    new_variables = NULL;
+    error = tic_get_variable_segment(handle, offset, length, buf, false);
   }
 
-  tic_variables_free(new_variables);
+  // Update the part of the raw data that we read, mark everything else as
+  // stale, and decode.  Fields outside of the segment keep the values from
+  // earlier reads.
+  if (error == NULL)
+  {
+    variables->product = tic_device_get_product(tic_handle_get_device(handle));
+    memcpy(variables->raw + offset, buf, length);
+    for (size_t i = 0; i < TIC_VARIABLES_SIZE; i++)
+    {
+      variables->fresh[i] = i >= offset && i < offset + length;
+    }
+    write_buffer_to_variables(variables->raw, variables);
+  }
 
   if (error != NULL)
   {
-    error = tic_error_add(error,
+    error = tic_error_add_static(error,
       "There was an error reading variables from the device.");
   }
 
   return error;
 }
 
+bool tic_variables_is_stale(const tic_variables * variables,
+  size_t offset, size_t length)
+{
+  if (variables == NULL) { return true; }
+
+  for (size_t i = offset; i < offset + length; i++)
+  {
+    if (i >= TIC_VARIABLES_SIZE || !variables->fresh[i]) { return true; }
+  }
+  return false;
+}
+
 uint8_t tic_variables_get_operation_state(const tic_variables * variables)
 {
   if (variables == NULL) { return 0; }
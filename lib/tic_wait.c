@@ -0,0 +1,153 @@
+// Functions for waiting until the Tic finishes a movement.
+
+#include "tic_internal.h"
+
+// Bounds for the time between reads of the variables.
+#define TIC_WAIT_MIN_INTERVAL_NS 2000000
+#define TIC_WAIT_MAX_INTERVAL_NS 100000000
+
+// How often to read the variables while homing, when we cannot predict when
+// the motor will stop.
+#define TIC_WAIT_HOMING_INTERVAL_NS 20000000
+
+// How often to reset the command timeout.  This must be no shorter than
+// TIC_WAIT_MAX_INTERVAL_NS so that we do not send more than one reset per
+// read.
+#define TIC_WAIT_COMMAND_TIMEOUT_INTERVAL_NS TIC_WAIT_MAX_INTERVAL_NS
+
+// We wait for half of the remaining time so that the reads get more frequent
+// as the motor gets close.
+uint64_t tic_wait_get_interval_ns(const tic_variables * variables)
+{
+  tic_motion_profile * profile = NULL;
+  tic_error * error = tic_motion_profile_create(variables,
+    tic_variables_get_target_position(variables), &profile);
+  if (error != NULL)
+  {
+    // The motor might never arrive, but it could start moving if someone
+    // changes the max speed.
+    tic_error_free(error);
+    return TIC_WAIT_MAX_INTERVAL_NS;
+  }
+
+  uint64_t interval = tic_motion_profile_get_duration_us(profile) * 1000 / 2;
+  tic_motion_profile_free(profile);
+
+  if (interval < TIC_WAIT_MIN_INTERVAL_NS) { return TIC_WAIT_MIN_INTERVAL_NS; }
+  if (interval > TIC_WAIT_MAX_INTERVAL_NS) { return TIC_WAIT_MAX_INTERVAL_NS; }
+  return interval;
+}
+
+static tic_error * tic_wait_error_status_error(uint16_t error_status)
+{
+  tic_string str;
+  tic_string_setup(&str);
+  tic_sprintf(&str, "The Tic stopped because of an error:");
+  const char * separator = " ";
+  for (uint32_t i = 0; i < 16; i++)
+  {
+    if (error_status >> i & 1)
+    {
+      tic_sprintf(&str, "%s%s", separator, tic_look_up_error_name_ui(1 << i));
+      separator = ", ";
+    }
+  }
+  tic_sprintf(&str, ".");
+
+  if (str.data == NULL) { return &tic_error_no_memory; }
+  tic_error * error = tic_error_create("%s", str.data);
+  free(str.data);
+  return error;
+}
+
+tic_error * tic_wait_for_position(tic_handle * handle, uint32_t timeout_ms)
+{
+  if (handle == NULL)
+  {
+    return tic_error_create("Handle is null.");
+  }
+
+  tic_error * error = NULL;
+
+  tic_variables * variables = NULL;
+  error = tic_variables_create(&variables);
+
+  uint64_t start = tic_poller_get_time_ns();
+  uint64_t end = start + (uint64_t)timeout_ms * 1000000;
+  uint64_t last_reset = start;
+
+  while (error == NULL)
+  {
+    error = tic_update_variables(handle, variables, false);
+    if (error != NULL) { break; }
+
+    uint64_t now = tic_poller_get_time_ns();
+    uint16_t error_status = tic_variables_get_error_status(variables);
+    uint8_t planning_mode = tic_variables_get_planning_mode(variables);
+
+    uint64_t interval;
+    if (error_status)
+    {
+      error = tic_wait_error_status_error(error_status);
+      break;
+    }
+    else if (tic_variables_get_homing_active(variables))
+    {
+      interval = TIC_WAIT_HOMING_INTERVAL_NS;
+    }
+    else if (planning_mode == TIC_PLANNING_MODE_TARGET_POSITION)
+    {
+      if (tic_variables_get_current_position(variables) ==
+        tic_variables_get_target_position(variables))
+      {
+        break;
+      }
+      interval = tic_wait_get_interval_ns(variables);
+    }
+    else if (planning_mode == TIC_PLANNING_MODE_TARGET_VELOCITY)
+    {
+      error = tic_error_create(
+        "The Tic has a target velocity instead of a target position.");
+      break;
+    }
+    else
+    {
+      // The motor is not trying to move.
+      break;
+    }
+
+    if (timeout_ms != 0)
+    {
+      if (now >= end)
+      {
+        error = tic_error_add_code(tic_error_create(
+          "Timed out after %u ms.", timeout_ms), TIC_ERROR_TIMEOUT);
+        break;
+      }
+      if (now + interval > end) { interval = end - now; }
+    }
+
+    // Keep the command timeout from expiring while we wait, like the
+    // Tic Control Center does.
+    if (now - last_reset >= TIC_WAIT_COMMAND_TIMEOUT_INTERVAL_NS)
+    {
+      error = tic_reset_command_timeout(handle);
+      last_reset = now;
+    }
+
+    if (error == NULL)
+    {
+      tic_poller_sleep_until(now + interval);
+    }
+  }
+
+  tic_variables_free(variables);
+
+  if (error != NULL)
+  {
+    error = tic_error_add(error,
+      "There was an error waiting for the Tic to reach its target.");
+  }
+
+  return error;
+}
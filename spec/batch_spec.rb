@@ -0,0 +1,53 @@
+require_relative 'spec_helper'
+
+describe 'batch mode' do
+  it 'ignores blank lines and comments' do
+    stdout, stderr, result = run_ticcmd('--batch -', input: "# comment\n\n")
+    expect(stdout).to eq ''
+    expect(stderr).to eq ''
+    expect(result).to eq 0
+  end
+
+  it 'rejects global options on a line' do
+    stdout, stderr, result = run_ticcmd('--batch -', input: "\n--list\n")
+    expect(stdout).to match /\A2: error \(\d+\.\d{3} ms\)\n\z/
+    expect(stderr).to eq "Error: Line contains an option that is " \
+      "not allowed in batch mode.\n"
+    expect(result).to eq EXIT_BAD_ARGS
+  end
+
+  it 'reports bad arguments with the line number' do
+    stdout, stderr, result = run_ticcmd('--batch -', input: "-p 1x\n")
+    expect(stdout).to match /\A1: error \(\d+\.\d{3} ms\)\n\z/
+    expect(stderr).to eq "Error: The number after '-p' is invalid.\n"
+    expect(result).to eq EXIT_BAD_ARGS
+  end
+
+  it 'supports quoted arguments' do
+    input = "--settings 'no such \"file\".txt'\n"
+    stdout, stderr, result = run_ticcmd('--batch -', input: input)
+    expect(stdout).to match /\A1: error \(\d+\.\d{3} ms\)\n\z/
+    expect(stderr).to eq "Error: no such \"file\".txt: " \
+      "No such file or directory.\n"
+    expect(result).to eq EXIT_OPERATION_FAILED
+
+    input = "--settings \"a \\\"b\\\" \\\\c\"d\n"
+    stdout, stderr, result = run_ticcmd('--batch -', input: input)
+    expect(stderr).to eq "Error: a \"b\" \\cd: No such file or directory.\n"
+    expect(result).to eq EXIT_OPERATION_FAILED
+  end
+
+  it 'rejects unterminated quotes' do
+    stdout, stderr, result = run_ticcmd('--batch -', input: "-p '1\n")
+    expect(stdout).to match /\A1: error \(\d+\.\d{3} ms\)\n\z/
+    expect(stderr).to eq "Error: Line has an unterminated quote.\n"
+    expect(result).to eq EXIT_BAD_ARGS
+  end
+
+  it 'uses the device specified on the command line' do
+    stdout, stderr, result = run_ticcmd('-d x --batch -', input: "-p 1\n")
+    expect(stdout).to match /\A1: error \(\d+\.\d{3} ms\)\n\z/
+    expect(stderr).to eq "Error: No device was found with serial number 'x'.\n"
+    expect(result).to eq EXIT_DEVICE_NOT_FOUND
+  end
+end
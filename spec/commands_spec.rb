@@ -89,6 +89,30 @@ describe 'commands for controlling the motor', usb: true do
     end
   end
 
+  describe 'Wait' do
+    it 'waits until the target position is reached' do
+      stdout, stderr, result = run_ticcmd('--halt-and-set-position 0')
+      expect(result).to eq 0
+
+      stdout, stderr, result = run_ticcmd('-p 2000 --wait-timeout 5000')
+      expect(stderr).to eq ''
+      expect(stdout).to eq ''
+      expect(result).to eq 0
+
+      expect(tic_get_status['Current position']).to eq 2000
+    end
+
+    it 'fails if the Tic has a target velocity' do
+      stdout, stderr, result = run_ticcmd('-y 100000 --wait')
+      expect(stderr).to include 'target velocity'
+      expect(stdout).to eq ''
+      expect(result).to eq 2
+
+      stdout, stderr, result = run_ticcmd('--halt-and-hold')
+      expect(result).to eq 0
+    end
+  end
+
   describe 'Reset command timeout' do
     it 'runs' do
       stdout, stderr, result = run_ticcmd('--reset-command-timeout')
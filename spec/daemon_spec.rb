@@ -0,0 +1,91 @@
+require_relative 'spec_helper'
+require 'socket'
+
+# Starts a daemon serving an emulated Tic on a socket in a temporary directory,
+# yields the socket path, and stops the daemon afterwards.
+def with_emulated_daemon
+  Dir.mktmpdir do |dir|
+    path = File.join(dir, 'tic.sock')
+    env = { 'TIC_EMULATED_DEVICES' => 'T825' }
+    Open3.popen3(env, 'ticcmd', '--daemon', path) do |stdin, stdout, stderr, thread|
+      begin
+        100.times do
+          break if File.socket?(path) || !thread.alive?
+          sleep 0.05
+        end
+        raise "Daemon did not start: #{stderr.read}" if !File.socket?(path)
+        yield path
+      ensure
+        Process.kill('TERM', thread.pid) if thread.alive?
+        thread.value
+      end
+    end
+  end
+end
+
+# Sends the given requests to the daemon and returns each response as an array
+# holding the header line and the body.
+def daemon_requests(path, requests)
+  socket = UNIXSocket.new(path)
+  socket.write(requests.map { |r| r + "\n" }.join)
+  socket.close_write
+  responses = []
+  while (header = socket.gets)
+    size = header.split.last.to_i
+    responses << [header.chomp, socket.read(size)]
+  end
+  socket.close
+  responses
+end
+
+describe 'daemon mode' do
+  it 'fails if there is no device' do
+    Dir.mktmpdir do |dir|
+      path = File.join(dir, 'tic.sock')
+      stdout, stderr, result = run_ticcmd("-d x --daemon #{path}")
+      expect(stdout).to eq ''
+      expect(stderr).to eq "Error: No device was found.\n"
+      expect(result).to eq EXIT_DEVICE_NOT_FOUND
+      expect(File.exist?(path)).to eq false
+    end
+  end
+
+  it 'is not allowed in batch mode' do
+    stdout, stderr, result = run_ticcmd('--batch -', input: "--daemon x\n")
+    expect(stdout).to match /\A1: error \(\d+\.\d{3} ms\)\n\z/
+    expect(stderr).to eq "Error: Line contains an option that is " \
+      "not allowed in batch mode.\n"
+    expect(result).to eq EXIT_BAD_ARGS
+  end
+
+  it 'does not replace a file that is not a socket' do
+    Dir.mktmpdir do |dir|
+      path = File.join(dir, 'file')
+      File.write(path, 'data')
+      env = { 'TIC_EMULATED_DEVICES' => 'T825' }
+      stdout, stderr, status = Open3.capture3(env, 'ticcmd', '--daemon', path)
+      expect(stderr).to eq "Error: Refusing to replace #{path} " \
+        "because it is not a socket.\n"
+      expect(status.exitstatus).to eq EXIT_BAD_ARGS
+      expect(File.read(path)).to eq 'data'
+    end
+  end
+
+  it 'answers requests' do
+    with_emulated_daemon do |path|
+      responses = daemon_requests(path, ['--energize', '-s --full', '-p 1x'])
+      expect(responses.size).to eq 3
+
+      expect(responses[0]).to eq ['ok 0', '']
+
+      header, body = responses[1]
+      expect(header).to eq "ok #{body.size}"
+      status = YAML.load(body)
+      expect(status['Serial number']).to eq 'EMU00001'
+      expect(status['Energized']).to eq true
+
+      expect(responses[2]).to eq ['error 1 41',
+        "Error: The number after '-p' is invalid.\n"]
+    end
+  end
+end
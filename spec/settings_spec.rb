@@ -988,4 +988,125 @@ describe 'settings' do
       expect(result).to eq 2
     end
   end
+
+  describe 'bulk fixing' do
+    it "fixes each file in a directory and reports the warnings" do
+      Dir.mktmpdir do |dir|
+        Dir.mkdir("#{dir}/in")
+        File.write("#{dir}/in/a.txt", "product: T825\nmax_speed: 900000000\n")
+        File.write("#{dir}/in/b.txt", "product: T825\n")
+        File.write("#{dir}/in/c.txt", "product: T825\nbogus: 1\n")
+
+        stdout, stderr, result = run_ticcmd(
+          "--fix-settings-bulk #{dir}/in #{dir}/out --jobs 2")
+        expect(stderr).to eq "Error: 1 of 3 settings files could not be fixed.\n"
+        expect(result).to eq 2
+
+        report = YAML.load(stdout)
+        a, b, c = report.fetch('files')
+        expect(a['warnings'].size).to eq 1
+        expect(a['warnings'][0]).to start_with 'Warning: The maximum speed'
+        expect(b).to_not have_key 'warnings'
+        expect(c['error']).to include 'Unrecognized key on line 2: "bogus".'
+        expect(report.fetch('summary')).to eq('files' => 3,
+          'fixed_without_warnings' => 1, 'fixed_with_warnings' => 1,
+          'failed' => 1)
+
+        expect(YAML.load_file("#{dir}/out/a.txt")['max_speed']).to eq 500000000
+        expect(File.exist?("#{dir}/out/c.txt")).to eq false
+      end
+    end
+
+    it "reports empty files as failed and keeps going" do
+      Dir.mktmpdir do |dir|
+        Dir.mkdir("#{dir}/in")
+        File.write("#{dir}/in/a.txt", "product: T825\n")
+        File.write("#{dir}/in/b.txt", "")
+        File.write("#{dir}/in/c.txt", "# just a comment\n")
+
+        stdout, stderr, result = run_ticcmd(
+          "--fix-settings-bulk #{dir}/in #{dir}/out")
+        expect(stderr).to eq "Error: 2 of 3 settings files could not be fixed.\n"
+        expect(result).to eq 2
+
+        report = YAML.load(stdout)
+        a, b, c = report.fetch('files')
+        expect(a).to_not have_key 'error'
+        expect(b['error']).to include 'The settings file is empty.'
+        expect(c['error']).to include 'The settings file is empty.'
+        expect(report.fetch('summary')).to eq('files' => 3,
+          'fixed_without_warnings' => 1, 'fixed_with_warnings' => 0,
+          'failed' => 2)
+        expect(File.exist?("#{dir}/out/a.txt")).to eq true
+      end
+    end
+  end
+
+  describe 'binary settings images' do
+    it "can be saved and loaded", usb: true do
+      Dir.mktmpdir do |dir|
+        image = "#{dir}/settings.bin"
+        stdout, stderr, result = run_ticcmd("--get-settings-bin #{image}")
+        expect(stderr).to eq ""
+        expect(result).to eq 0
+        expect(File.size(image)).to eq 128
+        expect(File.binread(image, 4)).to eq "TICS"
+
+        settings_before = YAML.load(run_ticcmd('--get-settings -')[0])
+        tic_change_settings do |s|
+          s['max_speed'] = 1234567
+        end
+
+        stdout, stderr, result = run_ticcmd("--settings-bin #{image}")
+        expect(stderr).to eq ""
+        expect(result).to eq 0
+        expect(YAML.load(run_ticcmd('--get-settings -')[0])).to \
+          eq settings_before
+      end
+    end
+
+    it "rejects corrupt images", usb: true do
+      Dir.mktmpdir do |dir|
+        image = "#{dir}/settings.bin"
+        stdout, stderr, result = run_ticcmd("--get-settings-bin #{image}")
+        expect(result).to eq 0
+        data = File.binread(image)
+        data[40] = (data[40].ord ^ 1).chr
+        File.binwrite(image, data)
+
+        stdout, stderr, result = run_ticcmd("--settings-bin #{image}")
+        expect(stderr).to eq "Error: There was an error reading the " \
+          "settings image.  The settings image is corrupt: its checksum " \
+          "is incorrect.\n"
+        expect(result).to eq 2
+      end
+    end
+  end
+
+  describe 'diffing' do
+    it "shows the fields that differ from the device", usb: true do
+      Dir.mktmpdir do |dir|
+        filename = "#{dir}/settings.txt"
+        stdout, stderr, result = run_ticcmd("--get-settings #{filename}")
+        expect(result).to eq 0
+
+        stdout, stderr, result = run_ticcmd("--diff-settings #{filename}")
+        expect(stderr).to eq ""
+        expect(result).to eq 0
+        expect(stdout).to eq ""
+
+        settings = YAML.load_file(filename)
+        old_max_speed = settings['max_speed']
+        settings['max_speed'] = old_max_speed + 1
+        File.write(filename, settings.to_yaml)
+
+        stdout, stderr, result = run_ticcmd("--diff-settings #{filename}")
+        expect(stderr).to eq ""
+        expect(result).to eq 0
+        expect(YAML.load(stdout)).to eq(
+          'max_speed' => { 'device' => old_max_speed,
+                           'file' => old_max_speed + 1 })
+      end
+    end
+  end
 end
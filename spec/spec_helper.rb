@@ -1,5 +1,6 @@
 require 'rspec'
 require 'open3'
+require 'tmpdir'
 require 'yaml'
 
 EXIT_BAD_ARGS = 1
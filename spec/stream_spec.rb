@@ -0,0 +1,18 @@
+require_relative 'spec_helper'
+
+describe 'streaming' do
+  it 'rejects unknown field names' do
+    stdout, stderr, result = run_ticcmd('--stream --stream-fields foo')
+    expect(stdout).to eq ''
+    expect(stderr).to eq "Error: Unknown field for --stream-fields: 'foo'.\n"
+    expect(result).to eq EXIT_BAD_ARGS
+  end
+
+  it 'is not allowed in batch mode' do
+    stdout, stderr, result = run_ticcmd('--batch -', input: "--stream\n")
+    expect(stdout).to match /\A1: error \(\d+\.\d{3} ms\)\n\z/
+    expect(stderr).to eq "Error: Line contains an option that is " \
+      "not allowed in batch mode.\n"
+    expect(result).to eq EXIT_BAD_ARGS
+  end
+end
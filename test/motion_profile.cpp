@@ -0,0 +1,134 @@
+// Tests the motion profile predictor against the emulator.  The emulator runs
+// on manual time, so each move is stepped through one millisecond at a time
+// and compared to the predicted trajectory.
+
+#include <tic.hpp>
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+static uint32_t failure_count = 0;
+
+static void check(bool condition, const std::string & what)
+{
+  if (!condition)
+  {
+    std::cerr << "  FAILED: " << what << std::endl;
+    failure_count++;
+  }
+}
+
+struct move
+{
+  const char * name;
+  uint32_t max_speed;
+  uint32_t starting_speed;
+  uint32_t max_accel;
+  uint32_t max_decel;
+
+  // If non-zero, the motor gets up to this velocity before the move starts.
+  int32_t initial_velocity;
+
+  // If non-zero, the max speed is lowered to this just before the move.
+  uint32_t lowered_max_speed;
+
+  // The target, relative to the position where the move starts.
+  int32_t distance;
+};
+
+static void test_move(const move & m)
+{
+  tic::emulator emulator = tic::emulator::create(TIC_PRODUCT_T825);
+  emulator.set_manual_time(true);
+  tic::handle handle = emulator.open_handle();
+
+  tic::settings settings = handle.get_settings();
+  tic_settings_set_command_timeout(settings.get_pointer(), 0);
+  handle.set_settings(settings);
+  handle.reinitialize();
+
+  handle.exit_safe_start();
+  handle.set_max_speed(m.max_speed);
+  handle.set_starting_speed(m.starting_speed);
+  handle.set_max_accel(m.max_accel);
+  handle.set_max_decel(m.max_decel);
+  if (m.initial_velocity)
+  {
+    handle.set_target_velocity(m.initial_velocity);
+    emulator.advance_time(5000000);
+  }
+  if (m.lowered_max_speed)
+  {
+    handle.set_max_speed(m.lowered_max_speed);
+  }
+
+  tic::variables variables = handle.get_variables();
+  int32_t target = variables.get_current_position() + m.distance;
+  tic::motion_profile profile = tic::motion_profile::create(variables, target);
+  handle.set_target_position(target);
+
+  // Give up well after the predicted arrival.
+  uint64_t duration_us = profile.get_duration_us();
+  uint64_t limit_us = duration_us * 2 + 10000000;
+
+  uint64_t time_us = 0;
+  int32_t max_position_error = 0;
+  while (time_us < limit_us)
+  {
+    emulator.advance_time(1000);
+    time_us += 1000;
+    variables = handle.get_variables();
+    int32_t position = variables.get_current_position();
+    int32_t error = std::abs(position - profile.get_position(time_us));
+    if (error > max_position_error) { max_position_error = error; }
+    if (position == target && variables.get_current_velocity() == 0) { break; }
+  }
+
+  // The emulator's planner works in one-millisecond steps, so allow for a
+  // little rounding on each phase of the move.
+  uint64_t tolerance_us = duration_us / 100 + 100000;
+  uint64_t difference_us = time_us > duration_us ?
+    time_us - duration_us : duration_us - time_us;
+  check(difference_us <= tolerance_us, "predicted " +
+    std::to_string(duration_us / 1000) + " ms, emulator took " +
+    std::to_string(time_us / 1000) + " ms");
+  check(max_position_error <= 2, "position was off by up to " +
+    std::to_string(max_position_error) + " steps");
+}
+
+int main()
+{
+  static const move moves[] = {
+    { "cruise at the max speed", 2000000, 0, 40000, 0, 0, 0, 1000 },
+    { "separate deceleration", 2000000, 500000, 40000, 80000, 0, 0, -1000 },
+    { "too short to reach the max speed", 20000000, 0, 100000, 50000,
+      0, 0, 300 },
+    { "moving away from the target", 5000000, 0, 100000, 0,
+      -5000000, 0, 2000 },
+    { "already moving toward the target", 5000000, 100000, 20000, 0,
+      5000000, 0, 20000 },
+    { "max speed lowered while moving", 12000000, 0, 40000, 0,
+      12000000, 2000000, 38200 },
+  };
+
+  for (const move & m : moves)
+  {
+    std::cout << m.name << std::endl;
+    try
+    {
+      test_move(m);
+    }
+    catch (const std::exception & error)
+    {
+      check(false, std::string("exception: ") + error.what());
+    }
+  }
+
+  if (failure_count)
+  {
+    std::cerr << failure_count << " check(s) failed." << std::endl;
+    return 1;
+  }
+  return 0;
+}
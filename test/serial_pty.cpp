@@ -0,0 +1,591 @@
+// Tests the serial transport against a fake Tic on a pseudo-terminal.  The
+// fake Tic records every byte the library sends, checks the device number and
+// CRC of each command, and answers block reads from an image of the
+// variables.
+
+#include <tic.hpp>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+typedef std::vector<uint8_t> bytes;
+
+static uint32_t failure_count = 0;
+
+static std::string format_bytes(const bytes & data)
+{
+  std::string result;
+  for (uint8_t byte : data)
+  {
+    char hex[4];
+    snprintf(hex, sizeof(hex), "%02X ", byte);
+    result += hex;
+  }
+  if (!result.empty()) { result.pop_back(); }
+  return result;
+}
+
+static void check(bool condition, const std::string & what)
+{
+  if (!condition)
+  {
+    std::cerr << "  FAILED: " << what << std::endl;
+    failure_count++;
+  }
+}
+
+static void check_bytes(const bytes & actual, const bytes & expected,
+  const std::string & what)
+{
+  check(actual == expected, what + ": expected " + format_bytes(expected) +
+    ", got " + format_bytes(actual));
+}
+
+static void check_error(const std::function<void()> & action,
+  const std::string & expected_message)
+{
+  std::string message;
+  try
+  {
+    action();
+  }
+  catch (const tic::error & error)
+  {
+    message = error.message();
+  }
+  check(message.find(expected_message) != std::string::npos,
+    "expected error containing '" + expected_message + "', got '" +
+    message + "'");
+}
+
+// Computes the CRC-7 used by Pololu serial protocols, written out separately
+// from the library's version so the test does not just agree with itself.
+static uint8_t crc7(const bytes & data)
+{
+  uint8_t crc = 0;
+  for (uint8_t byte : data)
+  {
+    for (int i = 0; i < 8; i++)
+    {
+      bool bit = ((byte >> i) ^ crc) & 1;
+      crc >>= 1;
+      if (bit) { crc ^= 0x48; }
+    }
+  }
+  return crc;
+}
+
+static bytes with_crc(bytes data)
+{
+  data.push_back(crc7(data));
+  return data;
+}
+
+struct fake_tic_options
+{
+  bool compact = false;
+  uint8_t device_number = 14;
+  bool crc_for_commands = false;
+  bool crc_for_responses = false;
+  bool responses_7bit = false;
+  bool echo = false;
+  bool corrupt_echo = false;
+  bool corrupt_response_crc = false;
+};
+
+class fake_tic
+{
+public:
+  explicit fake_tic(const fake_tic_options & options) : options(options)
+  {
+    memset(variables, 0, sizeof(variables));
+
+    master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) || unlockpt(master))
+    {
+      throw std::runtime_error("Failed to create a pseudo-terminal.");
+    }
+    port = ptsname(master);
+
+    thread = std::thread(&fake_tic::run, this);
+  }
+
+  ~fake_tic()
+  {
+    stop = true;
+    thread.join();
+    close(master);
+  }
+
+  // Waits for the specified number of bytes from the library and returns
+  // them.  Returns fewer bytes if they do not arrive within a second.
+  bytes receive(size_t count)
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    received_changed.wait_for(lock, std::chrono::seconds(1),
+      [&]{ return received.size() >= count; });
+    if (count > received.size()) { count = received.size(); }
+    bytes result(received.begin(), received.begin() + count);
+    received.erase(received.begin(), received.begin() + count);
+    return result;
+  }
+
+  // Returns all the bytes received so far.
+  bytes receive_all()
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    bytes result;
+    result.swap(received);
+    return result;
+  }
+
+  // Returns the problems the fake Tic saw in the commands it received.
+  std::vector<std::string> get_problems()
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    return problems;
+  }
+
+  // The most block reads that were received before the first of them was
+  // answered.
+  size_t get_max_pending_reads()
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    return max_pending_reads;
+  }
+
+  std::string port;
+  uint8_t variables[0x80];
+
+private:
+  // Returns the number of data bytes that follow a command byte.
+  static size_t data_length(uint8_t command)
+  {
+    switch (command)
+    {
+    case TIC_CMD_SET_TARGET_POSITION:
+    case TIC_CMD_SET_TARGET_VELOCITY:
+    case TIC_CMD_HALT_AND_SET_POSITION:
+    case TIC_CMD_SET_MAX_SPEED:
+    case TIC_CMD_SET_STARTING_SPEED:
+    case TIC_CMD_SET_MAX_ACCEL:
+    case TIC_CMD_SET_MAX_DECEL:
+      return 5;
+    case TIC_CMD_GO_HOME:
+    case TIC_CMD_SET_STEP_MODE:
+    case TIC_CMD_SET_CURRENT_LIMIT:
+    case TIC_CMD_SET_DECAY_MODE:
+    case TIC_CMD_SET_AGC_OPTION:
+      return 1;
+    case TIC_CMD_GET_VARIABLE:
+    case TIC_CMD_GET_VARIABLE_AND_CLEAR_ERRORS_OCCURRED:
+    case TIC_CMD_GET_SETTING:
+      return 2;
+    default:
+      return 0;
+    }
+  }
+
+  // Removes one complete command from the input and handles it.  Returns
+  // false if the input does not hold a complete command yet.
+  bool parse_command()
+  {
+    size_t header_length = options.compact ? 1 : 3;
+    if (input.size() < header_length) { return false; }
+
+    uint8_t command = input[0];
+    if (!options.compact)
+    {
+      if (input[0] != 0xAA)
+      {
+        problems.push_back("Expected 0xAA, got " + format_bytes({input[0]}));
+        input.erase(input.begin());
+        return true;
+      }
+      if (input[1] != options.device_number)
+      {
+        problems.push_back("Wrong device number " + format_bytes({input[1]}));
+      }
+      command = input[2] | 0x80;
+    }
+
+    size_t length = header_length + data_length(command) +
+      options.crc_for_commands;
+    if (input.size() < length) { return false; }
+
+    bytes packet(input.begin(), input.begin() + length);
+    input.erase(input.begin(), input.begin() + length);
+
+    if (options.crc_for_commands)
+    {
+      uint8_t crc = packet.back();
+      packet.pop_back();
+      if (crc7(packet) != crc)
+      {
+        problems.push_back("Bad CRC in " + format_bytes(packet));
+      }
+    }
+
+    if (command == TIC_CMD_GET_VARIABLE)
+    {
+      pending_reads.push_back(bytes(packet.end() - 2, packet.end()));
+    }
+    return true;
+  }
+
+  bytes respond(const bytes & request)
+  {
+    uint8_t offset = request[0];
+    uint8_t size = request[1];
+    bytes response(variables + offset, variables + offset + size);
+    if (options.responses_7bit)
+    {
+      uint8_t msbs = 0;
+      for (size_t i = 0; i < size; i++)
+      {
+        msbs |= (response[i] >> 7) << i;
+        response[i] &= 0x7F;
+      }
+      response.push_back(msbs);
+    }
+    if (options.crc_for_responses)
+    {
+      response = with_crc(response);
+      if (options.corrupt_response_crc) { response.back() ^= 1; }
+    }
+    return response;
+  }
+
+  void write_all(const bytes & data)
+  {
+    size_t sent = 0;
+    while (sent < data.size())
+    {
+      ssize_t count = write(master, data.data() + sent, data.size() - sent);
+      if (count <= 0) { return; }
+      sent += count;
+    }
+  }
+
+  void run()
+  {
+    while (!stop)
+    {
+      // Answer the block reads once the library stops sending, so we can
+      // tell whether it sent them all before waiting for a response.
+      struct pollfd pfd = { master, POLLIN, 0 };
+      int result = poll(&pfd, 1, 5);
+      if (result > 0 && (pfd.revents & POLLIN))
+      {
+        uint8_t buffer[256];
+        ssize_t count = read(master, buffer, sizeof(buffer));
+        if (count <= 0) { continue; }
+        bytes chunk(buffer, buffer + count);
+
+        if (options.echo)
+        {
+          bytes echo = chunk;
+          if (options.corrupt_echo) { echo[0] ^= 0x40; }
+          write_all(echo);
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        received.insert(received.end(), chunk.begin(), chunk.end());
+        input.insert(input.end(), chunk.begin(), chunk.end());
+        while (parse_command()) { }
+        received_changed.notify_all();
+      }
+      else if (result > 0)
+      {
+        // The library has not opened the port yet or has closed it.
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      }
+      else if (!pending_reads.empty())
+      {
+        bytes responses;
+        {
+          std::unique_lock<std::mutex> lock(mutex);
+          if (pending_reads.size() > max_pending_reads)
+          {
+            max_pending_reads = pending_reads.size();
+          }
+          for (const bytes & request : pending_reads)
+          {
+            bytes response = respond(request);
+            responses.insert(responses.end(), response.begin(), response.end());
+          }
+          pending_reads.clear();
+        }
+        write_all(responses);
+      }
+    }
+  }
+
+  fake_tic_options options;
+  int master;
+  std::thread thread;
+  std::atomic<bool> stop{false};
+
+  std::mutex mutex;
+  std::condition_variable received_changed;
+  bytes received;
+  bytes input;
+  std::vector<bytes> pending_reads;
+  size_t max_pending_reads = 0;
+  std::vector<std::string> problems;
+};
+
+static tic::settings serial_settings(const fake_tic_options & options)
+{
+  tic::settings settings = tic::settings::create();
+  settings.set_product(TIC_PRODUCT_T825);
+  settings.fill_with_defaults();
+  tic_settings * p = settings.get_pointer();
+  tic_settings_set_serial_baud_rate(p, 115200);
+  tic_settings_set_serial_device_number_u16(p, options.device_number);
+  tic_settings_set_serial_crc_for_commands(p, options.crc_for_commands);
+  tic_settings_set_serial_crc_for_responses(p, options.crc_for_responses);
+  tic_settings_set_serial_7bit_responses(p, options.responses_7bit);
+  return settings;
+}
+
+static tic::handle open_fake(const fake_tic & fake,
+  const fake_tic_options & options, uint32_t flags = 0)
+{
+  if (options.compact) { flags |= TIC_SERIAL_COMPACT_PROTOCOL; }
+  if (options.echo) { flags |= TIC_SERIAL_ECHO; }
+  return tic::handle::open_serial(fake.port, serial_settings(options), flags);
+}
+
+// Fills the variables with values whose bytes have the most significant bit
+// set, so the 7-bit encoding gets exercised.
+static void set_test_variables(fake_tic & fake)
+{
+  for (size_t i = 0; i < sizeof(fake.variables); i++)
+  {
+    fake.variables[i] = 0x80 | i;
+  }
+  int32_t position = -123456789;
+  memcpy(fake.variables + TIC_VAR_CURRENT_POSITION, &position, 4);
+  uint32_t max_speed = 0x89ABCDEF;
+  memcpy(fake.variables + TIC_VAR_MAX_SPEED, &max_speed, 4);
+}
+
+static void check_test_variables(const tic::variables & variables)
+{
+  check(variables.get_current_position() == -123456789,
+    "current position decoded");
+  check(variables.get_max_speed() == 0x89ABCDEF, "max speed decoded");
+}
+
+// The expected block read commands for reading all the variables in blocks
+// of the specified size.
+static bytes variable_reads(const fake_tic_options & options, size_t block)
+{
+  bytes result;
+  for (size_t offset = 0; offset < TIC_VARIABLES_SIZE; offset += block)
+  {
+    size_t size = TIC_VARIABLES_SIZE - offset;
+    if (size > block) { size = block; }
+    bytes packet;
+    if (options.compact)
+    {
+      packet = { TIC_CMD_GET_VARIABLE };
+    }
+    else
+    {
+      packet = { 0xAA, options.device_number, TIC_CMD_GET_VARIABLE & 0x7F };
+    }
+    packet.push_back(offset);
+    packet.push_back(size);
+    if (options.crc_for_commands) { packet = with_crc(packet); }
+    result.insert(result.end(), packet.begin(), packet.end());
+  }
+  return result;
+}
+
+static void check_no_problems(fake_tic & fake)
+{
+  for (const std::string & problem : fake.get_problems())
+  {
+    check(false, problem);
+  }
+}
+
+static void test_crc7()
+{
+  // The example from Pololu's serial protocol documentation.
+  check(crc7({ 0x83, 0x01 }) == 0x17, "CRC-7 of 83 01");
+}
+
+static void test_compact_commands()
+{
+  fake_tic_options options;
+  options.compact = true;
+  fake_tic fake(options);
+  tic::handle handle = open_fake(fake, options);
+
+  handle.set_target_position(200);
+  check_bytes(fake.receive(6), { 0xE0, 0x01, 0x48, 0x00, 0x00, 0x00 },
+    "set target position 200");
+
+  handle.set_target_position(-1);
+  check_bytes(fake.receive(6), { 0xE0, 0x0F, 0x7F, 0x7F, 0x7F, 0x7F },
+    "set target position -1");
+
+  handle.set_max_speed(0x80000081);
+  check_bytes(fake.receive(6), { 0xE6, 0x09, 0x01, 0x00, 0x00, 0x00 },
+    "set max speed 0x80000081");
+
+  handle.energize();
+  check_bytes(fake.receive(1), { 0x85 }, "energize");
+
+  check_no_problems(fake);
+}
+
+static void test_pololu_commands_with_crc()
+{
+  fake_tic_options options;
+  options.crc_for_commands = true;
+  fake_tic fake(options);
+  tic::handle handle = open_fake(fake, options);
+
+  handle.set_target_position(200);
+  check_bytes(fake.receive(9),
+    with_crc({ 0xAA, 14, 0x60, 0x01, 0x48, 0x00, 0x00, 0x00 }),
+    "set target position 200 with device number and CRC");
+
+  handle.exit_safe_start();
+  check_bytes(fake.receive(4), with_crc({ 0xAA, 14, 0x03 }),
+    "exit safe start with device number and CRC");
+
+  check_no_problems(fake);
+}
+
+static void test_pipelined_reads()
+{
+  fake_tic_options options;
+  options.compact = true;
+  fake_tic fake(options);
+  set_test_variables(fake);
+  tic::handle handle = open_fake(fake, options);
+
+  check_test_variables(handle.get_variables());
+  check_bytes(fake.receive_all(), variable_reads(options, 15),
+    "block reads for the variables");
+  check(fake.get_max_pending_reads() == 6,
+    "all 6 block reads are sent before the first response, got " +
+    std::to_string(fake.get_max_pending_reads()));
+  check_no_problems(fake);
+}
+
+static void test_7bit_responses_with_crc()
+{
+  fake_tic_options options;
+  options.crc_for_commands = true;
+  options.crc_for_responses = true;
+  options.responses_7bit = true;
+  fake_tic fake(options);
+  set_test_variables(fake);
+  tic::handle handle = open_fake(fake, options);
+
+  check_test_variables(handle.get_variables());
+  check_bytes(fake.receive_all(), variable_reads(options, 7),
+    "7-bit block reads for the variables");
+  check_no_problems(fake);
+}
+
+static void test_bad_response_crc()
+{
+  fake_tic_options options;
+  options.compact = true;
+  options.crc_for_responses = true;
+  options.corrupt_response_crc = true;
+  fake_tic fake(options);
+  tic::handle handle = open_fake(fake, options);
+
+  check_error([&]{ handle.get_variables(); }, "incorrect CRC");
+}
+
+static void test_half_duplex_echo()
+{
+  fake_tic_options options;
+  options.echo = true;
+  options.crc_for_responses = true;
+  fake_tic fake(options);
+  set_test_variables(fake);
+  tic::handle handle = open_fake(fake, options);
+
+  handle.set_target_position(200);
+  check_bytes(fake.receive(8), { 0xAA, 14, 0x60, 0x01, 0x48, 0x00, 0x00, 0x00 },
+    "set target position 200 on an echoing line");
+
+  // The echo of the block reads must not be mistaken for responses, and the
+  // library must not send a block read while a response is coming.
+  check_test_variables(handle.get_variables());
+  check_bytes(fake.receive_all(), variable_reads(options, 15),
+    "block reads on an echoing line");
+  check(fake.get_max_pending_reads() == 1,
+    "one block read at a time on a half-duplex line, got " +
+    std::to_string(fake.get_max_pending_reads()));
+  check_no_problems(fake);
+}
+
+static void test_echo_mismatch()
+{
+  fake_tic_options options;
+  options.echo = true;
+  options.corrupt_echo = true;
+  fake_tic fake(options);
+  tic::handle handle = open_fake(fake, options);
+
+  check_error([&]{ handle.energize(); }, "echo");
+}
+
+int main()
+{
+  static const struct { const char * name; void (*run)(); } tests[] = {
+    { "crc7", test_crc7 },
+    { "compact commands", test_compact_commands },
+    { "Pololu commands with CRC", test_pololu_commands_with_crc },
+    { "pipelined reads", test_pipelined_reads },
+    { "7-bit responses with CRC", test_7bit_responses_with_crc },
+    { "bad response CRC", test_bad_response_crc },
+    { "half-duplex echo", test_half_duplex_echo },
+    { "echo mismatch", test_echo_mismatch },
+  };
+
+  for (const auto & test : tests)
+  {
+    std::cout << test.name << std::endl;
+    try
+    {
+      test.run();
+    }
+    catch (const std::exception & error)
+    {
+      check(false, std::string("exception: ") + error.what());
+    }
+  }
+
+  if (failure_count)
+  {
+    std::cerr << failure_count << " check(s) failed." << std::endl;
+    return 1;
+  }
+  return 0;
+}